@@ -22,6 +22,7 @@
 #include "cy_app_source.h"
 #endif /* CY_PD_SINK_ONLY */
 #include "cy_app_sink.h"
+#include "cy_app_pdo.h"
 #include "cy_app_swap.h"
 #include "cy_app_vdm.h"
 #include "cy_app.h"
@@ -32,6 +33,35 @@
 #include "cy_pdstack_timer_id.h"
 
 #include "cy_app_fault_handlers.h"
+#include "cy_app_coroutine.h"
+
+#if CY_APP_TIMESTAMP_ENABLE
+#include "cy_tcpwm_counter.h"
+#endif /* CY_APP_TIMESTAMP_ENABLE */
+
+#if CY_APP_ADC_SCHED_ENABLE
+#include "cy_app_adc_sched.h"
+#endif /* CY_APP_ADC_SCHED_ENABLE */
+
+#if CY_APP_PARTNER_CACHE_ENABLE
+#include "cy_app_partner.h"
+#endif /* CY_APP_PARTNER_CACHE_ENABLE */
+
+#if CY_APP_POWER_BUDGET_ENABLE
+#include "cy_app_power_budget.h"
+#endif /* CY_APP_POWER_BUDGET_ENABLE */
+
+#if CY_APP_TELEMETRY_ENABLE
+#include "cy_app_telemetry.h"
+#endif /* CY_APP_TELEMETRY_ENABLE */
+
+#if CY_APP_SINK_ENERGY_ENABLE
+#include "cy_app_sink_energy.h"
+#endif /* CY_APP_SINK_ENERGY_ENABLE */
+
+#if CY_APP_THERMAL_DERATE_ENABLE
+#include "cy_app_thermal.h"
+#endif /* CY_APP_THERMAL_DERATE_ENABLE */
 
 #if BATTERY_CHARGING_ENABLE
 #include "cy_app_battery_charging.h"
@@ -120,9 +150,6 @@ static uint8_t glAppPrevPolarity[NO_OF_TYPEC_PORTS];
 static bool glAppResetEpr[NO_OF_TYPEC_PORTS];
 #endif /* (CY_PD_EPR_ENABLE && (!CY_PD_SOURCE_ONLY)) */
 
-#if CY_PD_REV3_ENABLE
-void send_get_revision(cy_timer_id_t id, void *ptrContext);
-#endif /* CY_PD_REV3_ENABLE */
 #if CY_HPI_MASTER_ENABLE
 extern cy_hpi_master_context_t *get_hpi_master_context(void);
 #endif /* CY_HPI_MASTER_ENABLE */
@@ -130,6 +157,33 @@ extern cy_hpi_master_context_t *get_hpi_master_context(void);
 cy_en_usbpd_adc_id_t glAppVbusPollAdcId[NO_OF_TYPEC_PORTS] = {CY_USBPD_ADC_ID_0};
 cy_en_usbpd_adc_input_t glAppVbusPollAdcInput[NO_OF_TYPEC_PORTS] = {CY_USBPD_ADC_INPUT_AMUX_A};
 
+#if CY_APP_ADC_CAL_CACHE_ENABLE
+/* The VBUS poll ADC of the port holds a valid calibration. */
+static volatile bool glAppAdcCalValid[NO_OF_TYPEC_PORTS];
+
+/* Number of calibrations saved by reusing the cached calibration. */
+static uint32_t glAppAdcCalSaved[NO_OF_TYPEC_PORTS];
+
+static void app_adc_cal_age_cb(cy_timer_id_t id, void *callbackCtx);
+#endif /* CY_APP_ADC_CAL_CACHE_ENABLE */
+
+#if CY_APP_VBUS_DISCHARGE_CTRL_ENABLE
+/* VBUS level in mV below which the discharge is complete. */
+static uint16_t glAppDischgTarget[NO_OF_TYPEC_PORTS];
+
+/* VBUS measured at the previous poll; 0 before the first poll. */
+static uint16_t glAppDischgLastVbus[NO_OF_TYPEC_PORTS];
+
+/* Time in ms from the previous poll, or the start of the discharge, to the next poll. */
+static uint16_t glAppDischgPeriod[NO_OF_TYPEC_PORTS];
+
+/* Time in ms since the discharge was started. */
+static uint16_t glAppDischgElapsed[NO_OF_TYPEC_PORTS];
+
+/* Duration in ms of the last discharge. */
+static uint16_t glAppDischgTime[NO_OF_TYPEC_PORTS];
+#endif /* CY_APP_VBUS_DISCHARGE_CTRL_ENABLE */
+
 #if ((CY_PD_REV3_ENABLE) && (CY_APP_GET_REVISION_ENABLE))
 static bool glAppGetRevSendStatus[NO_OF_TYPEC_PORTS] = {
     false, 
@@ -167,8 +221,6 @@ volatile uint8_t glAppPrefDataRole[NO_OF_TYPEC_PORTS];
 volatile uint8_t glAppPrefPowerRole[NO_OF_TYPEC_PORTS];
 #endif /* (CY_APP_POWER_ROLE_PREFERENCE_ENABLE) */
 
-/* Forward declaration of function to trigger swap operations */
-static void app_initiate_swap (cy_timer_id_t id, void *context);
 #endif /* (CY_APP_ROLE_PREFERENCE_ENABLE) */
 
 #if (!CY_PD_SINK_ONLY)
@@ -277,12 +329,17 @@ void get_rev_cb(cy_stc_pdstack_context_t *ptrPdStackContext, cy_en_pdstack_resp_
             if (glAppGetRevSendStatus[ptrPdStackContext->port] == false)
             {
                 /* If the transmission was successful but response timed out, then attempt retrying the AMS. */
-                Cy_PdUtils_SwTimer_Start (ptrPdStackContext->ptrTimerContext, ptrPdStackContext,
-                    CY_APP_GET_TIMER_ID(ptrPdStackContext, CY_APP_PD_GET_REVISION_COMMAND_RETRY_TIMER), CY_APP_GET_REV_PD_CMD_RETRY_TIMER_PERIOD, send_get_revision);
+                Cy_App_Coro_Wake (ptrPdStackContext, CY_APP_CORO_GET_REVISION, CY_APP_GET_REV_PD_CMD_RETRY_TIMER_PERIOD);
             }
         }
     }
 
+    /* Let the Get_Revision sequence finish once the AMS is complete */
+    if (glAppGetRevSendStatus[ptrPdStackContext->port] == true)
+    {
+        Cy_App_Coro_Stop (ptrPdStackContext, CY_APP_CORO_GET_REVISION);
+    }
+
 #if (DFP_ALT_MODE_SUPP || UFP_ALT_MODE_SUPP)
     /* Enable VDM manager for DFP if the transmission of get revision message is completed */
     if(
@@ -297,20 +354,31 @@ void get_rev_cb(cy_stc_pdstack_context_t *ptrPdStackContext, cy_en_pdstack_resp_
 }
 
 
-void send_get_revision(cy_timer_id_t id, void *ptrContext)
+/* Sequence which sends the PD Get_Revision AMS until it completes or the retries are exhausted */
+static cy_en_app_coro_status_t send_get_revision(cy_stc_pdstack_context_t *ptrPdStackContext, cy_stc_app_coro_t *coro)
 {
-    cy_stc_pdstack_context_t *ptrPdStackContext = (cy_stc_pdstack_context_t *)ptrContext;
+    CY_APP_CORO_BEGIN(coro);
 
-    /* Nothing to do if we are not in PD contract */
-    if (!ptrPdStackContext->dpmConfig.contractExist)
+    while (glAppGetRevSendStatus[ptrPdStackContext->port] == false)
     {
-        return;
-    }
-    if(Cy_PdStack_Dpm_SendPdCommand(ptrPdStackContext, CY_PDSTACK_DPM_CMD_SEND_GET_REVISION, NULL, false, (cy_pdstack_dpm_pd_cmd_cbk_t)get_rev_cb) != CY_PDSTACK_STAT_SUCCESS)
-    {
-        Cy_PdUtils_SwTimer_Start (ptrPdStackContext->ptrTimerContext, ptrPdStackContext,
-                id, CY_APP_GET_REV_PD_CMD_RETRY_TIMER_PERIOD, send_get_revision);
+        /* Nothing to do if we are not in PD contract */
+        if (!ptrPdStackContext->dpmConfig.contractExist)
+        {
+            CY_APP_CORO_EXIT(coro);
+        }
+
+        if(Cy_PdStack_Dpm_SendPdCommand(ptrPdStackContext, CY_PDSTACK_DPM_CMD_SEND_GET_REVISION, NULL, false, (cy_pdstack_dpm_pd_cmd_cbk_t)get_rev_cb) == CY_PDSTACK_STAT_SUCCESS)
+        {
+            /* get_rev_cb resumes the sequence if the AMS has to be retried */
+            CY_APP_CORO_WAIT_EVENT(coro);
+        }
+        else
+        {
+            CY_APP_CORO_WAIT_MS(coro, CY_APP_GET_REV_PD_CMD_RETRY_TIMER_PERIOD);
+        }
     }
+
+    CY_APP_CORO_END(coro);
 }
 #endif /* ((CY_PD_REV3_ENABLE) && (CY_APP_GET_REVISION_ENABLE)) */
 
@@ -350,6 +418,8 @@ cy_en_pdstack_status_t Cy_App_Fault_DisablePort(cy_stc_pdstack_context_t *ptrPdS
 
 
 #if (!CCG_CBL_DISC_DISABLE)
+static cy_en_app_coro_status_t app_cbl_dsc_trigger(cy_stc_pdstack_context_t *ptrPdStackContext, cy_stc_app_coro_t *coro);
+
 void app_cbl_dsc_callback (cy_stc_pdstack_context_t *ptrPdStackContext, cy_en_pdstack_resp_status_t resp,
         const cy_stc_pdstack_pd_packet_t *pkt_ptr)
 {
@@ -358,21 +428,29 @@ void app_cbl_dsc_callback (cy_stc_pdstack_context_t *ptrPdStackContext, cy_en_pd
     /* Keep repeating the DPM command until we succeed */
     if (resp == CY_PDSTACK_SEQ_ABORTED)
     {
-        Cy_PdUtils_SwTimer_Start (ptrPdStackContext->ptrTimerContext, ptrPdStackContext,
-                CY_APP_GET_TIMER_ID(ptrPdStackContext, CY_APP_CBL_DISC_TRIGGER_TIMER), CY_APP_CBL_DISC_TIMER_PERIOD, Cy_App_CableDiscTimerCallback);
+        Cy_App_Coro_Start (ptrPdStackContext, CY_APP_CORO_CBL_DISC, app_cbl_dsc_trigger, CY_APP_CBL_DISC_TIMER_PERIOD);
     }
 }
 
+/* Sequence which asks the PD stack to initiate cable discovery until the command is accepted */
+static cy_en_app_coro_status_t app_cbl_dsc_trigger(cy_stc_pdstack_context_t *ptrPdStackContext, cy_stc_app_coro_t *coro)
+{
+    CY_APP_CORO_BEGIN(coro);
+
+    while (Cy_PdStack_Dpm_SendPdCommand(ptrPdStackContext, CY_PDSTACK_DPM_CMD_INITIATE_CBL_DISCOVERY, NULL, false, app_cbl_dsc_callback) != CY_PDSTACK_STAT_SUCCESS)
+    {
+        /* Send the DPM command again after a delay */
+        CY_APP_CORO_WAIT_MS(coro, CY_APP_CBL_DISC_TIMER_PERIOD);
+    }
+
+    CY_APP_CORO_END(coro);
+}
 
 void Cy_App_CableDiscTimerCallback (cy_timer_id_t id, void *callbackContext)
 {
     cy_stc_pdstack_context_t *pdstack_context = callbackContext;
 
-    if (Cy_PdStack_Dpm_SendPdCommand(pdstack_context, CY_PDSTACK_DPM_CMD_INITIATE_CBL_DISCOVERY, NULL, false, app_cbl_dsc_callback) != CY_PDSTACK_STAT_SUCCESS )
-    {
-        /* Start timer which will send initiate the DPM command after a delay */
-        app_cbl_dsc_callback(pdstack_context, CY_PDSTACK_SEQ_ABORTED, 0);
-    }
+    Cy_App_Coro_Start (pdstack_context, CY_APP_CORO_CBL_DISC, app_cbl_dsc_trigger, 0u);
 
     (void) id;
 }
@@ -413,11 +491,7 @@ bool Cy_App_VdmLayerReset(cy_stc_pdstack_context_t *ptrPdStackContext)
         ptrAltModeContext->altModeAppStatus->discCblPending = true;
 
         /* Ask PD stack to trigger cable discovery */
-        if (Cy_PdStack_Dpm_SendPdCommand(ptrPdStackContext, CY_PDSTACK_DPM_CMD_INITIATE_CBL_DISCOVERY, NULL, false, app_cbl_dsc_callback) !=  CY_PDSTACK_STAT_SUCCESS)
-        {
-            Cy_PdUtils_SwTimer_Start (ptrPdStackContext->ptrTimerContext, ptrPdStackContext ,
-                    CY_APP_GET_TIMER_ID(ptrPdStackContext, CY_APP_CBL_DISC_TRIGGER_TIMER), CY_APP_CBL_DISC_TIMER_PERIOD, Cy_App_CableDiscTimerCallback);
-        }
+        Cy_App_Coro_Start (ptrPdStackContext, CY_APP_CORO_CBL_DISC, app_cbl_dsc_trigger, 0u);
 #endif /* (!CCG_CBL_DISC_DISABLE) */
     }
     else
@@ -553,8 +627,37 @@ static void app_psrc_invalid_vbus_dischg_disable(cy_stc_pdstack_context_t *ptrPd
         glAppInvalidVbusDisOn[ptrPdStackContext->port] = false;
         Cy_App_VbusDischargeOff(ptrPdStackContext);
         Cy_PdUtils_SwTimer_Stop(ptrPdStackContext->ptrTimerContext, CY_APP_GET_TIMER_ID(ptrPdStackContext, CY_APP_PSOURCE_DIS_TIMER));
+#if CY_APP_VBUS_DISCHARGE_CTRL_ENABLE
+        Cy_PdUtils_SwTimer_Stop(ptrPdStackContext->ptrTimerContext, CY_APP_GET_TIMER_ID(ptrPdStackContext, CY_APP_PSOURCE_DIS_MONITOR_TIMER));
+#endif /* CY_APP_VBUS_DISCHARGE_CTRL_ENABLE */
+    }
+}
+
+#if CY_APP_VBUS_DISCHARGE_CTRL_ENABLE
+/*
+ * Monitor callback of the invalid VBUS discharge. The discharge is stopped
+ * once VBUS is below vSafe0V; CY_APP_PSOURCE_DIS_TIMER remains the upper bound.
+ */
+static void app_psrc_invalid_vbus_monitor_cbk(cy_timer_id_t id,  void * callbackCtx)
+{
+    cy_stc_pdstack_context_t *ptrPdStackContext = callbackCtx;
+    uint16_t period;
+
+    (void)id;
+
+    period = Cy_App_VbusDischargeCtrl_Poll(ptrPdStackContext, NULL);
+    if (period == 0u)
+    {
+        app_psrc_invalid_vbus_dischg_disable(ptrPdStackContext);
+    }
+    else
+    {
+        Cy_PdUtils_SwTimer_Start(ptrPdStackContext->ptrTimerContext, ptrPdStackContext,
+                CY_APP_GET_TIMER_ID(ptrPdStackContext, CY_APP_PSOURCE_DIS_MONITOR_TIMER),
+                period, app_psrc_invalid_vbus_monitor_cbk);
     }
 }
+#endif /* CY_APP_VBUS_DISCHARGE_CTRL_ENABLE */
 
 /*
  * Timer callback function in case of timeout from VBUS discharge when trying to remove
@@ -573,6 +676,18 @@ uint8_t Cy_App_Task(cy_stc_pdstack_context_t *ptrPdStackContext)
 {
     Cy_App_Fault_Task (ptrPdStackContext);
 
+#if CY_APP_PARTNER_CACHE_ENABLE
+    Cy_App_Partner_Task (ptrPdStackContext);
+#endif /* CY_APP_PARTNER_CACHE_ENABLE */
+
+#if CY_APP_POWER_BUDGET_ENABLE
+    Cy_App_PowerBudget_Task (ptrPdStackContext);
+#endif /* CY_APP_POWER_BUDGET_ENABLE */
+
+#if CY_APP_THERMAL_DERATE_ENABLE
+    Cy_App_Thermal_Task (ptrPdStackContext);
+#endif /* CY_APP_THERMAL_DERATE_ENABLE */
+
 #if BATTERY_CHARGING_ENABLE
     Cy_App_Bc_Task (ptrPdStackContext->ptrUsbPdContext);
 #if CCG_TYPE_A_PORT_ENABLE
@@ -644,6 +759,9 @@ bool Cy_App_Sleep(void)
 {
     bool stat = true;
     uint8_t port;
+#if CY_APP_FAULT_HANDLER_ENABLE
+    cy_stc_pdstack_context_t *fault_ctx;
+#endif /* CY_APP_FAULT_HANDLER_ENABLE */
 
 #if (((DFP_ALT_MODE_SUPP) || (UFP_ALT_MODE_SUPP)) || ((DP_UFP_SUPP) && (PMG1_HPD_RX_ENABLE)))
     cy_stc_pdstack_context_t *ptrPdStackContext = NULL;
@@ -677,12 +795,20 @@ bool Cy_App_Sleep(void)
             stat = false;
             break;
         }
-        /* Do not go to Sleep while the CC/SBU fault handling is pending */
-        if ((Cy_App_GetPdAppStatus(port)->faultStatus & CY_APP_PORT_SINK_FAULT_ACTIVE) != 0)
+#if CY_APP_FAULT_HANDLER_ENABLE
+        /*
+         * Do not go to Sleep while a fault which exceeded its limit still has to take a
+         * sink or detached port down. The exceeded bits are cleared once the port disable
+         * completes; a source port only waits for detach and may sleep.
+         */
+        fault_ctx = Cy_PdStack_Dpm_GetContext(port);
+        if (((Cy_App_Fault_GetStatus(fault_ctx) & CY_APP_FAULT_STATUS_EXCEEDED_MASK) != 0u) &&
+                ((fault_ctx->dpmConfig.attach == false) || (fault_ctx->dpmConfig.curPortRole == CY_PD_PRT_ROLE_SINK)))
         {
             stat = false;
             break;
         }
+#endif /* CY_APP_FAULT_HANDLER_ENABLE */
 
 #if ((DFP_ALT_MODE_SUPP) || (UFP_ALT_MODE_SUPP))
         if (Cy_PdAltMode_VdmTask_IsIdle(ptrPdStackContext->ptrAltModeContext) == false)
@@ -705,6 +831,28 @@ bool Cy_App_Sleep(void)
 
     }
 
+#if CY_APP_TELEMETRY_ENABLE
+    if (stat)
+    {
+        /* Sampling would wake the device up every period */
+        Cy_App_Telemetry_Sleep();
+    }
+#endif /* CY_APP_TELEMETRY_ENABLE */
+
+#if CY_APP_ADC_CAL_CACHE_ENABLE
+    if (stat)
+    {
+        /* The calibration age does not need to wake the device up */
+        for (port = 0; port < NO_OF_TYPEC_PORTS; port++)
+        {
+            cy_stc_pdstack_context_t *ptrAdcCalContext = Cy_PdStack_Dpm_GetContext(port);
+
+            Cy_PdUtils_SwTimer_Stop(ptrAdcCalContext->ptrTimerContext,
+                    CY_APP_GET_TIMER_ID(ptrAdcCalContext, CY_APP_ADC_CAL_AGE_TIMER));
+        }
+    }
+#endif /* CY_APP_ADC_CAL_CACHE_ENABLE */
+
 #if ((DFP_ALT_MODE_SUPP) || (UFP_ALT_MODE_SUPP))
     if (stat)
     {
@@ -726,6 +874,29 @@ bool Cy_App_Sleep(void)
 
 void Cy_App_Resume(void)
 {
+#if CY_APP_ADC_CAL_CACHE_ENABLE
+    uint8_t cal_port;
+    cy_stc_pdstack_context_t *ptrAdcCalContext;
+#endif /* CY_APP_ADC_CAL_CACHE_ENABLE */
+
+#if CY_APP_TELEMETRY_ENABLE
+    Cy_App_Telemetry_Resume();
+#endif /* CY_APP_TELEMETRY_ENABLE */
+
+#if CY_APP_ADC_CAL_CACHE_ENABLE
+    /* A calibration which survived the deep sleep ages again from now on */
+    for (cal_port = 0; cal_port < NO_OF_TYPEC_PORTS; cal_port++)
+    {
+        if (glAppAdcCalValid[cal_port])
+        {
+            ptrAdcCalContext = Cy_PdStack_Dpm_GetContext(cal_port);
+            Cy_PdUtils_SwTimer_Start(ptrAdcCalContext->ptrTimerContext, ptrAdcCalContext,
+                    CY_APP_GET_TIMER_ID(ptrAdcCalContext, CY_APP_ADC_CAL_AGE_TIMER),
+                    CY_APP_ADC_CAL_MAX_AGE, app_adc_cal_age_cb);
+        }
+    }
+#endif /* CY_APP_ADC_CAL_CACHE_ENABLE */
+
 #if    (DFP_ALT_MODE_SUPP) || (UFP_ALT_MODE_SUPP)
 #if CY_APP_USB_ENABLE
     Cy_App_Usb_Resume();
@@ -967,6 +1138,33 @@ bool app_extd_msg_handler(cy_stc_pdstack_context_t *ptrPdStackContext, cy_stc_pd
 #endif /* CY_PD_REV3_ENABLE */
 
 #if (CY_APP_ROLE_PREFERENCE_ENABLE)
+#if CY_APP_PARTNER_CACHE_ENABLE
+/* Partner cache flag which records the outcome of a swap type */
+static uint8_t app_swap_partner_flag (uint8_t swap_type)
+{
+    uint8_t flag = 0u;
+
+    if (swap_type == (uint8_t)CY_PDSTACK_DPM_CMD_SEND_DR_SWAP)
+    {
+        flag = CY_APP_PARTNER_FLAG_DR_SWAP_REJECT;
+    }
+    else if (swap_type == (uint8_t)CY_PDSTACK_DPM_CMD_SEND_PR_SWAP)
+    {
+        flag = CY_APP_PARTNER_FLAG_PR_SWAP_REJECT;
+    }
+    else if (swap_type == (uint8_t)CY_PDSTACK_DPM_CMD_SEND_VCONN_SWAP)
+    {
+        flag = CY_APP_PARTNER_FLAG_VCONN_SWAP_REJECT;
+    }
+    else
+    {
+        /* No flag for other swap types */
+    }
+
+    return flag;
+}
+#endif /* CY_APP_PARTNER_CACHE_ENABLE */
+
 static void app_role_swap_resp_cb (cy_stc_pdstack_context_t *ptrPdStackContext, 
         cy_en_pdstack_resp_status_t resp,
         const cy_stc_pdstack_pd_packet_t *pkt_ptr)
@@ -985,8 +1183,7 @@ static void app_role_swap_resp_cb (cy_stc_pdstack_context_t *ptrPdStackContext,
             app_stat->actv_swap_count++;
             if (app_stat->actv_swap_count < CY_APP_MAX_SWAP_ATTEMPT_COUNT)
             {
-                Cy_PdUtils_SwTimer_Start(ptrPdStackContext->ptrTimerContext, ptrPdStackContext,
-                        CY_APP_GET_TIMER_ID(ptrPdStackContext, CY_APP_INITIATE_SWAP_TIMER), CY_APP_SWAP_WAIT_TIMER_PERIOD, app_initiate_swap);
+                Cy_App_Coro_Wake(ptrPdStackContext, CY_APP_CORO_ROLE_SWAP, CY_APP_SWAP_WAIT_TIMER_PERIOD);
             }
             else
             {
@@ -996,24 +1193,42 @@ static void app_role_swap_resp_cb (cy_stc_pdstack_context_t *ptrPdStackContext,
 #else
                 app_stat->app_pending_swaps = 0u;
                 app_stat->actv_swap_type  = 0u;
+                Cy_App_Coro_Stop(ptrPdStackContext, CY_APP_CORO_ROLE_SWAP);
 #endif /* (CY_APP_POWER_ROLE_PREFERENCE_ENABLE) */
             }
         }
         else
         {
+#if CY_APP_PARTNER_CACHE_ENABLE
+            /* Remember whether the partner accepts this swap, so that rejected swaps are not retried on reconnect */
+            if (pkt_ptr->hdr.hdr.msgType == CY_PD_CTRL_MSG_ACCEPT)
+            {
+                Cy_App_Partner_UpdateFlags(ptrPdStackContext, app_swap_partner_flag(app_stat->actv_swap_type), false);
+            }
+            else if ((pkt_ptr->hdr.hdr.msgType == CY_PD_CTRL_MSG_REJECT) ||
+                    (pkt_ptr->hdr.hdr.msgType == CY_PD_CTRL_MSG_NOT_SUPPORTED))
+            {
+                Cy_App_Partner_UpdateFlags(ptrPdStackContext, app_swap_partner_flag(app_stat->actv_swap_type), true);
+            }
+            else
+            {
+                /* Outcome is not known */
+            }
+#endif /* CY_APP_PARTNER_CACHE_ENABLE */
+
 #if (CY_APP_POWER_ROLE_PREFERENCE_ENABLE)
             /* Swap succeeded or failed. Proceed with next swap. */
             next_swap = true;
 #else
             app_stat->app_pending_swaps = 0u;
             app_stat->actv_swap_type  = 0u;
+            Cy_App_Coro_Stop(ptrPdStackContext, CY_APP_CORO_ROLE_SWAP);
 #endif /* (CY_APP_POWER_ROLE_PREFERENCE_ENABLE) */
         }
     }
     else if ((resp == CY_PDSTACK_CMD_FAILED) || (resp == CY_PDSTACK_SEQ_ABORTED) || (resp == CY_PDSTACK_RES_TIMEOUT))
     {
-        Cy_PdUtils_SwTimer_Start(ptrPdStackContext->ptrTimerContext, ptrPdStackContext,
-                CY_APP_GET_TIMER_ID(ptrPdStackContext, CY_APP_INITIATE_SWAP_TIMER), app_stat->actv_swap_delay, app_initiate_swap);
+        Cy_App_Coro_Wake(ptrPdStackContext, CY_APP_CORO_ROLE_SWAP, app_stat->actv_swap_delay);
     }
 
 #if (CY_APP_POWER_ROLE_PREFERENCE_ENABLE)
@@ -1024,16 +1239,14 @@ static void app_role_swap_resp_cb (cy_stc_pdstack_context_t *ptrPdStackContext,
 
         app_stat->actv_swap_type  = 0u;
         app_stat->actv_swap_count = 0u;
-        Cy_PdUtils_SwTimer_Start(ptrPdStackContext->ptrTimerContext, ptrPdStackContext,
-                CY_APP_GET_TIMER_ID(ptrPdStackContext, CY_APP_INITIATE_SWAP_TIMER),
-                CY_APP_INITIATE_DR_SWAP_TIMER_PERIOD, app_initiate_swap);
+        Cy_App_Coro_Wake(ptrPdStackContext, CY_APP_CORO_ROLE_SWAP, CY_APP_INITIATE_DR_SWAP_TIMER_PERIOD);
     }
 #endif /* (CY_APP_POWER_ROLE_PREFERENCE_ENABLE) */
 }
 
-static void app_initiate_swap (cy_timer_id_t id, void *context)
+/* Pick the swap operation to be performed next and check whether it is still required */
+static uint8_t app_select_swap (cy_stc_pdstack_context_t *ptrPdStackContext)
 {
-    cy_stc_pdstack_context_t *ptrPdStackContext = (cy_stc_pdstack_context_t *)context;
     uint8_t port = ptrPdStackContext->port;
 #if (DFP_ALT_MODE_SUPP || UFP_ALT_MODE_SUPP)
     cy_stc_pdaltmode_context_t *ptrAltModeContext = ptrPdStackContext->ptrAltModeContext;
@@ -1041,32 +1254,9 @@ static void app_initiate_swap (cy_timer_id_t id, void *context)
 
     cy_stc_app_status_t *app_stat_p = Cy_App_GetStatus(port);
 
-    cy_stc_pdstack_dpm_pd_cmd_buf_t pd_cmd_buf;
-
     uint8_t actv_swap     = app_stat_p->actv_swap_type;
     uint8_t swaps_pending = app_stat_p->app_pending_swaps;
 
-    (void)id;
-
-    /* Stop the timer that triggers swap operation */
-    Cy_PdUtils_SwTimer_Stop(ptrPdStackContext->ptrTimerContext, CY_APP_GET_TIMER_ID(ptrPdStackContext, CY_APP_INITIATE_SWAP_TIMER));
-
-    /* Nothing to do if we are not in PD contract */
-    if (!ptrPdStackContext->dpmConfig.contractExist)
-        return;
-
-#if ((CY_PD_REV3_ENABLE) && (CY_APP_GET_REVISION_ENABLE))
-    /* Defer swap initiation if get revision handling is not completed. */
-    if((glAppGetRevSendStatus[ptrPdStackContext->port] != true) && ((ptrPdStackContext->dpmConfig.specRevSopLive >= CY_PD_REV3)))
-    {
-        Cy_PdUtils_SwTimer_Start(ptrPdStackContext->ptrTimerContext, ptrPdStackContext,
-                CY_APP_GET_TIMER_ID(ptrPdStackContext, CY_APP_INITIATE_SWAP_TIMER),
-                CY_APP_GET_REV_PD_CMD_RETRY_TIMER_PERIOD, app_initiate_swap);
-
-        return;
-    }
-#endif /* ((CY_PD_REV3_ENABLE) && (CY_APP_GET_REVISION_ENABLE)) */
-
     if (actv_swap == 0)
     {
 #if (CY_APP_POWER_ROLE_PREFERENCE_ENABLE)
@@ -1099,87 +1289,124 @@ static void app_initiate_swap (cy_timer_id_t id, void *context)
         app_stat_p->actv_swap_count = 0u;
     }
 
-    if (actv_swap != 0u)
+    /* Check whether the selected swap is still valid */
+    switch (actv_swap)
     {
-        /* Check whether the selected swap is still valid */
-        switch (actv_swap)
-        {
+        case 0u:
+            break;
+
 #if (CY_APP_POWER_ROLE_PREFERENCE_ENABLE)
-            case CY_PDSTACK_DPM_CMD_SEND_VCONN_SWAP:
-                if (ptrPdStackContext->dpmConfig.vconnLogical)
-                {
-                    app_stat_p->app_pending_swaps &= ~CY_APP_VCONN_SWAP_PENDING;
-                    actv_swap = 0u;
-                }
-                break;
+        case CY_PDSTACK_DPM_CMD_SEND_VCONN_SWAP:
+            if (ptrPdStackContext->dpmConfig.vconnLogical)
+            {
+                app_stat_p->app_pending_swaps &= ~CY_APP_VCONN_SWAP_PENDING;
+                actv_swap = 0u;
+            }
+            break;
 #endif /* (CY_APP_POWER_ROLE_PREFERENCE_ENABLE) */
 
-            case CY_PDSTACK_DPM_CMD_SEND_DR_SWAP:
-                /* Stop sending DR_SWAP if any alternate mode has been entered */
-                if
+        case CY_PDSTACK_DPM_CMD_SEND_DR_SWAP:
+            /* Stop sending DR_SWAP if any alternate mode has been entered */
+            if
 #if (DFP_ALT_MODE_SUPP || UFP_ALT_MODE_SUPP)
-                (
+            (
 #endif /* (DFP_ALT_MODE_SUPP || UFP_ALT_MODE_SUPP) */
-                        (ptrPdStackContext->dpmConfig.curPortType == glAppPrefDataRole[port]) 
+                    (ptrPdStackContext->dpmConfig.curPortType == glAppPrefDataRole[port]) 
 #if (DFP_ALT_MODE_SUPP || UFP_ALT_MODE_SUPP)
-                        ||
-                        (ptrAltModeContext->altModeAppStatus->altModeEntered != 0u)
-                )
+                    ||
+                    (ptrAltModeContext->altModeAppStatus->altModeEntered != 0u)
+            )
 #endif /* (DFP_ALT_MODE_SUPP || UFP_ALT_MODE_SUPP) */
-                {
-                    app_stat_p->app_pending_swaps &= ~CY_APP_DR_SWAP_PENDING;
-                    actv_swap = 0u;
-                }
-                break;
+            {
+                app_stat_p->app_pending_swaps &= ~CY_APP_DR_SWAP_PENDING;
+                actv_swap = 0u;
+            }
+            break;
 
 #if (CY_APP_POWER_ROLE_PREFERENCE_ENABLE)
-            case CY_PDSTACK_DPM_CMD_SEND_PR_SWAP:
-                if (ptrPdStackContext->dpmConfig.curPortRole == glAppPrefPowerRole[port])
-                {
-                    app_stat_p->app_pending_swaps &= ~CY_APP_PR_SWAP_PENDING;
-                    actv_swap = 0u;
-                }
-                break;
+        case CY_PDSTACK_DPM_CMD_SEND_PR_SWAP:
+            if (ptrPdStackContext->dpmConfig.curPortRole == glAppPrefPowerRole[port])
+            {
+                app_stat_p->app_pending_swaps &= ~CY_APP_PR_SWAP_PENDING;
+                actv_swap = 0u;
+            }
+            break;
 #endif /* (CY_APP_POWER_ROLE_PREFERENCE_ENABLE) */
 
-            default:
-                actv_swap = 0u;
-                break;
+        default:
+            actv_swap = 0u;
+            break;
+    }
+
+    return actv_swap;
+}
+
+/* Sequence which performs the pending role swaps one after the other */
+static cy_en_app_coro_status_t app_initiate_swap (cy_stc_pdstack_context_t *ptrPdStackContext, cy_stc_app_coro_t *coro)
+{
+    cy_stc_app_status_t *app_stat_p = Cy_App_GetStatus(ptrPdStackContext->port);
+    cy_stc_pdstack_dpm_pd_cmd_buf_t pd_cmd_buf;
+    uint8_t actv_swap;
+
+    CY_APP_CORO_BEGIN(coro);
+
+    for (;;)
+    {
+        /* Nothing to do if we are not in PD contract */
+        if (!ptrPdStackContext->dpmConfig.contractExist)
+        {
+            CY_APP_CORO_EXIT(coro);
+        }
+
+#if ((CY_PD_REV3_ENABLE) && (CY_APP_GET_REVISION_ENABLE))
+        /* Defer swap initiation if get revision handling is not completed. */
+        if((glAppGetRevSendStatus[ptrPdStackContext->port] != true) && ((ptrPdStackContext->dpmConfig.specRevSopLive >= CY_PD_REV3)))
+        {
+            CY_APP_CORO_WAIT_MS(coro, CY_APP_GET_REV_PD_CMD_RETRY_TIMER_PERIOD);
+            continue;
         }
+#endif /* ((CY_PD_REV3_ENABLE) && (CY_APP_GET_REVISION_ENABLE)) */
 
+        actv_swap = app_select_swap(ptrPdStackContext);
         if (actv_swap == 0u)
         {
-            /*
-             * Currently selected SWAP is no longer relevant. Re-run function to identify the next swap to be
-             * performed.
-             */
-            if (app_stat_p->app_pending_swaps != 0u)
+            app_stat_p->actv_swap_type = 0u;
+
+            /* No swap left to be performed */
+            if (app_stat_p->app_pending_swaps == 0u)
             {
-                app_stat_p->actv_swap_type = 0u;
-                Cy_PdUtils_SwTimer_Start(ptrPdStackContext->ptrTimerContext, ptrPdStackContext,
-                        CY_APP_GET_TIMER_ID(ptrPdStackContext, CY_APP_INITIATE_SWAP_TIMER),
-                        CY_APP_INITIATE_DR_SWAP_TIMER_PERIOD, app_initiate_swap);
+                CY_APP_CORO_EXIT(coro);
             }
+
+            /*
+             * Currently selected SWAP is no longer relevant. Identify the next swap to be
+             * performed after a delay.
+             */
+            CY_APP_CORO_WAIT_MS(coro, CY_APP_INITIATE_DR_SWAP_TIMER_PERIOD);
+            continue;
         }
-        else
-        {
-            /* Store the swap command for use in the callback */
-            app_stat_p->actv_swap_type = actv_swap;
 
-            /* Only packet type needs to be set when initiating swap operations */
-            pd_cmd_buf.cmdSop = CY_PD_SOP;
+        /* Store the swap command for use in the callback */
+        app_stat_p->actv_swap_type = actv_swap;
 
-            /* Try to trigger the selected swap operation */
-            if (Cy_PdStack_Dpm_SendPdCommand(ptrPdStackContext, (cy_en_pdstack_dpm_pd_cmd_t)actv_swap, &pd_cmd_buf,
-                        false, app_role_swap_resp_cb) != CY_PDSTACK_STAT_SUCCESS)
-            {
-                /* Retries in case of AMS failure can always be done with a small delay */
-                Cy_PdUtils_SwTimer_Start(ptrPdStackContext->ptrTimerContext, ptrPdStackContext,
-                        CY_APP_GET_TIMER_ID(ptrPdStackContext, CY_APP_INITIATE_SWAP_TIMER),
-                        CY_APP_INITIATE_DR_SWAP_TIMER_PERIOD, app_initiate_swap);
-            }
+        /* Only packet type needs to be set when initiating swap operations */
+        pd_cmd_buf.cmdSop = CY_PD_SOP;
+
+        /* Try to trigger the selected swap operation */
+        if (Cy_PdStack_Dpm_SendPdCommand(ptrPdStackContext, (cy_en_pdstack_dpm_pd_cmd_t)actv_swap, &pd_cmd_buf,
+                    false, app_role_swap_resp_cb) == CY_PDSTACK_STAT_SUCCESS)
+        {
+            /* app_role_swap_resp_cb resumes the sequence once the swap AMS is complete */
+            CY_APP_CORO_WAIT_EVENT(coro);
+        }
+        else
+        {
+            /* Retries in case of AMS failure can always be done with a small delay */
+            CY_APP_CORO_WAIT_MS(coro, CY_APP_INITIATE_DR_SWAP_TIMER_PERIOD);
         }
     }
+
+    CY_APP_CORO_END(coro);
 }
 
 /* This function is called at the end of a PD contract to check whether any role swaps need to be triggered */
@@ -1226,15 +1453,34 @@ void Cy_App_ContractHandler (cy_stc_pdstack_context_t *ptrPdStackContext)
         delay_reqd = CY_APP_INITIATE_DR_SWAP_TIMER_PERIOD;
     }
 
-    /* Start a timer that will kick off the swap state machine. */
-    Cy_PdUtils_SwTimer_Start(ptrPdStackContext->ptrTimerContext, ptrPdStackContext,
-            CY_APP_GET_TIMER_ID(ptrPdStackContext, CY_APP_INITIATE_SWAP_TIMER), delay_reqd, app_initiate_swap);
+#if CY_APP_PARTNER_CACHE_ENABLE
+    /* Do not retry swaps which the partner has rejected on an earlier connection. */
+    {
+        uint8_t partner_flags = Cy_App_Partner_GetFlags(ptrPdStackContext);
+
+        if ((partner_flags & CY_APP_PARTNER_FLAG_PR_SWAP_REJECT) != 0u)
+        {
+            app_stat->app_pending_swaps &= ~CY_APP_PR_SWAP_PENDING;
+        }
+        if ((partner_flags & CY_APP_PARTNER_FLAG_DR_SWAP_REJECT) != 0u)
+        {
+            app_stat->app_pending_swaps &= ~CY_APP_DR_SWAP_PENDING;
+        }
+        if ((partner_flags & CY_APP_PARTNER_FLAG_VCONN_SWAP_REJECT) != 0u)
+        {
+            app_stat->app_pending_swaps &= ~CY_APP_VCONN_SWAP_PENDING;
+        }
+    }
+#endif /* CY_APP_PARTNER_CACHE_ENABLE */
+
+    /* Kick off the swap state machine after the required delay. */
+    Cy_App_Coro_Start(ptrPdStackContext, CY_APP_CORO_ROLE_SWAP, app_initiate_swap, delay_reqd);
 }
 
 void Cy_App_ConnectChangeHandler (cy_stc_pdstack_context_t *ptrPdStackContext)
 {
-    /* Stop all timers used to trigger swap operations. */
-    Cy_PdUtils_SwTimer_Stop(ptrPdStackContext->ptrTimerContext, CY_APP_GET_TIMER_ID(ptrPdStackContext, CY_APP_INITIATE_SWAP_TIMER));
+    /* Stop the sequence used to trigger swap operations. */
+    Cy_App_Coro_Stop(ptrPdStackContext, CY_APP_CORO_ROLE_SWAP);
     uint8_t port = ptrPdStackContext->port;
 
 #if (CY_APP_POWER_ROLE_PREFERENCE_ENABLE)
@@ -1252,26 +1498,100 @@ void Cy_App_ConnectChangeHandler (cy_stc_pdstack_context_t *ptrPdStackContext)
 #endif /* (CY_APP_ROLE_PREFERENCE_ENABLE) */
 
 #if (CY_PD_EPR_ENABLE && (!CY_PD_SOURCE_ONLY))
-void epr_enter_mode_timer_cb (
-        cy_timer_id_t id,
-        void *ptrContext)
+/* Sequence which requests EPR mode entry as a sink until the request is accepted by the stack */
+static cy_en_app_coro_status_t epr_enter_mode_seq (
+        cy_stc_pdstack_context_t *ptrPdStackContext,
+        cy_stc_app_coro_t *coro)
 {
-    (void)id;
-    cy_stc_pdstack_context_t *ptrPdStackContext = (cy_stc_pdstack_context_t *)ptrContext;
+    CY_APP_CORO_BEGIN(coro);
 
-    /* Check if the conditions for EPR entry are still valid. */
-    if (ptrPdStackContext->dpmConfig.curPortRole == CY_PD_PRT_ROLE_SINK)
+    do
     {
-        if (Cy_PdStack_Dpm_SendPdCommand (ptrPdStackContext, CY_PDSTACK_DPM_CMD_SNK_EPR_MODE_ENTRY, NULL, false, NULL) != CY_PDSTACK_STAT_SUCCESS)
+        CY_APP_CORO_WAIT_MS(coro, CY_APP_EPR_SNK_ENTRY_TIMER_PERIOD);
+
+        /* Check if the conditions for EPR entry are still valid. */
+        if (ptrPdStackContext->dpmConfig.curPortRole != CY_PD_PRT_ROLE_SINK)
         {
-            /* Retry the EPR Entry. */
-            Cy_PdUtils_SwTimer_Start(ptrPdStackContext->ptrTimerContext, ptrPdStackContext,
-                    CY_APP_GET_TIMER_ID(ptrPdStackContext, CY_APP_EPR_MODE_TIMER), CY_APP_EPR_SNK_ENTRY_TIMER_PERIOD, epr_enter_mode_timer_cb);
+            CY_APP_CORO_EXIT(coro);
         }
-    }
+    } while (Cy_PdStack_Dpm_SendPdCommand (ptrPdStackContext, CY_PDSTACK_DPM_CMD_SNK_EPR_MODE_ENTRY, NULL, false, NULL) != CY_PDSTACK_STAT_SUCCESS);
+
+    CY_APP_CORO_END(coro);
 }
 #endif /* CY_PD_EPR_ENABLE && (!CY_PD_SOURCE_ONLY) */
 
+#if (CY_APP_PPS_SNK_ENABLE && (!CY_PD_SOURCE_ONLY))
+/* Check whether the port is a sink with an explicit contract on a PPS APDO */
+static bool app_pps_snk_contract_active (cy_stc_pdstack_context_t *ptrPdStackContext)
+{
+    const cy_pd_pd_do_t *sel_pdo = &ptrPdStackContext->dpmStat.snkSelPdo;
+
+    return ((ptrPdStackContext->dpmConfig.contractExist) &&
+            (ptrPdStackContext->dpmConfig.curPortRole == CY_PD_PRT_ROLE_SINK) &&
+            (sel_pdo->fixed_src.supplyType == CY_PDSTACK_PDO_AUGMENTED) &&
+            (sel_pdo->pps_src.apdoType == CY_PDSTACK_APDO_PPS));
+}
+
+/* Response callback for the periodic PPS request */
+static void app_pps_snk_req_cb (cy_stc_pdstack_context_t *ptrPdStackContext,
+        cy_en_pdstack_resp_status_t resp,
+        const cy_stc_pdstack_pd_packet_t *pkt_ptr)
+{
+    if ((resp == CY_PDSTACK_CMD_FAILED) || (resp == CY_PDSTACK_SEQ_ABORTED) || (resp == CY_PDSTACK_RES_TIMEOUT))
+    {
+        /* Request could not be sent. Try again shortly. */
+        Cy_App_Coro_Wake(ptrPdStackContext, CY_APP_CORO_PPS_SNK, APP_PPS_SNK_CONTRACT_RETRY_PERIOD);
+    }
+    else if ((resp == CY_PDSTACK_RES_RCVD) && (pkt_ptr->hdr.hdr.msgType != CY_PD_CTRL_MSG_ACCEPT))
+    {
+        /* Request was rejected and the previous contract remains in place. */
+        Cy_App_Coro_Wake(ptrPdStackContext, CY_APP_CORO_PPS_SNK, APP_PPS_SNK_CONTRACT_PERIOD);
+    }
+    else
+    {
+        /* The sequence is restarted once the new contract is complete. */
+    }
+}
+
+/*
+ * Sequence which repeats the request for the PPS APDO, so that the source does not
+ * drop the contract due to PPS timeout. The sequence is restarted on each contract.
+ */
+static cy_en_app_coro_status_t app_pps_snk_keep_alive (
+        cy_stc_pdstack_context_t *ptrPdStackContext,
+        cy_stc_app_coro_t *coro)
+{
+    cy_stc_pdstack_dpm_pd_cmd_buf_t pd_cmd_buf;
+
+    CY_APP_CORO_BEGIN(coro);
+
+    for (;;)
+    {
+        if (!app_pps_snk_contract_active(ptrPdStackContext))
+        {
+            CY_APP_CORO_EXIT(coro);
+        }
+
+        pd_cmd_buf.cmdSop = CY_PD_SOP;
+        pd_cmd_buf.noOfCmdDo = 1u;
+        pd_cmd_buf.cmdDo[0] = ptrPdStackContext->dpmStat.snkRdo;
+
+        if (Cy_PdStack_Dpm_SendPdCommand(ptrPdStackContext, CY_PDSTACK_DPM_CMD_SEND_REQUEST, &pd_cmd_buf,
+                    false, app_pps_snk_req_cb) == CY_PDSTACK_STAT_SUCCESS)
+        {
+            /* app_pps_snk_req_cb resumes the sequence if the contract is not renewed */
+            CY_APP_CORO_WAIT_EVENT(coro);
+        }
+        else
+        {
+            CY_APP_CORO_WAIT_MS(coro, APP_PPS_SNK_CONTRACT_RETRY_PERIOD);
+        }
+    }
+
+    CY_APP_CORO_END(coro);
+}
+#endif /* (CY_APP_PPS_SNK_ENABLE && (!CY_PD_SOURCE_ONLY)) */
+
 #if ((!CY_PD_SINK_ONLY) && (!CY_PD_DEBUG_ACC_DISABLE))
 /* Dummy callback used to ensure VBus discharge happens after debug accessory sink is disconnected */
 static void debug_acc_src_disable_cbk(cy_stc_pdstack_context_t *ptrPdStackContext)
@@ -1279,14 +1599,14 @@ static void debug_acc_src_disable_cbk(cy_stc_pdstack_context_t *ptrPdStackContex
     (void)ptrPdStackContext;
 }
 
-static void debug_acc_src_psrc_enable(cy_timer_id_t id, void * context)
+/* Sequence which applies VBus to a debug accessory sink once the MUX delay has elapsed */
+static cy_en_app_coro_status_t debug_acc_src_psrc_enable(cy_stc_pdstack_context_t *ptrPdStackContext, cy_stc_app_coro_t *coro)
 {
-    (void)id;
-
-    cy_stc_pdstack_context_t *ptrPdStackContext =
-        (cy_stc_pdstack_context_t*) context;
+    CY_APP_CORO_BEGIN(coro);
 
     ptrPdStackContext->ptrAppCbk->psrc_enable(ptrPdStackContext, NULL);
+
+    CY_APP_CORO_END(coro);
 }
 #endif /* ((!CY_PD_SINK_ONLY) && (!CY_PD_DEBUG_ACC_DISABLE)) */
 
@@ -1360,6 +1680,23 @@ void Cy_App_EventHandler(cy_stc_pdstack_context_t *ptrPdStackContext,
 #endif /* (CY_APP_HOST_ALERT_MSG_DISABLE != 1) */
 #endif /* CY_PD_REV3_ENABLE */
 
+#if CY_APP_POWER_BUDGET_ENABLE
+    Cy_App_PowerBudget_EventHandler(ptrPdStackContext, evt);
+#endif /* CY_APP_POWER_BUDGET_ENABLE */
+
+#if CY_APP_SINK_ENERGY_ENABLE
+    /* Reads the telemetry energy of the previous contract before it restarts */
+    Cy_App_SinkEnergy_EventHandler(ptrPdStackContext, evt);
+#endif /* CY_APP_SINK_ENERGY_ENABLE */
+
+#if CY_APP_TELEMETRY_ENABLE
+    Cy_App_Telemetry_EventHandler(ptrPdStackContext, evt);
+#endif /* CY_APP_TELEMETRY_ENABLE */
+
+#if CY_APP_FRS_RX_FAST_PATH_ENABLE
+    Cy_App_Swap_FrsEventHandler(ptrPdStackContext, evt);
+#endif /* CY_APP_FRS_RX_FAST_PATH_ENABLE */
+
     switch(evt)
     {
         case APP_EVT_TYPEC_STARTED:
@@ -1442,9 +1779,8 @@ void Cy_App_EventHandler(cy_stc_pdstack_context_t *ptrPdStackContext,
                         /* If the delay is 0 then changing it to 1, so that after 1 ms cb is called to apply VBus.*/
                         mux_wait_delay = 1u;
                     }
-                    Cy_PdUtils_SwTimer_Start(ptrPdStackContext->ptrTimerContext, ptrPdStackContext,
-                            CY_APP_GET_TIMER_ID(ptrPdStackContext, CY_APP_PSOURCE_EN_TIMER),
-                            mux_wait_delay, debug_acc_src_psrc_enable);
+                    Cy_App_Coro_Start(ptrPdStackContext, CY_APP_CORO_DEBUG_ACC,
+                            debug_acc_src_psrc_enable, mux_wait_delay);
                 }
 
                 glAppStatus[port].debug_acc_attached = true;
@@ -1557,8 +1893,11 @@ void Cy_App_EventHandler(cy_stc_pdstack_context_t *ptrPdStackContext,
         case APP_EVT_TYPE_C_ERROR_RECOVERY:
 
 #if (CY_PD_EPR_ENABLE && (!CY_PD_SOURCE_ONLY))
-            Cy_PdUtils_SwTimer_Stop (ptrPdStackContext->ptrTimerContext, CY_APP_GET_TIMER_ID(ptrPdStackContext, CY_APP_EPR_MODE_TIMER));
+            Cy_App_Coro_Stop (ptrPdStackContext, CY_APP_CORO_EPR_ENTRY);
 #endif /* (CY_PD_EPR_ENABLE && (!CY_PD_SOURCE_ONLY)) */
+#if (CY_APP_PPS_SNK_ENABLE && (!CY_PD_SOURCE_ONLY))
+            Cy_App_Coro_Stop (ptrPdStackContext, CY_APP_CORO_PPS_SNK);
+#endif /* (CY_APP_PPS_SNK_ENABLE && (!CY_PD_SOURCE_ONLY)) */
 #if ((DFP_ALT_MODE_SUPP) || (UFP_ALT_MODE_SUPP))
 
 #if (!CCG_CBL_DISC_DISABLE)
@@ -1570,9 +1909,13 @@ void Cy_App_EventHandler(cy_stc_pdstack_context_t *ptrPdStackContext,
 #endif /* (DFP_ALT_MODE_SUPP) || (UFP_ALT_MODE_SUPP) */
             if(evt == APP_EVT_DISCONNECT)
             {
+#if CY_APP_PARTNER_CACHE_ENABLE
+                Cy_App_Partner_Detach(ptrPdStackContext);
+#endif /* CY_APP_PARTNER_CACHE_ENABLE */
 #if ((CY_PD_REV3_ENABLE) && (CY_APP_GET_REVISION_ENABLE))
                 /* Reset the retry count for PD Get_Revision AMS */
                 glAppGetRevRetry[ptrPdStackContext->port] = 0x00u;
+                Cy_App_Coro_Stop (ptrPdStackContext, CY_APP_CORO_GET_REVISION);
 
                 glAppGetRevSendStatus[ptrPdStackContext->port] = false;
 #endif /* ((CY_PD_REV3_ENABLE) && (CY_APP_GET_REVISION_ENABLE)) */
@@ -1636,6 +1979,9 @@ void Cy_App_EventHandler(cy_stc_pdstack_context_t *ptrPdStackContext,
                     ptrPdStackContext->ptrAppCbk->psrc_disable(ptrPdStackContext, debug_acc_src_disable_cbk);
                 }
 
+                /* Drop any VBus enable which is still pending */
+                Cy_App_Coro_Stop(ptrPdStackContext, CY_APP_CORO_DEBUG_ACC);
+
                 /* Mark debug accessory detached */
                 glAppStatus[port].debug_acc_attached = false;
 #endif /* ((!CY_PD_SINK_ONLY) && (!CY_PD_DEBUG_ACC_DISABLE)) */
@@ -1664,7 +2010,7 @@ void Cy_App_EventHandler(cy_stc_pdstack_context_t *ptrPdStackContext,
             Cy_PdAltMode_VdmTask_MngrDeInit (ptrAltModeContext);
 
 #if CY_PD_DP_VCONN_SWAP_FEATURE
-            Cy_PdUtils_SwTimer_Stop (ptrPdStackContext->ptrTimerContext, CY_APP_GET_TIMER_ID(ptrPdStackContext, CY_APP_CBL_DISC_TRIGGER_TIMER));
+            Cy_App_Coro_Stop (ptrPdStackContext, CY_APP_CORO_CBL_DISC);
 #endif /* CY_PD_DP_VCONN_SWAP_FEATURE */
 
 #endif /* (DFP_ALT_MODE_SUPP) || (UFP_ALT_MODE_SUPP) */
@@ -1807,7 +2153,7 @@ void Cy_App_EventHandler(cy_stc_pdstack_context_t *ptrPdStackContext,
                 glAppStatus[port].app_pending_swaps &= ~CY_APP_DR_SWAP_PENDING;
                 if (glAppStatus[port].actv_swap_type == CY_PDSTACK_DPM_CMD_SEND_DR_SWAP)
                 {
-                    Cy_PdUtils_SwTimer_Stop(ptrPdStackContext->ptrTimerContext, CY_APP_GET_TIMER_ID(ptrPdStackContext, CY_APP_INITIATE_SWAP_TIMER));
+                    Cy_App_Coro_Stop(ptrPdStackContext, CY_APP_CORO_ROLE_SWAP);
                     Cy_App_ContractHandler (ptrPdStackContext);
                 }
 #endif /* (CY_APP_ROLE_PREFERENCE_ENABLE) */
@@ -1934,27 +2280,44 @@ void Cy_App_EventHandler(cy_stc_pdstack_context_t *ptrPdStackContext,
 #if ((CY_PD_REV3_ENABLE) && (CY_APP_GET_REVISION_ENABLE))
             if((!(glAppGetRevSendStatus[ptrPdStackContext->port])) && (ptrPdStackContext->dpmConfig.specRevSopLive >= CY_PD_REV3))
             {
-                if((Cy_PdUtils_SwTimer_IsRunning(ptrPdStackContext->ptrTimerContext, CY_APP_GET_TIMER_ID(ptrPdStackContext, CY_APP_PD_GET_REVISION_COMMAND_RETRY_TIMER)) == false))
+                if(Cy_App_Coro_IsActive(ptrPdStackContext, CY_APP_CORO_GET_REVISION) == false)
                 {
-                    /* Start the timer for sending the PD Get_Revision AMS */
-                    Cy_PdUtils_SwTimer_Start (ptrPdStackContext->ptrTimerContext, ptrPdStackContext,
-                            CY_APP_GET_TIMER_ID(ptrPdStackContext, CY_APP_PD_GET_REVISION_COMMAND_RETRY_TIMER), CY_APP_GET_REV_PD_CMD_RETRY_TIMER_PERIOD, send_get_revision);
+                    /* Start the sequence for sending the PD Get_Revision AMS */
+                    Cy_App_Coro_Start (ptrPdStackContext, CY_APP_CORO_GET_REVISION, send_get_revision,
+                            CY_APP_GET_REV_PD_CMD_RETRY_TIMER_PERIOD);
                 }
             }
 #endif /* ((CY_PD_REV3_ENABLE) && (CY_APP_GET_REVISION_ENABLE)) */
 
+#if (CY_APP_PPS_SNK_ENABLE && (!CY_PD_SOURCE_ONLY))
+            if (app_pps_snk_contract_active(ptrPdStackContext))
+            {
+                /* Renew the PPS contract before the source times it out */
+                Cy_App_Coro_Start(ptrPdStackContext, CY_APP_CORO_PPS_SNK, app_pps_snk_keep_alive,
+                        APP_PPS_SNK_CONTRACT_PERIOD);
+            }
+            else
+            {
+                Cy_App_Coro_Stop(ptrPdStackContext, CY_APP_CORO_PPS_SNK);
+            }
+#endif /* (CY_APP_PPS_SNK_ENABLE && (!CY_PD_SOURCE_ONLY)) */
+
 #if (CY_PD_EPR_ENABLE && (!CY_PD_SOURCE_ONLY))
-            Cy_PdUtils_SwTimer_Stop (ptrPdStackContext->ptrTimerContext, CY_APP_GET_TIMER_ID(ptrPdStackContext, CY_APP_EPR_MODE_TIMER));
+            Cy_App_Coro_Stop (ptrPdStackContext, CY_APP_CORO_EPR_ENTRY);
 
             if((!glAppResetEpr[port]) && (ptrPdStackContext->dpmConfig.specRevSopLive >= CY_PD_REV3))
             {
-                /* Start a timer to attempt EPR entry if the current role is sink */
+                /* Start the sequence to attempt EPR entry if the current role is sink */
                 if ( (ptrPdStackContext->dpmConfig.curPortRole == CY_PD_PRT_ROLE_SINK) &&
                         (ptrPdStackContext->dpmStat.srcCapP->dat[0].fixed_src.eprModeCapable == true) && 
-                            (ptrPdStackContext->dpmExtStat.epr.snkEnable == true))
+                            (ptrPdStackContext->dpmExtStat.epr.snkEnable == true)
+#if CY_APP_PARTNER_CACHE_ENABLE
+                        /* Skip EPR entry with partners on which it has failed before */
+                        && ((Cy_App_Partner_GetFlags(ptrPdStackContext) & CY_APP_PARTNER_FLAG_EPR_FAILED) == 0u)
+#endif /* CY_APP_PARTNER_CACHE_ENABLE */
+                   )
                 {
-                    Cy_PdUtils_SwTimer_Start(ptrPdStackContext->ptrTimerContext, ptrPdStackContext,
-                            CY_APP_GET_TIMER_ID(ptrPdStackContext, CY_APP_EPR_MODE_TIMER), CY_APP_EPR_SNK_ENTRY_TIMER_PERIOD, epr_enter_mode_timer_cb);
+                    Cy_App_Coro_Start(ptrPdStackContext, CY_APP_CORO_EPR_ENTRY, epr_enter_mode_seq, 0u);
 
                     glAppResetEpr[port] = true;
                 }
@@ -2048,7 +2411,7 @@ void Cy_App_EventHandler(cy_stc_pdstack_context_t *ptrPdStackContext,
             glAppStatus[port].app_pending_swaps &= ~CY_APP_PR_SWAP_PENDING;
             if (glAppStatus[port].actv_swap_type == CY_PDSTACK_DPM_CMD_SEND_PR_SWAP)
             {
-                Cy_PdUtils_SwTimer_Stop(ptrPdStackContext->ptrTimerContext, CY_APP_GET_TIMER_ID(ptrPdStackContext, CY_APP_INITIATE_SWAP_TIMER));
+                Cy_App_Coro_Stop(ptrPdStackContext, CY_APP_CORO_ROLE_SWAP);
                 Cy_App_ContractHandler (ptrPdStackContext);
             }
 #endif /* (CY_APP_POWER_ROLE_PREFERENCE_ENABLE) */
@@ -2163,13 +2526,19 @@ void Cy_App_EventHandler(cy_stc_pdstack_context_t *ptrPdStackContext,
 
 #if CY_PD_EPR_ENABLE
         case APP_EVT_EPR_MODE_ENTER_FAILED:
+#if CY_APP_PARTNER_CACHE_ENABLE
+            Cy_App_Partner_UpdateFlags(ptrPdStackContext, CY_APP_PARTNER_FLAG_EPR_FAILED, true);
+#endif /* CY_APP_PARTNER_CACHE_ENABLE */
             break;
         case APP_EVT_EPR_MODE_ENTER_RECEIVED:
 #if CY_APP_ROLE_PREFERENCE_ENABLE
-            Cy_PdUtils_SwTimer_Stop(ptrPdStackContext->ptrTimerContext, CY_APP_GET_TIMER_ID(ptrPdStackContext, CY_APP_INITIATE_SWAP_TIMER));
+            Cy_App_Coro_Stop(ptrPdStackContext, CY_APP_CORO_ROLE_SWAP);
 #endif /* CY_APP_ROLE_PREFERENCE_ENABLE */
             break;
         case APP_EVT_EPR_MODE_ENTER_SUCCESS:
+#if CY_APP_PARTNER_CACHE_ENABLE
+            Cy_App_Partner_UpdateFlags(ptrPdStackContext, CY_APP_PARTNER_FLAG_EPR_FAILED, false);
+#endif /* CY_APP_PARTNER_CACHE_ENABLE */
             break;
 #endif /* CY_PD_EPR_ENABLE */
 
@@ -2191,6 +2560,13 @@ void Cy_App_EventHandler(cy_stc_pdstack_context_t *ptrPdStackContext,
                         CY_APP_PSOURCE_DIS_TIMER_PERIOD, app_psrc_invalid_vbus_tmr_cbk);
                 glAppInvalidVbusDisOn[port] = true;
                 Cy_App_VbusDischargeOn(ptrPdStackContext);
+#if CY_APP_VBUS_DISCHARGE_CTRL_ENABLE
+                Cy_App_VbusDischargeCtrl_Start(ptrPdStackContext, CY_PD_VSAFE_0V, CY_APP_VBUS_TURN_ON_MARGIN,
+                        CY_APP_VBUS_DISCHARGE_POLL_MIN);
+                (void)Cy_PdUtils_SwTimer_Start(ptrPdStackContext->ptrTimerContext, ptrPdStackContext,
+                        CY_APP_GET_TIMER_ID(ptrPdStackContext, CY_APP_PSOURCE_DIS_MONITOR_TIMER),
+                        CY_APP_VBUS_DISCHARGE_POLL_MIN, app_psrc_invalid_vbus_monitor_cbk);
+#endif /* CY_APP_VBUS_DISCHARGE_CTRL_ENABLE */
             }
 #endif /* (!CY_PD_SINK_ONLY) */
             break;
@@ -2232,6 +2608,14 @@ cy_stc_pdstack_app_status_t* Cy_App_GetPdAppStatus(uint8_t port)
      return &glAppPdStatus[port];
 }
 
+#if CY_APP_TIMESTAMP_ENABLE
+uint32_t Cy_App_GetTimestamp(void)
+{
+    return (Cy_TCPWM_Counter_GetCounter(CY_APP_TIMESTAMP_TCPWM_HW, CY_APP_TIMESTAMP_TCPWM_NUM) &
+            CY_APP_TIMESTAMP_MASK);
+}
+#endif /* CY_APP_TIMESTAMP_ENABLE */
+
 #if CY_PD_DP_VCONN_SWAP_FEATURE
 /* Callback that will be called when there is any change to the V5V or VSYS supplies */
 void Cy_App_SupplyChangeCallback(void *context, cy_en_usbpd_supply_t supply_id, bool present)
@@ -2290,6 +2674,13 @@ void Cy_App_Init(cy_stc_pdstack_context_t *ptrPdStackContext, const cy_stc_app_p
 
     glAppVbusPollAdcId[port] = appParams->appVbusPollAdcId;
     glAppVbusPollAdcInput[port] = appParams->appVbusPollAdcInput;
+#if CY_APP_ADC_CAL_CACHE_ENABLE
+    Cy_App_AdcCalInvalidate(port);
+#endif /* CY_APP_ADC_CAL_CACHE_ENABLE */
+
+#if CY_APP_PARTNER_CACHE_ENABLE
+    Cy_App_Partner_Init();
+#endif /* CY_APP_PARTNER_CACHE_ENABLE */
 
 #if CY_USE_CONFIG_TABLE
     /* Update the swap response from config table */
@@ -2424,6 +2815,11 @@ void Cy_App_Init(cy_stc_pdstack_context_t *ptrPdStackContext, const cy_stc_app_p
 #endif /* (PMG1_V5V_CHANGE_DETECT) */
 #endif /* CY_PD_DP_VCONN_SWAP_FEATURE */
 
+#if CY_APP_FRS_RX_FAST_PATH_ENABLE
+    /* Handle the FRS signal in its interrupt, ahead of the PD stack */
+    Cy_App_Swap_FrsInit(ptrPdStackContext);
+#endif /* CY_APP_FRS_RX_FAST_PATH_ENABLE */
+
     if(true != Cy_PdUtils_SwTimer_IsRunning(ptrPdStackContext->ptrTimerContext, CY_PDUTILS_CCG_ACTIVITY_TIMER))
     {
         Cy_PdUtils_SwTimer_Start(ptrPdStackContext->ptrTimerContext, ptrPdStackContext, CY_PDUTILS_CCG_ACTIVITY_TIMER,
@@ -2600,6 +2996,13 @@ bool Cy_App_SystemSleep(cy_stc_pdstack_context_t *ptrPdStack0Context, cy_stc_pds
 #if PMG1_PD_DUALPORT_ENABLE
                         Cy_USBPD_SetReference(ptrPdStack1Context->ptrUsbPdContext, false);
 #endif /* PMG1_PD_DUALPORT_ENABLE */
+#if CY_APP_ADC_CAL_CACHE_ENABLE
+                        /* The ADC is calibrated again after the reference switch and deep sleep */
+                        Cy_App_AdcCalInvalidate(ptrPdStack0Context->port);
+#if PMG1_PD_DUALPORT_ENABLE
+                        Cy_App_AdcCalInvalidate(ptrPdStack1Context->port);
+#endif /* PMG1_PD_DUALPORT_ENABLE */
+#endif /* CY_APP_ADC_CAL_CACHE_ENABLE */
                         retval = true;
                     }
                 }
@@ -2632,9 +3035,7 @@ bool Cy_App_SystemSleep(cy_stc_pdstack_context_t *ptrPdStack0Context, cy_stc_pds
     /* Call Cy_App_Resume() if Cy_App_Sleep() had returned true */
     if(app_slept)
     {
-#if ((DFP_ALT_MODE_SUPP) || (UFP_ALT_MODE_SUPP))
         Cy_App_Resume();
-#endif /* ((DFP_ALT_MODE_SUPP) || (UFP_ALT_MODE_SUPP)) */
     }
 #if RIDGE_SLAVE_ENABLE
     if(ridge_intf_slept)
@@ -2751,16 +3152,63 @@ bool Cy_App_VconnIsPresent(cy_stc_pdstack_context_t *ptrPdStackContext)
     return Cy_USBPD_Vconn_IsPresent(ptrPdStackContext->ptrUsbPdContext, ptrPdStackContext->dpmConfig.revPol);
 }
 
+#if CY_APP_ADC_CAL_CACHE_ENABLE
+static void app_adc_cal_age_cb(cy_timer_id_t id, void *callbackCtx)
+{
+    cy_stc_pdstack_context_t *ptrPdStackContext = (cy_stc_pdstack_context_t *)callbackCtx;
+
+    (void)id;
+    glAppAdcCalValid[ptrPdStackContext->port] = false;
+}
+
+void Cy_App_AdcCalInvalidate(uint8_t port)
+{
+    if (port < NO_OF_TYPEC_PORTS)
+    {
+        glAppAdcCalValid[port] = false;
+    }
+}
+
+uint32_t Cy_App_AdcCalGetSavedCount(uint8_t port)
+{
+    return (port < NO_OF_TYPEC_PORTS) ? glAppAdcCalSaved[port] : 0u;
+}
+#endif /* CY_APP_ADC_CAL_CACHE_ENABLE */
+
 bool Cy_App_VbusIsPresent(cy_stc_pdstack_context_t *ptrPdStackContext, uint16_t volt, int8_t per)
 {
     uint8_t level;
     uint8_t retVal;
     uint8_t port = ptrPdStackContext->port;
+
+#if CY_APP_ADC_SCHED_ENABLE
+    Cy_App_AdcSched_Preempt(ptrPdStackContext);
+#endif /* CY_APP_ADC_SCHED_ENABLE */
+
+#if CY_APP_ADC_CAL_CACHE_ENABLE
+    /*
+     * The calibration is reused until it is invalidated by a reference change,
+     * deep sleep or its age.
+     */
+    if (glAppAdcCalValid[port])
+    {
+        glAppAdcCalSaved[port]++;
+    }
+    else
+    {
+        Cy_USBPD_Adc_Calibrate(ptrPdStackContext->ptrUsbPdContext, glAppVbusPollAdcId[port]);
+        glAppAdcCalValid[port] = true;
+        Cy_PdUtils_SwTimer_Start(ptrPdStackContext->ptrTimerContext, ptrPdStackContext,
+                CY_APP_GET_TIMER_ID(ptrPdStackContext, CY_APP_ADC_CAL_AGE_TIMER),
+                CY_APP_ADC_CAL_MAX_AGE, app_adc_cal_age_cb);
+    }
+#else
     /*
      * Re-run calibration every time to ensure that VDDD or the measurement
      * does not break
      */
     Cy_USBPD_Adc_Calibrate(ptrPdStackContext->ptrUsbPdContext, glAppVbusPollAdcId[port]);
+#endif /* CY_APP_ADC_CAL_CACHE_ENABLE */
     level =  Cy_USBPD_Adc_GetVbusLevel(ptrPdStackContext->ptrUsbPdContext, 
             glAppVbusPollAdcId[port], 
             volt, per);
@@ -2769,6 +3217,10 @@ bool Cy_App_VbusIsPresent(cy_stc_pdstack_context_t *ptrPdStackContext, uint16_t
             glAppVbusPollAdcId[port], 
             glAppVbusPollAdcInput[port], level);
 
+#if CY_APP_ADC_SCHED_ENABLE
+    Cy_App_AdcSched_Continue(ptrPdStackContext);
+#endif /* CY_APP_ADC_SCHED_ENABLE */
+
     return retVal;
 }
 
@@ -2782,16 +3234,95 @@ void Cy_App_VbusDischargeOff(cy_stc_pdstack_context_t* context)
     Cy_USBPD_Vbus_DischargeOff(context->ptrUsbPdContext);
 }
 
+#if CY_APP_VBUS_DISCHARGE_CTRL_ENABLE
+void Cy_App_VbusDischargeCtrl_Start(cy_stc_pdstack_context_t *context, uint16_t volt, int8_t per, uint16_t period)
+{
+    uint8_t port = context->port;
+    int32_t target = (int32_t)volt + (((int32_t)volt * per) / 100);
+
+    /* A vSafe0V target can compute to zero, which VBUS never falls below */
+    if (target < (int32_t)CY_APP_VBUS_DISCHARGE_VSAFE0V_MAX)
+    {
+        target = (int32_t)CY_APP_VBUS_DISCHARGE_VSAFE0V_MAX;
+    }
+
+    glAppDischgTarget[port]   = (uint16_t)target;
+    glAppDischgLastVbus[port] = 0u;
+    glAppDischgPeriod[port]   = period;
+    glAppDischgElapsed[port]  = 0u;
+    glAppDischgTime[port]     = CY_APP_VBUS_DISCHARGE_TIME_INVALID;
+}
+
+uint16_t Cy_App_VbusDischargeCtrl_Poll(cy_stc_pdstack_context_t *context, uint16_t *vbus_p)
+{
+    uint8_t port = context->port;
+    uint16_t vbus = Cy_App_VbusGetValue(context);
+    uint32_t drop;
+    uint32_t period;
+
+    if (vbus_p != NULL)
+    {
+        *vbus_p = vbus;
+    }
+
+    /* The first poll follows the start by the period given to Cy_App_VbusDischargeCtrl_Start */
+    glAppDischgElapsed[port] += glAppDischgPeriod[port];
+
+    if (vbus < glAppDischgTarget[port])
+    {
+        glAppDischgTime[port] = glAppDischgElapsed[port];
+        return 0u;
+    }
+
+    if (glAppDischgLastVbus[port] == 0u)
+    {
+        /* No slope is known after the first sample */
+        period = CY_APP_VBUS_DISCHARGE_POLL_MIN;
+    }
+    else if (glAppDischgLastVbus[port] > vbus)
+    {
+        /* Poll again half way to the time the target is expected to be reached */
+        drop   = (uint32_t)glAppDischgLastVbus[port] - vbus;
+        period = (((uint32_t)vbus - glAppDischgTarget[port]) * glAppDischgPeriod[port]) / (drop * 2u);
+        period = CY_PDUTILS_GET_MAX(period, CY_APP_VBUS_DISCHARGE_POLL_MIN);
+        period = CY_PDUTILS_GET_MIN(period, CY_APP_VBUS_DISCHARGE_POLL_MAX);
+    }
+    else
+    {
+        /* VBUS is not falling; the timer bound of the caller applies */
+        period = CY_APP_VBUS_DISCHARGE_POLL_MAX;
+    }
+
+    glAppDischgLastVbus[port] = vbus;
+    glAppDischgPeriod[port]   = (uint16_t)period;
+
+    return (uint16_t)period;
+}
+
+uint16_t Cy_App_VbusDischargeCtrl_GetTime(cy_stc_pdstack_context_t *context)
+{
+    return glAppDischgTime[context->port];
+}
+#endif /* CY_APP_VBUS_DISCHARGE_CTRL_ENABLE */
+
 uint16_t Cy_App_VbusGetValue(cy_stc_pdstack_context_t *ptrPdStackContext)
 {
     uint16_t retVal;
     uint8_t port = ptrPdStackContext->port;
 
+#if CY_APP_ADC_SCHED_ENABLE
+    Cy_App_AdcSched_Preempt(ptrPdStackContext);
+#endif /* CY_APP_ADC_SCHED_ENABLE */
+
     /* Measure the actual VBUS voltage */
     retVal = Cy_USBPD_Adc_MeasureVbus(ptrPdStackContext->ptrUsbPdContext,
             glAppVbusPollAdcId[port],
             glAppVbusPollAdcInput[port]);
 
+#if CY_APP_ADC_SCHED_ENABLE
+    Cy_App_AdcSched_Continue(ptrPdStackContext);
+#endif /* CY_APP_ADC_SCHED_ENABLE */
+
     return retVal;
 }
 
@@ -153,6 +153,9 @@
 /** Period (in ms) of VBUS drop to VSAFE0 checks after power source is turned OFF. */
 #define CY_APP_PSOURCE_DIS_MONITOR_TIMER_PERIOD        (1u)
 
+/** Discharge time reported when VBUS did not reach the discharge target. */
+#define CY_APP_VBUS_DISCHARGE_TIME_INVALID             (0xFFFFu)
+
 /** Period in ms for turning ON VBUS FET. */
 #define CY_APP_VBUS_FET_ON_TIMER_PERIOD                (5u)
 
@@ -254,6 +257,9 @@
  * messages. */
 #define CY_APP_MIN_PD_SPEC_VERSION_FOR_EXTD_ALERT_SUPPORT      (0x31110000UL)
 
+/** Time in us from the time stamp start to end, taken with Cy_App_GetTimestamp. */
+#define CY_APP_TIMESTAMP_DIFF(start, end)                  (((end) - (start)) & CY_APP_TIMESTAMP_MASK)
+
 /** \} group_pmg_app_common_app_macros */
 
 /*****************************************************************************
@@ -536,6 +542,39 @@ bool Cy_App_VbusIsPresent(cy_stc_pdstack_context_t *ptrPdStackContext, uint16_t
  */
 uint16_t Cy_App_VbusGetValue(cy_stc_pdstack_context_t *ptrPdStackContext);
 
+#if (CY_APP_ADC_CAL_CACHE_ENABLE || DOXYGEN)
+/**
+ * @brief This function discards the cached calibration of the VBUS poll ADC,
+ * so that the ADC is calibrated again before its next use by
+ * Cy_App_VbusIsPresent. To be called when VDDD or the ADC reference changes.
+ *
+ * @param port PD port index.
+ *
+ * @return None.
+ */
+void Cy_App_AdcCalInvalidate(uint8_t port);
+
+/**
+ * @brief This function returns the number of ADC calibrations which have been
+ * saved by reusing the cached calibration.
+ *
+ * @param port PD port index.
+ *
+ * @return Number of calibrations saved.
+ */
+uint32_t Cy_App_AdcCalGetSavedCount(uint8_t port);
+#endif /* (CY_APP_ADC_CAL_CACHE_ENABLE || DOXYGEN) */
+
+#if (CY_APP_TIMESTAMP_ENABLE || DOXYGEN)
+/**
+ * @brief This function returns the time stamp counter, which counts in us and
+ * wraps at CY_APP_TIMESTAMP_MASK. It can be called from interrupt context.
+ *
+ * @return Time stamp in us. Use CY_APP_TIMESTAMP_DIFF for intervals.
+ */
+uint32_t Cy_App_GetTimestamp(void);
+#endif /* (CY_APP_TIMESTAMP_ENABLE || DOXYGEN) */
+
 /**
  * @brief This function turns on discharge FET on selected port.
  *
@@ -554,6 +593,46 @@ void Cy_App_VbusDischargeOn(cy_stc_pdstack_context_t* context);
  */
 void Cy_App_VbusDischargeOff(cy_stc_pdstack_context_t* context);
 
+#if (CY_APP_VBUS_DISCHARGE_CTRL_ENABLE || DOXYGEN)
+/**
+ * @brief This function starts tracking a VBUS discharge. Subsequent calls to
+ * Cy_App_VbusDischargeCtrl_Poll report when VBUS has fallen below the target.
+ *
+ * @param context Pointer to the PDStack context.
+ * @param volt Target voltage in mV units.
+ * @param per Threshold margin as percentage of the target voltage. A threshold
+ * below CY_APP_VBUS_DISCHARGE_VSAFE0V_MAX is raised to it.
+ * @param period Time in ms from the start of the discharge to the first
+ * call of Cy_App_VbusDischargeCtrl_Poll.
+ *
+ * @return None.
+ */
+void Cy_App_VbusDischargeCtrl_Start(cy_stc_pdstack_context_t *context, uint16_t volt, int8_t per, uint16_t period);
+
+/**
+ * @brief This function measures VBUS during a discharge and returns the time
+ * to the next measurement. The time follows the slope of VBUS, within
+ * CY_APP_VBUS_DISCHARGE_POLL_MIN and CY_APP_VBUS_DISCHARGE_POLL_MAX. The caller
+ * keeps its own timer as the upper bound of the discharge.
+ *
+ * @param context Pointer to the PDStack context.
+ * @param vbus_p Returns the measured VBUS voltage in mV. Can be NULL.
+ *
+ * @return Time in ms to the next measurement; 0 if VBUS is below the target.
+ */
+uint16_t Cy_App_VbusDischargeCtrl_Poll(cy_stc_pdstack_context_t *context, uint16_t *vbus_p);
+
+/**
+ * @brief This function returns the duration of the last discharge.
+ *
+ * @param context Pointer to the PDStack context.
+ *
+ * @return Time in ms VBUS took to fall below the target;
+ * CY_APP_VBUS_DISCHARGE_TIME_INVALID if the target has not been reached.
+ */
+uint16_t Cy_App_VbusDischargeCtrl_GetTime(cy_stc_pdstack_context_t *context);
+#endif /* (CY_APP_VBUS_DISCHARGE_CTRL_ENABLE || DOXYGEN) */
+
 /**
  * @brief Restarts alternate mode layer.
  *
@@ -594,7 +673,10 @@ void Cy_App_ContractHandler (cy_stc_pdstack_context_t *ptrPdStackContext);
 void Cy_App_ConnectChangeHandler (cy_stc_pdstack_context_t *ptrPdStackContext);
 
 /**
- * @brief Callback function for cable discovery process.
+ * @brief Starts the cable discovery sequence. The PD stack is asked to initiate
+ * cable discovery and the request is retried periodically until it is accepted.
+ * The function keeps the timer callback signature so that it can be registered
+ * as a software timer callback.
  * @param id Timer ID responsible for the callback.
  * @param callbackContext Callback context.
  * @return None.
@@ -0,0 +1,306 @@
+/***************************************************************************//**
+* \file cy_app_adc_sched.c
+* \version 2.0
+*
+* \brief
+* Implements the ADC sampling scheduler shared by the application modules
+*
+********************************************************************************
+* \copyright
+* Copyright 2024, Cypress Semiconductor Corporation (an Infineon company)
+* or an affiliate of Cypress Semiconductor Corporation. All rights reserved.
+* You may use this file only in accordance with the license, terms, conditions,
+* disclaimers, and limitations in the end user license agreement accompanying
+* the software package with which this file was provided.
+*******************************************************************************/
+
+#include "cybsp.h"
+#include "cy_app_config.h"
+#include "cy_app.h"
+#include "cy_app_adc_sched.h"
+#include "cy_app_timer_id.h"
+
+#include "cy_usbpd_vbus_ctrl.h"
+#include "cy_pdutils_sw_timer.h"
+
+#if CY_APP_ADC_SCHED_ENABLE
+
+/* Pending requests of each port */
+static cy_stc_app_adc_req_t glAppAdcSchedQueue[NO_OF_TYPEC_PORTS][CY_APP_ADC_SCHED_QUEUE_SIZE];
+
+/* Number of pending requests of each port */
+static uint8_t glAppAdcSchedCount[NO_OF_TYPEC_PORTS];
+
+/* Request being served on each port */
+static cy_stc_app_adc_req_t glAppAdcSchedActive[NO_OF_TYPEC_PORTS];
+
+/* A request is being served on the port */
+static volatile bool glAppAdcSchedBusy[NO_OF_TYPEC_PORTS];
+
+/* The active request has switched the reference or connected its signal */
+static volatile bool glAppAdcSchedApplied[NO_OF_TYPEC_PORTS];
+
+/* Mask of ADCs whose reference has been switched by the scheduler */
+static uint8_t glAppAdcSchedVrefSwitched[NO_OF_TYPEC_PORTS];
+
+/* Reference of each ADC before the scheduler switched it: true for VDDD */
+static bool glAppAdcSchedVrefOrig[NO_OF_TYPEC_PORTS][CY_APP_ADC_SCHED_NUM_ADC];
+
+/* Nesting depth of the synchronous measurements on each port */
+static uint8_t glAppAdcSchedPreemptDepth[NO_OF_TYPEC_PORTS];
+
+/* The settle time of the active request has been interrupted by a synchronous measurement */
+static bool glAppAdcSchedPreempted[NO_OF_TYPEC_PORTS];
+
+static void adc_sched_timer_cb(cy_timer_id_t id, void *callbackCtx);
+
+/* Restores the references which have been switched for the served requests */
+static void adc_sched_restore_vref(cy_stc_pdstack_context_t *ptrPdStackContext)
+{
+    uint8_t port = ptrPdStackContext->port;
+    uint8_t adc;
+
+    if (glAppAdcSchedVrefSwitched[port] == 0u)
+    {
+        return;
+    }
+
+    for (adc = 0u; adc < CY_APP_ADC_SCHED_NUM_ADC; adc++)
+    {
+        if ((glAppAdcSchedVrefSwitched[port] & (1u << adc)) != 0u)
+        {
+            Cy_USBPD_Adc_SelectVref(ptrPdStackContext->ptrUsbPdContext, (cy_en_usbpd_adc_id_t)adc,
+                    (glAppAdcSchedVrefOrig[port][adc]) ? CY_USBPD_ADC_VREF_VDDD : CY_USBPD_ADC_VREF_PROG);
+        }
+    }
+
+    glAppAdcSchedVrefSwitched[port] = 0u;
+
+#if CY_APP_ADC_CAL_CACHE_ENABLE
+    Cy_App_AdcCalInvalidate(port);
+#endif /* CY_APP_ADC_CAL_CACHE_ENABLE */
+}
+
+/* Takes the sample of the active request and passes the result to its callback */
+static void adc_sched_sample(cy_stc_pdstack_context_t *ptrPdStackContext)
+{
+    cy_stc_app_adc_req_t *req = &glAppAdcSchedActive[ptrPdStackContext->port];
+    uint8_t level;
+    uint16_t volt;
+
+    level = Cy_USBPD_Adc_Sample(ptrPdStackContext->ptrUsbPdContext, req->adcId, req->input);
+    volt = Cy_USBPD_Adc_LevelToVolt(ptrPdStackContext->ptrUsbPdContext, req->adcId, level);
+
+    glAppAdcSchedApplied[ptrPdStackContext->port] = false;
+
+    req->result(ptrPdStackContext, req->cbkContext, level, volt);
+}
+
+/* Switches the reference for the request and connects its signal; returns the time to wait before the sample */
+static uint16_t adc_sched_apply(cy_stc_pdstack_context_t *ptrPdStackContext, const cy_stc_app_adc_req_t *req)
+{
+    uint8_t port = ptrPdStackContext->port;
+    const bool *ref_vddd = ptrPdStackContext->ptrUsbPdContext->adcRefVddd;
+    uint16_t delay = req->settleTime;
+
+    if (req->vrefVddd != ref_vddd[req->adcId])
+    {
+        if ((glAppAdcSchedVrefSwitched[port] & (1u << req->adcId)) == 0u)
+        {
+            glAppAdcSchedVrefOrig[port][req->adcId] = ref_vddd[req->adcId];
+            glAppAdcSchedVrefSwitched[port] |= (uint8_t)(1u << req->adcId);
+        }
+
+        Cy_USBPD_Adc_SelectVref(ptrPdStackContext->ptrUsbPdContext, req->adcId,
+                (req->vrefVddd) ? CY_USBPD_ADC_VREF_VDDD : CY_USBPD_ADC_VREF_PROG);
+        delay = CY_PDUTILS_GET_MAX(delay, CY_APP_ADC_SCHED_VREF_SETTLE_TIME);
+    }
+
+    if (req->setup != NULL)
+    {
+        req->setup(ptrPdStackContext, req->cbkContext);
+    }
+
+    return delay;
+}
+
+/* Serves the pending requests until one of them has to wait for its settle time */
+static void adc_sched_run(cy_stc_pdstack_context_t *ptrPdStackContext)
+{
+    uint8_t port = ptrPdStackContext->port;
+    cy_stc_app_adc_req_t *queue = glAppAdcSchedQueue[port];
+    cy_stc_app_adc_req_t *req = &glAppAdcSchedActive[port];
+    const bool *ref_vddd = ptrPdStackContext->ptrUsbPdContext->adcRefVddd;
+    uint32_t intr_state;
+    uint16_t delay;
+    uint8_t pick;
+    uint8_t idx;
+
+    while (true)
+    {
+        intr_state = Cy_SysLib_EnterCriticalSection();
+
+        if (glAppAdcSchedCount[port] == 0u)
+        {
+            glAppAdcSchedBusy[port] = false;
+            Cy_SysLib_ExitCriticalSection(intr_state);
+
+            adc_sched_restore_vref(ptrPdStackContext);
+            return;
+        }
+
+        /* Prefer the oldest request which does not need a reference switch */
+        pick = 0u;
+        for (idx = 0u; idx < glAppAdcSchedCount[port]; idx++)
+        {
+            if (queue[idx].vrefVddd == ref_vddd[queue[idx].adcId])
+            {
+                pick = idx;
+                break;
+            }
+        }
+
+        *req = queue[pick];
+        for (idx = pick; idx < (glAppAdcSchedCount[port] - 1u); idx++)
+        {
+            queue[idx] = queue[idx + 1u];
+        }
+        glAppAdcSchedCount[port]--;
+        glAppAdcSchedBusy[port] = true;
+
+        /* Marked before the request is applied so that a preemption in between releases it */
+        glAppAdcSchedApplied[port] = true;
+
+        Cy_SysLib_ExitCriticalSection(intr_state);
+
+        delay = adc_sched_apply(ptrPdStackContext, req);
+
+        if (delay != 0u)
+        {
+            Cy_PdUtils_SwTimer_Start(ptrPdStackContext->ptrTimerContext, ptrPdStackContext,
+                    CY_APP_GET_TIMER_ID(ptrPdStackContext, CY_APP_ADC_SCHED_TIMER), delay, adc_sched_timer_cb);
+            return;
+        }
+
+        adc_sched_sample(ptrPdStackContext);
+    }
+}
+
+static void adc_sched_timer_cb(cy_timer_id_t id, void *callbackCtx)
+{
+    cy_stc_pdstack_context_t *ptrPdStackContext = (cy_stc_pdstack_context_t *)callbackCtx;
+
+    (void)id;
+
+    adc_sched_sample(ptrPdStackContext);
+    adc_sched_run(ptrPdStackContext);
+}
+
+cy_en_app_status_t Cy_App_AdcSched_Request(cy_stc_pdstack_context_t *ptrPdStackContext,
+        const cy_stc_app_adc_req_t *req)
+{
+    uint8_t port = ptrPdStackContext->port;
+    uint32_t intr_state;
+    bool start;
+
+    if ((req == NULL) || (req->result == NULL) || ((uint8_t)req->adcId >= CY_APP_ADC_SCHED_NUM_ADC))
+    {
+        return CY_APP_STAT_BAD_PARAM;
+    }
+
+    intr_state = Cy_SysLib_EnterCriticalSection();
+
+    if (glAppAdcSchedCount[port] >= CY_APP_ADC_SCHED_QUEUE_SIZE)
+    {
+        Cy_SysLib_ExitCriticalSection(intr_state);
+        return CY_APP_STAT_BUSY;
+    }
+
+    glAppAdcSchedQueue[port][glAppAdcSchedCount[port]] = *req;
+    glAppAdcSchedCount[port]++;
+
+    /* Requests queued while another one is served are picked up once it completes */
+    start = (glAppAdcSchedBusy[port] == false);
+    glAppAdcSchedBusy[port] = true;
+
+    Cy_SysLib_ExitCriticalSection(intr_state);
+
+    if (start)
+    {
+        adc_sched_run(ptrPdStackContext);
+    }
+
+    return CY_APP_STAT_SUCCESS;
+}
+
+bool Cy_App_AdcSched_IsBusy(cy_stc_pdstack_context_t *ptrPdStackContext)
+{
+    return glAppAdcSchedBusy[ptrPdStackContext->port];
+}
+
+void Cy_App_AdcSched_Preempt(cy_stc_pdstack_context_t *ptrPdStackContext)
+{
+    uint8_t port = ptrPdStackContext->port;
+    uint16_t timer_id = CY_APP_GET_TIMER_ID(ptrPdStackContext, CY_APP_ADC_SCHED_TIMER);
+    cy_stc_app_adc_req_t *req = &glAppAdcSchedActive[port];
+    uint32_t intr_state;
+    bool release = false;
+
+    intr_state = Cy_SysLib_EnterCriticalSection();
+
+    glAppAdcSchedPreemptDepth[port]++;
+    if ((glAppAdcSchedPreemptDepth[port] == 1u) && (glAppAdcSchedApplied[port]))
+    {
+        Cy_PdUtils_SwTimer_Stop(ptrPdStackContext->ptrTimerContext, timer_id);
+        glAppAdcSchedApplied[port] = false;
+        glAppAdcSchedPreempted[port] = true;
+        release = true;
+    }
+
+    Cy_SysLib_ExitCriticalSection(intr_state);
+
+    if (release)
+    {
+        if (req->release != NULL)
+        {
+            req->release(ptrPdStackContext, req->cbkContext);
+        }
+        adc_sched_restore_vref(ptrPdStackContext);
+    }
+}
+
+void Cy_App_AdcSched_Continue(cy_stc_pdstack_context_t *ptrPdStackContext)
+{
+    uint8_t port = ptrPdStackContext->port;
+    uint32_t intr_state;
+    uint16_t delay;
+    bool resume = false;
+
+    intr_state = Cy_SysLib_EnterCriticalSection();
+
+    if (glAppAdcSchedPreemptDepth[port] != 0u)
+    {
+        glAppAdcSchedPreemptDepth[port]--;
+        if ((glAppAdcSchedPreemptDepth[port] == 0u) && (glAppAdcSchedPreempted[port]))
+        {
+            glAppAdcSchedPreempted[port] = false;
+            glAppAdcSchedApplied[port] = true;
+            resume = true;
+        }
+    }
+
+    Cy_SysLib_ExitCriticalSection(intr_state);
+
+    if (resume)
+    {
+        /* The settle time starts again as the signal has been disconnected */
+        delay = adc_sched_apply(ptrPdStackContext, &glAppAdcSchedActive[port]);
+        Cy_PdUtils_SwTimer_Start(ptrPdStackContext->ptrTimerContext, ptrPdStackContext,
+                CY_APP_GET_TIMER_ID(ptrPdStackContext, CY_APP_ADC_SCHED_TIMER),
+                CY_PDUTILS_GET_MAX(delay, 1u), adc_sched_timer_cb);
+    }
+}
+
+#endif /* CY_APP_ADC_SCHED_ENABLE */
+
+/* [] End of file */
@@ -0,0 +1,184 @@
+/***************************************************************************//**
+* \file cy_app_adc_sched.h
+* \version 2.0
+*
+* \brief
+* Defines the data structures and function prototypes of the ADC sampling
+* scheduler shared by the application modules.
+*
+********************************************************************************
+* \copyright
+* Copyright 2024, Cypress Semiconductor Corporation (an Infineon company)
+* or an affiliate of Cypress Semiconductor Corporation. All rights reserved.
+* You may use this file only in accordance with the license, terms, conditions,
+* disclaimers, and limitations in the end user license agreement accompanying
+* the software package with which this file was provided.
+*******************************************************************************/
+
+#ifndef _CY_APP_ADC_SCHED_H_
+#define _CY_APP_ADC_SCHED_H_
+
+/*******************************************************************************
+ * Header files including
+ ******************************************************************************/
+#include <stdint.h>
+#include <stdbool.h>
+#include "cy_pdstack_common.h"
+#include "cy_usbpd_common.h"
+#include "cy_app_status.h"
+
+#if (CY_APP_ADC_SCHED_ENABLE || DOXYGEN)
+
+/**
+* \addtogroup group_pmg_app_common_adc_sched
+* \{
+* The ADC scheduler serializes sample requests for the USBPD ADCs of a port.
+* Each request names the ADC, the input, the reference and a settle time. The
+* scheduler waits for the settle time using a software timer instead of a
+* busy-wait loop, and passes the result to the callback of the request.
+*
+* Pending requests which use the reference the ADC is currently set to are
+* served first, so that reference switches are minimized. Once the queue is
+* empty, the ADC references are restored to their state before the first
+* switch.
+*
+* Synchronous measurements, such as Cy_App_VbusIsPresent and
+* Cy_App_VbusGetValue, are wrapped in Cy_App_AdcSched_Preempt and
+* Cy_App_AdcSched_Continue. A request which waits for its settle time is
+* disconnected and the references are restored for the synchronous
+* measurement; the request is set up again and its settle time restarts
+* afterwards.
+*
+* \defgroup group_pmg_app_common_adc_sched_macros Macros
+* \defgroup group_pmg_app_common_adc_sched_data_structures Data structures
+* \defgroup group_pmg_app_common_adc_sched_functions Functions
+*/
+/** \} group_pmg_app_common_adc_sched */
+
+/*****************************************************************************
+ * Macros
+ *****************************************************************************/
+/**
+* \addtogroup group_pmg_app_common_adc_sched_macros
+* \{
+*/
+
+#ifndef CY_APP_ADC_SCHED_QUEUE_SIZE
+/** Maximum number of pending sample requests per port. */
+#define CY_APP_ADC_SCHED_QUEUE_SIZE             (4u)
+#endif /* CY_APP_ADC_SCHED_QUEUE_SIZE */
+
+#ifndef CY_APP_ADC_SCHED_VREF_SETTLE_TIME
+/** Minimum time in ms between a reference switch and the sample. */
+#define CY_APP_ADC_SCHED_VREF_SETTLE_TIME       (1u)
+#endif /* CY_APP_ADC_SCHED_VREF_SETTLE_TIME */
+
+/** Number of USBPD ADCs per port handled by the scheduler. */
+#define CY_APP_ADC_SCHED_NUM_ADC                (2u)
+
+/** \} group_pmg_app_common_adc_sched_macros */
+
+/*****************************************************************************
+ * Data Struct Definition
+ *****************************************************************************/
+/**
+* \addtogroup group_pmg_app_common_adc_sched_data_structures
+* \{
+*/
+
+/**
+ * @brief Callback which connects the signal to be measured before the settle time starts.
+ *
+ * @param ptrPdStackContext Pointer to the PDStack context
+ * @param cbkContext Context pointer of the request
+ */
+typedef void (*cy_app_adc_setup_cbk_t)(cy_stc_pdstack_context_t *ptrPdStackContext, void *cbkContext);
+
+/**
+ * @brief Callback which receives the result of a sample request.
+ *
+ * @param ptrPdStackContext Pointer to the PDStack context
+ * @param cbkContext Context pointer of the request
+ * @param level ADC level sampled
+ * @param volt Sampled voltage in mV
+ */
+typedef void (*cy_app_adc_result_cbk_t)(cy_stc_pdstack_context_t *ptrPdStackContext, void *cbkContext,
+        uint8_t level, uint16_t volt);
+
+/**
+ * @brief ADC sample request
+ */
+typedef struct
+{
+    cy_en_usbpd_adc_id_t adcId;         /**< ADC to be used. */
+    cy_en_usbpd_adc_input_t input;      /**< ADC input to be sampled. */
+    bool vrefVddd;                      /**< true to sample with VDDD as reference; false for the RefGen reference. */
+    uint8_t settleTime;                 /**< Time in ms from the setup to the sample. */
+    cy_app_adc_setup_cbk_t setup;       /**< Setup callback. Can be NULL. */
+    cy_app_adc_setup_cbk_t release;     /**< Callback which disconnects the signal when a synchronous measurement preempts the request. Can be NULL. */
+    cy_app_adc_result_cbk_t result;     /**< Result callback. Must not be NULL. */
+    void *cbkContext;                   /**< Context pointer passed to the callbacks. */
+} cy_stc_app_adc_req_t;
+
+/** \} group_pmg_app_common_adc_sched_data_structures */
+
+/*****************************************************************************
+ * Global Function Declaration
+ *****************************************************************************/
+/**
+* \addtogroup group_pmg_app_common_adc_sched_functions
+* \{
+*/
+
+/**
+ * @brief Queues a sample request. The request is copied. The callbacks are
+ * invoked from the caller context if the sample can be taken at once, or
+ * from the scheduler timer callback otherwise.
+ *
+ * @param ptrPdStackContext Pointer to the PDStack context of the port
+ * @param req Sample request
+ *
+ * @return CY_APP_STAT_SUCCESS if the request is queued; CY_APP_STAT_BAD_PARAM
+ * if the request is invalid; CY_APP_STAT_BUSY if the queue is full.
+ */
+cy_en_app_status_t Cy_App_AdcSched_Request(cy_stc_pdstack_context_t *ptrPdStackContext,
+        const cy_stc_app_adc_req_t *req);
+
+/**
+ * @brief Checks whether the scheduler of the port has pending requests.
+ *
+ * @param ptrPdStackContext Pointer to the PDStack context of the port
+ *
+ * @return true if a request is pending; false otherwise.
+ */
+bool Cy_App_AdcSched_IsBusy(cy_stc_pdstack_context_t *ptrPdStackContext);
+
+/**
+ * @brief Hands the ADCs of the port over to a synchronous measurement. A
+ * request which waits for its settle time is stopped, its release callback
+ * is invoked and the ADC references are restored. Calls can be nested; each
+ * call has to be followed by Cy_App_AdcSched_Continue.
+ *
+ * @param ptrPdStackContext Pointer to the PDStack context of the port
+ *
+ * @return None
+ */
+void Cy_App_AdcSched_Preempt(cy_stc_pdstack_context_t *ptrPdStackContext);
+
+/**
+ * @brief Ends a synchronous measurement started with Cy_App_AdcSched_Preempt.
+ * A stopped request is set up again and waits for its full settle time.
+ *
+ * @param ptrPdStackContext Pointer to the PDStack context of the port
+ *
+ * @return None
+ */
+void Cy_App_AdcSched_Continue(cy_stc_pdstack_context_t *ptrPdStackContext);
+
+/** \} group_pmg_app_common_adc_sched_functions */
+
+#endif /* (CY_APP_ADC_SCHED_ENABLE || DOXYGEN) */
+
+#endif /* _CY_APP_ADC_SCHED_H_ */
+
+/* [] END OF FILE */
@@ -35,6 +35,25 @@
 
 cy_stc_bc_status_t gl_bc_status[NO_OF_BC_PORTS];
 
+/* Interrupt driven D+/D- handling needs the QC source state machine. */
+#define BC_QC_PULSE_IRQ         (CY_APP_BC_QC_PULSE_IRQ_ENABLE && \
+                                 (!(QC_SRC_AFC_CHARGING_DISABLED || QC_AFC_CHARGING_DISABLED)))
+
+#if BC_QC_PULSE_IRQ
+#if ((CY_APP_BC_QC_EDGE_RING_SIZE & (CY_APP_BC_QC_EDGE_RING_SIZE - 1u)) != 0u)
+#error "CY_APP_BC_QC_EDGE_RING_SIZE must be a power of two."
+#endif
+
+#if (!CY_APP_TIMESTAMP_ENABLE)
+#error "CY_APP_BC_QC_PULSE_IRQ_ENABLE requires CY_APP_TIMESTAMP_ENABLE to time stamp the D+/D- edges."
+#endif
+
+/* D+/D- edges of each port waiting for Cy_App_Bc_Task. */
+static cy_stc_bc_qc_edges_t gl_bc_qc_edges[NO_OF_BC_PORTS];
+
+static void bc_qc_edge_reset(cy_stc_usbpd_context_t *context);
+#endif /* BC_QC_PULSE_IRQ */
+
 #if (!APPLE_SOURCE_DISABLE)
 const uint16_t gl_apple_id_to_cur_map [] = {
     APPLE_AMP_1A,
@@ -891,6 +910,9 @@ static void bc_fsm_src_qc_or_afc(cy_stc_usbpd_context_t *context, cy_en_bc_fsm_e
             /* Not AFC, move to QC detected. */
             (void)Cy_USBPD_Bch_AfcSrcStop(context);
             bc_set_current_mode(context, BC_CHARGE_QC2);
+#if BC_QC_PULSE_IRQ
+            bc_qc_edge_reset(context);
+#endif /* BC_QC_PULSE_IRQ */
             bc_stat->bc_fsm_state = BC_FSM_SRC_QC_CONNECTED;
             Cy_App_Bc_FsmSetEvt(context, BC_EVT_QC_CHANGE);
             break;
@@ -936,6 +958,11 @@ static void bc_fsm_src_qc_connected(cy_stc_usbpd_context_t *context, cy_en_bc_fs
         case BC_FSM_EVT_DISCONNECT:
             /* Detached. */
             (void)Cy_USBPD_Bch_QcSrcContModeStop(context);
+#if BC_QC_PULSE_IRQ
+            Cy_PdUtils_SwTimer_Stop(bc_stat->ptr_timer_ctx,
+                    CY_APP_GET_TIMER_ID(context, CY_APP_BC_QC_PULSE_SETTLE_TIMER));
+            gl_bc_qc_edges[context->port].settle = false;
+#endif /* BC_QC_PULSE_IRQ */
             bc_stat->bc_fsm_state = BC_FSM_SRC_LOOK_FOR_CONNECT;
 
             Cy_App_Bc_FsmSetEvt(context, BC_EVT_ENTRY);
@@ -953,6 +980,11 @@ static void bc_fsm_src_qc_connected(cy_stc_usbpd_context_t *context, cy_en_bc_fs
                 /* Disables Continuous mode operation. */
                 (void)Cy_USBPD_Bch_QcSrcContModeStop(context);
                 Cy_App_Bc_FsmClearEvt(context, BC_EVT_QC_CONT);
+#if BC_QC_PULSE_IRQ
+                Cy_PdUtils_SwTimer_Stop(bc_stat->ptr_timer_ctx,
+                        CY_APP_GET_TIMER_ID(context, CY_APP_BC_QC_PULSE_SETTLE_TIMER));
+                gl_bc_qc_edges[context->port].settle = false;
+#endif /* BC_QC_PULSE_IRQ */
             }
 
             if(bc_stat->dp_dm_status.state != QC_MODE_CONT)
@@ -2123,17 +2155,55 @@ static void bc_fsm_sink_qc_charger_detected(cy_stc_usbpd_context_t * context, cy
 #endif /* QC_AFC_SNK_EN */
 #endif /* (!(CCG_SOURCE_ONLY)) && (!BC_SOURCE_ONLY) */
 
+#if BC_QC_PULSE_IRQ
+/* Buffers a D+/D- edge reported in interrupt context. */
+static void bc_qc_edge_push(cy_stc_usbpd_context_t *context, uint32_t event)
+{
+    cy_stc_bc_qc_edges_t *edges = &gl_bc_qc_edges[context->port];
+    cy_stc_bc_qc_edge_t *edge;
+
+    /* The edges already buffered make the task sample D+/D-; the QC receiver keeps the pulse count. */
+    if ((uint8_t)(edges->wr - edges->rd) >= CY_APP_BC_QC_EDGE_RING_SIZE)
+    {
+        edges->dropped++;
+        return;
+    }
+
+    edge = &edges->edge[edges->wr & (CY_APP_BC_QC_EDGE_RING_SIZE - 1u)];
+    edge->time   = Cy_App_GetTimestamp();
+    edge->evt    = (uint16_t)event;
+    edge->pulses = (int16_t)Cy_USBPD_Bch_Get_QcPulseCount(context);
+    edges->wr++;
+}
+#endif /* BC_QC_PULSE_IRQ */
+
 /* Callbacks from the PDL driver. */
 static void bc_phy_cbk_handler(void *callbackCtx, uint32_t event)
 {
     cy_stc_usbpd_context_t *usbpdcontext = (cy_stc_usbpd_context_t *)callbackCtx;
+
+#if BC_QC_PULSE_IRQ
+    if (gl_bc_status[usbpdcontext->port].bc_fsm_state == BC_FSM_SRC_QC_CONNECTED)
+    {
+        bc_qc_edge_push(usbpdcontext, event);
+
+        /* QC 3.0 pulses are applied by the settle timer once the train ends. */
+        event &= ~(uint32_t)BC_EVT_QC_CONT;
+        if (event == 0u)
+        {
+            return;
+        }
+    }
+#endif /* BC_QC_PULSE_IRQ */
+
     Cy_App_Bc_FsmSetEvt(usbpdcontext, event);
 }
 
 #endif /* (defined(CY_IP_MXUSBPD) || defined(CY_IP_M0S8USBPD)) */
 
 #if (!(QC_SRC_AFC_CHARGING_DISABLED || QC_AFC_CHARGING_DISABLED))
-static void bc_debounce(cy_stc_usbpd_context_t *context)
+/* Samples and debounces DP/DM. Returns true if DP/DM match the debounced state. */
+static bool bc_debounce(cy_stc_usbpd_context_t *context)
 {
     uint32_t i;
     cy_stc_bc_dp_dm_state_t new_state;
@@ -2172,7 +2242,7 @@ static void bc_debounce(cy_stc_usbpd_context_t *context)
     {
         bc_stat->old_dp_dm_status.state = bc_stat->dp_dm_status.state;
         Cy_PdUtils_SwTimer_Stop(bc_stat->ptr_timer_ctx, CY_APP_GET_TIMER_ID(context, CY_APP_BC_DP_DM_DEBOUNCE_TIMER));
-        return;
+        return true;
     }
 
     if(bc_stat->old_dp_dm_status.state != new_state.state)
@@ -2192,11 +2262,11 @@ static void bc_debounce(cy_stc_usbpd_context_t *context)
                                 CY_APP_GET_TIMER_ID(context, CY_APP_BC_DP_DM_DEBOUNCE_TIMER),
                                 CY_APP_BC_DP_DM_DEBOUNCE_TIMER_PERIOD, NULL);
             bc_stat->old_dp_dm_status.state = new_state.state;
-            return;
+            return false;
         }
         if(bc_stat->dp_dm_status.state == QC_MODE_CONT)
         {
-            return;
+            return false;
         }
     }
 
@@ -2220,7 +2290,162 @@ static void bc_debounce(cy_stc_usbpd_context_t *context)
             }
         }
     }
+
+    return false;
+}
+
+/*
+ * Configures the DP/DM comparators to interrupt on a change of the current QC 2.0 mode.
+ * The QC receiver interrupts cover the transitions which the comparators do not.
+ */
+static void bc_qc_config_edge_comps(cy_stc_usbpd_context_t *context)
+{
+    const cy_stc_bc_status_t *bc_stat = &gl_bc_status[context->port];
+
+    switch (bc_stat->dp_dm_status.state)
+    {
+        case (uint16_t)QC_MODE_5V:
+            /* For < 0.6 V transition on DP. */
+            Cy_USBPD_Bch_Phy_Config_Comp(context, BC_CMP_0_IDX, CHGB_COMP_P_DP, CHGB_COMP_N_VREF,
+                  CHGB_VREF_0_325V, CHGB_COMP_EDGE_FALLING);
+            /* For > 0 V transition on DM. */
+            Cy_USBPD_Bch_Phy_Config_Comp(context, BC_CMP_1_IDX, CHGB_COMP_P_DM, CHGB_COMP_N_VREF,
+                  CHGB_VREF_0_325V, CHGB_COMP_EDGE_RISING);
+            /* QCOM RCVR interrupt will be used for > 0.6 V transition on DP. */
+            break;
+
+        case (uint16_t)QC_MODE_9V:
+            /* For < 0.6 V transition on DM. */
+            Cy_USBPD_Bch_Phy_Config_Comp(context, BC_CMP_1_IDX, CHGB_COMP_P_DM, CHGB_COMP_N_VREF,
+                      CHGB_VREF_0_325V, CHGB_COMP_EDGE_FALLING);
+            /*
+             * QCOM RCVR interrupts will be used for < 3.3 V transition on DP
+             * and > 0.6 V transition on DM.
+             */
+            break;
+
+        case (uint16_t)QC_MODE_12V:
+            /* For < 0.6 V transition on DP. */
+            Cy_USBPD_Bch_Phy_Config_Comp(context, BC_CMP_0_IDX, CHGB_COMP_P_DP, CHGB_COMP_N_VREF,
+                      CHGB_VREF_0_325V, CHGB_COMP_EDGE_FALLING);
+             /* For < 0.6 V transition on DM. */
+            Cy_USBPD_Bch_Phy_Config_Comp(context, BC_CMP_1_IDX, CHGB_COMP_P_DM, CHGB_COMP_N_VREF,
+                      CHGB_VREF_0_325V, CHGB_COMP_EDGE_FALLING);
+            /* QCOM RCVR interrupts will be used for > 0.6 V transition on DP and DM. */
+            break;
+
+        case (uint16_t)QC_MODE_20V:
+            /* Nothing to do here because QC RCVR interrupt will detect < 3.3 V
+             * transition on DP and DM. */
+            break;
+
+        case (uint16_t)QC_MODE_CONT:
+            /* For < 0.6 V transition on DP. */
+            Cy_USBPD_Bch_Phy_Config_Comp(context,BC_CMP_0_IDX, CHGB_COMP_P_DP, CHGB_COMP_N_VREF,
+                      CHGB_VREF_0_325V, CHGB_COMP_EDGE_FALLING);
+            /*
+             * QCOM RCVR interrupt will be used for < 3.3 V transition on DM and > 0.6 V
+             * transition on DP.
+             */
+            break;
+
+        default:
+            /* Intentionally left empty. */
+            break;
+    }
+}
+
+#if BC_QC_PULSE_IRQ
+static void bc_qc_pulse_settle_cb(cy_timer_id_t id, void *cbContext)
+{
+    cy_stc_usbpd_context_t *context = (cy_stc_usbpd_context_t *)cbContext;
+    cy_stc_bc_qc_edges_t *edges = &gl_bc_qc_edges[context->port];
+
+    CY_UNUSED_PARAMETER(id);
+
+    if (edges->settle)
+    {
+        /* The pulse train has ended; apply the pulse count batched by the QC receiver. */
+        edges->settle = false;
+        Cy_App_Bc_FsmSetEvt(context, BC_EVT_QC_CONT);
+    }
+    else
+    {
+        /* Fallback poll: sample DP/DM in case an edge interrupt was missed. */
+        edges->dbnc = true;
+    }
+}
+
+/* Consumes the buffered D+/D- edges. Returns true if DP/DM have to be sampled. */
+static bool bc_qc_edge_drain(cy_stc_usbpd_context_t *context)
+{
+    cy_stc_bc_status_t *bc_stat = &gl_bc_status[context->port];
+    cy_stc_bc_qc_edges_t *edges = &gl_bc_qc_edges[context->port];
+    const cy_stc_bc_qc_edge_t *edge;
+    bool pulse = false;
+    bool train = edges->settle;
+    uint32_t gap;
+    uint8_t rd;
+
+    for (rd = edges->rd; rd != edges->wr; rd++)
+    {
+        edge = &edges->edge[rd & (CY_APP_BC_QC_EDGE_RING_SIZE - 1u)];
+        if ((edge->evt & BC_EVT_QC_CONT) != 0u)
+        {
+            /* Time from the previous pulse edge of the same train. */
+            if (train)
+            {
+                gap = CY_APP_TIMESTAMP_DIFF(edges->last_pulse, edge->time);
+                if (gap < edges->min_gap)
+                {
+                    edges->min_gap = (uint16_t)gap;
+                }
+            }
+            edges->last_pulse = edge->time;
+            train = true;
+            pulse = true;
+        }
+        edges->dbnc = true;
+    }
+    edges->rd = rd;
+
+    /* Restart the settle time on each pulse so that a train is applied at once. */
+    if ((pulse) && (bc_stat->dp_dm_status.state == QC_MODE_CONT))
+    {
+        edges->settle = true;
+        Cy_PdUtils_SwTimer_Start(bc_stat->ptr_timer_ctx, (void *)context,
+                CY_APP_GET_TIMER_ID(context, CY_APP_BC_QC_PULSE_SETTLE_TIMER),
+                CY_APP_BC_QC_PULSE_SETTLE_PERIOD, bc_qc_pulse_settle_cb);
+    }
+
+    return edges->dbnc;
+}
+
+/* Restarts the edge buffering of the port, with DP/DM sampled until they are stable. */
+static void bc_qc_edge_reset(cy_stc_usbpd_context_t *context)
+{
+    cy_stc_bc_qc_edges_t *edges = &gl_bc_qc_edges[context->port];
+
+    Cy_PdUtils_SwTimer_Stop(gl_bc_status[context->port].ptr_timer_ctx,
+            CY_APP_GET_TIMER_ID(context, CY_APP_BC_QC_PULSE_SETTLE_TIMER));
+    edges->rd = edges->wr;
+    edges->dbnc = true;
+    edges->settle = false;
+    edges->min_gap = 0xFFFFu;
 }
+
+/* Arms the edge interrupts. Returns false if DP/DM changed before they were armed. */
+static bool bc_qc_arm_edges(cy_stc_usbpd_context_t *context)
+{
+    const cy_stc_bc_status_t *bc_stat = &gl_bc_status[context->port];
+
+    Cy_USBPD_Bch_QcSrcMasterSenseEn(context);
+    bc_qc_config_edge_comps(context);
+
+    return ((Cy_USBPD_Bch_Phy_DpStat(context) == (bc_stat->dp_dm_status.d[0] == (uint8_t)BC_D_3_3V)) &&
+            (Cy_USBPD_Bch_Phy_DmStat(context) == (bc_stat->dp_dm_status.d[1] == (uint8_t)BC_D_3_3V)));
+}
+#endif /* BC_QC_PULSE_IRQ */
 #endif /* (!QC_AFC_CHARGING_DISABLED) */
 
 #if QC_AFC_SNK_EN
@@ -2245,6 +2470,7 @@ cy_en_usbpd_status_t Cy_App_Bc_Init(cy_stc_usbpd_context_t *context, cy_stc_pdut
             stat = CY_USBPD_STAT_SUCCESS;
             bc_stat->bc_fsm_state = BC_FSM_OFF;
             bc_stat->bc_evt       = 0u;
+            bc_stat->evt_hwm      = 0u;
         }
 #if QC_AFC_SNK_EN
         bc_stat->max_volt = BC_QC_AFC_SNK_MAX_VOLT;
@@ -2330,6 +2556,10 @@ cy_en_usbpd_status_t Cy_App_Bc_Stop(cy_stc_usbpd_context_t *context)
     Cy_PdUtils_SwTimer_StopRange(bc_stat->ptr_timer_ctx,
             CY_APP_GET_TIMER_ID(context, CY_APP_BC_GENERIC_TIMER1),
             CY_APP_GET_TIMER_ID(context, CY_APP_CDP_DP_DM_POLL_TIMER));
+#if BC_QC_PULSE_IRQ
+    Cy_PdUtils_SwTimer_Stop(bc_stat->ptr_timer_ctx, CY_APP_GET_TIMER_ID(context, CY_APP_BC_QC_PULSE_SETTLE_TIMER));
+    gl_bc_qc_edges[context->port].settle = false;
+#endif /* BC_QC_PULSE_IRQ */
     Cy_USBPD_Bch_Phy_Dis(context);
 
     bc_stat->bc_fsm_state = BC_FSM_OFF;
@@ -2389,6 +2619,7 @@ cy_en_usbpd_status_t Cy_App_Bc_Task(cy_stc_usbpd_context_t *context)
 {
 #if (defined(CY_IP_MXUSBPD) || defined(CY_IP_M0S8USBPD))
     cy_stc_bc_status_t* bc_stat = &gl_bc_status[context->port];
+    uint8_t budget;
     uint8_t evt;
 
 #if CCG_TYPE_A_PORT_ENABLE
@@ -2403,18 +2634,47 @@ cy_en_usbpd_status_t Cy_App_Bc_Task(cy_stc_usbpd_context_t *context)
     }
 
 #if (!(QC_SRC_AFC_CHARGING_DISABLED || QC_AFC_CHARGING_DISABLED))
+#if BC_QC_PULSE_IRQ
+    if (bc_stat->bc_fsm_state == BC_FSM_SRC_QC_CONNECTED)
+    {
+        /* DP/DM are sampled after an edge until they are stable, and the edge interrupts are re-armed. */
+        if ((bc_qc_edge_drain(context)) && (bc_debounce(context)) && (bc_qc_arm_edges(context)))
+        {
+            gl_bc_qc_edges[context->port].dbnc = false;
+        }
+
+        /* While awake, DP/DM are also sampled at a slow rate in case an edge interrupt was missed. */
+        if (!Cy_PdUtils_SwTimer_IsRunning(bc_stat->ptr_timer_ctx,
+                    CY_APP_GET_TIMER_ID(context, CY_APP_BC_QC_PULSE_SETTLE_TIMER)))
+        {
+            Cy_PdUtils_SwTimer_Start(bc_stat->ptr_timer_ctx, (void *)context,
+                    CY_APP_GET_TIMER_ID(context, CY_APP_BC_QC_PULSE_SETTLE_TIMER),
+                    CY_APP_BC_QC_FALLBACK_POLL_PERIOD, bc_qc_pulse_settle_cb);
+        }
+    }
+    else
+#endif /* BC_QC_PULSE_IRQ */
     if((bc_stat->bc_fsm_state == BC_FSM_SRC_QC_OR_AFC) || (bc_stat->bc_fsm_state == BC_FSM_SRC_QC_CONNECTED)
         || (bc_stat->bc_fsm_state == BC_FSM_SRC_AFC_CONNECTED))
     {
-        bc_debounce(context);
+        (void)bc_debounce(context);
     }
 #endif /* (!(QC_SRC_AFC_CHARGING_DISABLED || QC_AFC_CHARGING_DISABLED)) */
 
-    /* Gets the next event to be processed. */
-    evt = Cy_PdUtils_EventGroup_GetEvent((uint32_t *)&(bc_stat->bc_evt), true);
-
-    if (evt < BC_FSM_MAX_EVTS)
+    /*
+     * Process the pending events, lowest event number first, including those
+     * raised by the transitions themselves, up to the budget for this call.
+     */
+    for (budget = CY_APP_BC_EVT_BUDGET; budget != 0u; budget--)
     {
+        /* Gets the next event to be processed. */
+        evt = Cy_PdUtils_EventGroup_GetEvent((uint32_t *)&(bc_stat->bc_evt), true);
+
+        if (evt >= BC_FSM_MAX_EVTS)
+        {
+            break;
+        }
+
         /* Calls the FSM handler function if a valid event exists. */
         bc_fsm_table[bc_stat->bc_fsm_state](context, (cy_en_bc_fsm_evt_t)evt);
     }
@@ -2462,6 +2722,19 @@ bool Cy_App_Bc_PrepareDeepSleep(cy_stc_usbpd_context_t *context)
         return false;
     }
 
+#if BC_QC_PULSE_IRQ
+    /* Sleep between the pulse trains once the edges are consumed and DP/DM are stable. */
+    if ((gl_bc_qc_edges[context->port].settle) ||
+        ((bc_stat->bc_fsm_state == BC_FSM_SRC_QC_CONNECTED) &&
+         ((gl_bc_qc_edges[context->port].dbnc) || (gl_bc_qc_edges[context->port].rd != gl_bc_qc_edges[context->port].wr))))
+    {
+        return false;
+    }
+
+    /* The edge interrupts wake the device; the fallback poll only runs while awake. */
+    Cy_PdUtils_SwTimer_Stop(bc_stat->ptr_timer_ctx, CY_APP_GET_TIMER_ID(context, CY_APP_BC_QC_PULSE_SETTLE_TIMER));
+#endif /* BC_QC_PULSE_IRQ */
+
 #if (!(QC_SRC_AFC_CHARGING_DISABLED || QC_AFC_CHARGING_DISABLED))
     if (bc_stat->bc_fsm_state == BC_FSM_SRC_AFC_CONNECTED)
     {
@@ -2502,57 +2775,7 @@ bool Cy_App_Bc_PrepareDeepSleep(cy_stc_usbpd_context_t *context)
         if ((bc_stat->bc_fsm_state == BC_FSM_SRC_QC_OR_AFC) ||
             (bc_stat->bc_fsm_state == BC_FSM_SRC_QC_CONNECTED))
         {
-            switch (bc_stat->dp_dm_status.state)
-            {
-                case (uint16_t)QC_MODE_5V:
-                    /* For < 0.6 V transition on DP. */
-                    Cy_USBPD_Bch_Phy_Config_Comp(context, BC_CMP_0_IDX, CHGB_COMP_P_DP, CHGB_COMP_N_VREF,
-                          CHGB_VREF_0_325V, CHGB_COMP_EDGE_FALLING);
-                    /* For > 0 V transition on DM. */
-                    Cy_USBPD_Bch_Phy_Config_Comp(context, BC_CMP_1_IDX, CHGB_COMP_P_DM, CHGB_COMP_N_VREF,
-                          CHGB_VREF_0_325V, CHGB_COMP_EDGE_RISING);
-                    /* QCOM RCVR interrupt will be used for > 0.6 V transition on DP. */
-                    break;
-
-                case (uint16_t)QC_MODE_9V:
-                    /* For < 0.6 V transition on DM. */
-                    Cy_USBPD_Bch_Phy_Config_Comp(context, BC_CMP_1_IDX, CHGB_COMP_P_DM, CHGB_COMP_N_VREF,
-                              CHGB_VREF_0_325V, CHGB_COMP_EDGE_FALLING);
-                    /*
-                     * QCOM RCVR interrupts will be used for < 3.3 V transition on DP
-                     * and > 0.6 V transition on DM.
-                     */
-                    break;
-
-                case (uint16_t)QC_MODE_12V:
-                    /* For < 0.6 V transition on DP. */
-                    Cy_USBPD_Bch_Phy_Config_Comp(context, BC_CMP_0_IDX, CHGB_COMP_P_DP, CHGB_COMP_N_VREF,
-                              CHGB_VREF_0_325V, CHGB_COMP_EDGE_FALLING);
-                     /* For < 0.6 V transition on DM. */
-                    Cy_USBPD_Bch_Phy_Config_Comp(context, BC_CMP_1_IDX, CHGB_COMP_P_DM, CHGB_COMP_N_VREF,
-                              CHGB_VREF_0_325V, CHGB_COMP_EDGE_FALLING);
-                    /* QCOM RCVR interrupts will be used for > 0.6 V transition on DP and DM. */
-                    break;
-
-                case (uint16_t)QC_MODE_20V:
-                    /* Nothing to do here because QC RCVR interrupt will detect < 3.3 V
-                     * transition on DP and DM. */
-                    break;
-
-                case (uint16_t)QC_MODE_CONT:
-                    /* For < 0.6 V transition on DP. */
-                    Cy_USBPD_Bch_Phy_Config_Comp(context,BC_CMP_0_IDX, CHGB_COMP_P_DP, CHGB_COMP_N_VREF,
-                              CHGB_VREF_0_325V, CHGB_COMP_EDGE_FALLING);
-                    /*
-                     * QCOM RCVR interrupt will be used for < 3.3 V transition on DM and > 0.6 V
-                     * transition on DP.
-                     */
-                    break;
-
-                default:
-                    /* Intentionally left empty. */
-                    break;
-            }
+            bc_qc_config_edge_comps(context);
         }
 #endif /* (!(QC_SRC_AFC_CHARGING_DISABLED || QC_AFC_CHARGING_DISABLED)) */
 
@@ -2580,6 +2803,10 @@ void Cy_App_Bc_Resume(cy_stc_usbpd_context_t *context)
         Cy_App_Bc_FsmClearEvt(context, BC_EVT_CMP1_FIRE);
         Cy_USBPD_Bch_Phy_DisableComp(context, BC_CMP_1_IDX);
         Cy_App_Bc_FsmClearEvt(context, BC_EVT_CMP2_FIRE);
+#if BC_QC_PULSE_IRQ
+        /* The comparators are off; sample DP/DM until the edge interrupts are re-armed. */
+        gl_bc_qc_edges[context->port].dbnc = true;
+#endif /* BC_QC_PULSE_IRQ */
     }
 #endif /* (!(QC_SRC_AFC_CHARGING_DISABLED || QC_AFC_CHARGING_DISABLED)) */
     Cy_USBPD_Bch_Phy_Config_Wakeup(context);
@@ -2592,6 +2819,13 @@ const cy_stc_bc_status_t* Cy_App_Bc_GetStatus(cy_stc_usbpd_context_t *context)
     return ((const cy_stc_bc_status_t *)bc_stat);
 }
 
+#if BC_QC_PULSE_IRQ
+const cy_stc_bc_qc_edges_t* Cy_App_Bc_GetQcEdges(cy_stc_usbpd_context_t *context)
+{
+    return ((const cy_stc_bc_qc_edges_t *)&gl_bc_qc_edges[context->port]);
+}
+#endif /* BC_QC_PULSE_IRQ */
+
 void Cy_App_Bc_PdEventHandler(cy_stc_usbpd_context_t *context, cy_en_pdstack_app_evt_t evt, const void* dat)
 {
     CY_UNUSED_PARAMETER(dat);
@@ -2705,8 +2939,18 @@ void Cy_App_Bc_PdEventHandler(cy_stc_usbpd_context_t *context, cy_en_pdstack_app
 void Cy_App_Bc_FsmSetEvt(cy_stc_usbpd_context_t *context, uint32_t evt_mask)
 {
     cy_stc_bc_status_t *bc_stat = &gl_bc_status[context->port];
+    uint32_t pending;
+    uint8_t depth = 0u;
+
     bc_stat->bc_evt |= evt_mask;
 
+    /* Track the largest number of events pending at once, including those raised while a batch is processed */
+    for (pending = bc_stat->bc_evt; pending != 0u; pending &= (pending - 1u))
+    {
+        depth++;
+    }
+    bc_stat->evt_hwm = CY_PDUTILS_GET_MAX(bc_stat->evt_hwm, depth);
+
 #if CY_APP_RTOS_ENABLED
     /* USBPD context is typecasted to PDStack context because Type-A port
      * does not have PDStack context and Cy_App_SendRtosEvent uses only the port
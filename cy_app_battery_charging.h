@@ -26,6 +26,7 @@
 #include "cy_usbpd_bch.h"
 #include "cy_pdstack_common.h"
 #include "cy_pdutils_sw_timer.h"
+#include "cy_app_config.h"
 
 /**
 * \addtogroup group_pmg_app_common_bch
@@ -124,6 +125,27 @@
 * \{
 */
 
+#ifndef CY_APP_BC_EVT_BUDGET
+/** Maximum number of state machine events processed by one Cy_App_Bc_Task call. */
+#define CY_APP_BC_EVT_BUDGET            (4u)
+#endif /* CY_APP_BC_EVT_BUDGET */
+
+#ifndef CY_APP_BC_QC_EDGE_RING_SIZE
+/** Number of D+/D- edges buffered between Cy_App_Bc_Task calls. Must be a power of two. */
+#define CY_APP_BC_QC_EDGE_RING_SIZE     (8u)
+#endif /* CY_APP_BC_QC_EDGE_RING_SIZE */
+
+#ifndef CY_APP_BC_QC_PULSE_SETTLE_PERIOD
+/** Time in ms without QC 3.0 pulses after which a pulse train is applied. */
+#define CY_APP_BC_QC_PULSE_SETTLE_PERIOD (2u)
+#endif /* CY_APP_BC_QC_PULSE_SETTLE_PERIOD */
+
+#ifndef CY_APP_BC_QC_FALLBACK_POLL_PERIOD
+/** Period in ms at which D+/D- of a connected QC sink are sampled while the
+ * device is awake, in case an edge interrupt was missed. */
+#define CY_APP_BC_QC_FALLBACK_POLL_PERIOD (100u)
+#endif /* CY_APP_BC_QC_FALLBACK_POLL_PERIOD */
+
 #define AFC_DETECT_RETRY_COUNT          (6)     /**< AFC detect retry count. */
 #define AFC_WAIT_DM_RETRY_COUNT         (10)    /**< AFC wait retry count. */
 
@@ -327,8 +349,36 @@ typedef struct {
     uint8_t afc_retry_count;                    /**< Sink Tx retries counter. */
 
     bool attach;                                /**< Whether charger attach has been detected. */
+    uint8_t evt_hwm;                            /**< Largest number of events pending at once. */
 } cy_stc_bc_status_t;
 
+/**
+ * @brief D+/D- edge reported by an interrupt while a QC sink is connected.
+ */
+typedef struct
+{
+    uint32_t time;                              /**< Time stamp of the edge in us from Cy_App_GetTimestamp. */
+    uint16_t evt;                               /**< Event mask reported by the BC PHY. */
+    int16_t pulses;                             /**< Net QC 3.0 pulse count pending at the edge. */
+} cy_stc_bc_qc_edge_t;
+
+/**
+ * @brief Ring of the D+/D- edges of a port, filled by the BC PHY callback and
+ * drained by Cy_App_Bc_Task.
+ */
+typedef struct
+{
+    cy_stc_bc_qc_edge_t edge[CY_APP_BC_QC_EDGE_RING_SIZE];  /**< Buffered edges. */
+    uint8_t volatile wr;                        /**< Count of edges written. */
+    uint8_t volatile rd;                        /**< Count of edges read. */
+    uint8_t volatile dropped;                   /**< Count of edges lost on a full ring. */
+    uint16_t min_gap;                           /**< Shortest time in us between two QC 3.0 pulse edges;
+                                                     0xFFFF if none has been seen since connect. */
+    uint32_t last_pulse;                        /**< Time stamp of the last QC 3.0 pulse edge consumed. */
+    bool dbnc;                                  /**< D+/D- are sampled until they are stable again. */
+    bool settle;                                /**< A QC 3.0 pulse train is waiting to be applied. */
+} cy_stc_bc_qc_edges_t;
+
 /** \} group_pmg_app_common_bch_data_structures */
 
 /*******************************************************************************
@@ -379,7 +429,8 @@ bool Cy_App_Bc_IsActive(cy_stc_usbpd_context_t *context);
 
 /**
  * @brief This function performs actions associated with the battery charging state
- * machine and is expected to be called from the application main.
+ * machine and is expected to be called from the application main. Up to
+ * CY_APP_BC_EVT_BUDGET pending events are processed per call.
  *
  * @param context Pointer to USBPD context.
  * @return cy_en_usbpd_status_t
@@ -412,6 +463,17 @@ void Cy_App_Bc_Resume(cy_stc_usbpd_context_t *context);
  */
 const cy_stc_bc_status_t* Cy_App_Bc_GetStatus(cy_stc_usbpd_context_t *context);
 
+#if (CY_APP_BC_QC_PULSE_IRQ_ENABLE || DOXYGEN)
+/**
+ * @brief This function retrieves the ring of time stamped D+/D- edges of a
+ * connected QC sink, including the edges already consumed.
+ *
+ * @param context Pointer to USBPD context.
+ * @return Pointer to the edge ring. The structure must not be modified by the caller.
+ */
+const cy_stc_bc_qc_edges_t* Cy_App_Bc_GetQcEdges(cy_stc_usbpd_context_t *context);
+#endif /* (CY_APP_BC_QC_PULSE_IRQ_ENABLE || DOXYGEN) */
+
 /**
  * @brief This function updates the battery charging state machine based on event notifications
  * from the USB PDStack. This event handler calls the Cy_App_Bc_Start and Cy_App_Bc_Stop functions
@@ -53,6 +53,25 @@
 #ifndef CY_PD_FRS_TX_ENABLE
 #define CY_PD_FRS_TX_ENABLE                                     (0u)
 #endif /* CY_PD_FRS_TX_ENABLE */
+
+#ifndef CY_APP_FRS_RX_FAST_PATH_ENABLE
+/** Enable switching of the power path directly from the FRS signal detect
+ * callback, with the source path prepared while an FRS capable contract is
+ * active. Requires CY_PD_FRS_RX_ENABLE. */
+#define CY_APP_FRS_RX_FAST_PATH_ENABLE                          (0u)
+#endif /* CY_APP_FRS_RX_FAST_PATH_ENABLE */
+
+#ifndef CY_APP_FRS_VSAFE5V_MARGIN
+/** Margin in percent above 5 V below which VBUS counts as vSafe5V and the
+ * provider FET may be turned on after an FRS signal. */
+#define CY_APP_FRS_VSAFE5V_MARGIN                               (10)
+#endif /* CY_APP_FRS_VSAFE5V_MARGIN */
+
+#ifndef CY_APP_FRS_VSAFE5V_POLL_COUNT
+/** Number of 1 ms polls for VBUS to reach vSafe5V after an FRS signal. The
+ * PD stack turns the source on once the swap completes if VBUS stays high. */
+#define CY_APP_FRS_VSAFE5V_POLL_COUNT                           (10u)
+#endif /* CY_APP_FRS_VSAFE5V_POLL_COUNT */
 #endif /* CY_PD_REV3_ENABLE */
 /** @endcond */
 
@@ -61,10 +80,47 @@
  * 0: Pick the source PDO which delivers maximum amount of power
  * 1: Pick the fixed source PDO which delivers maximum amount of power
  * 2: Pick the fixed source PDO which delivers the maximum current
- * 3: Pick the fixed source PDO which delivers power at maximum voltage */
+ * 3: Pick the fixed source PDO which delivers power at maximum voltage
+ * This selects the default policy; it can be changed at runtime using Cy_App_Pdo_SetPolicy(). */
 #define CY_APP_PD_PDO_SEL_ALGO                                  (0u)
 #endif /* CY_APP_PD_PDO_SEL_ALGO */
 
+#ifndef CY_APP_PDO_EVAL_CACHE_ENABLE
+/** Enable caching of source capability evaluation results, so that source
+ * capabilities re-advertised by the same partner are not evaluated again. */
+#define CY_APP_PDO_EVAL_CACHE_ENABLE                            (0u)
+#endif /* CY_APP_PDO_EVAL_CACHE_ENABLE */
+
+#ifndef CY_APP_RDO_LIMIT_CACHE_ENABLE
+/** Enable validation of requests received as a source against precomputed
+ * limits of the advertised source PDOs. */
+#define CY_APP_RDO_LIMIT_CACHE_ENABLE                           (0u)
+#endif /* CY_APP_RDO_LIMIT_CACHE_ENABLE */
+
+#ifndef CY_APP_PROT_THRESHOLD_CACHE_ENABLE
+/** Enable a per-port table of the OCP thresholds of the advertised source PDOs,
+ * so that the source current limit is programmed without recomputing it on
+ * each contract. */
+#define CY_APP_PROT_THRESHOLD_CACHE_ENABLE                      (0u)
+#endif /* CY_APP_PROT_THRESHOLD_CACHE_ENABLE */
+
+#ifndef CY_APP_PPS_SNK_ENABLE
+/** Enable selection of SPR PPS APDOs when operating as a sink. Requires a PPS
+ * APDO in the sink capabilities. */
+#define CY_APP_PPS_SNK_ENABLE                                   (0u)
+#endif /* CY_APP_PPS_SNK_ENABLE */
+
+#ifndef CY_APP_PARTNER_CACHE_ENABLE
+/** Enable the flash-backed cache of partner contracts and swap/EPR outcomes. */
+#define CY_APP_PARTNER_CACHE_ENABLE                             (0u)
+#endif /* CY_APP_PARTNER_CACHE_ENABLE */
+
+#ifndef CY_APP_PARTNER_FLAG_RETRY_COUNT
+/** Number of connections of a cached partner on which a recorded swap reject or
+ * EPR failure is honoured. The attempt is retried on the next connection. */
+#define CY_APP_PARTNER_FLAG_RETRY_COUNT                         (8u)
+#endif /* CY_APP_PARTNER_FLAG_RETRY_COUNT */
+
 /** @cond DOXYGEN_HIDE */
 #define CY_APP_REGULATOR_REQUIRE_STABLE_ON_TIME                 (0)
 #define REGULATOR_ENABLE(port)                                  false
@@ -110,6 +166,46 @@
 #define CY_APP_SINK_FET_CTRL_GPIO_EN                            (0u)
 #endif /* CY_APP_SINK_FET_CTRL_GPIO_EN */
 
+#ifndef CY_APP_SNK_FAULT_CONFIRM_ENABLE
+/** Enable confirmation of sink UVP comparator trips by VBUS ADC samples taken
+ * after the trip. Trips which are not confirmed are counted and ignored. */
+#define CY_APP_SNK_FAULT_CONFIRM_ENABLE                         (0u)
+#endif /* CY_APP_SNK_FAULT_CONFIRM_ENABLE */
+
+#ifndef CY_APP_SNK_FAULT_CONFIRM_SAMPLES
+/** Maximum number of VBUS samples taken to confirm a sink UVP comparator trip */
+#define CY_APP_SNK_FAULT_CONFIRM_SAMPLES                        (5u)
+#endif /* CY_APP_SNK_FAULT_CONFIRM_SAMPLES */
+
+#ifndef CY_APP_SNK_FAULT_CONFIRM_MIN
+/** Number of samples below the fault threshold which confirm the trip; must
+ * not exceed CY_APP_SNK_FAULT_CONFIRM_SAMPLES */
+#define CY_APP_SNK_FAULT_CONFIRM_MIN                            (3u)
+#endif /* CY_APP_SNK_FAULT_CONFIRM_MIN */
+
+#ifndef CY_APP_SNK_FAULT_CONFIRM_INTERVAL
+/** Time in ms between the trip and the first sample, and between two samples */
+#define CY_APP_SNK_FAULT_CONFIRM_INTERVAL                       (1u)
+#endif /* CY_APP_SNK_FAULT_CONFIRM_INTERVAL */
+
+#ifndef CY_APP_FAULT_BACKOFF_ENABLE
+/** Enable recovery policies per fault type, with an exponential backoff
+ * before each recovery and decay of the fault counts during stable contracts */
+#define CY_APP_FAULT_BACKOFF_ENABLE                             (0u)
+#endif /* CY_APP_FAULT_BACKOFF_ENABLE */
+
+#ifndef CY_APP_FAULT_RECORD_ENABLE
+/** Enable a RAM ring of records of each fault, with the contract and VBUS at
+ * the time of the fault and the recovery action taken */
+#define CY_APP_FAULT_RECORD_ENABLE                              (0u)
+#endif /* CY_APP_FAULT_RECORD_ENABLE */
+
+#ifndef CY_APP_FAULT_RECORD_FLASH_ENABLE
+/** Enable batched writes of the latest fault records to flash. Requires
+ * CY_APP_FAULT_RECORD_ENABLE. */
+#define CY_APP_FAULT_RECORD_FLASH_ENABLE                        (0u)
+#endif /* CY_APP_FAULT_RECORD_FLASH_ENABLE */
+
 /*******************************************************************************
  * VBUS monitor configuration
  ******************************************************************************/
@@ -130,16 +226,185 @@
 #define CY_APP_VBUS_DISCHARGE_TO_5V_MARGIN                      (10)
 #endif /* CY_APP_VBUS_DISCHARGE_TO_5V_MARGIN */
 
+#ifndef CY_APP_VBUS_DISCHARGE_CTRL_ENABLE
+/** Set to '1' to poll VBUS during discharge at a rate that follows its slope
+ * and to record the discharge time. The discharge timers remain the upper bound. */
+#define CY_APP_VBUS_DISCHARGE_CTRL_ENABLE                       (0u)
+#endif /* CY_APP_VBUS_DISCHARGE_CTRL_ENABLE */
+
+#ifndef CY_APP_VBUS_DISCHARGE_POLL_MIN
+/** Minimum VBUS poll period in ms during discharge */
+#define CY_APP_VBUS_DISCHARGE_POLL_MIN                          (1u)
+#endif /* CY_APP_VBUS_DISCHARGE_POLL_MIN */
+
+#ifndef CY_APP_VBUS_DISCHARGE_POLL_MAX
+/** Maximum VBUS poll period in ms during discharge */
+#define CY_APP_VBUS_DISCHARGE_POLL_MAX                          (4u)
+#endif /* CY_APP_VBUS_DISCHARGE_POLL_MAX */
+
+#ifndef CY_APP_VBUS_DISCHARGE_VSAFE0V_MAX
+/** Discharge target in mV used when the computed target is below it, such as
+ * for a discharge to vSafe0V. Defaults to the vSafe0V maximum of the USB PD spec. */
+#define CY_APP_VBUS_DISCHARGE_VSAFE0V_MAX                       (800u)
+#endif /* CY_APP_VBUS_DISCHARGE_VSAFE0V_MAX */
+
 #ifndef CY_APP_VBUS_NEW_VALID_MARGIN
 /** Allowed margin over expected voltage (as percentage) */
 #define CY_APP_VBUS_NEW_VALID_MARGIN                            (5)
 #endif /* CY_APP_VBUS_NEW_VALID_MARGIN */
 
+#ifndef CY_APP_VBUS_RAMP_MONITOR_ENABLE
+/** Enable measurement based tracking of source voltage transitions. Once VBUS
+ * has crossed the transition threshold, PS_RDY is signalled as soon as VBUS has
+ * settled within CY_APP_VBUS_NEW_VALID_MARGIN of the new voltage, instead of
+ * after the fixed CY_APP_PSOURCE_EN_HYS_TIMER_PERIOD delay. The EPR AVS
+ * hysteresis is not shortened. */
+#define CY_APP_VBUS_RAMP_MONITOR_ENABLE                         (0u)
+#endif /* CY_APP_VBUS_RAMP_MONITOR_ENABLE */
+
+#ifndef CY_APP_VBUS_RAMP_SAMPLE_PERIOD
+/** Period in ms of VBUS measurements during a source voltage transition */
+#define CY_APP_VBUS_RAMP_SAMPLE_PERIOD                          (1u)
+#endif /* CY_APP_VBUS_RAMP_SAMPLE_PERIOD */
+
+#ifndef CY_APP_VBUS_RAMP_STABLE_COUNT
+/** Number of consecutive measurements within the valid window after which
+ * VBUS is considered settled */
+#define CY_APP_VBUS_RAMP_STABLE_COUNT                           (3u)
+#endif /* CY_APP_VBUS_RAMP_STABLE_COUNT */
+
+#ifndef CY_APP_ADC_CAL_CACHE_ENABLE
+/** Enable reuse of the ADC calibration by Cy_App_VbusIsPresent. The ADC is
+ * recalibrated on first use, after deep sleep, after reference changes
+ * signalled through Cy_App_AdcCalInvalidate and once the calibration is
+ * older than CY_APP_ADC_CAL_MAX_AGE. */
+#define CY_APP_ADC_CAL_CACHE_ENABLE                             (0u)
+#endif /* CY_APP_ADC_CAL_CACHE_ENABLE */
+
+#ifndef CY_APP_ADC_CAL_MAX_AGE
+/** Time in ms after which a cached ADC calibration is discarded */
+#define CY_APP_ADC_CAL_MAX_AGE                                  (1000u)
+#endif /* CY_APP_ADC_CAL_MAX_AGE */
+
+#ifndef CY_APP_ADC_SCHED_ENABLE
+/** Set to '1' to serve application ADC measurements through the ADC scheduler.
+ * The SBU moisture detection then waits for its settle times using a timer
+ * instead of busy-wait delays inside a critical section. */
+#define CY_APP_ADC_SCHED_ENABLE                                 (0u)
+#endif /* CY_APP_ADC_SCHED_ENABLE */
+
+#ifndef CY_APP_TELEMETRY_ENABLE
+/** Set to '1' to enable periodic VBUS and IBUS telemetry sampling on attached ports */
+#define CY_APP_TELEMETRY_ENABLE                                 (0u)
+#endif /* CY_APP_TELEMETRY_ENABLE */
+
+#ifndef CY_APP_TELEMETRY_IBUS_ENABLE
+/** Set to '1' to include VBUS current in the telemetry. Requires the current
+ * sense amplifier of the device to be configured. */
+#define CY_APP_TELEMETRY_IBUS_ENABLE                            (0u)
+#endif /* CY_APP_TELEMETRY_IBUS_ENABLE */
+
+#ifndef CY_APP_SINK_ENERGY_ENABLE
+/** Set to '1' to account the energy drawn by sink ports per contract and per
+ * source type */
+#define CY_APP_SINK_ENERGY_ENABLE                               (0u)
+#endif /* CY_APP_SINK_ENERGY_ENABLE */
+
+#ifndef CY_APP_SINK_ENERGY_IBUS_ENABLE
+/** Set to '1' to account the measured VBUS x IBUS energy from the telemetry
+ * sampler instead of the energy of the negotiated set points. Requires
+ * CY_APP_TELEMETRY_ENABLE and CY_APP_TELEMETRY_IBUS_ENABLE. */
+#define CY_APP_SINK_ENERGY_IBUS_ENABLE                          (0u)
+#endif /* CY_APP_SINK_ENERGY_IBUS_ENABLE */
+
+#ifndef CY_APP_SINK_ENERGY_PERIOD
+/** Integration period in ms of the sink energy accounting */
+#define CY_APP_SINK_ENERGY_PERIOD                               (1000u)
+#endif /* CY_APP_SINK_ENERGY_PERIOD */
+
+#ifndef CY_APP_THERMAL_DERATE_ENABLE
+/** Set to '1' to derate the advertised source capabilities of the ports in
+ * steps as their temperature rises */
+#define CY_APP_THERMAL_DERATE_ENABLE                            (0u)
+#endif /* CY_APP_THERMAL_DERATE_ENABLE */
+
+#ifndef CY_APP_TIMESTAMP_ENABLE
+/** Set to '1' to read a microsecond time stamp with Cy_App_GetTimestamp from
+ * a free running TCPWM counter. The solution configures the counter to count
+ * up at 1 MHz over its full range and starts it before Cy_App_Init. */
+#define CY_APP_TIMESTAMP_ENABLE                                 (0u)
+#endif /* CY_APP_TIMESTAMP_ENABLE */
+
+#ifndef CY_APP_TIMESTAMP_TCPWM_HW
+/** TCPWM block of the time stamp counter */
+#define CY_APP_TIMESTAMP_TCPWM_HW                               (TCPWM)
+#endif /* CY_APP_TIMESTAMP_TCPWM_HW */
+
+#ifndef CY_APP_TIMESTAMP_TCPWM_NUM
+/** Number of the time stamp counter in the TCPWM block */
+#define CY_APP_TIMESTAMP_TCPWM_NUM                              (0u)
+#endif /* CY_APP_TIMESTAMP_TCPWM_NUM */
+
+#ifndef CY_APP_TIMESTAMP_MASK
+/** Range of the time stamp counter. The 16-bit TCPWM counters wrap after
+ * 65.536 ms. */
+#define CY_APP_TIMESTAMP_MASK                                   (0xFFFFu)
+#endif /* CY_APP_TIMESTAMP_MASK */
+
+#ifndef CY_APP_BC_QC_PULSE_IRQ_ENABLE
+/** Set to '1' to handle the D+/D- changes of a connected QC sink from the
+ * comparator and QC receiver interrupts instead of sampling D+/D- in each
+ * Cy_App_Bc_Task call. QC 3.0 pulse trains are applied once they have settled. */
+#define CY_APP_BC_QC_PULSE_IRQ_ENABLE                           (0u)
+#endif /* CY_APP_BC_QC_PULSE_IRQ_ENABLE */
+
 #ifndef VBUS_SOFT_START_ENABLE
 /** Set to '1' to enable VBUS soft start feature */
 #define VBUS_SOFT_START_ENABLE                                  (0u)
 #endif /* VBUS_SOFT_START_ENABLE */
 
+#ifndef CY_APP_SOFT_START_MAX_STEPS
+/** Maximum number of steps in a VBUS soft-start profile. */
+#define CY_APP_SOFT_START_MAX_STEPS                             (4u)
+#endif /* CY_APP_SOFT_START_MAX_STEPS */
+
+#ifndef CY_APP_SOFT_START_POLL_PERIOD
+/** Period in ms at which a soft-start profile checks VBUS. */
+#define CY_APP_SOFT_START_POLL_PERIOD                           (1u)
+#endif /* CY_APP_SOFT_START_POLL_PERIOD */
+
+#ifndef CY_APP_SOFT_START_OCP_CUR
+/** OCP threshold in 10 mA units during unmasked soft-start profile steps. */
+#define CY_APP_SOFT_START_OCP_CUR                               (20u)
+#endif /* CY_APP_SOFT_START_OCP_CUR */
+
+#ifndef CY_APP_SOFT_START_TRIP_DRIVE
+/** NGDO drive strength applied after an OCP trip during a soft-start profile. */
+#define CY_APP_SOFT_START_TRIP_DRIVE                            (0x02u)
+#endif /* CY_APP_SOFT_START_TRIP_DRIVE */
+
+#ifndef CY_APP_SOFT_START_TRIP_DWELL
+/** Time in ms the lowered drive strength is held after an OCP trip. */
+#define CY_APP_SOFT_START_TRIP_DWELL                            (5u)
+#endif /* CY_APP_SOFT_START_TRIP_DWELL */
+
+#ifndef CY_APP_SOFT_START_MAX_TRIPS
+/** OCP trips tolerated during one soft-start profile before the regular OCP
+ * handling takes over. */
+#define CY_APP_SOFT_START_MAX_TRIPS                             (3u)
+#endif /* CY_APP_SOFT_START_MAX_TRIPS */
+
+#ifndef CY_APP_SOFT_START_FINAL_DRIVE
+/** NGDO drive strength applied once a soft-start profile is complete. */
+#define CY_APP_SOFT_START_FINAL_DRIVE                           (0x0Eu)
+#endif /* CY_APP_SOFT_START_FINAL_DRIVE */
+
+#ifndef CY_APP_SOFT_START_RAMP_TIMEOUT
+/** Time in ms after which the VBUS ramp time of a soft-start profile is no
+ * longer tracked. */
+#define CY_APP_SOFT_START_RAMP_TIMEOUT                          (250u)
+#endif /* CY_APP_SOFT_START_RAMP_TIMEOUT */
+
 /** Enable to set VBUS_MAX_VOLTAGE to 50V for EPR voltages. */
 #ifndef CY_APP_VBUS_EPR_MAX_VOLTAGE_ENABLE
 #define CY_APP_VBUS_EPR_MAX_VOLTAGE_ENABLE                      (0u)
@@ -239,6 +504,27 @@
 #define CY_APP_FLASH_LOG_BACKUP_ROW_NUM                         (0x3F7)
 #endif /* CY_APP_FLASH_LOG_BACKUP_ROW_NUM */
 
+#ifndef CY_APP_FAULT_RECORD_ROW_NUM
+/** Flash address row number where the fault records are stored */
+#define CY_APP_FAULT_RECORD_ROW_NUM                             (0x3F8)
+#endif /* CY_APP_FAULT_RECORD_ROW_NUM */
+
+#ifndef CY_APP_FAULT_RECORD_BACKUP_ROW_NUM
+/** Flash address row number used in turn with CY_APP_FAULT_RECORD_ROW_NUM */
+#define CY_APP_FAULT_RECORD_BACKUP_ROW_NUM                      (0x3F9)
+#endif /* CY_APP_FAULT_RECORD_BACKUP_ROW_NUM */
+
+#ifndef CY_APP_PARTNER_CACHE_ROW_NUM
+/** Flash address row number where the partner cache is stored */
+#define CY_APP_PARTNER_CACHE_ROW_NUM                            (0x3FA)
+#endif /* CY_APP_PARTNER_CACHE_ROW_NUM */
+
+#ifndef CY_APP_PARTNER_CACHE_BACKUP_ROW_NUM
+/** Flash address row number used in turn with CY_APP_PARTNER_CACHE_ROW_NUM
+ * to store the partner cache */
+#define CY_APP_PARTNER_CACHE_BACKUP_ROW_NUM                     (0x3FB)
+#endif /* CY_APP_PARTNER_CACHE_BACKUP_ROW_NUM */
+
 #ifndef CY_APP_FW1_CONFTABLE_MAX_ADDR 
 /** Flash address within which the FW1's configuration table address is 
  * located */
@@ -321,6 +607,11 @@
 #define CY_APP_SMART_POWER_ENABLE                               (0u)
 #endif /* CY_APP_SMART_POWER_ENABLE */
 
+#ifndef CY_APP_POWER_BUDGET_ENABLE
+/** Enable sharing of the adapter power between the source ports */
+#define CY_APP_POWER_BUDGET_ENABLE                              (0u)
+#endif /* CY_APP_POWER_BUDGET_ENABLE */
+
 #if CY_APP_DMC_ENABLE
 
 #ifndef CY_APP_DEBUG_PULLUP_ON_UART
@@ -0,0 +1,210 @@
+/***************************************************************************//**
+* \file cy_app_coroutine.c
+* \version 2.0
+*
+* \brief
+* Implements the cooperative coroutine scheduler used for multi-step timed
+* sequences in the application layer
+*
+********************************************************************************
+* \copyright
+* Copyright 2024, Cypress Semiconductor Corporation (an Infineon company)
+* or an affiliate of Cypress Semiconductor Corporation. All rights reserved.
+* You may use this file only in accordance with the license, terms, conditions,
+* disclaimers, and limitations in the end user license agreement accompanying
+* the software package with which this file was provided.
+*******************************************************************************/
+
+#include "cybsp.h"
+#include "cy_app_config.h"
+#include "cy_app_coroutine.h"
+#include "cy_app_timer_id.h"
+
+#include "cy_pdutils_sw_timer.h"
+
+/* Coroutine slots of each PD port */
+static cy_stc_app_coro_t glAppCoro[NO_OF_TYPEC_PORTS][CY_APP_CORO_COUNT];
+
+/* Period with which the shared coroutine timer was last started */
+static uint16_t glAppCoroPeriod[NO_OF_TYPEC_PORTS];
+
+/* Flag indicating that the scheduler is currently dispatching coroutines on the port */
+static volatile bool glAppCoroBusy[NO_OF_TYPEC_PORTS];
+
+static void coro_timer_cb(cy_timer_id_t id, void *context);
+
+/* Deduct the elapsed time from the delay of all waiting coroutines */
+static void coro_update_delays(uint8_t port, uint16_t elapsed)
+{
+    cy_stc_app_coro_t *coro = glAppCoro[port];
+    uint8_t i;
+
+    for (i = 0; i < (uint8_t)CY_APP_CORO_COUNT; i++)
+    {
+        if ((coro[i].fn != NULL) && (coro[i].delay != CY_APP_CORO_WAIT_FOREVER))
+        {
+            coro[i].delay = (coro[i].delay > elapsed) ? (uint16_t)(coro[i].delay - elapsed) : 0u;
+        }
+    }
+}
+
+/* Stop the shared timer and account for the time that has elapsed since it was started */
+static void coro_sync(cy_stc_pdstack_context_t *ptrPdStackContext)
+{
+    uint8_t port = ptrPdStackContext->port;
+    uint16_t timer_id = CY_APP_GET_TIMER_ID(ptrPdStackContext, CY_APP_COROUTINE_TIMER);
+    uint16_t remaining;
+
+    /* Delays are already up to date while the scheduler is dispatching */
+    if ((glAppCoroBusy[port] == false) &&
+            (Cy_PdUtils_SwTimer_IsRunning(ptrPdStackContext->ptrTimerContext, timer_id)))
+    {
+        remaining = Cy_PdUtils_SwTimer_GetCount(ptrPdStackContext->ptrTimerContext, timer_id);
+        Cy_PdUtils_SwTimer_Stop(ptrPdStackContext->ptrTimerContext, timer_id);
+
+        if (glAppCoroPeriod[port] > remaining)
+        {
+            coro_update_delays(port, glAppCoroPeriod[port] - remaining);
+        }
+    }
+}
+
+/* Start the shared timer for the earliest pending wake-up on the port */
+static void coro_arm(cy_stc_pdstack_context_t *ptrPdStackContext)
+{
+    cy_stc_app_coro_t *coro = glAppCoro[ptrPdStackContext->port];
+    uint16_t timer_id = CY_APP_GET_TIMER_ID(ptrPdStackContext, CY_APP_COROUTINE_TIMER);
+    uint16_t next = CY_APP_CORO_WAIT_FOREVER;
+    uint8_t i;
+
+    /* The scheduler re-arms the timer once all ready coroutines have been run */
+    if (glAppCoroBusy[ptrPdStackContext->port])
+    {
+        return;
+    }
+
+    for (i = 0; i < (uint8_t)CY_APP_CORO_COUNT; i++)
+    {
+        if ((coro[i].fn != NULL) && (coro[i].delay < next))
+        {
+            next = coro[i].delay;
+        }
+    }
+
+    if (next == CY_APP_CORO_WAIT_FOREVER)
+    {
+        Cy_PdUtils_SwTimer_Stop(ptrPdStackContext->ptrTimerContext, timer_id);
+    }
+    else
+    {
+        if (next == 0u)
+        {
+            next = 1u;
+        }
+
+        glAppCoroPeriod[ptrPdStackContext->port] = next;
+        Cy_PdUtils_SwTimer_Start(ptrPdStackContext->ptrTimerContext, ptrPdStackContext,
+                timer_id, next, coro_timer_cb);
+    }
+}
+
+/*
+ * Resume the coroutine in the specified slot and release the slot once it completes. The
+ * slot is kept if the coroutine has started another function in it before completing.
+ */
+static void coro_run(cy_stc_pdstack_context_t *ptrPdStackContext, uint8_t id)
+{
+    cy_stc_app_coro_t *coro = &glAppCoro[ptrPdStackContext->port][id];
+    cy_app_coro_fn_t fn = coro->fn;
+
+    if ((fn != NULL) && (fn(ptrPdStackContext, coro) == CY_APP_CORO_DONE) && (coro->fn == fn))
+    {
+        coro->fn = NULL;
+    }
+}
+
+/* Shared timer callback: run all coroutines whose delay has expired */
+static void coro_timer_cb(cy_timer_id_t id, void *context)
+{
+    cy_stc_pdstack_context_t *ptrPdStackContext = (cy_stc_pdstack_context_t *)context;
+    cy_stc_app_coro_t *coro = glAppCoro[ptrPdStackContext->port];
+    uint8_t port = ptrPdStackContext->port;
+    uint8_t i;
+
+    (void)id;
+
+    glAppCoroBusy[port] = true;
+    coro_update_delays(port, glAppCoroPeriod[port]);
+
+    for (i = 0; i < (uint8_t)CY_APP_CORO_COUNT; i++)
+    {
+        if ((coro[i].fn != NULL) && (coro[i].delay == 0u))
+        {
+            coro_run(ptrPdStackContext, i);
+        }
+    }
+
+    glAppCoroBusy[port] = false;
+    coro_arm(ptrPdStackContext);
+}
+
+/* Run the coroutine now if no delay is requested; otherwise, let the shared timer resume it */
+static void coro_schedule(cy_stc_pdstack_context_t *ptrPdStackContext, cy_en_app_coro_id_t id, uint16_t delay)
+{
+    cy_stc_app_coro_t *coro = &glAppCoro[ptrPdStackContext->port][id];
+    uint32_t intr_state;
+
+    intr_state = Cy_SysLib_EnterCriticalSection();
+    coro_sync(ptrPdStackContext);
+
+    /* Keep the scheduler away from the slot while it is being run from this context */
+    coro->delay = (delay == 0u) ? CY_APP_CORO_WAIT_FOREVER : delay;
+    coro_arm(ptrPdStackContext);
+    Cy_SysLib_ExitCriticalSection(intr_state);
+
+    if (delay == 0u)
+    {
+        coro_run(ptrPdStackContext, (uint8_t)id);
+
+        intr_state = Cy_SysLib_EnterCriticalSection();
+        coro_sync(ptrPdStackContext);
+        coro_arm(ptrPdStackContext);
+        Cy_SysLib_ExitCriticalSection(intr_state);
+    }
+}
+
+void Cy_App_Coro_Start(cy_stc_pdstack_context_t *ptrPdStackContext, cy_en_app_coro_id_t id,
+        cy_app_coro_fn_t fn, uint16_t delay)
+{
+    cy_stc_app_coro_t *coro = &glAppCoro[ptrPdStackContext->port][id];
+
+    coro->lc = 0u;
+    coro->fn = fn;
+    coro_schedule(ptrPdStackContext, id, delay);
+}
+
+void Cy_App_Coro_Wake(cy_stc_pdstack_context_t *ptrPdStackContext, cy_en_app_coro_id_t id, uint16_t delay)
+{
+    if (glAppCoro[ptrPdStackContext->port][id].fn != NULL)
+    {
+        coro_schedule(ptrPdStackContext, id, delay);
+    }
+}
+
+void Cy_App_Coro_Stop(cy_stc_pdstack_context_t *ptrPdStackContext, cy_en_app_coro_id_t id)
+{
+    uint32_t intr_state;
+
+    intr_state = Cy_SysLib_EnterCriticalSection();
+    coro_sync(ptrPdStackContext);
+    glAppCoro[ptrPdStackContext->port][id].fn = NULL;
+    coro_arm(ptrPdStackContext);
+    Cy_SysLib_ExitCriticalSection(intr_state);
+}
+
+bool Cy_App_Coro_IsActive(cy_stc_pdstack_context_t *ptrPdStackContext, cy_en_app_coro_id_t id)
+{
+    return (glAppCoro[ptrPdStackContext->port][id].fn != NULL);
+}
+
+/* [] End of file */
@@ -0,0 +1,221 @@
+/***************************************************************************//**
+* \file cy_app_coroutine.h
+* \version 2.0
+*
+* \brief
+* Defines the data structures, macros and function prototypes of the
+* lightweight cooperative coroutine scheduler used for multi-step timed
+* sequences in the application layer.
+*
+********************************************************************************
+* \copyright
+* Copyright 2024, Cypress Semiconductor Corporation (an Infineon company)
+* or an affiliate of Cypress Semiconductor Corporation. All rights reserved.
+* You may use this file only in accordance with the license, terms, conditions,
+* disclaimers, and limitations in the end user license agreement accompanying
+* the software package with which this file was provided.
+*******************************************************************************/
+
+#ifndef _CY_APP_COROUTINE_H_
+#define _CY_APP_COROUTINE_H_
+
+/*******************************************************************************
+ * Header files including
+ ******************************************************************************/
+#include <stdint.h>
+#include <stdbool.h>
+#include "cy_pdstack_common.h"
+
+/**
+* \addtogroup group_pmg_app_common_coro
+* \{
+* The coroutine scheduler provides stackless, cooperative sequences
+* (protothreads) for the retry loops and staged operations of the application
+* layer. All coroutines of a PD port share a single software timer. The
+* scheduler always programs that timer for the earliest pending wake-up, so
+* sequences which expire together are served by one timer interrupt.
+*
+* A coroutine is a function which starts with \ref CY_APP_CORO_BEGIN and ends
+* with \ref CY_APP_CORO_END. Local variables are not preserved across a wait
+* point; any state which must survive a wait has to be held in static storage.
+*
+* <b>Features:</b>
+* * One software timer per port for all sequences
+* * Millisecond delays and event waits inside a sequence
+* * Wake-up of a waiting sequence from PDStack response callbacks
+*
+* \defgroup group_pmg_app_common_coro_macros Macros
+* \defgroup group_pmg_app_common_coro_enums Enumerated types
+* \defgroup group_pmg_app_common_coro_data_structures Data structures
+* \defgroup group_pmg_app_common_coro_functions Functions
+*/
+/** \} group_pmg_app_common_coro */
+
+/*****************************************************************************
+ * Macros
+ *****************************************************************************/
+/**
+* \addtogroup group_pmg_app_common_coro_macros
+* \{
+*/
+
+/** Delay value which makes a coroutine wait until it is explicitly woken up. */
+#define CY_APP_CORO_WAIT_FOREVER                (0xFFFFu)
+
+/** Marks the start of the coroutine body. */
+#define CY_APP_CORO_BEGIN(coro)                 switch ((coro)->lc) { case 0u:
+
+/** Suspends the coroutine and resumes it after the specified delay in ms. */
+#define CY_APP_CORO_WAIT_MS(coro, ms)                                          \
+    do {                                                                        \
+        (coro)->lc = (uint16_t)__LINE__;                                        \
+        (coro)->delay = (uint16_t)(ms);                                         \
+        return CY_APP_CORO_WAITING;                                             \
+        case __LINE__:;                                                         \
+    } while (0)
+
+/** Suspends the coroutine until it is woken up using Cy_App_Coro_Wake. */
+#define CY_APP_CORO_WAIT_EVENT(coro)            CY_APP_CORO_WAIT_MS(coro, CY_APP_CORO_WAIT_FOREVER)
+
+/** Terminates the coroutine from anywhere within the body. */
+#define CY_APP_CORO_EXIT(coro)                                                 \
+    do {                                                                        \
+        (coro)->lc = 0u;                                                        \
+        return CY_APP_CORO_DONE;                                                \
+    } while (0)
+
+/** Marks the end of the coroutine body. */
+#define CY_APP_CORO_END(coro)                   } (coro)->lc = 0u; return CY_APP_CORO_DONE
+
+/** \} group_pmg_app_common_coro_macros */
+
+/*****************************************************************************
+ * Data Struct Definition
+ *****************************************************************************/
+/**
+* \addtogroup group_pmg_app_common_coro_enums
+* \{
+*/
+
+/**
+ * @typedef cy_en_app_coro_id_t
+ * @brief List of coroutine slots available on each PD port
+ */
+typedef enum
+{
+    CY_APP_CORO_GET_REVISION = 0,       /**< PD Get_Revision AMS with retries. */
+    CY_APP_CORO_CBL_DISC,               /**< Cable discovery trigger with retries. */
+    CY_APP_CORO_ROLE_SWAP,              /**< Data/power/VConn role swap state machine. */
+    CY_APP_CORO_EPR_ENTRY,              /**< Sink EPR mode entry with retries. */
+    CY_APP_CORO_DEBUG_ACC,              /**< Delayed VBus enable for a debug accessory sink. */
+    CY_APP_CORO_PPS_SNK,                /**< Periodic re-request of a PPS contract as a sink. */
+    CY_APP_CORO_FRS_VBUS,               /**< Wait for vSafe5V before the provider FET is turned on after an FRS signal. */
+    CY_APP_CORO_SNK_UVP_CONFIRM,        /**< VBUS sampling to confirm a sink UVP comparator trip. */
+    CY_APP_CORO_TELEMETRY,              /**< Periodic VBUS and IBUS sampling of the telemetry module. */
+    CY_APP_CORO_THERMAL,                /**< Pacing of the temperature sampling of the thermal derating controller. */
+    CY_APP_CORO_SINK_ENERGY,            /**< Periodic accounting of the energy drawn as a sink. */
+    CY_APP_CORO_FAULT_BACKOFF,          /**< Fault recovery delayed by the backoff of the fault policy. */
+    CY_APP_CORO_FAULT_DECAY,            /**< Forgetting of earlier faults while a PD contract is stable. */
+    CY_APP_CORO_COUNT                   /**< Number of coroutine slots per port. */
+} cy_en_app_coro_id_t;
+
+/**
+ * @typedef cy_en_app_coro_status_t
+ * @brief Status returned by a coroutine function to the scheduler
+ */
+typedef enum
+{
+    CY_APP_CORO_WAITING = 0,            /**< Coroutine is suspended at a wait point. */
+    CY_APP_CORO_DONE                    /**< Coroutine has run to completion. */
+} cy_en_app_coro_status_t;
+
+/** \} group_pmg_app_common_coro_enums */
+
+/**
+* \addtogroup group_pmg_app_common_coro_data_structures
+* \{
+*/
+
+/** Forward declaration of the coroutine state structure. */
+typedef struct cy_stc_app_coro cy_stc_app_coro_t;
+
+/**
+ * @brief Coroutine function type. The function is called by the scheduler
+ * each time the coroutine is resumed.
+ */
+typedef cy_en_app_coro_status_t (*cy_app_coro_fn_t)(cy_stc_pdstack_context_t *ptrPdStackContext,
+        cy_stc_app_coro_t *coro);
+
+/**
+ * @brief Coroutine state held by the scheduler for each slot
+ */
+struct cy_stc_app_coro
+{
+    cy_app_coro_fn_t fn;                /**< Coroutine function; NULL if the slot is idle. */
+    uint16_t lc;                        /**< Local continuation: resume point within the coroutine. */
+    uint16_t delay;                     /**< Time in ms until the coroutine is resumed. */
+};
+
+/** \} group_pmg_app_common_coro_data_structures */
+
+/*****************************************************************************
+ * Global Function Declaration
+ *****************************************************************************/
+/**
+* \addtogroup group_pmg_app_common_coro_functions
+* \{
+*/
+
+/**
+ * @brief Starts a coroutine from the beginning of its body. Any earlier instance
+ * running in the same slot is discarded.
+ *
+ * @param ptrPdStackContext Pointer to the PDStack context
+ * @param id Coroutine slot
+ * @param fn Coroutine function
+ * @param delay Delay in ms before the coroutine is run for the first time. The
+ * coroutine is run immediately from the caller context if this is 0.
+ *
+ * @return None
+ */
+void Cy_App_Coro_Start(cy_stc_pdstack_context_t *ptrPdStackContext, cy_en_app_coro_id_t id,
+        cy_app_coro_fn_t fn, uint16_t delay);
+
+/**
+ * @brief Resumes a suspended coroutine after the specified delay, replacing
+ * any wait which is currently pending. Has no effect if the slot is idle.
+ *
+ * @param ptrPdStackContext Pointer to the PDStack context
+ * @param id Coroutine slot
+ * @param delay Delay in ms before the coroutine is resumed. The coroutine is
+ * resumed immediately from the caller context if this is 0.
+ *
+ * @return None
+ */
+void Cy_App_Coro_Wake(cy_stc_pdstack_context_t *ptrPdStackContext, cy_en_app_coro_id_t id, uint16_t delay);
+
+/**
+ * @brief Terminates a coroutine without running it any further.
+ *
+ * @param ptrPdStackContext Pointer to the PDStack context
+ * @param id Coroutine slot
+ *
+ * @return None
+ */
+void Cy_App_Coro_Stop(cy_stc_pdstack_context_t *ptrPdStackContext, cy_en_app_coro_id_t id);
+
+/**
+ * @brief Checks whether a coroutine is running or suspended in the slot.
+ *
+ * @param ptrPdStackContext Pointer to the PDStack context
+ * @param id Coroutine slot
+ *
+ * @return true if the slot is in use; false otherwise.
+ */
+bool Cy_App_Coro_IsActive(cy_stc_pdstack_context_t *ptrPdStackContext, cy_en_app_coro_id_t id);
+
+/** \} group_pmg_app_common_coro_functions */
+
+#endif /* _CY_APP_COROUTINE_H_ */
+
+/* [] END OF FILE */
@@ -14,6 +14,7 @@
 * the software package with which this file was provided.
 *******************************************************************************/
 
+#include <string.h>
 #include "cybsp.h"
 #include "cy_app_config.h"
 #if (!CY_PD_SINK_ONLY)
@@ -24,7 +25,13 @@
 #include "cy_app.h"
 #include "cy_app_debug.h"
 #include "cy_app_timer_id.h"
+#include "cy_app_coroutine.h"
+#include "cy_app_fault_handlers.h"
+#if CY_APP_FAULT_RECORD_FLASH_ENABLE
+#include "cy_app_flash_config.h"
+#endif /* CY_APP_FAULT_RECORD_FLASH_ENABLE */
 
+#include "cy_pdutils.h"
 #include "cy_pdutils_sw_timer.h"
 #include "cy_pdstack_timer_id.h"
 #include "cy_usbpd_vbus_ctrl.h"
@@ -33,21 +40,8 @@
 #include "cy_pdaltmode_timer_id.h"
 #endif
 
-enum
-{
-    FAULT_TYPE_VBUS_OVP = 0,    /* 0 */
-    FAULT_TYPE_VBUS_UVP,        /* 1 */
-    FAULT_TYPE_VBUS_OCP,        /* 2 */
-    FAULT_TYPE_VBUS_SCP,        /* 3 */
-    FAULT_TYPE_CC_OVP,          /* 4 */
-    FAULT_TYPE_VCONN_OCP,       /* 5 */
-    FAULT_TYPE_SBU_OVP,         /* 6 */
-    FAULT_TYPE_OTP,             /* 7 */
-    FAULT_TYPE_VBUS_RCP,        /* 8 */
-    FAULT_TYPE_COUNT            /* 9 */
-};
-
-#if (VBUS_OVP_ENABLE || VBUS_UVP_ENABLE || VBUS_OCP_ENABLE || VBUS_SCP_ENABLE || VBUS_RCP_ENABLE || VCONN_OCP_ENABLE)
+#if (VBUS_OVP_ENABLE || VBUS_UVP_ENABLE || VBUS_OCP_ENABLE || VBUS_SCP_ENABLE || VBUS_RCP_ENABLE || VCONN_OCP_ENABLE || \
+     (CY_APP_FAULT_SOLN_SOURCE_COUNT != 0u))
 /* Variable defined in app.c */
 extern cy_stc_pdstack_app_status_t glAppPdStatus[];
 
@@ -58,21 +52,113 @@ extern cy_stc_pdstack_app_status_t glAppPdStatus[];
  * If fault retry count in the configuration table is set to this value, then
  * faults are not counted. That is, infinite fault recovery is enabled.
  */
-#define FAULT_COUNTER_SKIP_VALUE        (255u)
+#define FAULT_COUNTER_SKIP_VALUE        (CY_APP_FAULT_RETRY_INFINITE)
 
-/* Number of retries defined by user for each fault type */
-static uint8_t glAppFaultRetryLimit[NO_OF_TYPEC_PORTS][FAULT_TYPE_COUNT] =
+/* Number of retries defined by user for each fault source */
+static uint8_t glAppFaultRetryLimit[NO_OF_TYPEC_PORTS][CY_APP_FAULT_SOURCE_COUNT] =
 {
     {0}
 };
 
 /* Number of times each fault condition has been detected during the current connection */
-static volatile uint8_t glAppFaultCount[NO_OF_TYPEC_PORTS][FAULT_TYPE_COUNT] =
+static volatile uint8_t glAppFaultCount[NO_OF_TYPEC_PORTS][CY_APP_FAULT_SOURCE_COUNT] =
 {
     {0}
 };
 
-#endif /* (VBUS_OVP_ENABLE || VBUS_UVP_ENABLE || VBUS_OCP_ENABLE || VBUS_SCP_ENABLE || VBUS_RCP_ENABLE || VCONN_OCP_ENABLE) */
+/* Active and exceeded bits of each fault source; updated whenever a count or limit changes */
+static volatile uint32_t glAppFaultStatus[NO_OF_TYPEC_PORTS];
+
+#if (CY_APP_FAULT_SOLN_SOURCE_COUNT != 0u)
+/* Number of solution fault sources registered on each port */
+static uint8_t glAppFaultSolnCount[NO_OF_TYPEC_PORTS];
+#endif /* (CY_APP_FAULT_SOLN_SOURCE_COUNT != 0u) */
+
+#if CY_APP_FAULT_BACKOFF_ENABLE
+/* Recovery policy of each fault source; a zero base delay recovers immediately */
+static cy_stc_app_fault_policy_t glAppFaultPolicy[NO_OF_TYPEC_PORTS][CY_APP_FAULT_SOURCE_COUNT];
+
+/* Bit of each fault source for which a policy has been registered */
+static uint32_t glAppFaultPolicySet[NO_OF_TYPEC_PORTS];
+
+/*
+ * Occurrences of each fault source which set the backoff delay. Unlike the fault
+ * count, this is kept across disconnects and only decays while a contract is stable.
+ */
+static uint8_t glAppFaultBackoffLevel[NO_OF_TYPEC_PORTS][CY_APP_FAULT_SOURCE_COUNT];
+
+/* Recovery statistics of each port */
+static cy_stc_app_fault_recovery_stats_t glAppFaultRecoveryStats[NO_OF_TYPEC_PORTS];
+
+/* State of the pseudo-random jitter generator */
+static uint32_t glAppFaultJitterSeed = 0x2545F491u;
+#endif /* CY_APP_FAULT_BACKOFF_ENABLE */
+
+#if CY_APP_FAULT_RECORD_ENABLE
+/* Fault record ring of each port */
+static cy_stc_app_fault_record_t glAppFaultRecord[NO_OF_TYPEC_PORTS][CY_APP_FAULT_RECORD_RING_SIZE];
+
+/* Slot of each ring written next */
+static uint8_t glAppFaultRecordIdx[NO_OF_TYPEC_PORTS];
+
+/* Number of valid records in each ring */
+static uint8_t glAppFaultRecordCount[NO_OF_TYPEC_PORTS];
+
+/* Sequence number of the next record on any port */
+static uint16_t glAppFaultRecordSeq = 0u;
+
+/* Number of the latest records of each port which still have to be completed by the task */
+static volatile uint8_t glAppFaultRecordPending[NO_OF_TYPEC_PORTS];
+
+/* Time in ms at the last start of the time base timer */
+static volatile uint32_t glAppFaultRecordTimeBase = 0u;
+
+/* Port whose timer provides the time base; NULL until a port has been initialized */
+static cy_stc_pdstack_context_t *glAppFaultRecordTimeCtx = NULL;
+
+#if CY_APP_FAULT_RECORD_FLASH_ENABLE
+/* Latest records of all ports, as written to flash */
+static cy_stc_app_fault_record_row_t glAppFaultRecordRow;
+
+/* Flash row which holds the current copy of the records; the other row is written next */
+static uint16_t glAppFaultRecordFlashRow = CY_APP_FAULT_RECORD_ROW_NUM;
+
+/* The records have been loaded from flash */
+static bool glAppFaultRecordLoaded = false;
+
+/* Records have been added since the last write */
+static bool glAppFaultRecordDirty = false;
+
+/* The flush delay has expired and the records can be written */
+static volatile bool glAppFaultRecordFlushReq = false;
+
+/* Buffer used to write a complete flash row */
+static uint32_t glAppFaultRecordRowBuf[CY_APP_SYS_FLASH_ROW_SIZE / 4u];
+
+#if ((CY_APP_FAULT_RECORD_ROW_NUM == CY_APP_FLASH_LOG_ROW_NUM) || \
+     (CY_APP_FAULT_RECORD_ROW_NUM == CY_APP_FLASH_LOG_BACKUP_ROW_NUM) || \
+     (CY_APP_FAULT_RECORD_BACKUP_ROW_NUM == CY_APP_FLASH_LOG_ROW_NUM) || \
+     (CY_APP_FAULT_RECORD_BACKUP_ROW_NUM == CY_APP_FLASH_LOG_BACKUP_ROW_NUM) || \
+     (CY_APP_FAULT_RECORD_ROW_NUM >= CY_APP_SYS_APP_PRIORITY_ROW_NUM) || \
+     (CY_APP_FAULT_RECORD_BACKUP_ROW_NUM >= CY_APP_SYS_APP_PRIORITY_ROW_NUM))
+#error "Fault record rows overlap the log or firmware metadata rows."
+#endif
+
+#if (CY_APP_DMC_ENABLE && \
+     (((CY_APP_FAULT_RECORD_ROW_NUM >= CY_APP_SYS_DMC_METADATA_START_ROW_ID) && \
+       (CY_APP_FAULT_RECORD_ROW_NUM <= CY_APP_SYS_DMC_METADATA_END_ROW_ID)) || \
+      ((CY_APP_FAULT_RECORD_BACKUP_ROW_NUM >= CY_APP_SYS_DMC_METADATA_START_ROW_ID) && \
+       (CY_APP_FAULT_RECORD_BACKUP_ROW_NUM <= CY_APP_SYS_DMC_METADATA_END_ROW_ID))))
+#error "Fault record rows overlap the dock metadata rows."
+#endif
+
+/* Compile time check that the records fit in a flash row */
+typedef char fault_record_row_size_check_t[(sizeof(cy_stc_app_fault_record_row_t) <= CY_APP_SYS_FLASH_ROW_SIZE) ? 1 : -1];
+#endif /* CY_APP_FAULT_RECORD_FLASH_ENABLE */
+#endif /* CY_APP_FAULT_RECORD_ENABLE */
+
+#endif /* (VBUS_OVP_ENABLE || VBUS_UVP_ENABLE || VBUS_OCP_ENABLE || VBUS_SCP_ENABLE || VBUS_RCP_ENABLE || VCONN_OCP_ENABLE ||
+          (CY_APP_FAULT_SOLN_SOURCE_COUNT != 0u)) */
 
 #if ((VCONN_OCP_ENABLE) || (PMG1_V5V_CHANGE_DETECT))
 
@@ -121,27 +207,54 @@ void Cy_App_VconnChangeHandler(cy_stc_pdstack_context_t *ptrPdStackContext, bool
 
 #if CY_APP_FAULT_HANDLER_ENABLE
 
-/* Check whether any fault count has exceeded limit for the specified PD port */
-bool Cy_App_Fault_IsCountExceeded(cy_stc_pdstack_context_t * context)
+/* The preprocessor check of the source count relies on the number of built-in fault types */
+typedef char fault_type_count_check_t[((uint8_t)CY_APP_FAULT_TYPE_COUNT == CY_APP_FAULT_BUILTIN_COUNT) ? 1 : -1];
+
+/* Updates the status bits of a fault source from its count and limit */
+static void fault_update_status(uint8_t port, uint8_t fault_id)
 {
-    uint32_t i;
-    bool     retval = false;
-    uint8_t port = context->port;
-    /*
-     * Check whether the count for any fault type has exceeded the limit specified
-     */
-    for (i = 0; i < FAULT_TYPE_COUNT; i++)
+    uint32_t mask = CY_APP_FAULT_STATUS_ACTIVE(fault_id) | CY_APP_FAULT_STATUS_EXCEEDED(fault_id);
+    uint32_t bits = 0u;
+    uint32_t intr_state;
+
+    if (glAppFaultCount[port][fault_id] != 0u)
     {
-        if (glAppFaultCount[port][i] > glAppFaultRetryLimit[port][i])
-        {
-            retval = true;
-            break;
-        }
+        bits |= CY_APP_FAULT_STATUS_ACTIVE(fault_id);
+    }
+    if (glAppFaultCount[port][fault_id] > glAppFaultRetryLimit[port][fault_id])
+    {
+        bits |= CY_APP_FAULT_STATUS_EXCEEDED(fault_id);
     }
 
-    return (retval);
+    intr_state = Cy_SysLib_EnterCriticalSection();
+    glAppFaultStatus[port] = (glAppFaultStatus[port] & ~mask) | bits;
+    Cy_SysLib_ExitCriticalSection(intr_state);
 }
 
+/* Check whether any fault count has exceeded limit for the specified PD port */
+bool Cy_App_Fault_IsCountExceeded(cy_stc_pdstack_context_t * context)
+{
+    return ((glAppFaultStatus[context->port] & CY_APP_FAULT_STATUS_EXCEEDED_MASK) != 0u);
+}
+
+uint32_t Cy_App_Fault_GetStatus(cy_stc_pdstack_context_t * context)
+{
+    return glAppFaultStatus[context->port];
+}
+
+#if (CY_APP_FAULT_BACKOFF_ENABLE || (CY_APP_FAULT_SOLN_SOURCE_COUNT != 0u))
+/* Checks whether the ID is a built-in fault type or a registered solution fault source */
+static bool fault_is_valid_id(uint8_t port, uint8_t fault_id)
+{
+#if (CY_APP_FAULT_SOLN_SOURCE_COUNT != 0u)
+    return (fault_id < (CY_APP_FAULT_TYPE_COUNT + glAppFaultSolnCount[port]));
+#else
+    (void)port;
+    return (fault_id < CY_APP_FAULT_TYPE_COUNT);
+#endif /* (CY_APP_FAULT_SOLN_SOURCE_COUNT != 0u) */
+}
+#endif /* (CY_APP_FAULT_BACKOFF_ENABLE || (CY_APP_FAULT_SOLN_SOURCE_COUNT != 0u)) */
+
 /* This function stops PD operation and configures Type-C to look for detach of faulty device */
 void Cy_App_Fault_ConfigureForDetach(cy_stc_pdstack_context_t * context)
 {
@@ -162,54 +275,582 @@ void Cy_App_Fault_ConfigureForDetach(cy_stc_pdstack_context_t * context)
     Cy_PdStack_Dpm_PeStop(context);
 }
 
+/* Tries a hard reset to recover from a VBus fault; uses Type-C error recovery if there is no PD contract */
+static void app_fault_recover(cy_stc_pdstack_context_t * context)
+{
+    context->peStat.hardResetCount = 0;
+    if (Cy_PdStack_Dpm_SendPdCommand(context, CY_PDSTACK_DPM_CMD_SEND_HARD_RESET, NULL, false, NULL) != CY_PDSTACK_STAT_SUCCESS)
+    {
+        Cy_PdStack_Dpm_SendTypecCommand(context, CY_PDSTACK_DPM_CMD_TYPEC_ERR_RECOVERY, NULL);
+    }
+}
+
+#if CY_APP_FAULT_BACKOFF_ENABLE
+/*
+ * Returns the delay before the recovery from a fault: the base delay doubled
+ * for each earlier occurrence, capped at the maximum delay, with the jitter
+ * spread in both directions.
+ */
+static uint16_t app_fault_backoff_delay(const cy_stc_app_fault_policy_t *policy, uint8_t count)
+{
+    uint32_t delay = policy->baseDelay;
+    uint32_t spread;
+    uint8_t shift = (count > 1u) ? (count - 1u) : 0u;
+
+    while ((shift != 0u) && (delay < policy->maxDelay))
+    {
+        delay <<= 1u;
+        shift--;
+    }
+    delay = CY_PDUTILS_GET_MIN(delay, policy->maxDelay);
+
+    spread = (delay * policy->jitter) / 100u;
+    if (spread != 0u)
+    {
+        /* xorshift32 */
+        glAppFaultJitterSeed ^= glAppFaultJitterSeed << 13u;
+        glAppFaultJitterSeed ^= glAppFaultJitterSeed >> 17u;
+        glAppFaultJitterSeed ^= glAppFaultJitterSeed << 5u;
+
+        delay = delay - spread + (glAppFaultJitterSeed % ((spread << 1u) + 1u));
+    }
+
+    /* A delay of CY_APP_CORO_WAIT_FOREVER would never expire */
+    delay = CY_PDUTILS_GET_MIN(delay, CY_APP_CORO_WAIT_FOREVER - 1u);
+
+    return (uint16_t)CY_PDUTILS_GET_MAX(delay, 1u);
+}
+
+/* Recovers from the fault once the backoff delay the sequence was started with has expired */
+static cy_en_app_coro_status_t fault_backoff_recover(cy_stc_pdstack_context_t *ptrPdStackContext, cy_stc_app_coro_t *coro)
+{
+    CY_APP_CORO_BEGIN(coro);
+
+    if ((ptrPdStackContext->dpmConfig.attach) && (ptrPdStackContext->dpmStat.faultActive))
+    {
+        app_fault_recover(ptrPdStackContext);
+    }
+
+    CY_APP_CORO_END(coro);
+}
+
+/* Forgets one occurrence of each fault type; returns true while any count or backoff level remains */
+static bool fault_decay_step(uint8_t port)
+{
+    bool pending = false;
+    uint8_t i;
+
+    for (i = 0; i < CY_APP_FAULT_SOURCE_COUNT; i++)
+    {
+        if (glAppFaultCount[port][i] != 0u)
+        {
+            glAppFaultCount[port][i]--;
+            fault_update_status(port, i);
+            pending |= (glAppFaultCount[port][i] != 0u);
+        }
+
+        if (glAppFaultBackoffLevel[port][i] != 0u)
+        {
+            glAppFaultBackoffLevel[port][i]--;
+            pending |= (glAppFaultBackoffLevel[port][i] != 0u);
+        }
+    }
+
+    return pending;
+}
+
+/* Forgets one occurrence of each fault type after each stable contract period */
+static cy_en_app_coro_status_t fault_decay(cy_stc_pdstack_context_t *ptrPdStackContext, cy_stc_app_coro_t *coro)
+{
+    CY_APP_CORO_BEGIN(coro);
+
+    while (fault_decay_step(ptrPdStackContext->port))
+    {
+        CY_APP_CORO_WAIT_MS(coro, CY_APP_FAULT_DECAY_PERIOD);
+    }
+
+    CY_APP_CORO_END(coro);
+}
+
+cy_en_app_status_t Cy_App_Fault_SetPolicy(cy_stc_pdstack_context_t * context,
+        uint8_t faultId, const cy_stc_app_fault_policy_t *policy)
+{
+    if ((!fault_is_valid_id(context->port, faultId)) || (policy == NULL) ||
+            (policy->maxDelay < policy->baseDelay) || (policy->jitter > 100u))
+    {
+        return CY_APP_STAT_BAD_PARAM;
+    }
+
+    glAppFaultPolicy[context->port][faultId] = *policy;
+    glAppFaultPolicySet[context->port] |= (1UL << faultId);
+    glAppFaultRetryLimit[context->port][faultId] = policy->retryLimit;
+    fault_update_status(context->port, faultId);
+
+    return CY_APP_STAT_SUCCESS;
+}
+
+const cy_stc_app_fault_recovery_stats_t* Cy_App_Fault_GetRecoveryStats(cy_stc_pdstack_context_t * context)
+{
+    return &glAppFaultRecoveryStats[context->port];
+}
+#endif /* CY_APP_FAULT_BACKOFF_ENABLE */
+
+#if CY_APP_FAULT_RECORD_ENABLE
+static void fault_record_time_cb(cy_timer_id_t id, void *context)
+{
+    cy_stc_pdstack_context_t *ptrPdStackContext = (cy_stc_pdstack_context_t *)context;
+
+    (void)id;
+
+    glAppFaultRecordTimeBase += CY_APP_FAULT_RECORD_TIME_PERIOD;
+    Cy_PdUtils_SwTimer_Start(ptrPdStackContext->ptrTimerContext, ptrPdStackContext,
+            CY_APP_GET_TIMER_ID(ptrPdStackContext, CY_APP_FAULT_RECORD_TIME_TIMER),
+            CY_APP_FAULT_RECORD_TIME_PERIOD, fault_record_time_cb);
+}
+
+/* Starts the time base on the first port which is initialized */
+static void fault_record_time_start(cy_stc_pdstack_context_t * context)
+{
+    if (glAppFaultRecordTimeCtx == NULL)
+    {
+        glAppFaultRecordTimeCtx = context;
+        Cy_PdUtils_SwTimer_Start(context->ptrTimerContext, context,
+                CY_APP_GET_TIMER_ID(context, CY_APP_FAULT_RECORD_TIME_TIMER),
+                CY_APP_FAULT_RECORD_TIME_PERIOD, fault_record_time_cb);
+    }
+}
+
+/* Time in ms since the time base has been started */
+static uint32_t fault_record_app_time(void)
+{
+    cy_stc_pdstack_context_t *ctx = glAppFaultRecordTimeCtx;
+    uint32_t intr_state;
+    uint32_t time;
+
+    if (ctx == NULL)
+    {
+        return 0u;
+    }
+
+    /* An expired timer counts as a full period until its callback has run */
+    intr_state = Cy_SysLib_EnterCriticalSection();
+    time = glAppFaultRecordTimeBase + CY_APP_FAULT_RECORD_TIME_PERIOD -
+        Cy_PdUtils_SwTimer_GetCount(ctx->ptrTimerContext, CY_APP_GET_TIMER_ID(ctx, CY_APP_FAULT_RECORD_TIME_TIMER));
+    Cy_SysLib_ExitCriticalSection(intr_state);
+
+    return time;
+}
+
+/* Time stamp of the fault records; the solution may provide a real time clock */
+__attribute__ ((weak)) uint32_t soln_fault_record_time(void)
+{
+    return fault_record_app_time();
+}
+
+/* Debounce of the fault source from the configuration table */
+static uint8_t fault_get_debounce(cy_stc_pdstack_context_t * context, uint8_t fault_id)
+{
+    const cy_stc_usbpd_config_t *fault_config = context->ptrUsbPdContext->usbpdConfig;
+    uint8_t debounce = 0u;
+
+    if (fault_config == NULL)
+    {
+        return 0u;
+    }
+
+    switch (fault_id)
+    {
+#if VBUS_OVP_ENABLE
+        case CY_APP_FAULT_TYPE_VBUS_OVP:
+            if (fault_config->vbusOvpConfig != NULL)
+            {
+                debounce = fault_config->vbusOvpConfig->debounce;
+            }
+            break;
+#endif /* VBUS_OVP_ENABLE */
+
+#if VBUS_UVP_ENABLE
+        case CY_APP_FAULT_TYPE_VBUS_UVP:
+            if (fault_config->vbusUvpConfig != NULL)
+            {
+                debounce = fault_config->vbusUvpConfig->debounce;
+            }
+            break;
+#endif /* VBUS_UVP_ENABLE */
+
+#if VBUS_OCP_ENABLE
+        case CY_APP_FAULT_TYPE_VBUS_OCP:
+            if (fault_config->vbusOcpConfig != NULL)
+            {
+                debounce = fault_config->vbusOcpConfig->debounce;
+            }
+            break;
+#endif /* VBUS_OCP_ENABLE */
+
+#if VCONN_OCP_ENABLE
+        case CY_APP_FAULT_TYPE_VCONN_OCP:
+            if (fault_config->vconnOcpConfig != NULL)
+            {
+                debounce = fault_config->vconnOcpConfig->debounce;
+            }
+            break;
+#endif /* VCONN_OCP_ENABLE */
+
+        default:
+            /* No debounce configured */
+            break;
+    }
+
+    (void)fault_config;
+    return debounce;
+}
+
+#if CY_APP_FAULT_RECORD_FLASH_ENABLE
+/* 16-bit sum over the sequence number and records of a row */
+static uint16_t fault_record_checksum(const cy_stc_app_fault_record_row_t *row)
+{
+    const uint8_t *ptr = (const uint8_t *)row->record;
+    uint32_t len = sizeof(row->record);
+    uint16_t sum = row->seq + row->count;
+
+    while (len-- != 0u)
+    {
+        sum += *ptr++;
+    }
+
+    return sum;
+}
+
+/* Returns the records stored in the flash row, or NULL if the row does not hold valid records */
+static const cy_stc_app_fault_record_row_t* fault_record_read_row(uint16_t row)
+{
+    const cy_stc_app_fault_record_row_t *stored =
+        (const cy_stc_app_fault_record_row_t *)((uint32_t)row << CY_APP_SYS_FLASH_ROW_SHIFT_NUM);
+
+    if ((stored->signature != CY_APP_FAULT_RECORD_SIGNATURE) ||
+            (stored->count > CY_APP_FAULT_RECORD_ROW_COUNT) || (stored->checksum != fault_record_checksum(stored)))
+    {
+        return NULL;
+    }
+
+    return stored;
+}
+
+/* Continues with the records kept in flash before the last reset */
+static void fault_record_load(void)
+{
+    const cy_stc_app_fault_record_row_t *main_row;
+    const cy_stc_app_fault_record_row_t *backup_row;
+    const cy_stc_app_fault_record_row_t *stored;
+
+    if (glAppFaultRecordLoaded)
+    {
+        return;
+    }
+
+    glAppFaultRecordLoaded = true;
+
+    main_row   = fault_record_read_row(CY_APP_FAULT_RECORD_ROW_NUM);
+    backup_row = fault_record_read_row(CY_APP_FAULT_RECORD_BACKUP_ROW_NUM);
+
+    /* The row written last is current; the other one is overwritten next */
+    stored = main_row;
+    glAppFaultRecordFlashRow = CY_APP_FAULT_RECORD_ROW_NUM;
+    if ((backup_row != NULL) && ((main_row == NULL) || ((int16_t)(backup_row->seq - main_row->seq) > 0)))
+    {
+        stored = backup_row;
+        glAppFaultRecordFlashRow = CY_APP_FAULT_RECORD_BACKUP_ROW_NUM;
+    }
+
+    if (stored != NULL)
+    {
+        glAppFaultRecordRow = *stored;
+        if (stored->count != 0u)
+        {
+            glAppFaultRecordSeq = stored->record[stored->count - 1u].seq + 1u;
+        }
+    }
+}
+
+static void fault_record_flush_timer_cb(cy_timer_id_t id, void *context)
+{
+    (void)id;
+    (void)context;
+
+    glAppFaultRecordFlushReq = true;
+}
+
+/* Writes the latest records to the flash row not holding the current copy */
+static void fault_record_flush(void)
+{
+    cy_stc_app_fault_record_row_t *row = (cy_stc_app_fault_record_row_t *)glAppFaultRecordRowBuf;
+    uint32_t intr_state;
+    uint16_t next_row;
+
+    if ((!glAppFaultRecordFlushReq) || (!glAppFaultRecordDirty))
+    {
+        glAppFaultRecordFlushReq = false;
+        return;
+    }
+
+    glAppFaultRecordFlushReq = false;
+
+    /* Alternate between the two rows, so that a valid copy survives an interrupted write */
+    next_row = (glAppFaultRecordFlashRow == CY_APP_FAULT_RECORD_ROW_NUM) ?
+        CY_APP_FAULT_RECORD_BACKUP_ROW_NUM : CY_APP_FAULT_RECORD_ROW_NUM;
+
+    memset(glAppFaultRecordRowBuf, 0, sizeof(glAppFaultRecordRowBuf));
+
+    /* Faults are recorded from interrupt context: take a consistent snapshot before the checksum */
+    intr_state = Cy_SysLib_EnterCriticalSection();
+    glAppFaultRecordDirty = false;
+    glAppFaultRecordRow.signature = CY_APP_FAULT_RECORD_SIGNATURE;
+    glAppFaultRecordRow.seq++;
+    memcpy(row, &glAppFaultRecordRow, sizeof(cy_stc_app_fault_record_row_t));
+    Cy_SysLib_ExitCriticalSection(intr_state);
+
+    row->checksum = fault_record_checksum(row);
+
+    if (Cy_Flash_WriteRow((uint32_t)next_row << CY_APP_SYS_FLASH_ROW_SHIFT_NUM, glAppFaultRecordRowBuf) ==
+            CY_FLASH_DRV_SUCCESS)
+    {
+        glAppFaultRecordFlashRow = next_row;
+    }
+    else
+    {
+        /* Retry along with the next fault */
+        glAppFaultRecordDirty = true;
+    }
+}
+#endif /* CY_APP_FAULT_RECORD_FLASH_ENABLE */
+
+/*
+ * Adds a record of the fault and its recovery action to the ring of the port. Called from
+ * the fault callback: only the fault data is captured; the task completes the record.
+ */
+static void fault_add_record(cy_stc_pdstack_context_t * context, uint8_t fault_id, cy_en_app_fault_action_t action)
+{
+    uint8_t port = context->port;
+    const cy_stc_app_status_t *app_stat = Cy_App_GetStatus(port);
+    const cy_stc_pdstack_dpm_status_t *dpm_stat = &context->dpmStat;
+    cy_stc_app_fault_record_t *rec = &glAppFaultRecord[port][glAppFaultRecordIdx[port]];
+
+    rec->time     = soln_fault_record_time();
+    rec->seq      = glAppFaultRecordSeq++;
+    rec->vbus     = 0u;
+    rec->port     = port;
+    rec->faultId  = fault_id;
+    rec->debounce = fault_get_debounce(context, fault_id);
+    rec->action   = (uint8_t)action;
+
+    if (!context->dpmConfig.contractExist)
+    {
+        rec->contractVolt = 0u;
+        rec->contractCur  = 0u;
+    }
+    else if (context->dpmConfig.curPortRole == CY_PD_PRT_ROLE_SOURCE)
+    {
+        rec->contractVolt = app_stat->psrc_volt;
+        rec->contractCur  = (dpm_stat->srcSelPdo.fixed_src.supplyType == CY_PDSTACK_PDO_AUGMENTED) ?
+            (uint16_t)(dpm_stat->srcRdo.rdo_pps.opCur * 5u) : (uint16_t)dpm_stat->srcRdo.rdo_gen.opPowerCur;
+    }
+    else
+    {
+        rec->contractVolt = app_stat->psnk_volt;
+        rec->contractCur  = app_stat->psnk_cur;
+    }
+
+    glAppFaultRecordIdx[port] = (uint8_t)((glAppFaultRecordIdx[port] + 1u) % CY_APP_FAULT_RECORD_RING_SIZE);
+    if (glAppFaultRecordCount[port] < CY_APP_FAULT_RECORD_RING_SIZE)
+    {
+        glAppFaultRecordCount[port]++;
+    }
+    if (glAppFaultRecordPending[port] < CY_APP_FAULT_RECORD_RING_SIZE)
+    {
+        glAppFaultRecordPending[port]++;
+    }
+}
+
+/* Measures VBus for the records added since the last call and queues them for flash */
+static void fault_record_complete(cy_stc_pdstack_context_t * context)
+{
+    uint8_t port = context->port;
+    cy_stc_app_fault_record_t *rec;
+    uint32_t intr_state;
+    uint16_t vbus;
+    uint8_t slot;
+#if CY_APP_FAULT_RECORD_FLASH_ENABLE
+    cy_timer_id_t timer_id = CY_APP_GET_TIMER_ID(context, CY_APP_FAULT_RECORD_FLUSH_TIMER);
+#endif /* CY_APP_FAULT_RECORD_FLASH_ENABLE */
+
+    if (glAppFaultRecordPending[port] == 0u)
+    {
+        return;
+    }
+
+    vbus = Cy_App_VbusGetValue(context);
+
+    /* Further faults may add records meanwhile */
+    intr_state = Cy_SysLib_EnterCriticalSection();
+
+    slot = (uint8_t)((glAppFaultRecordIdx[port] + CY_APP_FAULT_RECORD_RING_SIZE - glAppFaultRecordPending[port]) %
+            CY_APP_FAULT_RECORD_RING_SIZE);
+    while (glAppFaultRecordPending[port] != 0u)
+    {
+        rec = &glAppFaultRecord[port][slot];
+        rec->vbus = vbus;
+
+#if CY_APP_FAULT_RECORD_FLASH_ENABLE
+        /* Keep the latest records of all ports for flash; the write is deferred so that records are batched */
+        if (glAppFaultRecordRow.count == CY_APP_FAULT_RECORD_ROW_COUNT)
+        {
+            memmove(&glAppFaultRecordRow.record[0], &glAppFaultRecordRow.record[1],
+                    (CY_APP_FAULT_RECORD_ROW_COUNT - 1u) * sizeof(cy_stc_app_fault_record_t));
+            glAppFaultRecordRow.count--;
+        }
+        glAppFaultRecordRow.record[glAppFaultRecordRow.count++] = *rec;
+        glAppFaultRecordDirty = true;
+#endif /* CY_APP_FAULT_RECORD_FLASH_ENABLE */
+
+        slot = (uint8_t)((slot + 1u) % CY_APP_FAULT_RECORD_RING_SIZE);
+        glAppFaultRecordPending[port]--;
+    }
+
+    Cy_SysLib_ExitCriticalSection(intr_state);
+
+#if CY_APP_FAULT_RECORD_FLASH_ENABLE
+    if (!Cy_PdUtils_SwTimer_IsRunning(context->ptrTimerContext, timer_id))
+    {
+        Cy_PdUtils_SwTimer_Start(context->ptrTimerContext, context, timer_id,
+                CY_APP_FAULT_RECORD_FLUSH_DELAY, fault_record_flush_timer_cb);
+    }
+#endif /* CY_APP_FAULT_RECORD_FLASH_ENABLE */
+}
+
+uint8_t Cy_App_Fault_GetRecords(cy_stc_pdstack_context_t * context, cy_stc_app_fault_record_t *records, uint8_t maxCount)
+{
+    uint8_t port = context->port;
+    uint32_t intr_state;
+    uint8_t count;
+    uint8_t idx;
+    uint8_t slot;
+
+    intr_state = Cy_SysLib_EnterCriticalSection();
+
+    count = CY_PDUTILS_GET_MIN(glAppFaultRecordCount[port], maxCount);
+
+    /* Start with the oldest of the latest count records */
+    slot = (uint8_t)((glAppFaultRecordIdx[port] + CY_APP_FAULT_RECORD_RING_SIZE - count) % CY_APP_FAULT_RECORD_RING_SIZE);
+    for (idx = 0u; idx < count; idx++)
+    {
+        records[idx] = glAppFaultRecord[port][slot];
+        slot = (uint8_t)((slot + 1u) % CY_APP_FAULT_RECORD_RING_SIZE);
+    }
+
+    Cy_SysLib_ExitCriticalSection(intr_state);
+
+    return count;
+}
+
+void Cy_App_Fault_ClearRecords(cy_stc_pdstack_context_t * context)
+{
+    uint32_t intr_state;
+
+    /* The write index is kept, as records still pending for the task are located from it */
+    intr_state = Cy_SysLib_EnterCriticalSection();
+    glAppFaultRecordCount[context->port] = 0u;
+    Cy_SysLib_ExitCriticalSection(intr_state);
+}
+#endif /* CY_APP_FAULT_RECORD_ENABLE */
+
 /* Generic routine that notifies the stack about recovery actions for a fault */
-static void app_handle_fault(cy_stc_pdstack_context_t * context, uint32_t fault_type)
+static void app_handle_fault(cy_stc_pdstack_context_t * context, uint8_t fault_type)
 {
     uint8_t port = context->ptrUsbPdContext->port;
-
-    if (fault_type != FAULT_TYPE_VCONN_OCP)
+#if CY_APP_FAULT_BACKOFF_ENABLE
+    uint16_t delay = 0u;
+#endif /* CY_APP_FAULT_BACKOFF_ENABLE */
+#if CY_APP_FAULT_RECORD_ENABLE
+    cy_en_app_fault_action_t action;
+#endif /* CY_APP_FAULT_RECORD_ENABLE */
+
+    if (fault_type != CY_APP_FAULT_TYPE_VCONN_OCP)
     {
         context->dpmStat.faultActive = true;
     }
 
+#if CY_APP_FAULT_BACKOFF_ENABLE
+    /* The contract is no longer stable */
+    Cy_App_Coro_Stop(context, CY_APP_CORO_FAULT_DECAY);
+#endif /* CY_APP_FAULT_BACKOFF_ENABLE */
+
     /* Update the fault count */
     if(glAppFaultRetryLimit[port][fault_type] == FAULT_COUNTER_SKIP_VALUE)
     {
-        /* Do not count faults if infinite fault retry is set */    
+#if CY_APP_FAULT_BACKOFF_ENABLE
+        /* Infinite fault retry is set: the count only marks the fault active and never exceeds the limit */
+        if (glAppFaultCount[port][fault_type] < FAULT_COUNTER_SKIP_VALUE)
+        {
+            glAppFaultCount[port][fault_type]++;
+        }
+#endif /* CY_APP_FAULT_BACKOFF_ENABLE */
     }
     else
     {
         glAppFaultCount[port][fault_type]++;
     }
+    fault_update_status(port, fault_type);
 
     if (glAppFaultCount[port][fault_type] < (glAppFaultRetryLimit[port][fault_type] + 1))
     {
+#if CY_APP_FAULT_BACKOFF_ENABLE
+        if (glAppFaultBackoffLevel[port][fault_type] < 0xFFu)
+        {
+            glAppFaultBackoffLevel[port][fault_type]++;
+        }
+
+        if (glAppFaultPolicy[port][fault_type].baseDelay != 0u)
+        {
+            delay = app_fault_backoff_delay(&glAppFaultPolicy[port][fault_type], glAppFaultBackoffLevel[port][fault_type]);
+            glAppFaultRecoveryStats[port].lastDelay = delay;
+            glAppFaultRecoveryStats[port].totalDelay += delay;
+        }
+        glAppFaultRecoveryStats[port].attempts++;
+#endif /* CY_APP_FAULT_BACKOFF_ENABLE */
+
 #if VCONN_OCP_ENABLE
-        if (fault_type == FAULT_TYPE_VCONN_OCP)
+        if (fault_type == CY_APP_FAULT_TYPE_VCONN_OCP)
         {
             /* Start VConn turn OFF procedure and start a timer to restore VConn after a delay */
             Cy_App_VconnChangeHandler (context, false);
             Cy_PdUtils_SwTimer_Start (context->ptrTimerContext, context, CY_PDSTACK_GET_PD_TIMER_ID(context, CY_PDSTACK_PD_VCONN_RECOVERY_TIMER),
+#if CY_APP_FAULT_BACKOFF_ENABLE
+                    (delay != 0u) ? delay :
+#endif /* CY_APP_FAULT_BACKOFF_ENABLE */
                     CY_APP_VCONN_RECOVERY_PERIOD, vconn_restore_timer_cb);
         }
         else
 #endif /* VCONN_OCP_ENABLE */
+#if CY_APP_FAULT_BACKOFF_ENABLE
+        if (delay != 0u)
+        {
+            /* Keep the power stage off for the backoff delay before the recovery */
+            Cy_App_Coro_Start(context, CY_APP_CORO_FAULT_BACKOFF, fault_backoff_recover, delay);
+        }
+        else
+#endif /* CY_APP_FAULT_BACKOFF_ENABLE */
         {
-            context->peStat.hardResetCount = 0;
             /*
              * Try a hard reset to recover from fault
              * If not successful (not in PD contract), try Type-C error recovery.
              */
-            if (Cy_PdStack_Dpm_SendPdCommand(context, CY_PDSTACK_DPM_CMD_SEND_HARD_RESET, NULL, false, NULL) != CY_PDSTACK_STAT_SUCCESS)
-            {
-                Cy_PdStack_Dpm_SendTypecCommand(context, CY_PDSTACK_DPM_CMD_TYPEC_ERR_RECOVERY, NULL);
-            }
+            app_fault_recover(context);
         }
     }
     else
     {
 #if VCONN_OCP_ENABLE
-        if (fault_type == FAULT_TYPE_VCONN_OCP)
+        if (fault_type == CY_APP_FAULT_TYPE_VCONN_OCP)
         {
             Cy_App_VconnChangeHandler (context, false);
         }
@@ -219,8 +860,68 @@ static void app_handle_fault(cy_stc_pdstack_context_t * context, uint32_t fault_
             Cy_App_Fault_ConfigureForDetach(context);
         }
     }
+
+#if CY_APP_FAULT_RECORD_ENABLE
+    if ((glAppFaultStatus[port] & CY_APP_FAULT_STATUS_EXCEEDED(fault_type)) != 0u)
+    {
+        action = CY_APP_FAULT_ACTION_DISABLE;
+    }
+    else if (fault_type == CY_APP_FAULT_TYPE_VCONN_OCP)
+    {
+        action = CY_APP_FAULT_ACTION_VCONN_RESTORE;
+    }
+#if CY_APP_FAULT_BACKOFF_ENABLE
+    else if (delay != 0u)
+    {
+        action = CY_APP_FAULT_ACTION_BACKOFF;
+    }
+#endif /* CY_APP_FAULT_BACKOFF_ENABLE */
+    else
+    {
+        action = CY_APP_FAULT_ACTION_RECOVER;
+    }
+    fault_add_record(context, fault_type, action);
+#endif /* CY_APP_FAULT_RECORD_ENABLE */
+}
+
+#if (CY_APP_FAULT_SOLN_SOURCE_COUNT != 0u)
+cy_en_app_status_t Cy_App_Fault_RegisterSource(cy_stc_pdstack_context_t * context, uint8_t retryLimit, uint8_t *faultId)
+{
+    uint8_t port = context->port;
+    uint8_t fault_id;
+
+    if (faultId == NULL)
+    {
+        return CY_APP_STAT_BAD_PARAM;
+    }
+
+    if (glAppFaultSolnCount[port] >= CY_APP_FAULT_SOLN_SOURCE_COUNT)
+    {
+        return CY_APP_STAT_NOT_SUPPORTED;
+    }
+
+    fault_id = (uint8_t)CY_APP_FAULT_TYPE_COUNT + glAppFaultSolnCount[port];
+    glAppFaultRetryLimit[port][fault_id] = retryLimit;
+    glAppFaultCount[port][fault_id] = 0u;
+    fault_update_status(port, fault_id);
+    glAppFaultSolnCount[port]++;
+
+    *faultId = fault_id;
+    return CY_APP_STAT_SUCCESS;
 }
 
+cy_en_app_status_t Cy_App_Fault_Report(cy_stc_pdstack_context_t * context, uint8_t faultId)
+{
+    if ((faultId < (uint8_t)CY_APP_FAULT_TYPE_COUNT) || (!fault_is_valid_id(context->port, faultId)))
+    {
+        return CY_APP_STAT_BAD_PARAM;
+    }
+
+    app_handle_fault(context, faultId);
+    return CY_APP_STAT_SUCCESS;
+}
+#endif /* (CY_APP_FAULT_SOLN_SOURCE_COUNT != 0u) */
+
 /* Timer used to re-enable the PD port after a fault */
 static void fault_recovery_timer_cb(cy_timer_id_t id, void *context)
 {
@@ -303,7 +1004,8 @@ void Cy_App_Fault_ClearCounts (uint8_t port)
 {
 #if CY_APP_FAULT_HANDLER_ENABLE
     /* Clear all fault counters on disconnect */
-    memset ((uint8_t *)glAppFaultCount[port], 0, FAULT_TYPE_COUNT);
+    memset ((uint8_t *)glAppFaultCount[port], 0, CY_APP_FAULT_SOURCE_COUNT);
+    glAppFaultStatus[port] = 0u;
 #endif /* CY_APP_FAULT_HANDLER_ENABLE */
 
     (void)port;
@@ -337,6 +1039,10 @@ bool Cy_App_Fault_EventHandler(cy_stc_pdstack_context_t * context, cy_en_pdstack
             {
                 /* Clear fault counters in cases where an actual disconnect has been detected */
                 Cy_App_Fault_ClearCounts (port);
+#if CY_APP_FAULT_BACKOFF_ENABLE
+                Cy_App_Coro_Stop(context, CY_APP_CORO_FAULT_BACKOFF);
+                Cy_App_Coro_Stop(context, CY_APP_CORO_FAULT_DECAY);
+#endif /* CY_APP_FAULT_BACKOFF_ENABLE */
             }
             break;
 
@@ -345,47 +1051,51 @@ bool Cy_App_Fault_EventHandler(cy_stc_pdstack_context_t * context, cy_en_pdstack
             break;
 
         case APP_EVT_PD_CONTRACT_NEGOTIATION_COMPLETE:
+#if CY_APP_FAULT_BACKOFF_ENABLE
+            /* Start forgetting earlier faults once the new contract has been stable for a while */
+            Cy_App_Coro_Start(context, CY_APP_CORO_FAULT_DECAY, fault_decay, CY_APP_FAULT_DECAY_PERIOD);
+#endif /* CY_APP_FAULT_BACKOFF_ENABLE */
             break;
 
 #if VBUS_OCP_ENABLE
         case APP_EVT_VBUS_OCP_FAULT:
             CY_APP_DEBUG_LOG(port, (port == 0 ? CY_APP_DEBUG_PD_P0_VBUS_OC : CY_APP_DEBUG_PD_P1_VBUS_OC), NULL, 0, CY_APP_DEBUG_LOGLEVEL_ERROR, true);
-            app_handle_fault(context, FAULT_TYPE_VBUS_OCP);
+            app_handle_fault(context, CY_APP_FAULT_TYPE_VBUS_OCP);
             break;
 #endif /* VBUS_OCP_ENABLE */
 
 #if VBUS_SCP_ENABLE
         case APP_EVT_VBUS_SCP_FAULT:
             CY_APP_DEBUG_LOG(port, (port == 0 ? CY_APP_DEBUG_PD_P0_VBUS_SC : CY_APP_DEBUG_PD_P1_VBUS_SC), NULL, 0, CY_APP_DEBUG_LOGLEVEL_ERROR, true);
-            app_handle_fault(context, FAULT_TYPE_VBUS_SCP);            
+            app_handle_fault(context, CY_APP_FAULT_TYPE_VBUS_SCP);            
             break;
 #endif /* VBUS_SCP_ENABLE */
 
 #if VBUS_RCP_ENABLE
         case APP_EVT_VBUS_RCP_FAULT:
             CY_APP_DEBUG_LOG(port, (port == 0 ? CY_APP_DEBUG_PD_P0_VBUS_RC : CY_APP_DEBUG_PD_P1_VBUS_RC), NULL, 0, CY_APP_DEBUG_LOGLEVEL_ERROR, true);
-            app_handle_fault(context, FAULT_TYPE_VBUS_RCP);           
+            app_handle_fault(context, CY_APP_FAULT_TYPE_VBUS_RCP);           
             break;
 #endif /* VBUS_RCP_ENABLE */
 
 #if VBUS_OVP_ENABLE
         case APP_EVT_VBUS_OVP_FAULT:
             CY_APP_DEBUG_LOG(port, (port == 0 ? CY_APP_DEBUG_PD_P0_VBUS_OV : CY_APP_DEBUG_PD_P1_VBUS_OV), NULL, 0, CY_APP_DEBUG_LOGLEVEL_ERROR, true);
-            app_handle_fault(context, FAULT_TYPE_VBUS_OVP);
+            app_handle_fault(context, CY_APP_FAULT_TYPE_VBUS_OVP);
             break;
 #endif /* VBUS_OVP_ENABLE */
 
 #if VBUS_UVP_ENABLE
         case APP_EVT_VBUS_UVP_FAULT:
             CY_APP_DEBUG_LOG(port, (port == 0 ? CY_APP_DEBUG_PD_P0_VBUS_UV : CY_APP_DEBUG_PD_P1_VBUS_UV), NULL, 0, CY_APP_DEBUG_LOGLEVEL_ERROR, true);
-            app_handle_fault(context, FAULT_TYPE_VBUS_UVP);
+            app_handle_fault(context, CY_APP_FAULT_TYPE_VBUS_UVP);
             break;
 #endif /* VBUS_UVP_ENABLE */
 
 #if VCONN_OCP_ENABLE
         case APP_EVT_VCONN_OCP_FAULT:
             CY_APP_DEBUG_LOG(port, (port == 0 ? CY_APP_DEBUG_PD_P0_VCONN_OC : CY_APP_DEBUG_PD_P1_VCONN_OC), NULL, 0, CY_APP_DEBUG_LOGLEVEL_ERROR, true);
-            app_handle_fault(context, FAULT_TYPE_VCONN_OCP);
+            app_handle_fault(context, CY_APP_FAULT_TYPE_VCONN_OCP);
             break;
 #endif /* VCONN_OCP_ENABLE */
 
@@ -406,49 +1116,89 @@ bool Cy_App_Fault_InitVars (cy_stc_pdstack_context_t * context)
     cy_stc_usbpd_config_t * fault_config = context->ptrUsbPdContext->usbpdConfig;
     uint8_t port = context->port;
 #endif /* (VBUS_OVP_ENABLE || VBUS_UVP_ENABLE || VBUS_OCP_ENABLE || VBUS_SCP_ENABLE || VBUS_RCP_ENABLE) */
+#if CY_APP_FAULT_HANDLER_ENABLE
+    uint8_t idx;
+#endif /* CY_APP_FAULT_HANDLER_ENABLE */
 
 #if VBUS_OVP_ENABLE
     if (fault_config->vbusOvpConfig != NULL)
     {
-        glAppFaultRetryLimit[port][FAULT_TYPE_VBUS_OVP] = fault_config->vbusOvpConfig->retryCount;
+        glAppFaultRetryLimit[port][CY_APP_FAULT_TYPE_VBUS_OVP] = fault_config->vbusOvpConfig->retryCount;
     }
 #endif /* VBUS_OVP_ENABLE */
 
 #if VBUS_OCP_ENABLE
     if (fault_config->vbusOcpConfig != NULL)
     {
-        glAppFaultRetryLimit[port][FAULT_TYPE_VBUS_OCP] = fault_config->vbusOcpConfig->retryCount;
+        glAppFaultRetryLimit[port][CY_APP_FAULT_TYPE_VBUS_OCP] = fault_config->vbusOcpConfig->retryCount;
     }
 #endif /* VBUS_OCP_ENABLE */
 
 #if VBUS_RCP_ENABLE
     if (fault_config->vbusRcpConfig != NULL)
     {
-        glAppFaultRetryLimit[port][FAULT_TYPE_VBUS_RCP] = fault_config->vbusRcpConfig->retryCount;
+        glAppFaultRetryLimit[port][CY_APP_FAULT_TYPE_VBUS_RCP] = fault_config->vbusRcpConfig->retryCount;
     }
 #endif /* VBUS_RCP_ENABLE */
 
 #if VBUS_UVP_ENABLE
     if (fault_config->vbusUvpConfig != NULL)
     {
-        glAppFaultRetryLimit[port][FAULT_TYPE_VBUS_UVP] = fault_config->vbusUvpConfig->retryCount;
+        glAppFaultRetryLimit[port][CY_APP_FAULT_TYPE_VBUS_UVP] = fault_config->vbusUvpConfig->retryCount;
     }
 #endif /* VBUS_UVP_ENABLE */
 
 #if VBUS_SCP_ENABLE
     if (fault_config->vbusScpConfig != NULL)
     {
-        glAppFaultRetryLimit[port][FAULT_TYPE_VBUS_SCP] = fault_config->vbusScpConfig->retryCount;
+        glAppFaultRetryLimit[port][CY_APP_FAULT_TYPE_VBUS_SCP] = fault_config->vbusScpConfig->retryCount;
     }
 #endif /* VBUS_SCP_ENABLE */
 
 #if VCONN_OCP_ENABLE
     if (fault_config->vconnOcpConfig != NULL)
     {
-        glAppFaultRetryLimit[port][FAULT_TYPE_VCONN_OCP] = fault_config->vconnOcpConfig->retryCount;
+        glAppFaultRetryLimit[port][CY_APP_FAULT_TYPE_VCONN_OCP] = fault_config->vconnOcpConfig->retryCount;
     }
 #endif /* VCONN_OCP_ENABLE */
 
+#if CY_APP_FAULT_HANDLER_ENABLE
+#if (CY_APP_FAULT_SOLN_SOURCE_COUNT != 0u)
+    /* Solution fault sources are registered again after the initialization */
+    glAppFaultSolnCount[context->port] = 0u;
+    for (idx = (uint8_t)CY_APP_FAULT_TYPE_COUNT; idx < CY_APP_FAULT_SOURCE_COUNT; idx++)
+    {
+        glAppFaultRetryLimit[context->port][idx] = 0u;
+        glAppFaultCount[context->port][idx] = 0u;
+#if CY_APP_FAULT_BACKOFF_ENABLE
+        memset(&glAppFaultPolicy[context->port][idx], 0, sizeof(cy_stc_app_fault_policy_t));
+        glAppFaultPolicySet[context->port] &= ~(1UL << idx);
+        glAppFaultBackoffLevel[context->port][idx] = 0u;
+#endif /* CY_APP_FAULT_BACKOFF_ENABLE */
+    }
+#endif /* (CY_APP_FAULT_SOLN_SOURCE_COUNT != 0u) */
+
+    /* Limits may have changed */
+    for (idx = 0u; idx < CY_APP_FAULT_SOURCE_COUNT; idx++)
+    {
+#if CY_APP_FAULT_BACKOFF_ENABLE
+        /* Registered policies take precedence over the configuration table */
+        if ((glAppFaultPolicySet[context->port] & (1UL << idx)) != 0u)
+        {
+            glAppFaultRetryLimit[context->port][idx] = glAppFaultPolicy[context->port][idx].retryLimit;
+        }
+#endif /* CY_APP_FAULT_BACKOFF_ENABLE */
+        fault_update_status(context->port, idx);
+    }
+
+#if CY_APP_FAULT_RECORD_ENABLE
+    fault_record_time_start(context);
+#if CY_APP_FAULT_RECORD_FLASH_ENABLE
+    fault_record_load();
+#endif /* CY_APP_FAULT_RECORD_FLASH_ENABLE */
+#endif /* CY_APP_FAULT_RECORD_ENABLE */
+#endif /* CY_APP_FAULT_HANDLER_ENABLE */
+
     (void) context;
     return true;
 }
@@ -468,6 +1218,13 @@ void Cy_App_Fault_Task(cy_stc_pdstack_context_t * context)
             glAppPdStatus[port].faultStatus |= CY_APP_PORT_DISABLE_IN_PROGRESS;
         }
     }
+
+#if CY_APP_FAULT_RECORD_ENABLE
+    fault_record_complete(context);
+#if CY_APP_FAULT_RECORD_FLASH_ENABLE
+    fault_record_flush();
+#endif /* CY_APP_FAULT_RECORD_FLASH_ENABLE */
+#endif /* CY_APP_FAULT_RECORD_ENABLE */
 #else
     (void)context;
 #endif /* CY_APP_FAULT_HANDLER_ENABLE */
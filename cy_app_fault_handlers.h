@@ -24,6 +24,7 @@
 #include <stdint.h>
 #include "cy_app_debug.h"
 #include "cy_app_config.h"
+#include "cy_app_status.h"
 
 #include "cy_usbpd_common.h"
 #include "cy_usbpd_vbus_ctrl.h"
@@ -90,10 +91,219 @@
 *    \snippet fault_handler_sut.c snippet_fault_handler_task
 *    \n
 *
+* With CY_APP_FAULT_BACKOFF_ENABLE set, a recovery policy can be registered
+* for each fault type with Cy_App_Fault_SetPolicy. The recovery from each
+* fault is then delayed by a backoff that doubles with every occurrence of the
+* fault, up to a maximum delay, and is spread by a random jitter. The
+* occurrences which set the delay are kept across disconnects and polarity
+* changes; once a PD contract has been stable for CY_APP_FAULT_DECAY_PERIOD ms,
+* one occurrence of each fault type is forgotten per period. Fault types
+* without a policy recover immediately with the retry limit of the
+* configuration table.
+*
+* Besides the built-in fault types, up to CY_APP_FAULT_SOLN_SOURCE_COUNT
+* solution fault sources, such as a thermal or input undervoltage monitor, can
+* be registered on each port with Cy_App_Fault_RegisterSource. The solution
+* reports their faults with Cy_App_Fault_Report; they are then counted and
+* recovered from like the built-in faults. Cy_App_Fault_GetStatus returns the
+* active and exceeded bits of all fault sources of a port in one word.
+*
+* With CY_APP_FAULT_RECORD_ENABLE set, a record of each fault is added to a
+* ring of CY_APP_FAULT_RECORD_RING_SIZE records per port: the contract voltage
+* and current, the VBus voltage, the debounce configured for the fault and the
+* recovery action taken. The fault callback only captures the raw fault data;
+* VBus is measured and the record is queued for flash by Cy_App_Fault_Task.
+* Records are time stamped by soln_fault_record_time(), a weak function which
+* returns the time in ms since the fault handler of the first port has been
+* initialized, unless the solution provides a clock. With
+* CY_APP_FAULT_RECORD_FLASH_ENABLE also set, the latest
+* CY_APP_FAULT_RECORD_ROW_COUNT records of all ports are written to the
+* CY_APP_FAULT_RECORD_ROW_NUM and CY_APP_FAULT_RECORD_BACKUP_ROW_NUM flash rows
+* in turn, at most once every CY_APP_FAULT_RECORD_FLUSH_DELAY ms, from
+* Cy_App_Fault_Task.
+*
+* \defgroup group_pmg_app_common_fault_macros Macros
+* \defgroup group_pmg_app_common_fault_enums Enumerated types
+* \defgroup group_pmg_app_common_fault_data_structures Data structures
 * \defgroup group_pmg_app_common_fault_functions Functions
 */
 /** \} group_pmg_app_common_fault */
 
+/*******************************************************************************
+ * Macros
+ ******************************************************************************/
+/**
+* \addtogroup group_pmg_app_common_fault_macros
+* \{
+*/
+
+#ifndef CY_APP_FAULT_DECAY_PERIOD
+/** Time in ms of stable PD contract after which one occurrence of each fault
+ * type is forgotten. */
+#define CY_APP_FAULT_DECAY_PERIOD                   (10000u)
+#endif /* CY_APP_FAULT_DECAY_PERIOD */
+
+/** Retry limit with which the occurrences of a fault never exceed the limit.
+ * Such faults are only counted, and so only set their active status bit, with
+ * CY_APP_FAULT_BACKOFF_ENABLE set. */
+#define CY_APP_FAULT_RETRY_INFINITE                 (255u)
+
+#ifndef CY_APP_FAULT_SOLN_SOURCE_COUNT
+/** Maximum number of solution fault sources registered on each port. */
+#define CY_APP_FAULT_SOLN_SOURCE_COUNT              (0u)
+#endif /* CY_APP_FAULT_SOLN_SOURCE_COUNT */
+
+/** @cond DOXYGEN_HIDE */
+/* Number of built-in fault types; must match CY_APP_FAULT_TYPE_COUNT */
+#define CY_APP_FAULT_BUILTIN_COUNT                  (9u)
+/** @endcond */
+
+/* Each fault source has one active and one exceeded bit in the 32-bit status */
+#if ((CY_APP_FAULT_BUILTIN_COUNT + CY_APP_FAULT_SOLN_SOURCE_COUNT) > 16u)
+#error "CY_APP_FAULT_SOURCE_COUNT cannot be more than 16."
+#endif /* ((CY_APP_FAULT_BUILTIN_COUNT + CY_APP_FAULT_SOLN_SOURCE_COUNT) > 16u) */
+
+/** Number of fault sources of each port, built-in and solution defined. */
+#define CY_APP_FAULT_SOURCE_COUNT                   ((uint8_t)CY_APP_FAULT_TYPE_COUNT + CY_APP_FAULT_SOLN_SOURCE_COUNT)
+
+/** Status bit of a fault source which has occurred since the last clear. */
+#define CY_APP_FAULT_STATUS_ACTIVE(id)              (1UL << (id))
+
+/** Status bit of a fault source which has exceeded its retry limit. */
+#define CY_APP_FAULT_STATUS_EXCEEDED(id)            (1UL << ((id) + 16u))
+
+/** Mask of the exceeded bits of the fault status. */
+#define CY_APP_FAULT_STATUS_EXCEEDED_MASK           (0xFFFF0000UL)
+
+#ifndef CY_APP_FAULT_RECORD_RING_SIZE
+/** Number of fault records kept in RAM for each port. */
+#define CY_APP_FAULT_RECORD_RING_SIZE               (8u)
+#endif /* CY_APP_FAULT_RECORD_RING_SIZE */
+
+#ifndef CY_APP_FAULT_RECORD_ROW_COUNT
+/** Number of fault records of all ports kept in flash. The row structure has
+ * to fit in a flash row. */
+#define CY_APP_FAULT_RECORD_ROW_COUNT               (7u)
+#endif /* CY_APP_FAULT_RECORD_ROW_COUNT */
+
+#ifndef CY_APP_FAULT_RECORD_FLUSH_DELAY
+/** Time in ms from a new fault record to the flash write, so that records
+ * are batched. */
+#define CY_APP_FAULT_RECORD_FLUSH_DELAY             (5000u)
+#endif /* CY_APP_FAULT_RECORD_FLUSH_DELAY */
+
+#ifndef CY_APP_FAULT_RECORD_TIME_PERIOD
+/** Period in ms of the timer which provides the default time stamp of the
+ * fault records. The timer wakes the device once per period. */
+#define CY_APP_FAULT_RECORD_TIME_PERIOD             (60000u)
+#endif /* CY_APP_FAULT_RECORD_TIME_PERIOD */
+
+/** Signature of a flash row holding fault records. */
+#define CY_APP_FAULT_RECORD_SIGNATURE               (0x43455246UL)
+
+/** \} group_pmg_app_common_fault_macros */
+
+/*******************************************************************************
+ * Enumerated Data Definition
+ ******************************************************************************/
+/**
+* \addtogroup group_pmg_app_common_fault_enums
+* \{
+*/
+
+/**
+ * @typedef cy_en_app_fault_type_t
+ * @brief Built-in fault types tracked by the fault handler. Their values are
+ * also the IDs of the built-in fault sources.
+ */
+typedef enum
+{
+    CY_APP_FAULT_TYPE_VBUS_OVP = 0,     /**< VBus overvoltage. */
+    CY_APP_FAULT_TYPE_VBUS_UVP,         /**< VBus undervoltage. */
+    CY_APP_FAULT_TYPE_VBUS_OCP,         /**< VBus overcurrent. */
+    CY_APP_FAULT_TYPE_VBUS_SCP,         /**< VBus short circuit. */
+    CY_APP_FAULT_TYPE_CC_OVP,           /**< CC line overvoltage. */
+    CY_APP_FAULT_TYPE_VCONN_OCP,        /**< VConn overcurrent. */
+    CY_APP_FAULT_TYPE_SBU_OVP,          /**< SBU line overvoltage. */
+    CY_APP_FAULT_TYPE_OTP,              /**< Overtemperature. */
+    CY_APP_FAULT_TYPE_VBUS_RCP,         /**< VBus reverse current. */
+    CY_APP_FAULT_TYPE_COUNT             /**< Number of fault types. */
+} cy_en_app_fault_type_t;
+
+/**
+ * @typedef cy_en_app_fault_action_t
+ * @brief Recovery action taken for a fault.
+ */
+typedef enum
+{
+    CY_APP_FAULT_ACTION_RECOVER = 0,    /**< Hard reset or Type-C error recovery. */
+    CY_APP_FAULT_ACTION_BACKOFF,        /**< Hard reset or Type-C error recovery after a backoff delay. */
+    CY_APP_FAULT_ACTION_VCONN_RESTORE,  /**< VConn turned off and restored after a delay. */
+    CY_APP_FAULT_ACTION_DISABLE         /**< Retry limit exceeded; port or VConn off until detach. */
+} cy_en_app_fault_action_t;
+
+/** \} group_pmg_app_common_fault_enums */
+
+/*******************************************************************************
+ * Data Struct Definition
+ ******************************************************************************/
+/**
+* \addtogroup group_pmg_app_common_fault_data_structures
+* \{
+*/
+
+/**
+ * @brief Recovery policy of a fault type
+ */
+typedef struct
+{
+    uint16_t baseDelay;                 /**< Delay in ms before the recovery from the first occurrence; 0 to recover immediately. */
+    uint16_t maxDelay;                  /**< Maximum delay in ms before the recovery. */
+    uint8_t retryLimit;                 /**< Number of recoveries before the port waits for a detach, or CY_APP_FAULT_RETRY_INFINITE. */
+    uint8_t jitter;                     /**< Random spread of the delay in percent. */
+} cy_stc_app_fault_policy_t;
+
+/**
+ * @brief Fault recovery statistics of a port
+ */
+typedef struct
+{
+    uint32_t totalDelay;                /**< Total backoff delay in ms. */
+    uint16_t attempts;                  /**< Number of recoveries, each re-applying the power stage. */
+    uint16_t lastDelay;                 /**< Backoff delay in ms of the last recovery. */
+} cy_stc_app_fault_recovery_stats_t;
+
+/**
+ * @brief Record of a fault
+ */
+typedef struct
+{
+    uint32_t time;                      /**< Time stamp from soln_fault_record_time(), in ms by default. */
+    uint16_t seq;                       /**< Sequence number of the record on all ports. */
+    uint16_t contractVolt;              /**< Contract voltage in mV; 0 if there is no PD contract. */
+    uint16_t contractCur;               /**< Contract current in 10 mA units; 0 if there is no PD contract. */
+    uint16_t vbus;                      /**< VBus voltage in mV measured by the task after the fault; 0 until then. */
+    uint8_t port;                       /**< Port of the fault. */
+    uint8_t faultId;                    /**< Fault type or solution fault source ID. */
+    uint8_t debounce;                   /**< Debounce configured for the fault; 0 if none. */
+    uint8_t action;                     /**< Recovery action, of type cy_en_app_fault_action_t. */
+} cy_stc_app_fault_record_t;
+
+/**
+ * @brief Fault records as stored in a flash row
+ */
+typedef struct
+{
+    uint32_t signature;                 /**< CY_APP_FAULT_RECORD_SIGNATURE. */
+    uint16_t seq;                       /**< Incremented on each write, to find the current row. */
+    uint16_t checksum;                  /**< 16-bit sum over seq, count and the records. */
+    uint8_t count;                      /**< Number of valid records. */
+    uint8_t reserved[3];                /**< Reserved for alignment. */
+    cy_stc_app_fault_record_t record[CY_APP_FAULT_RECORD_ROW_COUNT];   /**< Records, oldest first. */
+} cy_stc_app_fault_record_row_t;
+
+/** \} group_pmg_app_common_fault_data_structures */
+
 
 /*******************************************************************************
  * Functions
@@ -302,6 +512,95 @@ void Cy_App_Fault_ConfigureForDetach(cy_stc_pdstack_context_t * context);
  */    
 bool Cy_App_Fault_IsCountExceeded(cy_stc_pdstack_context_t * context);
 
+/**
+ * @brief Returns the fault status of the port
+ *
+ * @param context Pointer to the pdstack context
+ *
+ * @return CY_APP_FAULT_STATUS_ACTIVE and CY_APP_FAULT_STATUS_EXCEEDED bits of
+ * all fault sources of the port.
+ */
+uint32_t Cy_App_Fault_GetStatus(cy_stc_pdstack_context_t * context);
+
+#if ((CY_APP_FAULT_SOLN_SOURCE_COUNT != 0u) || DOXYGEN)
+/**
+ * @brief Register a solution fault source on the port
+ *
+ * @param context Pointer to the pdstack context
+ * @param retryLimit Number of recoveries before the port waits for a detach,
+ * or CY_APP_FAULT_RETRY_INFINITE
+ * @param faultId Returns the ID of the fault source
+ *
+ * @return CY_APP_STAT_SUCCESS if the source is registered; CY_APP_STAT_BAD_PARAM
+ * if faultId is NULL; CY_APP_STAT_NOT_SUPPORTED if all sources of the port
+ * are registered.
+ *
+ * @note Cy_App_Fault_InitVars drops the registered sources, so they have to be
+ * registered after it.
+ */
+cy_en_app_status_t Cy_App_Fault_RegisterSource(cy_stc_pdstack_context_t * context, uint8_t retryLimit, uint8_t *faultId);
+
+/**
+ * @brief Report a fault of a solution fault source. The fault is counted and
+ * recovered from like a built-in fault.
+ *
+ * @param context Pointer to the pdstack context
+ * @param faultId ID returned by Cy_App_Fault_RegisterSource
+ *
+ * @return CY_APP_STAT_SUCCESS if the fault is handled; CY_APP_STAT_BAD_PARAM if
+ * the ID is not a registered solution fault source.
+ */
+cy_en_app_status_t Cy_App_Fault_Report(cy_stc_pdstack_context_t * context, uint8_t faultId);
+#endif /* ((CY_APP_FAULT_SOLN_SOURCE_COUNT != 0u) || DOXYGEN) */
+
+#if (CY_APP_FAULT_RECORD_ENABLE || DOXYGEN)
+/**
+ * @brief Read the fault records of the port, oldest first
+ *
+ * @param context Pointer to the pdstack context
+ * @param records Buffer for the records
+ * @param maxCount Maximum number of records to be read
+ *
+ * @return Number of records read.
+ */
+uint8_t Cy_App_Fault_GetRecords(cy_stc_pdstack_context_t * context, cy_stc_app_fault_record_t *records, uint8_t maxCount);
+
+/**
+ * @brief Clear the fault records of the port kept in RAM
+ *
+ * @param context Pointer to the pdstack context
+ *
+ * @return None
+ */
+void Cy_App_Fault_ClearRecords(cy_stc_pdstack_context_t * context);
+#endif /* (CY_APP_FAULT_RECORD_ENABLE || DOXYGEN) */
+
+#if (CY_APP_FAULT_BACKOFF_ENABLE || DOXYGEN)
+/**
+ * @brief Register the recovery policy of a fault source. The retry limit of
+ * the policy replaces the limit from the configuration table, also when
+ * Cy_App_Fault_InitVars is called later.
+ *
+ * @param context Pointer to the pdstack context
+ * @param faultId Fault type, or ID of a registered solution fault source
+ * @param policy Recovery policy; copied
+ *
+ * @return CY_APP_STAT_SUCCESS if the policy is registered; CY_APP_STAT_BAD_PARAM
+ * if the fault source or the policy is invalid.
+ */
+cy_en_app_status_t Cy_App_Fault_SetPolicy(cy_stc_pdstack_context_t * context,
+        uint8_t faultId, const cy_stc_app_fault_policy_t *policy);
+
+/**
+ * @brief Returns the fault recovery statistics of the port
+ *
+ * @param context Pointer to the pdstack context
+ *
+ * @return Pointer to the statistics.
+ */
+const cy_stc_app_fault_recovery_stats_t* Cy_App_Fault_GetRecoveryStats(cy_stc_pdstack_context_t * context);
+#endif /* (CY_APP_FAULT_BACKOFF_ENABLE || DOXYGEN) */
+
 /** \} group_pmg_app_common_fault_functions */
 
 #endif /* _CY_APP_FAULT_HANDLERS_H_ */
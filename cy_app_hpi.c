@@ -19,6 +19,12 @@
 #include "cy_hpi.h"
 #include "cy_app_hpi.h"
 #include "cy_pdstack_common.h"
+#if CY_APP_TELEMETRY_ENABLE
+#include "cy_app_telemetry.h"
+#endif /* CY_APP_TELEMETRY_ENABLE */
+#if CY_APP_SINK_ENERGY_ENABLE
+#include "cy_app_sink_energy.h"
+#endif /* CY_APP_SINK_ENERGY_ENABLE */
 
 
 /** Data buffer to store the PD responses.
@@ -35,7 +41,9 @@ static const uint8_t gl_pdRespMinLen[CY_APP_PD_RESP_ID_MAX_NUM] =
     CY_APP_PD_RESP_MIN_DATA_LEN_W_HDR,         /* Battery Status PD Response ID min length is 5 with header. */
     CY_APP_PD_RESP_MIN_DATA_LEN_W_HDR,         /* Battery Capabilities Response ID min length is 5 with header. */
     CY_APP_PD_RESP_MIN_DATA_LEN_WO_HDR,        /* Source Info Response ID min length is 1 without header. */
-    CY_APP_PD_RESP_MIN_DATA_LEN_WO_HDR         /* PD Revision (message) Response ID min length is 1 without header. */
+    CY_APP_PD_RESP_MIN_DATA_LEN_WO_HDR,        /* PD Revision (message) Response ID min length is 1 without header. */
+    CY_APP_PD_RESP_MIN_DATA_LEN_WO_HDR,        /* Telemetry Response ID is not stored. */
+    CY_APP_PD_RESP_MIN_DATA_LEN_WO_HDR         /* Sink energy Response ID is not stored. */
 };
 
 /**< Constant to hold the response ID-specific match length for data. */
@@ -45,7 +53,9 @@ static const uint8_t gl_pdRespMatchLen[CY_APP_PD_RESP_ID_MAX_NUM] =
     CY_APP_PD_RESP_MATCH_LENGTH_W_HDR,          /* Battery Status PD Response ID match length is 2 bytes. */
     CY_APP_PD_RESP_MATCH_LENGTH_W_HDR,          /* Battery Capabilities PD Response ID match length is 2 bytes. */
     CY_APP_PD_RESP_MATCH_LENGTH_WO_HDR,         /* Source Info Response ID match length is 0 bytes. */
-    CY_APP_PD_RESP_MATCH_LENGTH_WO_HDR          /* PD Revision (Message) Response ID match length is 0 bytes. */
+    CY_APP_PD_RESP_MATCH_LENGTH_WO_HDR,         /* PD Revision (Message) Response ID match length is 0 bytes. */
+    CY_APP_PD_RESP_MATCH_LENGTH_WO_HDR,         /* Telemetry Response ID is not stored. */
+    CY_APP_PD_RESP_MATCH_LENGTH_WO_HDR          /* Sink energy Response ID is not stored. */
 };
 
 /**
@@ -446,6 +456,65 @@ cy_en_pdstack_status_t Cy_App_Hpi_HandlePdRespDataRw(cy_stc_hpi_context_t *ptrHp
             cmdStat = CY_PDSTACK_STAT_INVALID_ARGUMENT;
             break;
         }
+        if (CY_APP_PD_RESP_ID_TELEMETRY == ptrPdRespData->respId)
+        {
+#if CY_APP_TELEMETRY_ENABLE
+            /* Telemetry is produced by the sampler and is not stored in the common buffer. */
+            if (CY_APP_PD_RESP_DATA_CMD_READ == ptrPdRespData->dataCmd)
+            {
+                ptrPdRespData->cmdVal = false;
+                memcpy(&ptrPdRespData->respLen, Cy_App_Telemetry_GetStats(ptrPdStackContext),
+                        sizeof(cy_stc_app_telemetry_stats_t));
+                Cy_Hpi_RegEnqueueEvent(ptrHpiContext,
+                        (cy_en_hpi_reg_section_t)(ptrPdStackContext->port + 1),
+                        CY_HPI_RESPONSE_PD_RESP_DATA,
+                        sizeof(cy_stc_app_telemetry_stats_t) + 2u, &ptrPdRespData->respId);
+                cmdStat = CY_PDSTACK_STAT_NO_RESPONSE;
+            }
+            else if (CY_APP_PD_RESP_DATA_CMD_DELETE == ptrPdRespData->dataCmd)
+            {
+                Cy_App_Telemetry_Clear(ptrPdStackContext);
+            }
+            else
+            {
+                cmdStat = CY_PDSTACK_STAT_INVALID_ARGUMENT;
+            }
+#else
+            cmdStat = CY_PDSTACK_STAT_INVALID_ARGUMENT;
+#endif /* CY_APP_TELEMETRY_ENABLE */
+            break;
+        }
+        if (CY_APP_PD_RESP_ID_SINK_ENERGY == ptrPdRespData->respId)
+        {
+#if CY_APP_SINK_ENERGY_ENABLE
+            cy_stc_app_sink_energy_report_t report;
+            /* The data byte of a read selects the source type; the active contract is read by default. */
+            uint8_t srcType = (ptrPdRespData->respLen != 0u) ? ptrPdRespData->respData[0] : CY_APP_SINK_ENERGY_CONTRACT;
+
+            if ((CY_APP_PD_RESP_DATA_CMD_READ == ptrPdRespData->dataCmd) &&
+                    (Cy_App_SinkEnergy_GetReport(ptrPdStackContext, srcType, &report) == CY_APP_STAT_SUCCESS))
+            {
+                ptrPdRespData->cmdVal = false;
+                memcpy(&ptrPdRespData->respLen, &report, sizeof(cy_stc_app_sink_energy_report_t));
+                Cy_Hpi_RegEnqueueEvent(ptrHpiContext,
+                        (cy_en_hpi_reg_section_t)(ptrPdStackContext->port + 1),
+                        CY_HPI_RESPONSE_PD_RESP_DATA,
+                        sizeof(cy_stc_app_sink_energy_report_t) + 2u, &ptrPdRespData->respId);
+                cmdStat = CY_PDSTACK_STAT_NO_RESPONSE;
+            }
+            else if (CY_APP_PD_RESP_DATA_CMD_DELETE == ptrPdRespData->dataCmd)
+            {
+                Cy_App_SinkEnergy_Clear(ptrPdStackContext);
+            }
+            else
+            {
+                cmdStat = CY_PDSTACK_STAT_INVALID_ARGUMENT;
+            }
+#else
+            cmdStat = CY_PDSTACK_STAT_INVALID_ARGUMENT;
+#endif /* CY_APP_SINK_ENERGY_ENABLE */
+            break;
+        }
         /* Data command. */
         uint8_t portFlag = false;
         /* Checks if the command is specific to port or not. */
@@ -42,6 +42,8 @@
 * * Read/write battery status
 * * Read/write battery capabilities
 * * Read/write source Info and PD revision message
+* * Read/clear the telemetry statistics of the port
+* * Read/clear the sink energy accounting of the port
 *
 ********************************************************************************
 * \section section_pmg_app_common_hpi Configuration considerations
@@ -143,6 +145,10 @@ typedef enum
     CY_APP_PD_RESP_ID_BAT_CAP,              /**< Battery Capabilities Response ID. */
     CY_APP_PD_RESP_ID_SRC_INFO,             /**< Source Info Response ID. */
     CY_APP_PD_RESP_ID_PD_REV_MSG,           /**< PD Revision message Response ID. */
+    CY_APP_PD_RESP_ID_TELEMETRY,            /**< Telemetry statistics of the port. Read and delete only. */
+    CY_APP_PD_RESP_ID_SINK_ENERGY,          /**< Sink energy accounting of the port. Read and delete only. A read
+                                                 carries one data byte selecting the source type, or none for the
+                                                 active contract. */
     CY_APP_PD_RESP_ID_MAX_NUM               /**< Maximum number of Allowed IDs for PD response data. */
 }cy_en_app_pd_resp_id_t;
 
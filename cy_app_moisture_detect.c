@@ -20,12 +20,30 @@
 #include "cy_usbpd_vbus_ctrl.h"
 #include "cy_app.h"
 #include "cy_app_timer_id.h"
+#include "cy_app_adc_sched.h"
 
 #if CY_CORROSION_MITIGATION_ENABLE
 
+/* SBU measurements go through the ADC scheduler instead of busy-wait delays */
+#if (CY_APP_ADC_SCHED_ENABLE && (!CY_APP_MOISTURE_DETECT_USING_DP_DM) && (!defined(CY_DEVICE_CCG3PA)))
+#define MOISTURE_SBU_ASYNC      (1u)
+#else
+#define MOISTURE_SBU_ASYNC      (0u)
+#endif /* (CY_APP_ADC_SCHED_ENABLE && (!CY_APP_MOISTURE_DETECT_USING_DP_DM) && (!defined(CY_DEVICE_CCG3PA))) */
+
 static uint8_t gl_moisture_present_filter_cnt[NO_OF_TYPEC_PORTS];
 static uint8_t gl_moisture_absent_filter_cnt[NO_OF_TYPEC_PORTS];
 
+#if MOISTURE_SBU_ASYNC
+/* A SBU measurement is in progress on the port */
+static bool gl_moisture_sbu_busy[NO_OF_TYPEC_PORTS];
+
+#if (defined(CY_DEVICE_CCG3))
+/* UV/OV ADFT settings saved during a SBU measurement */
+static uint32_t gl_moisture_uvov_ctrl[NO_OF_TYPEC_PORTS];
+#endif /* (defined(CY_DEVICE_CCG3)) */
+#endif /* MOISTURE_SBU_ASYNC */
+
 void Cy_App_MoistureDetect_Init(cy_stc_pdstack_context_t * context)
 {
     gl_moisture_present_filter_cnt[context->port] = 0u;
@@ -143,6 +161,10 @@ bool Cy_App_MoistureDetect_IsMoisturePresent(cy_stc_usbpd_context_t * context)
     {
         /* Sets the ADC reference to voltage from the RefGen block. */
         Cy_USBPD_Adc_SelectVref(context, CY_USBPD_ADC_ID_0, CY_USBPD_ADC_VREF_PROG);
+#if CY_APP_ADC_CAL_CACHE_ENABLE
+        /* The VBUS poll calibration does not survive the reference switch */
+        Cy_App_AdcCalInvalidate(context->port);
+#endif /* CY_APP_ADC_CAL_CACHE_ENABLE */
     }
     /* Removes SBU to AUX connection and terminations on AUX lines. */
     Cy_USBPD_Mux_SbuSwitchConfigure(context, CY_USBPD_SBU_NOT_CONNECTED, CY_USBPD_SBU_NOT_CONNECTED);
@@ -160,29 +182,11 @@ bool Cy_App_MoistureDetect_IsMoisturePresent(cy_stc_usbpd_context_t * context)
     return ret;
 }
 
-/**
- * @brief This function monitors DP and DM or SBU lines for moisture detection.
- *
- * @param ptrPdStackContext PDStack context.
- * @return None.
- */
-static void Cy_App_MoistureDetect_MonitorDpDmSbu(cy_stc_pdstack_context_t *ptrPdStackContext)
+/* Applies the present and absent filters to a moisture measurement result */
+static void moisture_update_filter(cy_stc_pdstack_context_t *ptrPdStackContext, bool moisture_present)
 {
-    bool moisture_present;
-    cy_stc_usbpd_context_t *context = ptrPdStackContext->ptrUsbPdContext;
     uint8_t port = ptrPdStackContext->port;
 
-    moisture_present = Cy_App_MoistureDetect_IsMoisturePresent(context);
-#if (defined(CY_DEVICE_CCG6) && CY_APP_MOISTURE_DETECT_USING_DP_DM)
-    if(moisture_present != true)
-    {
-        /* Changes the polarity so that the other pair of DP/DM lines are used for moisture detection. */
-        ptrPdStackContext->dpmConfig.polarity = !(ptrPdStackContext->dpmConfig.polarity);
-        moisture_present = Cy_App_MoistureDetect_IsMoisturePresent(context);
-        ptrPdStackContext->dpmConfig.polarity = !(ptrPdStackContext->dpmConfig.polarity);
-    }
-#endif /* (defined (CY_DEVICE_CCG6) &&  CY_APP_MOISTURE_DETECT_USING_DP_DM) */
-
     if(moisture_present == true)
     {
         gl_moisture_absent_filter_cnt[port] = 0u;
@@ -206,15 +210,11 @@ static void Cy_App_MoistureDetect_MonitorDpDmSbu(cy_stc_pdstack_context_t *ptrPd
     }
 }
 
-void Cy_App_MoistureDetect_Run(cy_stc_pdstack_context_t * context)
+/* Recovers from, or starts the mitigation of, a change of the filtered moisture status */
+static void moisture_apply_status(cy_stc_pdstack_context_t * context)
 {
     cy_pd_cc_state_t newState;
 
-    if(Cy_PdUtils_SwTimer_IsRunning(context->ptrTimerContext, CY_APP_GET_TIMER_ID(context, CY_APP_MOISTURE_DETECT_TIMER_ID)))
-    {
-        return;
-    }
-    Cy_App_MoistureDetect_MonitorDpDmSbu(context);
     if(context->typecStat.moistureDetected == true)
     {
         if(context->typecStat.moisturePresent == false)
@@ -258,4 +258,188 @@ void Cy_App_MoistureDetect_Run(cy_stc_pdstack_context_t * context)
         }
     }
 }
+
+#if MOISTURE_SBU_ASYNC
+/* Connects SBU1 to the AMUX-A before the scheduler samples it. */
+static void moisture_sbu1_setup(cy_stc_pdstack_context_t *ptrPdStackContext, void *cbkContext)
+{
+    cy_stc_usbpd_context_t *context = ptrPdStackContext->ptrUsbPdContext;
+
+    (void)cbkContext;
+
+    /* Connects SBU1 to AUXN and SBU2 to AUXP. */
+    Cy_USBPD_Mux_SbuSwitchConfigure(context, CY_USBPD_SBU_CONNECT_AUX2, CY_USBPD_SBU_CONNECT_AUX1);
+    Cy_USBPD_Mux_AuxTermConfigure(context, CY_USBPD_AUX_1_470K_PD_RESISTOR, CY_USBPD_AUX_2_100K_PU_RESISTOR);
+
+#if (defined(CY_DEVICE_PMG1S3))
+    Cy_USBPD_Mux_SbuAdftEnable(context, CY_USBPD_SBU_ADFT_AUX1_SBU1);
+#elif (defined(CY_DEVICE_CCG6))
+    Cy_USBPD_Mux_SbuAdftEnable(context, CY_USBPD_SBU_ADFT_GND_SBU1_INT);
+#elif (defined(CY_DEVICE_CCG3))
+    gl_moisture_uvov_ctrl[ptrPdStackContext->port] = context->base->uvov_ctrl;
+    /* Disconnects the UV/OV resistor divider from ADFT so that SBU voltage can be measured. */
+    context->base->uvov_ctrl &= ~(PDSS_UVOV_CTRL_UVOV_ADFT_EN | PDSS_UVOV_CTRL_UVOV_ADFT_CTRL_MASK);
+    Cy_SysLib_DelayUs (10);
+    Cy_USBPD_Mux_SbuAdftEnable(context, CY_USBPD_SBU_ADFT_SBU1);
+#endif /* (defined(CY_DEVICE_PMG1S3)) */
+}
+
+/* Connects SBU2 to the AMUX-A before the scheduler samples it. */
+static void moisture_sbu2_setup(cy_stc_pdstack_context_t *ptrPdStackContext, void *cbkContext)
+{
+    cy_stc_usbpd_context_t *context = ptrPdStackContext->ptrUsbPdContext;
+
+    (void)cbkContext;
+
+#if (defined(CY_DEVICE_PMG1S3))
+    Cy_USBPD_Mux_SbuAdftEnable(context, CY_USBPD_SBU_ADFT_AUX2_SBU2);
+#elif (defined(CY_DEVICE_CCG6))
+    Cy_USBPD_Mux_SbuAdftEnable(context, CY_USBPD_SBU_ADFT_ISNK_OVP_SBU2_INT);
+#elif (defined(CY_DEVICE_CCG3))
+    Cy_USBPD_Mux_SbuAdftEnable(context, CY_USBPD_SBU_ADFT_SBU2);
+#endif /* (defined(CY_DEVICE_PMG1S3)) */
+}
+
+/* Removes the SBU line from the AMUX-A, also while a VBUS measurement preempts the scheduler. */
+static void moisture_sbu_release(cy_stc_pdstack_context_t *ptrPdStackContext, void *cbkContext)
+{
+    cy_stc_usbpd_context_t *context = ptrPdStackContext->ptrUsbPdContext;
+
+    (void)cbkContext;
+
+    /* Removes AMUX-A connection. */
+    Cy_USBPD_Mux_SbuAdftDisable(context);
+#if (defined(CY_DEVICE_CCG3))
+    Cy_SysLib_DelayUs(10);
+    /* Restores the original ADFT settings. */
+    context->base->uvov_ctrl = gl_moisture_uvov_ctrl[ptrPdStackContext->port];
+#endif /* (defined(CY_DEVICE_CCG3)) */
+}
+
+/* Releases the SBU lines and applies the result of the measurement. */
+static void moisture_sbu_done(cy_stc_pdstack_context_t *ptrPdStackContext, bool moisture_present)
+{
+    cy_stc_usbpd_context_t *context = ptrPdStackContext->ptrUsbPdContext;
+
+    /* Removes SBU to AUX connection and terminations on AUX lines. */
+    Cy_USBPD_Mux_SbuSwitchConfigure(context, CY_USBPD_SBU_NOT_CONNECTED, CY_USBPD_SBU_NOT_CONNECTED);
+    Cy_USBPD_Mux_AuxTermConfigure(context, CY_USBPD_AUX_NO_RESISTOR, CY_USBPD_AUX_NO_RESISTOR);
+    moisture_sbu_release(ptrPdStackContext, NULL);
+
+    gl_moisture_sbu_busy[ptrPdStackContext->port] = false;
+
+    /* Acts on the result at once instead of on the next run */
+    moisture_update_filter(ptrPdStackContext, moisture_present);
+    moisture_apply_status(ptrPdStackContext);
+}
+
+static void moisture_sbu2_result(cy_stc_pdstack_context_t *ptrPdStackContext, void *cbkContext,
+        uint8_t level, uint16_t volt)
+{
+    (void)cbkContext;
+    (void)level;
+
+    /* If the voltage is greater than 0.3 V, then moisture is detected. */
+    moisture_sbu_done(ptrPdStackContext, (volt > SBU2_MOISTURE_DETECT_THRESHOLD));
+}
+
+static void moisture_sbu1_result(cy_stc_pdstack_context_t *ptrPdStackContext, void *cbkContext,
+        uint8_t level, uint16_t volt)
+{
+    cy_stc_app_adc_req_t req;
+
+    (void)cbkContext;
+    (void)level;
+
+    /* If the voltage is less than 2.7 V, then moisture is detected. */
+    if(volt < SBU1_MOISTURE_DETECT_THRESHOLD)
+    {
+        moisture_sbu_done(ptrPdStackContext, true);
+        return;
+    }
+
+    req.adcId      = CY_USBPD_ADC_ID_0;
+    req.input      = CY_USBPD_ADC_INPUT_AMUX_A;
+    req.vrefVddd   = true;
+    req.settleTime = 1u;
+    req.setup      = moisture_sbu2_setup;
+    req.release    = moisture_sbu_release;
+    req.result     = moisture_sbu2_result;
+    req.cbkContext = NULL;
+
+    if(Cy_App_AdcSched_Request(ptrPdStackContext, &req) != CY_APP_STAT_SUCCESS)
+    {
+        moisture_sbu_done(ptrPdStackContext, false);
+    }
+}
+
+/* Starts a SBU measurement through the ADC scheduler unless one is in progress. */
+static void moisture_sbu_start(cy_stc_pdstack_context_t *ptrPdStackContext)
+{
+    cy_stc_app_adc_req_t req;
+
+    if(gl_moisture_sbu_busy[ptrPdStackContext->port])
+    {
+        return;
+    }
+
+    req.adcId      = CY_USBPD_ADC_ID_0;
+    req.input      = CY_USBPD_ADC_INPUT_AMUX_A;
+    req.vrefVddd   = true;
+    req.settleTime = 1u;
+    req.setup      = moisture_sbu1_setup;
+    req.release    = moisture_sbu_release;
+    req.result     = moisture_sbu1_result;
+    req.cbkContext = NULL;
+
+    gl_moisture_sbu_busy[ptrPdStackContext->port] = true;
+    if(Cy_App_AdcSched_Request(ptrPdStackContext, &req) != CY_APP_STAT_SUCCESS)
+    {
+        /* Retried on the next run */
+        gl_moisture_sbu_busy[ptrPdStackContext->port] = false;
+    }
+}
+#endif /* MOISTURE_SBU_ASYNC */
+
+/**
+ * @brief This function monitors DP and DM or SBU lines for moisture detection.
+ *
+ * @param ptrPdStackContext PDStack context.
+ * @return None.
+ */
+static void Cy_App_MoistureDetect_MonitorDpDmSbu(cy_stc_pdstack_context_t *ptrPdStackContext)
+{
+#if MOISTURE_SBU_ASYNC
+    /* The filters are updated once the measurement completes */
+    moisture_sbu_start(ptrPdStackContext);
+#else
+    bool moisture_present;
+    cy_stc_usbpd_context_t *context = ptrPdStackContext->ptrUsbPdContext;
+
+    moisture_present = Cy_App_MoistureDetect_IsMoisturePresent(context);
+#if (defined(CY_DEVICE_CCG6) && CY_APP_MOISTURE_DETECT_USING_DP_DM)
+    if(moisture_present != true)
+    {
+        /* Changes the polarity so that the other pair of DP/DM lines are used for moisture detection. */
+        ptrPdStackContext->dpmConfig.polarity = !(ptrPdStackContext->dpmConfig.polarity);
+        moisture_present = Cy_App_MoistureDetect_IsMoisturePresent(context);
+        ptrPdStackContext->dpmConfig.polarity = !(ptrPdStackContext->dpmConfig.polarity);
+    }
+#endif /* (defined (CY_DEVICE_CCG6) &&  CY_APP_MOISTURE_DETECT_USING_DP_DM) */
+
+    moisture_update_filter(ptrPdStackContext, moisture_present);
+#endif /* MOISTURE_SBU_ASYNC */
+}
+
+void Cy_App_MoistureDetect_Run(cy_stc_pdstack_context_t * context)
+{
+    if(Cy_PdUtils_SwTimer_IsRunning(context->ptrTimerContext, CY_APP_GET_TIMER_ID(context, CY_APP_MOISTURE_DETECT_TIMER_ID)))
+    {
+        return;
+    }
+    Cy_App_MoistureDetect_MonitorDpDmSbu(context);
+#if (!MOISTURE_SBU_ASYNC)
+    moisture_apply_status(context);
+#endif /* (!MOISTURE_SBU_ASYNC) */
+}
 #endif /* CY_CORROSION_MITIGATION_ENABLE */
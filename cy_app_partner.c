@@ -0,0 +1,375 @@
+/***************************************************************************//**
+* \file cy_app_partner.c
+* \version 2.0
+*
+* \brief
+* Implements the flash-backed partner power profile cache
+*
+********************************************************************************
+* \copyright
+* Copyright 2024, Cypress Semiconductor Corporation (an Infineon company)
+* or an affiliate of Cypress Semiconductor Corporation. All rights reserved.
+* You may use this file only in accordance with the license, terms, conditions,
+* disclaimers, and limitations in the end user license agreement accompanying
+* the software package with which this file was provided.
+*******************************************************************************/
+
+#include <stddef.h>
+#include <string.h>
+#include "cybsp.h"
+#include "cy_app_config.h"
+#include "cy_app_partner.h"
+#include "cy_app_timer_id.h"
+#include "cy_app_flash_config.h"
+
+#include "cy_pdutils_sw_timer.h"
+
+#if CY_APP_PARTNER_CACHE_ENABLE
+
+#if ((CY_APP_PARTNER_CACHE_ROW_NUM == CY_APP_FLASH_LOG_ROW_NUM) || \
+     (CY_APP_PARTNER_CACHE_ROW_NUM == CY_APP_FLASH_LOG_BACKUP_ROW_NUM) || \
+     (CY_APP_PARTNER_CACHE_BACKUP_ROW_NUM == CY_APP_FLASH_LOG_ROW_NUM) || \
+     (CY_APP_PARTNER_CACHE_BACKUP_ROW_NUM == CY_APP_FLASH_LOG_BACKUP_ROW_NUM) || \
+     (CY_APP_PARTNER_CACHE_ROW_NUM >= CY_APP_SYS_APP_PRIORITY_ROW_NUM) || \
+     (CY_APP_PARTNER_CACHE_BACKUP_ROW_NUM >= CY_APP_SYS_APP_PRIORITY_ROW_NUM))
+#error "Partner cache rows overlap the log or firmware metadata rows."
+#endif
+
+#if (CY_APP_DMC_ENABLE && \
+     (((CY_APP_PARTNER_CACHE_ROW_NUM >= CY_APP_SYS_DMC_METADATA_START_ROW_ID) && \
+       (CY_APP_PARTNER_CACHE_ROW_NUM <= CY_APP_SYS_DMC_METADATA_END_ROW_ID)) || \
+      ((CY_APP_PARTNER_CACHE_BACKUP_ROW_NUM >= CY_APP_SYS_DMC_METADATA_START_ROW_ID) && \
+       (CY_APP_PARTNER_CACHE_BACKUP_ROW_NUM <= CY_APP_SYS_DMC_METADATA_END_ROW_ID))))
+#error "Partner cache rows overlap the dock metadata rows."
+#endif
+
+/* Compile time check that the partner table fits in a flash row */
+typedef char partner_table_size_check_t[(sizeof(cy_stc_app_partner_table_t) <= CY_APP_SYS_FLASH_ROW_SIZE) ? 1 : -1];
+
+/* Marks a port on which no partner has been identified */
+#define PARTNER_NONE                    (0xFFu)
+
+/* Partner table in RAM */
+static cy_stc_app_partner_table_t glAppPartnerTable;
+
+/* Entry of the partner connected on each port */
+static uint8_t glAppPartnerCur[NO_OF_TYPEC_PORTS];
+
+/* Flash row which holds the current copy of the table; the other row is written next */
+static uint16_t glAppPartnerRow = CY_APP_PARTNER_CACHE_ROW_NUM;
+
+/* The table has been loaded from flash */
+static bool glAppPartnerLoaded = false;
+
+/* The table has changed since it was last written */
+static bool glAppPartnerDirty = false;
+
+/* The flush delay has expired and the table can be written */
+static volatile bool glAppPartnerFlushReq = false;
+
+/* Buffer used to write a complete flash row */
+static uint32_t glAppPartnerRowBuf[CY_APP_SYS_FLASH_ROW_SIZE / 4u];
+
+/* 16-bit sum over the sequence number and entries of a table */
+static uint16_t partner_checksum(const cy_stc_app_partner_table_t *table)
+{
+    const uint8_t *ptr = (const uint8_t *)&table->seq;
+    uint32_t len = sizeof(cy_stc_app_partner_table_t) - offsetof(cy_stc_app_partner_table_t, seq);
+    uint16_t sum = 0u;
+
+    while (len-- != 0u)
+    {
+        sum += *ptr++;
+    }
+
+    return sum;
+}
+
+/* Returns the table stored in the flash row, or NULL if the row does not hold a valid table */
+static const cy_stc_app_partner_table_t* partner_read_row(uint16_t row)
+{
+    const cy_stc_app_partner_table_t *table =
+        (const cy_stc_app_partner_table_t *)((uint32_t)row << CY_APP_SYS_FLASH_ROW_SHIFT_NUM);
+
+    if ((table->signature != CY_APP_PARTNER_SIGNATURE) || (table->checksum != partner_checksum(table)))
+    {
+        return NULL;
+    }
+
+    return table;
+}
+
+static void partner_flush_timer_cb(cy_timer_id_t id, void *context)
+{
+    (void)id;
+    (void)context;
+
+    glAppPartnerFlushReq = true;
+}
+
+/* Marks the table as changed; the write is deferred so that further changes are batched */
+static void partner_set_dirty(cy_stc_pdstack_context_t *ptrPdStackContext)
+{
+    uint16_t timer_id = CY_APP_GET_TIMER_ID(ptrPdStackContext, CY_APP_PARTNER_FLUSH_TIMER);
+
+    glAppPartnerDirty = true;
+
+    if (!Cy_PdUtils_SwTimer_IsRunning(ptrPdStackContext->ptrTimerContext, timer_id))
+    {
+        Cy_PdUtils_SwTimer_Start(ptrPdStackContext->ptrTimerContext, ptrPdStackContext,
+                timer_id, CY_APP_PARTNER_FLUSH_DELAY, partner_flush_timer_cb);
+    }
+}
+
+static cy_stc_app_partner_entry_t* partner_get_cur(cy_stc_pdstack_context_t *ptrPdStackContext)
+{
+    uint8_t idx = glAppPartnerCur[ptrPdStackContext->port];
+
+    return (idx == PARTNER_NONE) ? NULL : &glAppPartnerTable.entry[idx];
+}
+
+void Cy_App_Partner_Init(void)
+{
+    const cy_stc_app_partner_table_t *main_row;
+    const cy_stc_app_partner_table_t *backup_row;
+    const cy_stc_app_partner_table_t *table;
+    uint8_t port;
+
+    if (glAppPartnerLoaded)
+    {
+        return;
+    }
+
+    glAppPartnerLoaded = true;
+
+    for (port = 0u; port < NO_OF_TYPEC_PORTS; port++)
+    {
+        glAppPartnerCur[port] = PARTNER_NONE;
+    }
+
+    main_row   = partner_read_row(CY_APP_PARTNER_CACHE_ROW_NUM);
+    backup_row = partner_read_row(CY_APP_PARTNER_CACHE_BACKUP_ROW_NUM);
+
+    /* The row written last is current; the other one is overwritten next */
+    table = main_row;
+    glAppPartnerRow = CY_APP_PARTNER_CACHE_ROW_NUM;
+    if ((backup_row != NULL) && ((main_row == NULL) || (backup_row->seq > main_row->seq)))
+    {
+        table = backup_row;
+        glAppPartnerRow = CY_APP_PARTNER_CACHE_BACKUP_ROW_NUM;
+    }
+
+    if (table != NULL)
+    {
+        memcpy(&glAppPartnerTable, table, sizeof(cy_stc_app_partner_table_t));
+    }
+    else
+    {
+        memset(&glAppPartnerTable, 0, sizeof(cy_stc_app_partner_table_t));
+    }
+}
+
+void Cy_App_Partner_Identify(cy_stc_pdstack_context_t *ptrPdStackContext, uint32_t partnerId)
+{
+    cy_stc_app_partner_entry_t *entry = glAppPartnerTable.entry;
+    uint8_t match = PARTNER_NONE;
+    uint8_t oldest = 0u;
+    uint8_t idx;
+    bool expire = false;
+
+    /* Partner ID 0 marks an unused entry */
+    if (partnerId == 0u)
+    {
+        partnerId = 1u;
+    }
+
+    for (idx = 0u; idx < CY_APP_PARTNER_CACHE_SIZE; idx++)
+    {
+        if (entry[idx].partnerId == partnerId)
+        {
+            match = idx;
+        }
+
+        /* Unused entries are taken first; otherwise, the least recently used one */
+        if ((entry[oldest].partnerId != 0u) &&
+                ((entry[idx].partnerId == 0u) || (entry[idx].age > entry[oldest].age)))
+        {
+            oldest = idx;
+        }
+    }
+
+    /* Repeated source capabilities of the partner already identified on the port */
+    if ((match != PARTNER_NONE) && (match == glAppPartnerCur[ptrPdStackContext->port]))
+    {
+        return;
+    }
+
+    if (match == PARTNER_NONE)
+    {
+        /* Replace the least recently used entry. It is only written once it holds data. */
+        match = oldest;
+        memset(&entry[match], 0, sizeof(cy_stc_app_partner_entry_t));
+        entry[match].partnerId = partnerId;
+    }
+    else if ((entry[match].flags & CY_APP_PARTNER_FLAG_EXPIRING) != 0u)
+    {
+        /* Retry rejected swaps and failed EPR entry after a number of connections */
+        entry[match].retry++;
+        if (entry[match].retry >= CY_APP_PARTNER_FLAG_RETRY_COUNT)
+        {
+            entry[match].flags &= (uint8_t)~CY_APP_PARTNER_FLAG_EXPIRING;
+            entry[match].retry = 0u;
+        }
+        expire = true;
+    }
+
+    /* Age the other entries; ages only reach flash along with other changes */
+    for (idx = 0u; idx < CY_APP_PARTNER_CACHE_SIZE; idx++)
+    {
+        if ((idx != match) && (entry[idx].age < 0xFFu))
+        {
+            entry[idx].age++;
+        }
+    }
+
+    entry[match].age = 0u;
+    glAppPartnerCur[ptrPdStackContext->port] = match;
+
+    /* The connection count has to survive power cycles for the flags to expire */
+    if (expire)
+    {
+        partner_set_dirty(ptrPdStackContext);
+    }
+}
+
+void Cy_App_Partner_Detach(cy_stc_pdstack_context_t *ptrPdStackContext)
+{
+    glAppPartnerCur[ptrPdStackContext->port] = PARTNER_NONE;
+}
+
+const cy_stc_app_partner_entry_t* Cy_App_Partner_GetEntry(cy_stc_pdstack_context_t *ptrPdStackContext)
+{
+    return partner_get_cur(ptrPdStackContext);
+}
+
+void Cy_App_Partner_SaveContract(cy_stc_pdstack_context_t *ptrPdStackContext,
+        const cy_stc_app_partner_entry_t *contract)
+{
+    cy_stc_app_partner_entry_t *entry = partner_get_cur(ptrPdStackContext);
+    uint8_t flags;
+
+    if (entry == NULL)
+    {
+        return;
+    }
+
+    flags = (uint8_t)((entry->flags & ~(CY_APP_PARTNER_FLAG_CAP_MISMATCH | CY_APP_PARTNER_FLAG_GIVE_BACK)) |
+            (contract->flags & (CY_APP_PARTNER_FLAG_CAP_MISMATCH | CY_APP_PARTNER_FLAG_GIVE_BACK)) |
+            CY_APP_PARTNER_FLAG_CONTRACT);
+
+    /* Avoid flash writes if the partner got the same contract as before */
+    if ((entry->flags == flags) && (entry->cfgId == contract->cfgId) && (entry->srcPdo == contract->srcPdo) &&
+            (entry->pdoNo == contract->pdoNo) && (entry->contractVolt == contract->contractVolt) &&
+            (entry->contractPower == contract->contractPower) && (entry->operCurPwr == contract->operCurPwr) &&
+            (entry->maxMinCurPwr == contract->maxMinCurPwr))
+    {
+        return;
+    }
+
+    entry->cfgId         = contract->cfgId;
+    entry->srcPdo        = contract->srcPdo;
+    entry->pdoNo         = contract->pdoNo;
+    entry->contractVolt  = contract->contractVolt;
+    entry->contractPower = contract->contractPower;
+    entry->operCurPwr    = contract->operCurPwr;
+    entry->maxMinCurPwr  = contract->maxMinCurPwr;
+    entry->flags         = flags;
+
+    partner_set_dirty(ptrPdStackContext);
+}
+
+void Cy_App_Partner_UpdateFlags(cy_stc_pdstack_context_t *ptrPdStackContext, uint8_t mask, bool set)
+{
+    cy_stc_app_partner_entry_t *entry = partner_get_cur(ptrPdStackContext);
+    uint8_t flags;
+
+    if (entry == NULL)
+    {
+        return;
+    }
+
+    flags = (set) ? (uint8_t)(entry->flags | mask) : (uint8_t)(entry->flags & ~mask);
+    if (flags != entry->flags)
+    {
+        if ((set) && ((mask & CY_APP_PARTNER_FLAG_EXPIRING) != 0u))
+        {
+            entry->retry = 0u;
+        }
+        entry->flags = flags;
+        partner_set_dirty(ptrPdStackContext);
+    }
+}
+
+uint8_t Cy_App_Partner_GetFlags(cy_stc_pdstack_context_t *ptrPdStackContext)
+{
+    const cy_stc_app_partner_entry_t *entry = partner_get_cur(ptrPdStackContext);
+
+    return (entry == NULL) ? 0u : entry->flags;
+}
+
+void Cy_App_Partner_Clear(cy_stc_pdstack_context_t *ptrPdStackContext)
+{
+    uint8_t port;
+
+    memset(glAppPartnerTable.entry, 0, sizeof(glAppPartnerTable.entry));
+
+    for (port = 0u; port < NO_OF_TYPEC_PORTS; port++)
+    {
+        glAppPartnerCur[port] = PARTNER_NONE;
+    }
+
+    partner_set_dirty(ptrPdStackContext);
+}
+
+void Cy_App_Partner_Task(cy_stc_pdstack_context_t *ptrPdStackContext)
+{
+    cy_stc_app_partner_table_t *row = (cy_stc_app_partner_table_t *)glAppPartnerRowBuf;
+    uint16_t next_row;
+
+    (void)ptrPdStackContext;
+
+    if ((!glAppPartnerFlushReq) || (!glAppPartnerDirty))
+    {
+        glAppPartnerFlushReq = false;
+        return;
+    }
+
+    glAppPartnerFlushReq = false;
+    glAppPartnerDirty = false;
+
+    /* Alternate between the two rows, so that a valid copy survives an interrupted write */
+    next_row = (glAppPartnerRow == CY_APP_PARTNER_CACHE_ROW_NUM) ?
+        CY_APP_PARTNER_CACHE_BACKUP_ROW_NUM : CY_APP_PARTNER_CACHE_ROW_NUM;
+
+    glAppPartnerTable.signature = CY_APP_PARTNER_SIGNATURE;
+    glAppPartnerTable.seq++;
+    glAppPartnerTable.checksum = partner_checksum(&glAppPartnerTable);
+
+    memset(glAppPartnerRowBuf, 0, sizeof(glAppPartnerRowBuf));
+    memcpy(row, &glAppPartnerTable, sizeof(cy_stc_app_partner_table_t));
+
+    if (Cy_Flash_WriteRow((uint32_t)next_row << CY_APP_SYS_FLASH_ROW_SHIFT_NUM, glAppPartnerRowBuf) ==
+            CY_FLASH_DRV_SUCCESS)
+    {
+        glAppPartnerRow = next_row;
+    }
+    else
+    {
+        /* Retry along with the next change */
+        glAppPartnerDirty = true;
+    }
+}
+
+#endif /* CY_APP_PARTNER_CACHE_ENABLE */
+
+/* [] End of file */
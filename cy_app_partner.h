@@ -0,0 +1,242 @@
+/***************************************************************************//**
+* \file cy_app_partner.h
+* \version 2.0
+*
+* \brief
+* Defines the data structures and function prototypes of the flash-backed
+* partner power profile cache.
+*
+********************************************************************************
+* \copyright
+* Copyright 2024, Cypress Semiconductor Corporation (an Infineon company)
+* or an affiliate of Cypress Semiconductor Corporation. All rights reserved.
+* You may use this file only in accordance with the license, terms, conditions,
+* disclaimers, and limitations in the end user license agreement accompanying
+* the software package with which this file was provided.
+*******************************************************************************/
+
+#ifndef _CY_APP_PARTNER_H_
+#define _CY_APP_PARTNER_H_
+
+/*******************************************************************************
+ * Header files including
+ ******************************************************************************/
+#include <stdint.h>
+#include <stdbool.h>
+#include "cy_pdstack_common.h"
+
+#if (CY_APP_PARTNER_CACHE_ENABLE || DOXYGEN)
+
+/**
+* \addtogroup group_pmg_app_common_partner
+* \{
+* The partner cache remembers the power contract and the swap and EPR outcomes
+* of the last few port partners across power cycles. A partner is identified by
+* a fingerprint of its source capabilities. On reconnect, the stored contract is
+* requested directly, and role swaps or EPR entry attempts which the partner has
+* rejected before are skipped. Recorded rejects are dropped after
+* CY_APP_PARTNER_FLAG_RETRY_COUNT connections so that the attempts are retried.
+*
+* The table is held in RAM and written to one of two flash rows in turn. Updates
+* are batched: a row is only written CY_APP_PARTNER_FLUSH_DELAY after the first
+* change, and only if the content has changed.
+*
+* \defgroup group_pmg_app_common_partner_macros Macros
+* \defgroup group_pmg_app_common_partner_data_structures Data structures
+* \defgroup group_pmg_app_common_partner_functions Functions
+*/
+/** \} group_pmg_app_common_partner */
+
+/*****************************************************************************
+ * Macros
+ *****************************************************************************/
+/**
+* \addtogroup group_pmg_app_common_partner_macros
+* \{
+*/
+
+#ifndef CY_APP_PARTNER_CACHE_SIZE
+/** Number of partners remembered. The table must fit into one flash row. */
+#define CY_APP_PARTNER_CACHE_SIZE               (4u)
+#endif /* CY_APP_PARTNER_CACHE_SIZE */
+
+#ifndef CY_APP_PARTNER_FLUSH_DELAY
+/** Delay in ms from the first change of the table to the flash write. */
+#define CY_APP_PARTNER_FLUSH_DELAY              (10000u)
+#endif /* CY_APP_PARTNER_FLUSH_DELAY */
+
+/** Signature of a valid partner table in flash. */
+#define CY_APP_PARTNER_SIGNATURE                (0x5052u)
+
+/** The entry holds a contract for the partner. */
+#define CY_APP_PARTNER_FLAG_CONTRACT            (0x01u)
+
+/** The stored contract was requested with capability mismatch. */
+#define CY_APP_PARTNER_FLAG_CAP_MISMATCH        (0x02u)
+
+/** The stored contract was requested with the GiveBack flag. */
+#define CY_APP_PARTNER_FLAG_GIVE_BACK           (0x04u)
+
+/** The partner has rejected a DR_SWAP request. */
+#define CY_APP_PARTNER_FLAG_DR_SWAP_REJECT      (0x08u)
+
+/** The partner has rejected a PR_SWAP request. */
+#define CY_APP_PARTNER_FLAG_PR_SWAP_REJECT      (0x10u)
+
+/** The partner has rejected a VCONN_SWAP request. */
+#define CY_APP_PARTNER_FLAG_VCONN_SWAP_REJECT   (0x20u)
+
+/** EPR mode entry with the partner has failed. */
+#define CY_APP_PARTNER_FLAG_EPR_FAILED          (0x40u)
+
+/** Outcome flags which expire after CY_APP_PARTNER_FLAG_RETRY_COUNT connections. */
+#define CY_APP_PARTNER_FLAG_EXPIRING            (CY_APP_PARTNER_FLAG_DR_SWAP_REJECT |       \
+                                                 CY_APP_PARTNER_FLAG_PR_SWAP_REJECT |       \
+                                                 CY_APP_PARTNER_FLAG_VCONN_SWAP_REJECT |    \
+                                                 CY_APP_PARTNER_FLAG_EPR_FAILED)
+
+/** \} group_pmg_app_common_partner_macros */
+
+/*****************************************************************************
+ * Data Struct Definition
+ *****************************************************************************/
+/**
+* \addtogroup group_pmg_app_common_partner_data_structures
+* \{
+*/
+
+/**
+ * @brief Information remembered about one port partner
+ */
+typedef struct
+{
+    uint32_t partnerId;                 /**< Fingerprint of the partner's source capabilities; 0 if unused. */
+    uint32_t cfgId;                     /**< Fingerprint of the local settings the contract was selected with. */
+    uint32_t srcPdo;                    /**< Source PDO which was requested. */
+    uint16_t contractVolt;              /**< Contract voltage in 50 mV units. */
+    uint16_t contractPower;             /**< Contract power in 250 mW units. */
+    uint16_t operCurPwr;                /**< Operating current in 10 mA units or power in 250 mW units. */
+    uint16_t maxMinCurPwr;              /**< Max/min current in 10 mA units or power in 250 mW units. */
+    uint8_t pdoNo;                      /**< Object position which was requested. */
+    uint8_t flags;                      /**< Combination of CY_APP_PARTNER_FLAG_* values. */
+    uint8_t age;                        /**< Number of partner changes since the entry was last used. */
+    uint8_t retry;                      /**< Connections since a swap reject or EPR failure flag was last set. */
+} cy_stc_app_partner_entry_t;
+
+/**
+ * @brief Layout of the partner table in a flash row
+ */
+typedef struct
+{
+    uint16_t signature;                 /**< CY_APP_PARTNER_SIGNATURE if the row is valid. */
+    uint16_t checksum;                  /**< Checksum of the sequence number and entries. */
+    uint32_t seq;                       /**< Write sequence number; the row with the higher number is current. */
+    cy_stc_app_partner_entry_t entry[CY_APP_PARTNER_CACHE_SIZE];  /**< Partner entries. */
+} cy_stc_app_partner_table_t;
+
+/** \} group_pmg_app_common_partner_data_structures */
+
+/*****************************************************************************
+ * Global Function Declaration
+ *****************************************************************************/
+/**
+* \addtogroup group_pmg_app_common_partner_functions
+* \{
+*/
+
+/**
+ * @brief Loads the partner table from flash. Only the first call has an effect.
+ *
+ * @return None
+ */
+void Cy_App_Partner_Init(void);
+
+/**
+ * @brief Selects the entry of the connected partner, allocating the least
+ * recently used entry if the partner is not known.
+ *
+ * @param ptrPdStackContext Pointer to the PDStack context
+ * @param partnerId Fingerprint of the partner
+ *
+ * @return None
+ */
+void Cy_App_Partner_Identify(cy_stc_pdstack_context_t *ptrPdStackContext, uint32_t partnerId);
+
+/**
+ * @brief Forgets the partner selected on the port. To be called on disconnect.
+ *
+ * @param ptrPdStackContext Pointer to the PDStack context
+ *
+ * @return None
+ */
+void Cy_App_Partner_Detach(cy_stc_pdstack_context_t *ptrPdStackContext);
+
+/**
+ * @brief Returns the entry of the partner connected on the port.
+ *
+ * @param ptrPdStackContext Pointer to the PDStack context
+ *
+ * @return Pointer to the entry; NULL if the partner has not been identified.
+ */
+const cy_stc_app_partner_entry_t* Cy_App_Partner_GetEntry(cy_stc_pdstack_context_t *ptrPdStackContext);
+
+/**
+ * @brief Stores the contract requested from the partner connected on the port.
+ *
+ * @param ptrPdStackContext Pointer to the PDStack context
+ * @param contract Entry holding the cfgId, srcPdo, pdoNo, contract values and the
+ * CY_APP_PARTNER_FLAG_CAP_MISMATCH and CY_APP_PARTNER_FLAG_GIVE_BACK flags. Other
+ * fields are ignored.
+ *
+ * @return None
+ */
+void Cy_App_Partner_SaveContract(cy_stc_pdstack_context_t *ptrPdStackContext,
+        const cy_stc_app_partner_entry_t *contract);
+
+/**
+ * @brief Sets or clears outcome flags of the partner connected on the port.
+ *
+ * @param ptrPdStackContext Pointer to the PDStack context
+ * @param mask Combination of CY_APP_PARTNER_FLAG_* values
+ * @param set true to set the flags; false to clear them
+ *
+ * @return None
+ */
+void Cy_App_Partner_UpdateFlags(cy_stc_pdstack_context_t *ptrPdStackContext, uint8_t mask, bool set);
+
+/**
+ * @brief Returns the outcome flags of the partner connected on the port.
+ *
+ * @param ptrPdStackContext Pointer to the PDStack context
+ *
+ * @return Combination of CY_APP_PARTNER_FLAG_* values; 0 if the partner has not
+ * been identified.
+ */
+uint8_t Cy_App_Partner_GetFlags(cy_stc_pdstack_context_t *ptrPdStackContext);
+
+/**
+ * @brief Discards all partner information, including the copy in flash.
+ *
+ * @param ptrPdStackContext Pointer to the PDStack context used to schedule the flash write
+ *
+ * @return None
+ */
+void Cy_App_Partner_Clear(cy_stc_pdstack_context_t *ptrPdStackContext);
+
+/**
+ * @brief Writes pending changes of the partner table to flash. To be called
+ * from the application task.
+ *
+ * @param ptrPdStackContext Pointer to the PDStack context
+ *
+ * @return None
+ */
+void Cy_App_Partner_Task(cy_stc_pdstack_context_t *ptrPdStackContext);
+
+/** \} group_pmg_app_common_partner_functions */
+
+#endif /* (CY_APP_PARTNER_CACHE_ENABLE || DOXYGEN) */
+
+#endif /* _CY_APP_PARTNER_H_ */
+
+/* [] END OF FILE */
@@ -21,6 +21,9 @@
 #include "cy_pdutils.h"
 #include "cy_app_pdo.h"
 #include "cy_app.h"
+#if CY_APP_PARTNER_CACHE_ENABLE
+#include "cy_app_partner.h"
+#endif /* CY_APP_PARTNER_CACHE_ENABLE */
 
 #if (!(CY_PD_SOURCE_ONLY))
 
@@ -30,9 +33,20 @@ uint32_t glAppContractPower[NO_OF_TYPEC_PORTS];
 uint32_t glAppContractVoltage[NO_OF_TYPEC_PORTS];
 uint32_t glAppOperCurPower[NO_OF_TYPEC_PORTS];
 
-#if CY_PD_EPR_ENABLE
-uint32_t glAppPdoPower[NO_OF_TYPEC_PORTS];
-#endif /* CY_PD_EPR_ENABLE */
+/* Sink constraint table derived from the active sink PDOs. */
+static cy_stc_app_snk_constraint_t glAppSnkConstraint[NO_OF_TYPEC_PORTS][CY_APP_PDO_MAX_SNK_PDO];
+
+/* Source PDO selection policy of each port; NULL selects the CY_APP_PD_PDO_SEL_ALGO default. */
+static const cy_stc_app_pdo_policy_t *glAppPdoPolicy[NO_OF_TYPEC_PORTS];
+
+/* Identifier of the policy selected for each port. */
+static cy_en_app_pdo_policy_t glAppPdoPolicyId[NO_OF_TYPEC_PORTS];
+
+/* Target input voltage in 50 mV units used by the lowest loss and battery policies. */
+static uint16_t glAppPdoTargetVolt[NO_OF_TYPEC_PORTS];
+
+/* Battery level in percent used by the battery policy. */
+static uint8_t glAppPdoBattLevel[NO_OF_TYPEC_PORTS];
 
 static uint32_t calc_power(uint32_t voltage, uint32_t current)
 {
@@ -54,86 +68,271 @@ static uint32_t calc_current(uint32_t power, uint32_t voltage)
     return (CY_PDUTILS_DIV_ROUND_UP(power * 500, voltage));
 }
 
+#if (CY_APP_PDO_EVAL_CACHE_ENABLE || CY_APP_PARTNER_CACHE_ENABLE)
+/* Initial value of the FNV-1a hash. */
+#define PDO_HASH_SEED                   (0x811C9DC5u)
+
+/* Adds a word to an FNV-1a hash. */
+static uint32_t pdo_hash_word(uint32_t hash, uint32_t value)
+{
+    return (hash ^ value) * 0x01000193u;
+}
+
+/* Adds a list of PDOs to an FNV-1a hash. */
+static uint32_t pdo_hash(uint32_t hash, const cy_pd_pd_do_t* pdo, uint8_t len)
+{
+    uint8_t idx;
+
+    for (idx = 0u; idx < len; idx++)
+    {
+        hash = pdo_hash_word(hash, pdo[idx].val);
+    }
+
+    return hash;
+}
+#endif /* (CY_APP_PDO_EVAL_CACHE_ENABLE || CY_APP_PARTNER_CACHE_ENABLE) */
+
+#if CY_APP_PDO_EVAL_CACHE_ENABLE
+/* Source capability evaluation results of each port. */
+static cy_stc_app_pdo_cache_entry_t glAppPdoCache[NO_OF_TYPEC_PORTS][CY_APP_PDO_EVAL_CACHE_SIZE];
+
+/* Cache entry to be replaced next on each port. */
+static uint8_t glAppPdoCacheNext[NO_OF_TYPEC_PORTS];
+
+static void pdo_cache_clear(uint8_t port)
+{
+    uint8_t idx;
+
+    for (idx = 0u; idx < CY_APP_PDO_EVAL_CACHE_SIZE; idx++)
+    {
+        glAppPdoCache[port][idx].valid = false;
+    }
+}
+
+/* Returns the cached result for the source capabilities, or NULL if there is none. */
+static const cy_stc_app_pdo_cache_entry_t* pdo_cache_lookup(uint8_t port, uint32_t hash,
+        const cy_stc_pdstack_pd_packet_t* srcCap, uint8_t src_pdo_len, uint8_t snk_pdo_len, uint8_t flags)
+{
+    const cy_stc_app_pdo_cache_entry_t *entry;
+    uint8_t idx, pdo_idx;
+
+    for (idx = 0u; idx < CY_APP_PDO_EVAL_CACHE_SIZE; idx++)
+    {
+        entry = &glAppPdoCache[port][idx];
+
+        if ((entry->valid) && (entry->hash == hash) && (entry->srcLen == src_pdo_len) &&
+                (entry->snkLen == snk_pdo_len) && (entry->flags == flags))
+        {
+            for (pdo_idx = 0u; pdo_idx < src_pdo_len; pdo_idx++)
+            {
+                if (entry->srcPdo[pdo_idx] != srcCap->dat[pdo_idx].val)
+                {
+                    break;
+                }
+            }
+
+            if (pdo_idx == src_pdo_len)
+            {
+                return entry;
+            }
+        }
+    }
+
+    return NULL;
+}
+
+/* Stores the result of a full evaluation, replacing the oldest entry. */
+static void pdo_cache_store(uint8_t port, uint32_t hash, const cy_stc_pdstack_pd_packet_t* srcCap,
+        uint8_t src_pdo_len, uint8_t snk_pdo_len, uint8_t flags, uint8_t pdo_no, bool cap_mismatch, bool give_back)
+{
+    cy_stc_app_pdo_cache_entry_t *entry = &glAppPdoCache[port][glAppPdoCacheNext[port]];
+    uint8_t idx;
+
+    if (src_pdo_len > CY_APP_PDO_MAX_SRC_PDO)
+    {
+        return;
+    }
+
+    glAppPdoCacheNext[port] = (uint8_t)((glAppPdoCacheNext[port] + 1u) % CY_APP_PDO_EVAL_CACHE_SIZE);
+
+    for (idx = 0u; idx < src_pdo_len; idx++)
+    {
+        entry->srcPdo[idx] = srcCap->dat[idx].val;
+    }
+
+    entry->hash                  = hash;
+    entry->srcLen                = src_pdo_len;
+    entry->snkLen                = snk_pdo_len;
+    entry->flags                 = flags;
+    entry->pdoNo                 = pdo_no;
+    entry->capMismatch           = cap_mismatch;
+    entry->giveBack              = give_back;
+    entry->contract.contractVolt  = glAppContractVoltage[port];
+    entry->contract.contractPower = glAppContractPower[port];
+    entry->contract.operCurPwr    = glAppOperCurPower[port];
+    entry->contract.maxMinCurPwr  = glAppMaxMinPower[port];
+    entry->valid                 = true;
+}
+#endif /* CY_APP_PDO_EVAL_CACHE_ENABLE */
+
 /**
- * Checks if SRC pdo is acceptable for SNK pdo
+ * Rebuilds the sink constraint table if the active sink PDOs have changed
+ * since it was last built.
  * @param context Pointer to the PDStack context
+ * @param snk_pdo_len Number of active sink PDOs
+ * @return None
+ */
+static void update_snk_constraints(cy_stc_pdstack_context_t* context, uint8_t snk_pdo_len)
+{
+    cy_stc_app_snk_constraint_t *entry = glAppSnkConstraint[context->port];
+    const cy_pd_pd_do_t *pdo_snk;
+    uint32_t max_min;
+    uint8_t idx;
+    bool changed = false;
+
+    /*
+     * Entries beyond the previous count still hold the values they were last built from,
+     * so only a change of the stored values requires a rebuild.
+     */
+    for (idx = 0u; (idx < snk_pdo_len) && (!changed); idx++)
+    {
+        changed = ((entry[idx].pdo != context->dpmStat.curSnkPdo[idx].val) ||
+                (entry[idx].maxMinRaw != context->dpmStat.curSnkMaxMin[idx]));
+    }
+
+    if (!changed)
+    {
+        return;
+    }
+
+#if CY_APP_PDO_EVAL_CACHE_ENABLE
+    /* Cached results were derived from the previous sink capabilities. */
+    pdo_cache_clear(context->port);
+#endif /* CY_APP_PDO_EVAL_CACHE_ENABLE */
+
+    for (idx = 0u; idx < snk_pdo_len; idx++)
+    {
+        pdo_snk = &context->dpmStat.curSnkPdo[idx];
+        max_min = context->dpmStat.curSnkMaxMin[idx];
+
+        entry[idx].pdo          = pdo_snk->val;
+        entry[idx].maxMinRaw    = (uint16_t)max_min;
+        entry[idx].maxMinCurPwr = (uint16_t)(max_min & CY_PD_SNK_MIN_MAX_MASK);
+        entry[idx].giveBack     = ((max_min & CY_PD_GIVE_BACK_MASK) != 0u);
+        entry[idx].supplyType   = (uint8_t)pdo_snk->fixed_snk.supplyType;
+        entry[idx].avs          = false;
+
+        switch (pdo_snk->fixed_snk.supplyType)
+        {
+            case CY_PDSTACK_PDO_FIXED_SUPPLY:
+                entry[idx].minVolt  = (uint16_t)pdo_snk->fixed_snk.voltage;
+                entry[idx].maxVolt  = (uint16_t)pdo_snk->fixed_snk.voltage;
+                entry[idx].opCurPwr = (uint16_t)pdo_snk->fixed_snk.opCurrent;
+                break;
+
+            case CY_PDSTACK_PDO_VARIABLE_SUPPLY:
+                entry[idx].minVolt  = (uint16_t)pdo_snk->var_snk.minVoltage;
+                entry[idx].maxVolt  = (uint16_t)pdo_snk->var_snk.maxVoltage;
+                entry[idx].opCurPwr = (uint16_t)pdo_snk->var_snk.opCurrent;
+                break;
+
+            case CY_PDSTACK_PDO_BATTERY:
+                entry[idx].minVolt  = (uint16_t)pdo_snk->bat_snk.minVoltage;
+                entry[idx].maxVolt  = (uint16_t)pdo_snk->bat_snk.maxVoltage;
+                entry[idx].opCurPwr = (uint16_t)pdo_snk->bat_snk.opPower;
+                break;
+
+            default:
+                entry[idx].avs      = (pdo_snk->pps_snk.apdoType == CY_PDSTACK_APDO_AVS);
+                if (entry[idx].avs)
+                {
+                    /* Convert voltage to 50 mV from 100 mV unit and PDP into 250 mW unit */
+                    entry[idx].minVolt  = (uint16_t)(pdo_snk->epr_avs_snk.minVolt * 2u);
+                    entry[idx].maxVolt  = (uint16_t)(pdo_snk->epr_avs_snk.maxVolt * 2u);
+                    entry[idx].opCurPwr = (uint16_t)(pdo_snk->epr_avs_snk.pdp * 4u);
+                }
+                else
+                {
+                    /* Convert voltage to 50 mV from 100 mV unit and current to 10 mA from 50 mA unit */
+                    entry[idx].minVolt  = (uint16_t)(pdo_snk->pps_snk.minVolt * 2u);
+                    entry[idx].maxVolt  = (uint16_t)(pdo_snk->pps_snk.maxVolt * 2u);
+                    entry[idx].opCurPwr = (uint16_t)(pdo_snk->pps_snk.opCur * 5u);
+                }
+                break;
+        }
+    }
+}
+
+#if (CY_APP_PPS_SNK_ENABLE)
+/**
+ * Selects the PPS output voltage with the least headroom above the target voltage
+ * @param min_volt Lowest voltage supported by both partners in 50 mV units
+ * @param max_volt Highest voltage supported by both partners in 50 mV units
+ * @param target Target voltage in 50 mV units; 0 if not set
+ * @return Output voltage in 50 mV units
+ */
+static uint32_t get_pps_volt(uint32_t min_volt, uint32_t max_volt, uint16_t target)
+{
+    uint32_t volt = min_volt;
+
+    if (target != 0u)
+    {
+        volt = (uint32_t)target + CY_APP_PPS_SNK_VOLT_HEADROOM;
+        volt = CY_PDUTILS_GET_MAX(volt, min_volt);
+        volt = CY_PDUTILS_GET_MIN(volt, max_volt);
+    }
+
+    return volt;
+}
+#endif /* (CY_APP_PPS_SNK_ENABLE) */
+
+/**
+ * Checks if SRC pdo is acceptable for a SNK constraint and computes the resulting contract
  * @param pdo_src pointer to current SRC PDO
+ * @param snk Pointer to the sink constraint entry
  * @param snk_pdo_idx Index to the sink PDO
+ * @param pps_target Target voltage used to select the PPS output voltage
+ * @param contract Contract values filled in when the source PDO is acceptable
  * @return True if current src PDO is acceptable for current sink PDO
  */
-static bool is_src_acceptable_snk(cy_stc_pdstack_context_t* context, cy_pd_pd_do_t* pdo_src, uint8_t snk_pdo_idx)
+static bool is_src_acceptable_snk(const cy_pd_pd_do_t* pdo_src, const cy_stc_app_snk_constraint_t* snk,
+        uint8_t snk_pdo_idx, uint16_t pps_target, cy_stc_app_pdo_contract_t* contract)
 {
-    cy_pd_pd_do_t* pdo_snk = (cy_pd_pd_do_t*)&(context->dpmStat.curSnkPdo[snk_pdo_idx]);
-    uint8_t port = context->port;
-
-    uint32_t snk_supply_type = pdo_snk->fixed_snk.supplyType;
     uint32_t fix_volt;
     uint32_t maxVolt = 0u;
     uint32_t minVolt = 0u;
-    uint32_t out = false;
-    uint32_t max_min_temp, compare_temp;
-    uint32_t oper_cur_pwr;
-
-    max_min_temp = context->dpmStat.curSnkMaxMin[snk_pdo_idx] & CY_PD_SNK_MIN_MAX_MASK;
-#if CY_PD_EPR_ENABLE
-    glAppPdoPower[port] = 0;
-#endif /* CY_PD_EPR_ENABLE */
+    bool out = false;
+    uint32_t max_min_temp = snk->maxMinCurPwr;
+    uint32_t compare_temp;
+    uint32_t oper_cur_pwr = snk->opCurPwr;
 
     switch(pdo_src->fixed_src.supplyType)
     {
         case CY_PDSTACK_PDO_FIXED_SUPPLY:  /* Fixed supply PDO */
             fix_volt = pdo_src->fixed_src.voltage;
-#if CY_PD_EPR_ENABLE
-            glAppPdoPower[port] = calc_power(fix_volt, pdo_src->fixed_src.maxCurrent);
-#endif /* CY_PD_EPR_ENABLE */
             maxVolt = Cy_PdUtils_DivRoundUp(fix_volt, 20);
             minVolt = fix_volt - maxVolt;
             maxVolt = fix_volt + maxVolt;
 
-            switch(snk_supply_type)  /* Checking sink PDO type */
+            switch(snk->supplyType)  /* Checking sink PDO type */
             {
                 case CY_PDSTACK_PDO_FIXED_SUPPLY:
-                    if(fix_volt == pdo_snk->fixed_snk.voltage)
-                    {
-                        compare_temp = CY_PDUTILS_GET_MAX (max_min_temp, pdo_snk->fixed_snk.opCurrent);
-                        if (pdo_src->fixed_src.maxCurrent >= compare_temp)
-                        {
-                            glAppOperCurPower[port] = pdo_snk->fixed_snk.opCurrent;
-                            out = true;
-                        }
-                    }
+                    out = (fix_volt == snk->minVolt);
                     break;
 
                 case CY_PDSTACK_PDO_VARIABLE_SUPPLY:
-                    if ((minVolt >= pdo_snk->var_snk.minVoltage) && (maxVolt <= pdo_snk->var_snk.maxVoltage))
-                    {
-                        compare_temp = CY_PDUTILS_GET_MAX (max_min_temp, pdo_snk->var_snk.opCurrent);
-                        if (pdo_src->fixed_src.maxCurrent >= compare_temp)
-                        {
-                            glAppOperCurPower[port] = pdo_snk->var_snk.opCurrent;
-                            out = true;
-                        }
-                    }
+                    out = ((minVolt >= snk->minVolt) && (maxVolt <= snk->maxVolt));
                     break;
 
                 case CY_PDSTACK_PDO_BATTERY:
-                    if ((minVolt >= pdo_snk->bat_snk.minVoltage) && (maxVolt <= pdo_snk->bat_snk.maxVoltage))
+                    if ((minVolt >= snk->minVolt) && (maxVolt <= snk->maxVolt))
                     {
                         fix_volt = minVolt;
 
                         /* Calculate the operating current and min/max current values */
-                        oper_cur_pwr = calc_current(pdo_snk->bat_snk.opPower, minVolt);
-                        /* Calculate the operating current and min/max current values */
-                        /* Intel: Always set operating current to 27 W/fixed_pdo_voltage and max op. current to PDO voltage. */
+                        oper_cur_pwr = calc_current(snk->opCurPwr, minVolt);
                         max_min_temp = calc_current(max_min_temp, minVolt);
-
-                        /* Make sure the source can supply the maximum current that may be required. */
-                        compare_temp = CY_PDUTILS_GET_MAX(max_min_temp, oper_cur_pwr);
-                        if (pdo_src->fixed_src.maxCurrent >= compare_temp)
-                        {
-                            glAppOperCurPower[port] = oper_cur_pwr;
-                            out = true;
-                        }
+                        out = true;
                     }
                     break;
 
@@ -141,67 +340,43 @@ static bool is_src_acceptable_snk(cy_stc_pdstack_context_t* context, cy_pd_pd_do
                     break;
             }
 
-            if (out)
+            /* Make sure the source can supply the maximum current that may be required. */
+            if ((out) && (pdo_src->fixed_src.maxCurrent >= CY_PDUTILS_GET_MAX (max_min_temp, oper_cur_pwr)))
+            {
+                contract->contractVolt  = fix_volt;
+                contract->contractPower = calc_power (fix_volt, oper_cur_pwr);
+            }
+            else
             {
-                glAppContractVoltage[port] = fix_volt;
-                glAppContractPower[port]   = calc_power (fix_volt, glAppOperCurPower[port]);
-                glAppMaxMinPower[port]  = max_min_temp;
+                out = false;
             }
             break;
 
         case CY_PDSTACK_PDO_BATTERY:   /* SRC is a battery */
             maxVolt = pdo_src->bat_src.maxVoltage;
             minVolt = pdo_src->bat_src.minVoltage;
-#if CY_PD_EPR_ENABLE
-            glAppPdoPower[port] = pdo_src->bat_src.maxPower;
-#endif /* CY_PD_EPR_ENABLE */
-            switch(snk_supply_type)
-            {
-                case CY_PDSTACK_PDO_FIXED_SUPPLY:
-                    /* Battery cannot supply fixed voltage
-                     * Battery voltage changes with time
-                     * This contract if permitted can be un-reliable */
-                    break;
-
-                case CY_PDSTACK_PDO_VARIABLE_SUPPLY:
-                    if((minVolt >= pdo_snk->var_snk.minVoltage) && (maxVolt <= pdo_snk->var_snk.maxVoltage))
-                    {
-                        /* Calculate the expected operating power and maximum power requirement */
-                        oper_cur_pwr = calc_power(maxVolt, pdo_snk->var_snk.opCurrent);
-                        max_min_temp = calc_power(maxVolt, max_min_temp);
-
-                        compare_temp = CY_PDUTILS_GET_MAX (oper_cur_pwr, max_min_temp);
-                        if (pdo_src->bat_src.maxPower >= compare_temp)
-                        {
-                            glAppOperCurPower[port] = oper_cur_pwr;
-                            out = true;
-                        }
-                    }
-                    break;
 
-                case CY_PDSTACK_PDO_BATTERY:
-                    /* Battery connected directly to a battery.
-                     * This combination is unreliable. */
-                    if((minVolt >= pdo_snk->bat_snk.minVoltage) && (maxVolt <= pdo_snk->bat_snk.maxVoltage))
-                    {
-                        compare_temp = CY_PDUTILS_GET_MAX (max_min_temp, pdo_snk->bat_snk.opPower);
-                        if (pdo_src->bat_src.maxPower >= compare_temp)
-                        {
-                            glAppOperCurPower[port] = pdo_snk->bat_snk.opPower;
-                            out = true;
-                        }
-                    }
-                    break;
-
-                default:
-                    break;
-            }
-
-            if (out)
+            /*
+             * A battery cannot supply a fixed voltage as the battery voltage changes with time.
+             * Battery connected directly to a battery is unreliable, but permitted.
+             */
+            if ((snk->supplyType != CY_PDSTACK_PDO_FIXED_SUPPLY) && (snk->supplyType != CY_PDSTACK_PDO_AUGMENTED) &&
+                    (minVolt >= snk->minVolt) && (maxVolt <= snk->maxVolt))
             {
-                glAppContractVoltage[port] = maxVolt;
-                glAppMaxMinPower[port]  = max_min_temp;
-                glAppContractPower[port]   = glAppOperCurPower[port];
+                if (snk->supplyType == CY_PDSTACK_PDO_VARIABLE_SUPPLY)
+                {
+                    /* Calculate the expected operating power and maximum power requirement */
+                    oper_cur_pwr = calc_power(maxVolt, snk->opCurPwr);
+                    max_min_temp = calc_power(maxVolt, max_min_temp);
+                }
+
+                compare_temp = CY_PDUTILS_GET_MAX (oper_cur_pwr, max_min_temp);
+                if (pdo_src->bat_src.maxPower >= compare_temp)
+                {
+                    contract->contractVolt  = maxVolt;
+                    contract->contractPower = oper_cur_pwr;
+                    out = true;
+                }
             }
             break;
 
@@ -209,119 +384,378 @@ static bool is_src_acceptable_snk(cy_stc_pdstack_context_t* context, cy_pd_pd_do
             maxVolt = pdo_src->var_src.maxVoltage;
             minVolt = pdo_src->var_src.minVoltage;
 
-            switch (snk_supply_type) /* Checking sink PDO type */
+            /* A variable source cannot provide a fixed voltage */
+            if ((snk->supplyType != CY_PDSTACK_PDO_FIXED_SUPPLY) && (snk->supplyType != CY_PDSTACK_PDO_AUGMENTED) &&
+                    (minVolt >= snk->minVolt) && (maxVolt <= snk->maxVolt))
             {
-                case CY_PDSTACK_PDO_FIXED_SUPPLY:
-                    /* This connection is not feasible
-                     * A variable source cannot provide a fixed voltage */
-                    break;
-
-                case CY_PDSTACK_PDO_VARIABLE_SUPPLY:
-                    if((minVolt >= pdo_snk->var_snk.minVoltage) && (maxVolt <= pdo_snk->var_snk.maxVoltage))
-                    {
-                        compare_temp = CY_PDUTILS_GET_MAX (pdo_snk->var_snk.opCurrent, max_min_temp);
-
-                        if (pdo_src->var_src.maxCurrent >= compare_temp)
-                        {
-                            glAppContractPower[port] = calc_power(minVolt, pdo_snk->var_snk.opCurrent);
-                            glAppOperCurPower[port]   = pdo_snk->var_snk.opCurrent;
-                            out = true;
-                        }
-                    }
-                    break;
-
-                case CY_PDSTACK_PDO_BATTERY:
-                    if((minVolt >= pdo_snk->bat_snk.minVoltage) && (maxVolt <= pdo_snk->bat_snk.maxVoltage))
-                    {
-                        /* Convert from power to current */
-                        oper_cur_pwr = calc_current(pdo_snk->bat_snk.opPower, minVolt);
-                        max_min_temp = calc_current(max_min_temp, minVolt);
-
-                        compare_temp = CY_PDUTILS_GET_MAX (oper_cur_pwr, max_min_temp);
-                        if (pdo_src->var_src.maxCurrent >= compare_temp)
-                        {
-                            glAppContractPower[port] = pdo_snk->bat_snk.opPower;
-                            glAppOperCurPower[port]   = oper_cur_pwr;
-                            out = true;
-                        }
-                    }
-                    break;
+                if (snk->supplyType == CY_PDSTACK_PDO_BATTERY)
+                {
+                    /* Convert from power to current */
+                    oper_cur_pwr = calc_current(snk->opCurPwr, minVolt);
+                    max_min_temp = calc_current(max_min_temp, minVolt);
+                    contract->contractPower = snk->opCurPwr;
+                }
+                else
+                {
+                    contract->contractPower = calc_power(minVolt, snk->opCurPwr);
+                }
 
-                default:
-                    break;
+                compare_temp = CY_PDUTILS_GET_MAX (oper_cur_pwr, max_min_temp);
+                if (pdo_src->var_src.maxCurrent >= compare_temp)
+                {
+                    contract->contractVolt = maxVolt;
+                    out = true;
+                }
             }
+            break;
 
-            if (out)
+#if ((CY_PD_EPR_AVS_ENABLE) || (CY_APP_PPS_SNK_ENABLE))
+        case CY_PDSTACK_PDO_AUGMENTED:
+#if (CY_APP_PPS_SNK_ENABLE)
+            /* A PPS APDO can only satisfy a PPS APDO of the sink */
+            if ((pdo_src->pps_src.apdoType == CY_PDSTACK_APDO_PPS) &&
+                    (snk->supplyType == CY_PDSTACK_PDO_AUGMENTED) && (!snk->avs))
             {
-                glAppContractVoltage[port] = maxVolt;
-                glAppMaxMinPower[port]  = max_min_temp;
+                /* Convert voltage to 50 mV from 100 mV unit */
+                minVolt = CY_PDUTILS_GET_MAX((uint32_t)pdo_src->pps_src.minVolt * 2u, snk->minVolt);
+                maxVolt = CY_PDUTILS_GET_MIN((uint32_t)pdo_src->pps_src.maxVolt * 2u, snk->maxVolt);
+
+                /* Convert maximum current to 10 mA from 50 mA unit */
+                compare_temp = CY_PDUTILS_GET_MAX (max_min_temp, oper_cur_pwr);
+                if ((minVolt <= maxVolt) && (((uint32_t)pdo_src->pps_src.maxCur * 5u) >= compare_temp))
+                {
+                    contract->contractVolt  = get_pps_volt(minVolt, maxVolt, pps_target);
+                    contract->contractPower = calc_power(contract->contractVolt, oper_cur_pwr);
+                    out = true;
+                }
             }
-            break;
+#endif /* (CY_APP_PPS_SNK_ENABLE) */
 #if (CY_PD_EPR_AVS_ENABLE)
-            case CY_PDSTACK_PDO_AUGMENTED:
-                if((pdo_src->pps_src.apdoType == CY_PDSTACK_APDO_AVS) && (snk_pdo_idx >= CY_PD_MAX_NO_OF_PDO))
-                {
-                    /* Convert voltage to 50 mV from 100 mV unit */
-                    maxVolt = pdo_src->epr_avs_src.maxVolt * 2u;
-                    minVolt = pdo_src->epr_avs_src.minVolt * 2u;
+            if((pdo_src->pps_src.apdoType == CY_PDSTACK_APDO_AVS) && (snk_pdo_idx >= CY_PD_MAX_NO_OF_PDO))
+            {
+                /* Convert voltage to 50 mV from 100 mV unit */
+                maxVolt = pdo_src->epr_avs_src.maxVolt * 2u;
+                minVolt = pdo_src->epr_avs_src.minVolt * 2u;
 
-                    switch(snk_supply_type)
+                if (snk->supplyType == CY_PDSTACK_PDO_FIXED_SUPPLY)
+                {
+                    if((minVolt <= snk->minVolt) && (maxVolt >= snk->minVolt))
+                    {
+                        oper_cur_pwr = calc_power(snk->minVolt, snk->opCurPwr);
+                        max_min_temp = calc_power(snk->minVolt, max_min_temp);
+                        out = true;
+                    }
+                }
+                else if (snk->avs)
+                {
+                    if((minVolt <= snk->minVolt) && (maxVolt >= snk->maxVolt))
                     {
-                        case CY_PDSTACK_PDO_FIXED_SUPPLY:
-                            if((minVolt <= pdo_snk->fixed_snk.voltage) && (maxVolt >= pdo_snk->fixed_snk.voltage))
-                            {
-                                oper_cur_pwr = calc_power(pdo_snk->fixed_snk.voltage, pdo_snk->fixed_snk.opCurrent);
-                                max_min_temp = calc_power(pdo_snk->fixed_snk.voltage, max_min_temp);
-                                compare_temp = CY_PDUTILS_GET_MAX (max_min_temp, oper_cur_pwr);
-
-                                /* Convert PDP into 250 mW unit */
-                                if(pdo_src->epr_avs_src.pdp * 4u >= compare_temp)
-                                {
-                                    glAppOperCurPower[port] = oper_cur_pwr;
-                                    glAppContractVoltage[port] = pdo_snk->fixed_snk.voltage;
-                                    out = true;
-                                }
-                            }
-                            break;
-
-                        case CY_PDSTACK_PDO_AUGMENTED:
-                            if(pdo_snk->pps_snk.apdoType == CY_PDSTACK_APDO_AVS)
-                            {
-                                /* Convert voltage to 50 mV from 100 mV unit */
-                                if((minVolt <= pdo_snk->epr_avs_snk.minVolt * 2u) && (maxVolt >= pdo_snk->epr_avs_snk.maxVolt * 2u))
-                                {
-                                    max_min_temp = calc_power(pdo_snk->epr_avs_snk.maxVolt * 2u, max_min_temp);
-                                    compare_temp = CY_PDUTILS_GET_MAX (max_min_temp, pdo_snk->epr_avs_snk.pdp * 4u);
-
-                                    if(pdo_src->epr_avs_src.pdp * 4u >= compare_temp)
-                                    {
-                                        /* Convert PDP into 250 mW unit */
-                                        glAppOperCurPower[port] = pdo_snk->epr_avs_snk.pdp * 4u;
-                                        glAppContractVoltage[port] = pdo_snk->epr_avs_snk.maxVolt * 2u;
-                                        out = true;
-                                    }
-                                }
-                            }
-                            break;
-
-                        default:
-                            break;
+                        max_min_temp = calc_power(snk->maxVolt, max_min_temp);
+                        out = true;
                     }
                 }
-                if (out)
+                else
                 {
-                    glAppMaxMinPower[port]  = max_min_temp;
-                    glAppContractPower[port]   = glAppOperCurPower[port];
+                    /* No other sink PDO can be satisfied by an AVS APDO */
                 }
-                break;
+
+                /* Convert PDP into 250 mW unit */
+                if ((out) && (pdo_src->epr_avs_src.pdp * 4u >= CY_PDUTILS_GET_MAX (max_min_temp, oper_cur_pwr)))
+                {
+                    contract->contractVolt  = (snk->avs) ? snk->maxVolt : snk->minVolt;
+                    contract->contractPower = oper_cur_pwr;
+                }
+                else
+                {
+                    out = false;
+                }
+            }
 #endif /* (CY_PD_EPR_AVS_ENABLE) */
+            break;
+#endif /* ((CY_PD_EPR_AVS_ENABLE) || (CY_APP_PPS_SNK_ENABLE)) */
+
         default:
             break;
     }
 
+    if (out)
+    {
+        contract->operCurPwr   = oper_cur_pwr;
+        contract->maxMinCurPwr = max_min_temp;
+    }
+
+    (void)snk_pdo_idx;
+    (void)pps_target;
     return out;
 }
 
+#if (CY_PD_EPR_ENABLE)
+/* Returns the maximum power in 250 mW units offered by a fixed or battery source PDO. */
+static uint32_t get_src_pdo_power(const cy_pd_pd_do_t* pdo_src)
+{
+    uint32_t power = 0u;
+
+    if (pdo_src->fixed_src.supplyType == CY_PDSTACK_PDO_FIXED_SUPPLY)
+    {
+        power = calc_power(pdo_src->fixed_src.voltage, pdo_src->fixed_src.maxCurrent);
+    }
+    else if (pdo_src->fixed_src.supplyType == CY_PDSTACK_PDO_BATTERY)
+    {
+        power = pdo_src->bat_src.maxPower;
+    }
+    else
+    {
+        /* Variable and augmented PDOs are not checked */
+    }
+
+    return power;
+}
+#endif /* (CY_PD_EPR_ENABLE) */
+
+/* Contract power is calculated in is_src_acceptable_snk(). */
+static bool score_contract_power(cy_stc_pdstack_context_t *context, const cy_pd_pd_do_t *pdo_src,
+        const cy_stc_app_pdo_contract_t *contract, uint32_t *score)
+{
+    (void)context;
+    (void)pdo_src;
+
+    *score = contract->contractPower;
+    return true;
+}
+
+/* Only fixed PDOs take part; the power is based on the source PDO. */
+static bool score_fixed_power(cy_stc_pdstack_context_t *context, const cy_pd_pd_do_t *pdo_src,
+        const cy_stc_app_pdo_contract_t *contract, uint32_t *score)
+{
+    (void)context;
+    (void)contract;
+
+    *score = calc_power(pdo_src->fixed_src.voltage, pdo_src->fixed_src.maxCurrent);
+    return (pdo_src->fixed_src.supplyType == CY_PDSTACK_PDO_FIXED_SUPPLY);
+}
+
+/* Only fixed PDOs take part. */
+static bool score_fixed_voltage(cy_stc_pdstack_context_t *context, const cy_pd_pd_do_t *pdo_src,
+        const cy_stc_app_pdo_contract_t *contract, uint32_t *score)
+{
+    (void)context;
+
+    *score = contract->contractVolt;
+    return (pdo_src->fixed_src.supplyType == CY_PDSTACK_PDO_FIXED_SUPPLY);
+}
+
+/* Only fixed PDOs take part. */
+static bool score_fixed_current(cy_stc_pdstack_context_t *context, const cy_pd_pd_do_t *pdo_src,
+        const cy_stc_app_pdo_contract_t *contract, uint32_t *score)
+{
+    (void)context;
+    (void)contract;
+
+    *score = pdo_src->fixed_src.maxCurrent;
+    return (pdo_src->fixed_src.supplyType == CY_PDSTACK_PDO_FIXED_SUPPLY);
+}
+
+/*
+ * Contracts at or above the target voltage are preferred, the one with the least
+ * headroom first. Contracts below the target voltage are ranked by their voltage.
+ */
+static bool score_lowest_loss(cy_stc_pdstack_context_t *context, const cy_pd_pd_do_t *pdo_src,
+        const cy_stc_app_pdo_contract_t *contract, uint32_t *score)
+{
+    uint32_t target = glAppPdoTargetVolt[context->port];
+
+    (void)pdo_src;
+
+    if (contract->contractVolt >= target)
+    {
+        *score = 0x20000u - (contract->contractVolt - target);
+    }
+    else
+    {
+        *score = contract->contractVolt;
+    }
+
+    return true;
+}
+
+/* Maximum power while the battery is low, lowest loss once it is mostly charged. */
+static bool score_battery(cy_stc_pdstack_context_t *context, const cy_pd_pd_do_t *pdo_src,
+        const cy_stc_app_pdo_contract_t *contract, uint32_t *score)
+{
+    if (glAppPdoBattLevel[context->port] < CY_APP_PDO_BATT_FAST_CHARGE_LEVEL)
+    {
+        return score_contract_power(context, pdo_src, contract, score);
+    }
+
+    return score_lowest_loss(context, pdo_src, contract, score);
+}
+
+/* Tie-breaker of the battery policy: the criterion not used by score_battery(). */
+static bool score_battery_tie(cy_stc_pdstack_context_t *context, const cy_pd_pd_do_t *pdo_src,
+        const cy_stc_app_pdo_contract_t *contract, uint32_t *score)
+{
+    if (glAppPdoBattLevel[context->port] < CY_APP_PDO_BATT_FAST_CHARGE_LEVEL)
+    {
+        return score_lowest_loss(context, pdo_src, contract, score);
+    }
+
+    return score_contract_power(context, pdo_src, contract, score);
+}
+
+/* Built-in policies, indexed by cy_en_app_pdo_policy_t. */
+static const cy_stc_app_pdo_policy_t glAppPdoBuiltinPolicy[CY_APP_PDO_POLICY_CUSTOM] =
+{
+    {score_contract_power, NULL},               /* CY_APP_PDO_POLICY_MAX_POWER */
+    {score_fixed_power, NULL},                  /* CY_APP_PDO_POLICY_MAX_FIXED_POWER */
+    {score_fixed_voltage, NULL},                /* CY_APP_PDO_POLICY_MAX_VOLTAGE */
+    {score_fixed_current, NULL},                /* CY_APP_PDO_POLICY_MAX_CURRENT */
+    {score_lowest_loss, score_contract_power},  /* CY_APP_PDO_POLICY_LOWEST_LOSS */
+    {score_battery, score_battery_tie}          /* CY_APP_PDO_POLICY_BATTERY */
+};
+
+/* Policy selected through CY_APP_PD_PDO_SEL_ALGO. */
+static cy_en_app_pdo_policy_t get_default_policy(void)
+{
+    cy_en_app_pdo_policy_t policy;
+
+    switch(CY_APP_PD_PDO_SEL_ALGO)
+    {
+        case CY_PDSTACK_HIGHEST_POWER:
+            policy = CY_APP_PDO_POLICY_MAX_FIXED_POWER;
+            break;
+
+        case CY_PDSTACK_HIGHEST_VOLTAGE:
+            policy = CY_APP_PDO_POLICY_MAX_VOLTAGE;
+            break;
+
+        case CY_PDSTACK_HIGHEST_CURRENT:
+            policy = CY_APP_PDO_POLICY_MAX_CURRENT;
+            break;
+
+        default:
+            policy = CY_APP_PDO_POLICY_MAX_POWER;
+            break;
+    }
+
+    return policy;
+}
+
+/* Policy in use on the port. */
+static const cy_stc_app_pdo_policy_t* get_policy(uint8_t port)
+{
+    if (glAppPdoPolicy[port] == NULL)
+    {
+        return &glAppPdoBuiltinPolicy[get_default_policy()];
+    }
+
+    return glAppPdoPolicy[port];
+}
+
+cy_en_app_status_t Cy_App_Pdo_SetPolicy(cy_stc_pdstack_context_t *context, cy_en_app_pdo_policy_t policy)
+{
+    if ((uint32_t)policy >= (uint32_t)CY_APP_PDO_POLICY_CUSTOM)
+    {
+        return CY_APP_STAT_BAD_PARAM;
+    }
+
+    glAppPdoPolicy[context->port] = &glAppPdoBuiltinPolicy[policy];
+    glAppPdoPolicyId[context->port] = policy;
+    Cy_App_Pdo_ClearEvalCache(context);
+    return CY_APP_STAT_SUCCESS;
+}
+
+cy_en_app_status_t Cy_App_Pdo_RegisterPolicy(cy_stc_pdstack_context_t *context, const cy_stc_app_pdo_policy_t *policy)
+{
+    if ((policy == NULL) || (policy->score == NULL))
+    {
+        return CY_APP_STAT_BAD_PARAM;
+    }
+
+    glAppPdoPolicy[context->port] = policy;
+    glAppPdoPolicyId[context->port] = CY_APP_PDO_POLICY_CUSTOM;
+    Cy_App_Pdo_ClearEvalCache(context);
+    return CY_APP_STAT_SUCCESS;
+}
+
+cy_en_app_pdo_policy_t Cy_App_Pdo_GetPolicy(cy_stc_pdstack_context_t *context)
+{
+    if (glAppPdoPolicy[context->port] == NULL)
+    {
+        return get_default_policy();
+    }
+
+    return glAppPdoPolicyId[context->port];
+}
+
+#if CY_APP_PARTNER_CACHE_ENABLE
+/* Partner fingerprint: hash of the SPR PDOs, which are the same in SPR and EPR source capabilities. */
+static uint32_t get_partner_id(const cy_stc_pdstack_pd_packet_t* srcCap, uint8_t src_pdo_len)
+{
+    uint32_t hash = PDO_HASH_SEED;
+    uint8_t idx;
+
+    for (idx = 0u; (idx < src_pdo_len) && (idx < CY_PD_MAX_NO_OF_PDO); idx++)
+    {
+        /* EPR source capabilities pad the SPR section with empty PDOs */
+        if (srcCap->dat[idx].val != 0u)
+        {
+            hash = pdo_hash_word(hash, srcCap->dat[idx].val);
+        }
+    }
+
+    return hash;
+}
+
+/* Hash of everything the selected contract depends on. */
+static uint32_t get_partner_cfg_id(cy_stc_pdstack_context_t* context, uint32_t src_hash,
+        uint8_t snk_pdo_len, uint8_t flags)
+{
+    uint8_t port = context->port;
+    uint32_t hash = pdo_hash(src_hash, context->dpmStat.curSnkPdo, snk_pdo_len);
+    uint8_t idx;
+
+    for (idx = 0u; idx < snk_pdo_len; idx++)
+    {
+        hash = pdo_hash_word(hash, context->dpmStat.curSnkMaxMin[idx]);
+    }
+
+    hash = pdo_hash_word(hash, ((uint32_t)flags << 24u) | ((uint32_t)Cy_App_Pdo_GetPolicy(context) << 16u) |
+            glAppPdoTargetVolt[port]);
+    return pdo_hash_word(hash, (glAppPdoBattLevel[port] < CY_APP_PDO_BATT_FAST_CHARGE_LEVEL) ? 1u : 0u);
+}
+#endif /* CY_APP_PARTNER_CACHE_ENABLE */
+
+void Cy_App_Pdo_SetTargetVoltage(cy_stc_pdstack_context_t *context, uint16_t volt)
+{
+    if (glAppPdoTargetVolt[context->port] != volt)
+    {
+        glAppPdoTargetVolt[context->port] = volt;
+        Cy_App_Pdo_ClearEvalCache(context);
+    }
+}
+
+void Cy_App_Pdo_SetBatteryLevel(cy_stc_pdstack_context_t *context, uint8_t level)
+{
+    bool was_low = (glAppPdoBattLevel[context->port] < CY_APP_PDO_BATT_FAST_CHARGE_LEVEL);
+
+    glAppPdoBattLevel[context->port] = level;
+
+    /* Results only depend on which side of the fast charge level the battery is. */
+    if (was_low != (level < CY_APP_PDO_BATT_FAST_CHARGE_LEVEL))
+    {
+        Cy_App_Pdo_ClearEvalCache(context);
+    }
+}
+
+void Cy_App_Pdo_ClearEvalCache(cy_stc_pdstack_context_t *context)
+{
+#if CY_APP_PDO_EVAL_CACHE_ENABLE
+    pdo_cache_clear(context->port);
+#else
+    (void)context;
+#endif /* CY_APP_PDO_EVAL_CACHE_ENABLE */
+}
+
 static cy_pd_pd_do_t form_rdo(cy_stc_pdstack_context_t* context, uint8_t pdo_no, bool capMisMatch, bool giveBack, const cy_stc_pdstack_pd_packet_t* srcCap)
 {
 #if (CY_PD_REV3_ENABLE)
@@ -374,6 +808,15 @@ static cy_pd_pd_do_t form_rdo(cy_stc_pdstack_context_t* context, uint8_t pdo_no,
             snkRdo.rdo_epr_avs.opCur = (glAppContractPower[port] * 100u) / glAppContractVoltage[port];
         }
 #endif /* CY_PD_EPR_AVS_ENABLE */
+#if (CY_APP_PPS_SNK_ENABLE)
+        if(srcCap->dat[pdo_no - 1u].pps_src.apdoType == CY_PDSTACK_APDO_PPS)
+        {
+            /* Output voltage in 20 mV unit */
+            snkRdo.rdo_pps.outVolt = (glAppContractVoltage[port] * 5u) / 2u;
+            /* Operating current in 50 mA unit */
+            snkRdo.rdo_pps.opCur = glAppOperCurPower[port] / 5u;
+        }
+#endif /* (CY_APP_PPS_SNK_ENABLE) */
     }
 
 #if (CY_PD_REV3_ENABLE)
@@ -390,6 +833,14 @@ static cy_pd_pd_do_t form_rdo(cy_stc_pdstack_context_t* context, uint8_t pdo_no,
     return snkRdo;
 }
 
+/* Forms the request for the selected source PDO and passes it to the stack. */
+static void send_rdo(cy_stc_pdstack_context_t* context, const cy_stc_pdstack_pd_packet_t* srcCap, uint8_t pdo_no,
+        bool cap_mismatch, bool give_back, cy_pdstack_app_resp_cbk_t app_resp_handler)
+{
+    (Cy_App_GetRespBuffer(context->port))->respDo = form_rdo(context, pdo_no, cap_mismatch, give_back, srcCap);
+    app_resp_handler(context, Cy_App_GetRespBuffer(context->port));
+}
+
 /*
  * Evaluate the source capabilities listed by the source and picks the appropriate one to request.
  */
@@ -400,11 +851,38 @@ void Cy_App_Pdo_EvalSrcCap(cy_stc_pdstack_context_t* context, const cy_stc_pdsta
     uint8_t port = context->port;
     cy_stc_pdstack_dpm_status_t *dpm = &(context->dpmStat);
     uint16_t src_vsafe5_cur = srcCap->dat[0].fixed_src.maxCurrent; /* Source max current for first PDO */
-    cy_pd_pd_do_t snkRdo;
-    uint32_t highest_gl_contract_power = 0u;
+    const cy_stc_app_snk_constraint_t *snk = glAppSnkConstraint[port];
+    const cy_pd_pd_do_t *pdo_src;
+    const cy_stc_app_pdo_policy_t *policy = get_policy(port);
+    cy_stc_app_pdo_contract_t contract = {0};
+    cy_stc_app_pdo_contract_t best = {0};
+    uint32_t highest_score = 0u;
+    uint32_t highest_tie = 0u;
+    uint32_t score = 0u;
+    uint32_t tie = 0u;
+    uint32_t best_pos = 0u;
+    uint32_t pos;
+    uint8_t pdo_no;
+    bool cap_mismatch;
+    bool give_back;
     bool match = false;
+    bool high_cap = (bool)snkPdo[0].fixed_snk.highCap;
     uint8_t src_pdo_len = srcCap->len;
     uint8_t snk_pdo_len = dpm->curSnkPdocount;
+#if (CY_APP_PDO_EVAL_CACHE_ENABLE || CY_APP_PARTNER_CACHE_ENABLE)
+    uint32_t hash;
+    uint8_t cache_flags = 0u;
+#endif /* (CY_APP_PDO_EVAL_CACHE_ENABLE || CY_APP_PARTNER_CACHE_ENABLE) */
+#if CY_APP_PDO_EVAL_CACHE_ENABLE
+    const cy_stc_app_pdo_cache_entry_t *cache = NULL;
+    /* Application-specific policies may depend on state outside the cache key. */
+    bool cacheable = (Cy_App_Pdo_GetPolicy(context) != CY_APP_PDO_POLICY_CUSTOM);
+#endif /* CY_APP_PDO_EVAL_CACHE_ENABLE */
+#if CY_APP_PARTNER_CACHE_ENABLE
+    const cy_stc_app_partner_entry_t *partner;
+    cy_stc_app_partner_entry_t partner_contract;
+    uint32_t partner_cfg;
+#endif /* CY_APP_PARTNER_CACHE_ENABLE */
 #if (CY_PD_EPR_ENABLE)
     cy_stc_pdstack_dpm_ext_status_t *dpmExt = &(context->dpmExtStat);
     bool eprActive = false;
@@ -424,106 +902,146 @@ void Cy_App_Pdo_EvalSrcCap(cy_stc_pdstack_context_t* context, const cy_stc_pdsta
             Cy_PdStack_Dpm_ChangeEprToSpr(context, false);
         }
     }
+
+    Cy_PdStack_Dpm_IsEprModeActive(context, &eprActive);
+
+    /* Clear req_status */
+    (Cy_App_GetRespBuffer(port))->reqStatus = (cy_en_pdstack_app_req_status_t)0;
 #endif /* CY_PD_EPR_ENABLE */
 
-    for(snk_pdo_index = 0u; snk_pdo_index < snk_pdo_len; snk_pdo_index++)
+    if (snk_pdo_len > CY_APP_PDO_MAX_SNK_PDO)
     {
-        for(src_pdo_index = 0u; src_pdo_index < src_pdo_len; src_pdo_index++)
-        {
+        snk_pdo_len = CY_APP_PDO_MAX_SNK_PDO;
+    }
+
+    /* Sink limits are only re-derived when the sink capabilities have changed. */
+    update_snk_constraints(context, snk_pdo_len);
+
+#if (CY_APP_PDO_EVAL_CACHE_ENABLE || CY_APP_PARTNER_CACHE_ENABLE)
 #if (CY_PD_EPR_ENABLE)
-            if((src_pdo_index >= CY_PD_MAX_NO_OF_PDO) && (srcCap->dat[src_pdo_index].fixed_src.supplyType == CY_PDSTACK_PDO_BATTERY))
+    /* The EPR checks depend on the message type and the EPR mode state. */
+    cache_flags = (uint8_t)(((srcCap->hdr.hdr.extd != 0u) ? 0x01u : 0u) | ((eprActive) ? 0x02u : 0u));
+#endif /* CY_PD_EPR_ENABLE */
+    hash = pdo_hash(PDO_HASH_SEED, srcCap->dat, src_pdo_len);
+#endif /* (CY_APP_PDO_EVAL_CACHE_ENABLE || CY_APP_PARTNER_CACHE_ENABLE) */
+
+#if CY_APP_PARTNER_CACHE_ENABLE
+    /* The partner is identified before the evaluation cache can answer, as the swap and EPR checks use its flags. */
+    Cy_App_Partner_Identify(context, get_partner_id(srcCap, src_pdo_len));
+#endif /* CY_APP_PARTNER_CACHE_ENABLE */
+
+#if CY_APP_PDO_EVAL_CACHE_ENABLE
+    /* Source capabilities which have been evaluated before are answered from the cache. */
+    if (cacheable)
+    {
+        cache = pdo_cache_lookup(port, hash, srcCap, src_pdo_len, snk_pdo_len, cache_flags);
+    }
+    if (cache != NULL)
+    {
+        glAppContractVoltage[port] = cache->contract.contractVolt;
+        glAppContractPower[port]   = cache->contract.contractPower;
+        glAppOperCurPower[port]    = cache->contract.operCurPwr;
+        glAppMaxMinPower[port]     = cache->contract.maxMinCurPwr;
+
+        send_rdo(context, srcCap, cache->pdoNo, cache->capMismatch, cache->giveBack, app_resp_handler);
+        return;
+    }
+#endif /* CY_APP_PDO_EVAL_CACHE_ENABLE */
+
+#if CY_APP_PARTNER_CACHE_ENABLE
+    /*
+     * A partner seen before is offered the contract it got last time, provided that the
+     * capabilities and local settings are unchanged and the requested PDO is still offered.
+     * Results of application-specific policies are not reused as they may depend on other state.
+     */
+    partner = Cy_App_Partner_GetEntry(context);
+    partner_cfg = get_partner_cfg_id(context, hash, snk_pdo_len, cache_flags);
+
+    if ((partner != NULL) && ((partner->flags & CY_APP_PARTNER_FLAG_CONTRACT) != 0u) &&
+            (partner->cfgId == partner_cfg) && (partner->pdoNo != 0u) && (partner->pdoNo <= src_pdo_len) &&
+            (srcCap->dat[partner->pdoNo - 1u].val == partner->srcPdo) &&
+            (Cy_App_Pdo_GetPolicy(context) != CY_APP_PDO_POLICY_CUSTOM))
+    {
+        glAppContractVoltage[port] = partner->contractVolt;
+        glAppContractPower[port]   = partner->contractPower;
+        glAppOperCurPower[port]    = partner->operCurPwr;
+        glAppMaxMinPower[port]     = partner->maxMinCurPwr;
+
+        pdo_no       = partner->pdoNo;
+        cap_mismatch = ((partner->flags & CY_APP_PARTNER_FLAG_CAP_MISMATCH) != 0u);
+        give_back    = ((partner->flags & CY_APP_PARTNER_FLAG_GIVE_BACK) != 0u);
+
+#if CY_APP_PDO_EVAL_CACHE_ENABLE
+        pdo_cache_store(port, hash, srcCap, src_pdo_len, snk_pdo_len, cache_flags, pdo_no, cap_mismatch, give_back);
+#endif /* CY_APP_PDO_EVAL_CACHE_ENABLE */
+
+        send_rdo(context, srcCap, pdo_no, cap_mismatch, give_back, app_resp_handler);
+        return;
+    }
+#endif /* CY_APP_PARTNER_CACHE_ENABLE */
+
+    /* Score each source PDO against all sink constraints in a single pass. */
+    for(src_pdo_index = 0u; (src_pdo_index < src_pdo_len) && (snk_pdo_len != 0u); src_pdo_index++)
+    {
+        pdo_src = &srcCap->dat[src_pdo_index];
+
+#if (CY_PD_EPR_ENABLE)
+        if((src_pdo_index >= CY_PD_MAX_NO_OF_PDO) && (pdo_src->fixed_src.supplyType == CY_PDSTACK_PDO_BATTERY))
+        {
+            continue;
+        }
+
+        /* Sink should not process received EPR_Source_Capabilites message with a
+         * PDO greater than 100 W in any of the first seven object positions.
+         * 100000 mW in 250 mW unit. */
+        if(eprActive && (srcCap->hdr.hdr.extd)
+            && (src_pdo_index < CY_PD_MAX_NO_OF_PDO) && (get_src_pdo_power(pdo_src) > 100000u/250u))
+        {
+            (Cy_App_GetRespBuffer(port))->reqStatus = CY_PDSTACK_REQ_SEND_HARD_RESET;
+            app_resp_handler(context, Cy_App_GetRespBuffer(port));
+            return;
+        }
+#endif /* CY_PD_EPR_ENABLE */
+
+        for(snk_pdo_index = 0u; snk_pdo_index < snk_pdo_len; snk_pdo_index++)
+        {
+            if(!is_src_acceptable_snk(pdo_src, &snk[snk_pdo_index], snk_pdo_index,
+                        glAppPdoTargetVolt[port], &contract))
             {
                 continue;
             }
-#endif /* CY_PD_EPR_ENABLE */
-            if(is_src_acceptable_snk(context, (cy_pd_pd_do_t*)(&srcCap->dat[src_pdo_index]), snk_pdo_index))
-            {
-                bool max_cond = false; 
-                /*
-                 * Support four different algorithms based on which the most appropriate source PDO is selected:
-                 * CY_PDSTACK_HIGHEST_POWER   : Pick the fixed source PDO which delivers maximum amount of power
-                 * CY_PDSTACK_HIGHEST_VOLTAGE : Pick the fixed source PDO which delivers power at maximum voltage
-                 * CY_PDSTACK_HIGHEST_CURRENT : Pick the fixed source PDO which delivers the maximum current
-                 * Default (none of the above): Pick the source PDO which delivers maximum amount of power
-                 */
-                switch(CY_APP_PD_PDO_SEL_ALGO)
-                {
-                    case CY_PDSTACK_HIGHEST_POWER:
-                        /* Contract_power is based on SRC PDO */
-                        if (srcCap->dat[src_pdo_index].fixed_src.supplyType == CY_PDSTACK_PDO_FIXED_SUPPLY)
-                        {
-                            uint32_t temp_power = calc_power(srcCap->dat[src_pdo_index].fixed_src.voltage,
-                                    srcCap->dat[src_pdo_index].fixed_src.maxCurrent);
-                            if (temp_power >= highest_gl_contract_power)
-                            {
-                                highest_gl_contract_power = temp_power;
-                                max_cond = true;
-                            }
-                        }
-                        break;
-
-                    case CY_PDSTACK_HIGHEST_VOLTAGE:
-                        /* Only fixed PDO takes part */
-                        if ((srcCap->dat[src_pdo_index].fixed_src.supplyType == CY_PDSTACK_PDO_FIXED_SUPPLY)
-                                && (glAppContractVoltage[port] >= highest_gl_contract_power))
-                        {
-                            highest_gl_contract_power = glAppContractVoltage[port];
-                            max_cond = true;
-                        }
-                        break;
-
-                    case CY_PDSTACK_HIGHEST_CURRENT:
-                        /* Only fixed PDO takes part */
-                        if ((srcCap->dat[src_pdo_index].fixed_src.supplyType == CY_PDSTACK_PDO_FIXED_SUPPLY)
-                                && (srcCap->dat[src_pdo_index].fixed_src.maxCurrent >= highest_gl_contract_power))
-                        {
-                            highest_gl_contract_power = srcCap->dat[src_pdo_index].fixed_src.maxCurrent;
-                            max_cond = true;
-                        }
-                        break;
-
-                    default:
-                        /* Contract_power is calculated in is_src_acceptable_snk() */
-                        if (glAppContractPower[port] >= highest_gl_contract_power)
-                        {
-                            highest_gl_contract_power = glAppContractPower[port];
-                            max_cond = true;
-                        }
-                        break;
-                }
 
-                if (max_cond)
-                {
-                    /* Check if sink needs higher capability */
-                    if ((snkPdo[0].fixed_snk.highCap) && (glAppContractVoltage[port] == (CY_PD_VSAFE_5V/CY_PD_VOLT_PER_UNIT)))
-                    {
-                        /* 5 V contract is not acceptable with highCap = 1 */
-                        continue;
-                    }
+            /* Check if sink needs higher capability: 5 V contract is not acceptable with highCap = 1 */
+            if ((high_cap) && (contract.contractVolt == (CY_PD_VSAFE_5V/CY_PD_VOLT_PER_UNIT)))
+            {
+                continue;
+            }
 
-                    snkRdo = form_rdo(context, (src_pdo_index + 1u), false,
-                            (context->dpmStat.curSnkMaxMin[snk_pdo_index] & CY_PD_GIVE_BACK_MASK), srcCap);
-                    match = true;
-                }
+            if (!policy->score(context, pdo_src, &contract, &score))
+            {
+                continue;
             }
-#if (CY_PD_EPR_ENABLE)
-            /* Sink should not process received EPR_Source_Capabilites message with a
-             * PDO greater than 100 W in any of the first seven object positions.
-             * 100000 mW in 250 mW unit. */
-            Cy_PdStack_Dpm_IsEprModeActive(context, &eprActive);
-            if(eprActive && (srcCap->hdr.hdr.extd)
-                && (src_pdo_index < CY_PD_MAX_NO_OF_PDO) && (glAppPdoPower[port] > 100000u/250u))
+
+            tie = 0u;
+            if (policy->tieBreak != NULL)
             {
-                (Cy_App_GetRespBuffer(port))->reqStatus = CY_PDSTACK_REQ_SEND_HARD_RESET;
-                app_resp_handler(context, Cy_App_GetRespBuffer(port));
-                return;
+                (void)policy->tieBreak(context, pdo_src, &contract, &tie);
             }
-            else
+
+            /*
+             * On equal score, the candidate with the higher tie-breaker score, then the higher
+             * sink PDO index and then the higher source PDO index is preferred.
+             */
+            pos = ((uint32_t)snk_pdo_index << 8u) | src_pdo_index;
+            if ((!match) || (score > highest_score) ||
+                    ((score == highest_score) && ((tie > highest_tie) || ((tie == highest_tie) && (pos > best_pos)))))
             {
-                /* Clear req_status */
-                (Cy_App_GetRespBuffer(port))->reqStatus = (cy_en_pdstack_app_req_status_t)0;
+                highest_score = score;
+                highest_tie = tie;
+                best = contract;
+                best_pos = pos;
+                match = true;
             }
-#endif /* CY_PD_EPR_ENABLE */
         }
     }
 
@@ -542,11 +1060,44 @@ void Cy_App_Pdo_EvalSrcCap(cy_stc_pdstack_context_t* context, const cy_stc_pdsta
         }
 
         glAppMaxMinPower[port] = context->dpmStat.curSnkMaxMin[0];
-        snkRdo = form_rdo(context, 1u, true, false, srcCap);
+        pdo_no = 1u;
+        cap_mismatch = true;
+        give_back = false;
     }
+    else
+    {
+        /* Contract values are only stored once the best source PDO has been identified. */
+        glAppContractVoltage[port] = best.contractVolt;
+        glAppContractPower[port]   = best.contractPower;
+        glAppOperCurPower[port]    = best.operCurPwr;
+        glAppMaxMinPower[port]     = best.maxMinCurPwr;
 
-    (Cy_App_GetRespBuffer(port))->respDo = snkRdo;
-    app_resp_handler(context, Cy_App_GetRespBuffer(context->port));
+        pdo_no = (uint8_t)((best_pos & 0xFFu) + 1u);
+        cap_mismatch = false;
+        give_back = snk[best_pos >> 8u].giveBack;
+    }
+
+#if CY_APP_PDO_EVAL_CACHE_ENABLE
+    if (cacheable)
+    {
+        pdo_cache_store(port, hash, srcCap, src_pdo_len, snk_pdo_len, cache_flags, pdo_no, cap_mismatch, give_back);
+    }
+#endif /* CY_APP_PDO_EVAL_CACHE_ENABLE */
+
+#if CY_APP_PARTNER_CACHE_ENABLE
+    partner_contract.cfgId         = partner_cfg;
+    partner_contract.srcPdo        = srcCap->dat[pdo_no - 1u].val;
+    partner_contract.pdoNo         = pdo_no;
+    partner_contract.contractVolt  = (uint16_t)glAppContractVoltage[port];
+    partner_contract.contractPower = (uint16_t)glAppContractPower[port];
+    partner_contract.operCurPwr    = (uint16_t)glAppOperCurPower[port];
+    partner_contract.maxMinCurPwr  = (uint16_t)glAppMaxMinPower[port];
+    partner_contract.flags         = (uint8_t)(((cap_mismatch) ? CY_APP_PARTNER_FLAG_CAP_MISMATCH : 0u) |
+            ((give_back) ? CY_APP_PARTNER_FLAG_GIVE_BACK : 0u));
+    Cy_App_Partner_SaveContract(context, &partner_contract);
+#endif /* CY_APP_PARTNER_CACHE_ENABLE */
+
+    send_rdo(context, srcCap, pdo_no, cap_mismatch, give_back, app_resp_handler);
 }
 #endif /* (!(CY_PD_SOURCE_ONLY)) */
 
@@ -555,6 +1106,162 @@ void Cy_App_Pdo_EvalSrcCap(cy_stc_pdstack_context_t* context, const cy_stc_pdsta
  * This function can be used to ask EC to evaluate a request message.
  * For now evaluating here and executing the callback in this function itself.
  */
+#if CY_APP_RDO_LIMIT_CACHE_ENABLE
+/* Accept limits of the source PDOs advertised on each port. */
+static cy_stc_app_rdo_limit_table_t glAppRdoLimit[NO_OF_TYPEC_PORTS];
+
+/* Derives the accept limits of a source PDO. */
+static void rdo_limit_set(cy_stc_app_rdo_limit_t *limit, cy_pd_pd_do_t pdo, bool enabled)
+{
+    limit->pdo = pdo.val;
+    limit->check = (uint8_t)CY_APP_RDO_CHECK_STACK;
+    limit->minVolt = 0u;
+    limit->maxVolt = 0u;
+    limit->maxCurPwr = 0u;
+
+    /* Requests for disabled PDOs are left to the stack */
+    if (!enabled)
+    {
+        return;
+    }
+
+    switch (pdo.fixed_src.supplyType)
+    {
+        case CY_PDSTACK_PDO_FIXED_SUPPLY:
+            limit->maxCurPwr = pdo.fixed_src.maxCurrent;
+            limit->check = (uint8_t)CY_APP_RDO_CHECK_CURRENT;
+            break;
+
+        case CY_PDSTACK_PDO_VARIABLE_SUPPLY:
+            limit->maxCurPwr = pdo.var_src.maxCurrent;
+            limit->check = (uint8_t)CY_APP_RDO_CHECK_CURRENT;
+            break;
+
+        case CY_PDSTACK_PDO_BATTERY:
+            limit->maxCurPwr = pdo.bat_src.maxPower;
+            limit->check = (uint8_t)CY_APP_RDO_CHECK_POWER;
+            break;
+
+        case CY_PDSTACK_PDO_AUGMENTED:
+            if (pdo.pps_src.apdoType == CY_PDSTACK_APDO_PPS)
+            {
+                /* APDO voltages are in 100 mV units; the request uses 20 mV units */
+                limit->minVolt = (uint16_t)(pdo.pps_src.minVolt * 5u);
+                limit->maxVolt = (uint16_t)(pdo.pps_src.maxVolt * 5u);
+                limit->maxCurPwr = pdo.pps_src.maxCur;
+                limit->check = (uint8_t)CY_APP_RDO_CHECK_PPS;
+            }
+            break;
+
+        default:
+            /* Nothing to do */
+            break;
+    }
+}
+
+/* Returns the limit table of the port, rebuilding it if the source PDOs have changed. */
+static const cy_stc_app_rdo_limit_table_t* rdo_limit_get(cy_stc_pdstack_context_t* context)
+{
+    cy_stc_app_rdo_limit_table_t *table = &glAppRdoLimit[context->port];
+    const cy_stc_pdstack_dpm_status_t *dpm_stat = &context->dpmStat;
+    uint8_t count = CY_PDUTILS_GET_MIN(dpm_stat->srcPdoCount, CY_PD_MAX_NO_OF_PDO);
+    bool changed = ((table->count != count) || (table->mask != dpm_stat->srcPdoMask));
+    uint8_t idx;
+
+    for (idx = 0u; (idx < count) && (!changed); idx++)
+    {
+        changed = (table->limit[idx].pdo != dpm_stat->curSrcPdo[idx].val);
+    }
+
+    if (changed)
+    {
+        for (idx = 0u; idx < count; idx++)
+        {
+            rdo_limit_set(&table->limit[idx], dpm_stat->curSrcPdo[idx],
+                    ((dpm_stat->srcPdoMask & (1u << idx)) != 0u));
+        }
+
+        table->count = count;
+        table->mask = dpm_stat->srcPdoMask;
+    }
+
+    return table;
+}
+
+/*
+ * Checks the request against the precomputed limits. Returns false if the request has to be
+ * checked by the stack.
+ */
+static bool rdo_limit_check(cy_stc_pdstack_context_t* context, cy_pd_pd_do_t rdo,
+        cy_en_pdstack_app_req_status_t *status)
+{
+    const cy_stc_app_rdo_limit_table_t *table;
+    const cy_stc_app_rdo_limit_t *limit;
+    bool done = false;
+    uint8_t obj_pos = rdo.rdo_gen.objPos;
+    uint16_t op_cur_pwr = rdo.rdo_gen.opPowerCur;
+    uint16_t max_cur_pwr = rdo.rdo_gen.minMaxPowerCur;
+#if (CY_PD_EPR_ENABLE)
+    bool eprActive = false;
+
+    /* EPR requests carry a copy of the source PDO which is checked by the stack */
+    Cy_PdStack_Dpm_IsEprModeActive(context, &eprActive);
+    if (eprActive)
+    {
+        return false;
+    }
+#endif /* (CY_PD_EPR_ENABLE) */
+
+    table = rdo_limit_get(context);
+    if ((obj_pos == 0u) || (obj_pos > table->count))
+    {
+        return false;
+    }
+
+    limit = &table->limit[obj_pos - 1u];
+    switch ((cy_en_app_rdo_check_t)limit->check)
+    {
+        case CY_APP_RDO_CHECK_CURRENT:
+        case CY_APP_RDO_CHECK_POWER:
+            if (op_cur_pwr > limit->maxCurPwr)
+            {
+                *status = CY_PDSTACK_REQ_REJECT;
+                done = true;
+            }
+            /* A higher max current with capability mismatch is left to the stack */
+            else if (max_cur_pwr <= limit->maxCurPwr)
+            {
+                *status = CY_PDSTACK_REQ_ACCEPT;
+                done = true;
+            }
+            else
+            {
+                /* Checked by the stack */
+            }
+            break;
+
+        case CY_APP_RDO_CHECK_PPS:
+            if ((rdo.rdo_pps.outVolt < limit->minVolt) || (rdo.rdo_pps.outVolt > limit->maxVolt) ||
+                    (rdo.rdo_pps.opCur > limit->maxCurPwr))
+            {
+                *status = CY_PDSTACK_REQ_REJECT;
+            }
+            else
+            {
+                *status = CY_PDSTACK_REQ_ACCEPT;
+            }
+            done = true;
+            break;
+
+        default:
+            /* Checked by the stack */
+            break;
+    }
+
+    return done;
+}
+#endif /* CY_APP_RDO_LIMIT_CACHE_ENABLE */
+
 void Cy_App_Pdo_EvalRdo(cy_stc_pdstack_context_t* context, cy_pd_pd_do_t rdo, cy_pdstack_app_resp_cbk_t app_resp_handler)
 {
     uint8_t port = context->port;
@@ -568,6 +1275,14 @@ void Cy_App_Pdo_EvalRdo(cy_stc_pdstack_context_t* context, cy_pd_pd_do_t rdo, cy
     }
 #endif /* CY_PD_REV3_ENABLE && (!CY_PD_EPR_ENABLE) */
 
+#if CY_APP_RDO_LIMIT_CACHE_ENABLE
+    if (rdo_limit_check(context, rdo, &Cy_App_GetRespBuffer(port)->reqStatus))
+    {
+        app_resp_handler(context, Cy_App_GetRespBuffer(port));
+        return;
+    }
+#endif /* CY_APP_RDO_LIMIT_CACHE_ENABLE */
+
     if (Cy_PdStack_Dpm_IsRdoValid(context, rdo) == CY_PDSTACK_STAT_SUCCESS)
     {
         Cy_App_GetRespBuffer(port)->reqStatus = CY_PDSTACK_REQ_ACCEPT;
@@ -42,6 +42,14 @@
 * 3. Register the application callback to the PDStack middleware library.
 *    Refer to the \ref section_pmg_app_common_quick_start section.
 *
+* The source PDO selection policy defaults to the one configured through
+* CY_APP_PD_PDO_SEL_ALGO. It can be changed for each port at runtime using
+* Cy_App_Pdo_SetPolicy(), or replaced by an application-specific policy using
+* Cy_App_Pdo_RegisterPolicy().
+*
+* \defgroup group_pmg_app_common_pdo_macros Macros
+* \defgroup group_pmg_app_common_pdo_enums Enumerated types
+* \defgroup group_pmg_app_common_pdo_data_structures Data structures
 * \defgroup group_pmg_app_common_pdo_functions Functions
 */
 
@@ -52,6 +60,7 @@
  ******************************************************************************/
 
 #include "cy_pdstack_common.h"
+#include "cy_app_status.h"
 
 /*****************************************************************************
  * Macro definitions
@@ -63,6 +72,182 @@
 #define APP_PPS_SNK_CONTRACT_RETRY_PERIOD       (5u)
 /**< Period after which a failed PPS sink re-contract attempt will be retried */
 
+/**
+* \addtogroup group_pmg_app_common_pdo_macros
+* \{
+*/
+
+#if CY_PD_EPR_ENABLE
+/** Maximum number of sink PDOs considered during source capability evaluation */
+#define CY_APP_PDO_MAX_SNK_PDO                  (CY_PD_MAX_NO_OF_PDO + CY_PD_MAX_NO_OF_EPR_PDO)
+
+/** Maximum number of source PDOs in a source capabilities message */
+#define CY_APP_PDO_MAX_SRC_PDO                  (CY_PD_MAX_NO_OF_PDO + CY_PD_MAX_NO_OF_EPR_PDO)
+#else
+/** Maximum number of sink PDOs considered during source capability evaluation */
+#define CY_APP_PDO_MAX_SNK_PDO                  (CY_PD_MAX_NO_OF_PDO)
+
+/** Maximum number of source PDOs in a source capabilities message */
+#define CY_APP_PDO_MAX_SRC_PDO                  (CY_PD_MAX_NO_OF_PDO)
+#endif /* CY_PD_EPR_ENABLE */
+
+#ifndef CY_APP_PPS_SNK_VOLT_HEADROOM
+/** Headroom in 50 mV units requested above the target voltage when a PPS APDO
+ * is selected as a sink. */
+#define CY_APP_PPS_SNK_VOLT_HEADROOM            (10u)
+#endif /* CY_APP_PPS_SNK_VOLT_HEADROOM */
+
+#ifndef CY_APP_PDO_EVAL_CACHE_SIZE
+/** Number of source capability evaluation results cached per port */
+#define CY_APP_PDO_EVAL_CACHE_SIZE              (2u)
+#endif /* CY_APP_PDO_EVAL_CACHE_SIZE */
+
+#ifndef CY_APP_PDO_BATT_FAST_CHARGE_LEVEL
+/** Battery level in percent below which the battery policy requests the
+ * maximum power; at or above this level, it requests the lowest loss contract. */
+#define CY_APP_PDO_BATT_FAST_CHARGE_LEVEL       (80u)
+#endif /* CY_APP_PDO_BATT_FAST_CHARGE_LEVEL */
+
+/** \} group_pmg_app_common_pdo_macros */
+
+/**
+* \addtogroup group_pmg_app_common_pdo_enums
+* \{
+*/
+
+/**
+ * @typedef cy_en_app_pdo_policy_t
+ * @brief List of source PDO selection policies
+ */
+typedef enum
+{
+    CY_APP_PDO_POLICY_MAX_POWER = 0,    /**< Source PDO which delivers the maximum contract power. */
+    CY_APP_PDO_POLICY_MAX_FIXED_POWER,  /**< Fixed source PDO which advertises the maximum power. */
+    CY_APP_PDO_POLICY_MAX_VOLTAGE,      /**< Fixed source PDO which delivers power at the maximum voltage. */
+    CY_APP_PDO_POLICY_MAX_CURRENT,      /**< Fixed source PDO which delivers the maximum current. */
+    CY_APP_PDO_POLICY_LOWEST_LOSS,      /**< Source PDO with the least voltage headroom above the target voltage. */
+    CY_APP_PDO_POLICY_BATTERY,          /**< Maximum power while the battery is low; lowest loss otherwise. */
+    CY_APP_PDO_POLICY_CUSTOM            /**< Application policy registered using Cy_App_Pdo_RegisterPolicy. */
+} cy_en_app_pdo_policy_t;
+
+/**
+ * @typedef cy_en_app_rdo_check_t
+ * @brief Check applied to requests for a source PDO using the precomputed limits
+ */
+typedef enum
+{
+    CY_APP_RDO_CHECK_STACK = 0,         /**< Request is validated by the PD stack. */
+    CY_APP_RDO_CHECK_CURRENT,           /**< Operating and max current against the PDO current. */
+    CY_APP_RDO_CHECK_POWER,             /**< Operating and max power against the PDO power. */
+    CY_APP_RDO_CHECK_PPS                /**< Output voltage and operating current against the APDO limits. */
+} cy_en_app_rdo_check_t;
+
+/** \} group_pmg_app_common_pdo_enums */
+
+/*****************************************************************************
+ * Data Struct Definition
+ *****************************************************************************/
+/**
+* \addtogroup group_pmg_app_common_pdo_data_structures
+* \{
+*/
+
+/**
+ * @brief Limits derived from one active sink PDO. The table of sink constraints is
+ * only rebuilt when the sink capabilities change, so that the source capability
+ * evaluation does not re-derive these values for every source PDO.
+ */
+typedef struct
+{
+    uint32_t pdo;                       /**< Sink PDO the entry was derived from. */
+    uint16_t maxMinRaw;                 /**< Max/min current or power field the entry was derived from. */
+    uint16_t minVolt;                   /**< Minimum voltage in 50 mV units. */
+    uint16_t maxVolt;                   /**< Maximum voltage in 50 mV units. */
+    uint16_t opCurPwr;                  /**< Operating current in 10 mA units or power in 250 mW units. */
+    uint16_t maxMinCurPwr;              /**< Max/min current in 10 mA units or power in 250 mW units. */
+    uint8_t supplyType;                 /**< Supply type of the sink PDO. */
+    bool avs;                           /**< Sink PDO is an EPR AVS APDO. */
+    bool giveBack;                      /**< GiveBack flag to be set in the request. */
+} cy_stc_app_snk_constraint_t;
+
+/**
+ * @brief Contract resulting from matching a source PDO against a sink constraint.
+ */
+typedef struct
+{
+    uint32_t contractVolt;              /**< Contract voltage in 50 mV units. */
+    uint32_t contractPower;             /**< Contract power in 250 mW units. */
+    uint32_t operCurPwr;                /**< Operating current in 10 mA units or power in 250 mW units. */
+    uint32_t maxMinCurPwr;              /**< Max/min current in 10 mA units or power in 250 mW units. */
+} cy_stc_app_pdo_contract_t;
+
+/**
+ * @brief Cached result of a source capability evaluation. The entry is looked up
+ * using a hash of the source PDOs and confirmed against the stored copy.
+ */
+typedef struct
+{
+    uint32_t hash;                              /**< Hash of the source PDOs. */
+    uint32_t srcPdo[CY_APP_PDO_MAX_SRC_PDO];    /**< Source PDOs the result was derived from. */
+    cy_stc_app_pdo_contract_t contract;         /**< Selected contract. */
+    uint8_t srcLen;                             /**< Number of source PDOs. */
+    uint8_t snkLen;                             /**< Number of sink PDOs the source PDOs were matched against. */
+    uint8_t flags;                              /**< Message and EPR mode state the result is valid for. */
+    uint8_t pdoNo;                              /**< Object position to be requested. */
+    bool capMismatch;                           /**< Capability mismatch to be indicated in the request. */
+    bool giveBack;                              /**< GiveBack flag to be set in the request. */
+    bool valid;                                 /**< Entry holds a valid result. */
+} cy_stc_app_pdo_cache_entry_t;
+
+/**
+ * @brief Score function of a source PDO selection policy. The candidate with the
+ * highest score is requested.
+ *
+ * @param context Pointer to the PDStack context
+ * @param pdoSrc Source PDO being evaluated
+ * @param contract Contract that results from the source PDO
+ * @param score Score of the candidate; higher is better
+ *
+ * @return true if the candidate takes part in the selection; false otherwise.
+ */
+typedef bool (*cy_app_pdo_score_cbk_t)(cy_stc_pdstack_context_t *context, const cy_pd_pd_do_t *pdoSrc,
+        const cy_stc_app_pdo_contract_t *contract, uint32_t *score);
+
+/**
+ * @brief Source PDO selection policy. Candidates with equal score are ordered by
+ * the tie-breaker score, and then by their position: the later sink PDO, followed
+ * by the later source PDO, is preferred.
+ */
+typedef struct
+{
+    cy_app_pdo_score_cbk_t score;       /**< Primary score function. Must not be NULL. */
+    cy_app_pdo_score_cbk_t tieBreak;    /**< Tie-breaker score function. Can be NULL. Its return value is ignored. */
+} cy_stc_app_pdo_policy_t;
+
+/**
+ * @brief Accept limits of one source PDO, in the units of the request data object.
+ */
+typedef struct
+{
+    uint32_t pdo;                       /**< Source PDO the limits were derived from. */
+    uint16_t maxCurPwr;                 /**< Maximum current (10 mA or 50 mA for PPS) or power (250 mW). */
+    uint16_t minVolt;                   /**< Minimum PPS output voltage in 20 mV units. */
+    uint16_t maxVolt;                   /**< Maximum PPS output voltage in 20 mV units. */
+    uint8_t check;                      /**< Check to be applied, of type cy_en_app_rdo_check_t. */
+} cy_stc_app_rdo_limit_t;
+
+/**
+ * @brief Accept limits of the source PDOs advertised on a port, indexed by object position - 1.
+ */
+typedef struct
+{
+    cy_stc_app_rdo_limit_t limit[CY_PD_MAX_NO_OF_PDO];  /**< Limits of each source PDO. */
+    uint8_t count;                      /**< Number of source PDOs the table was built for. */
+    uint8_t mask;                       /**< Mask of enabled source PDOs the table was built for. */
+} cy_stc_app_rdo_limit_table_t;
+
+/** \} group_pmg_app_common_pdo_data_structures */
+
 /**
 * \addtogroup group_pmg_app_common_pdo_functions
 * \{
@@ -96,6 +281,11 @@ void Cy_App_Pdo_EvalSrcCap(cy_stc_pdstack_context_t* context, const cy_stc_pdsta
  * decide whether it should be satisfied. The response to the request should
  * be passed back to the stack through the app_resp_handler() callback.
  *
+ * When CY_APP_RDO_LIMIT_CACHE_ENABLE is set, requests for SPR fixed, variable,
+ * battery and PPS source PDOs are checked against limits which are derived once
+ * each time the source PDOs change. Requests which are not clearly valid or
+ * invalid, and all requests in EPR mode, are passed on to Cy_PdStack_Dpm_IsRdoValid.
+ *
  * @param context Pointer to the PDStack context
  * @param rdo The request data object received
  * @param app_resp_handler Application handler callback function
@@ -104,6 +294,78 @@ void Cy_App_Pdo_EvalSrcCap(cy_stc_pdstack_context_t* context, const cy_stc_pdsta
  */
 void Cy_App_Pdo_EvalRdo(cy_stc_pdstack_context_t* context, cy_pd_pd_do_t rdo, cy_pdstack_app_resp_cbk_t app_resp_handler) ;
 
+#if (!(CY_PD_SOURCE_ONLY))
+/**
+ * @brief Selects one of the built-in source PDO selection policies for the port.
+ * The policy is applied from the next source capability evaluation onwards.
+ *
+ * @param context Pointer to the PDStack context
+ * @param policy Built-in policy to be used
+ *
+ * @return CY_APP_STAT_SUCCESS if the policy was selected; CY_APP_STAT_BAD_PARAM
+ * if the policy is not a built-in one.
+ */
+cy_en_app_status_t Cy_App_Pdo_SetPolicy(cy_stc_pdstack_context_t *context, cy_en_app_pdo_policy_t policy);
+
+/**
+ * @brief Registers an application-specific source PDO selection policy for the port.
+ * The policy structure is not copied and must remain valid while it is in use.
+ * Source capabilities are always fully evaluated while an application policy is
+ * in use, as it may depend on other system state.
+ *
+ * @param context Pointer to the PDStack context
+ * @param policy Pointer to the policy
+ *
+ * @return CY_APP_STAT_SUCCESS if the policy was registered; CY_APP_STAT_BAD_PARAM
+ * if the policy does not provide a score function.
+ */
+cy_en_app_status_t Cy_App_Pdo_RegisterPolicy(cy_stc_pdstack_context_t *context, const cy_stc_app_pdo_policy_t *policy);
+
+/**
+ * @brief Returns the source PDO selection policy in use on the port.
+ *
+ * @param context Pointer to the PDStack context
+ *
+ * @return Policy in use.
+ */
+cy_en_app_pdo_policy_t Cy_App_Pdo_GetPolicy(cy_stc_pdstack_context_t *context);
+
+/**
+ * @brief Sets the input voltage which the system needs. The lowest loss and
+ * battery policies prefer the contract with the least headroom above this voltage.
+ * When a PPS APDO is selected, the output voltage is requested
+ * CY_APP_PPS_SNK_VOLT_HEADROOM above this voltage; if no target voltage is set,
+ * the lowest voltage supported by both partners is requested.
+ *
+ * @param context Pointer to the PDStack context
+ * @param volt Target voltage in 50 mV units
+ *
+ * @return None
+ */
+void Cy_App_Pdo_SetTargetVoltage(cy_stc_pdstack_context_t *context, uint16_t volt);
+
+/**
+ * @brief Updates the battery level used by the battery policy.
+ *
+ * @param context Pointer to the PDStack context
+ * @param level Battery level in percent
+ *
+ * @return None
+ */
+void Cy_App_Pdo_SetBatteryLevel(cy_stc_pdstack_context_t *context, uint8_t level);
+
+/**
+ * @brief Discards the cached source capability evaluation results of the port,
+ * so that the next source capabilities received are fully evaluated. Has no
+ * effect if CY_APP_PDO_EVAL_CACHE_ENABLE is not set.
+ *
+ * @param context Pointer to the PDStack context
+ *
+ * @return None
+ */
+void Cy_App_Pdo_ClearEvalCache(cy_stc_pdstack_context_t *context);
+#endif /* (!(CY_PD_SOURCE_ONLY)) */
+
 /** \} group_pmg_app_common_pdo_functions */
 
 #endif /* _CY_APP_PDO_H_ */
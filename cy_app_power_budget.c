@@ -0,0 +1,494 @@
+/***************************************************************************//**
+* \file cy_app_power_budget.c
+* \version 2.0
+*
+* \brief
+* Implements the power budget manager shared by the source ports of a
+* multi-port charger
+*
+********************************************************************************
+* \copyright
+* Copyright 2024, Cypress Semiconductor Corporation (an Infineon company)
+* or an affiliate of Cypress Semiconductor Corporation. All rights reserved.
+* You may use this file only in accordance with the license, terms, conditions,
+* disclaimers, and limitations in the end user license agreement accompanying
+* the software package with which this file was provided.
+*******************************************************************************/
+
+#include "cybsp.h"
+#include "cy_app_config.h"
+#include "cy_app_power_budget.h"
+#include "cy_app_timer_id.h"
+
+#include "cy_pdstack_dpm.h"
+#include "cy_pdutils.h"
+#include "cy_pdutils_sw_timer.h"
+
+#if CY_APP_POWER_BUDGET_ENABLE
+
+/* Budget state of each port */
+static cy_stc_app_pwr_budget_port_t glAppPwrBudgetPort[NO_OF_TYPEC_PORTS];
+
+/* Adapter power shared by all ports in watts */
+static uint16_t glAppPwrBudgetTotal;
+
+/* Power guaranteed to each port in watts */
+static uint16_t glAppPwrBudgetMin;
+
+/* The settle delay has expired and the budget has to be rebalanced */
+static volatile bool glAppPwrBudgetRebalance = false;
+
+/* Power of a source PDO in watts */
+static uint16_t pwr_budget_pdo_power(cy_pd_pd_do_t pdo)
+{
+    uint32_t power_mw = 0u;
+
+    switch (pdo.fixed_src.supplyType)
+    {
+        case CY_PDSTACK_PDO_FIXED_SUPPLY:
+            power_mw = ((uint32_t)pdo.fixed_src.voltage * pdo.fixed_src.maxCurrent) / 2u;
+            break;
+
+        case CY_PDSTACK_PDO_VARIABLE_SUPPLY:
+            power_mw = ((uint32_t)pdo.var_src.maxVoltage * pdo.var_src.maxCurrent) / 2u;
+            break;
+
+        case CY_PDSTACK_PDO_BATTERY:
+            power_mw = (uint32_t)pdo.bat_src.maxPower * 250u;
+            break;
+
+        case CY_PDSTACK_PDO_AUGMENTED:
+            if (pdo.pps_src.apdoType == CY_PDSTACK_APDO_PPS)
+            {
+                power_mw = (uint32_t)pdo.pps_src.maxVolt * pdo.pps_src.maxCur * 5u;
+            }
+            break;
+
+        default:
+            /* Nothing to do */
+            break;
+    }
+
+    return (uint16_t)(power_mw / 1000u);
+}
+
+/* Power of the active contract of a source port in watts */
+static uint16_t pwr_budget_contract_power(cy_stc_pdstack_context_t *ptrPdStackContext)
+{
+    const cy_stc_pdstack_dpm_status_t *dpm_stat = &ptrPdStackContext->dpmStat;
+    cy_pd_pd_do_t pdo = dpm_stat->srcSelPdo;
+    cy_pd_pd_do_t rdo = dpm_stat->srcRdo;
+    uint32_t cur_pwr = rdo.rdo_gen.opPowerCur;
+    uint32_t power_mw = 0u;
+
+    if ((!ptrPdStackContext->dpmConfig.contractExist) ||
+            (ptrPdStackContext->dpmConfig.curPortRole != CY_PD_PRT_ROLE_SOURCE))
+    {
+        return 0u;
+    }
+
+    /* Budget for the maximum operating current or power unless the sink supports GiveBack */
+    if ((!rdo.rdo_gen.giveBackFlag) && (rdo.rdo_gen.minMaxPowerCur > cur_pwr))
+    {
+        cur_pwr = rdo.rdo_gen.minMaxPowerCur;
+    }
+
+    switch (pdo.fixed_src.supplyType)
+    {
+        case CY_PDSTACK_PDO_FIXED_SUPPLY:
+            power_mw = ((uint32_t)pdo.fixed_src.voltage * cur_pwr) / 2u;
+            break;
+
+        case CY_PDSTACK_PDO_VARIABLE_SUPPLY:
+            power_mw = ((uint32_t)pdo.var_src.maxVoltage * cur_pwr) / 2u;
+            break;
+
+        case CY_PDSTACK_PDO_BATTERY:
+            power_mw = cur_pwr * 250u;
+            break;
+
+        case CY_PDSTACK_PDO_AUGMENTED:
+            power_mw = (uint32_t)rdo.rdo_pps.outVolt * rdo.rdo_pps.opCur;
+            break;
+
+        default:
+            /* Nothing to do */
+            break;
+    }
+
+    return (uint16_t)((power_mw + 999u) / 1000u);
+}
+
+static void pwr_budget_timer_cb(cy_timer_id_t id, void *context)
+{
+    (void)id;
+    (void)context;
+
+    glAppPwrBudgetRebalance = true;
+}
+
+/* Restarts the settle delay, so that a burst of events results in a single rebalance */
+static void pwr_budget_schedule(cy_stc_pdstack_context_t *ptrPdStackContext)
+{
+    Cy_PdUtils_SwTimer_Start(ptrPdStackContext->ptrTimerContext, ptrPdStackContext,
+            CY_APP_GET_TIMER_ID(ptrPdStackContext, CY_APP_PWR_BUDGET_TIMER),
+            CY_APP_PWR_BUDGET_SETTLE_DELAY, pwr_budget_timer_cb);
+}
+
+/* Computes the allocation of each port */
+static void pwr_budget_compute(void)
+{
+    cy_stc_app_pwr_budget_port_t *port_p = glAppPwrBudgetPort;
+    uint16_t remaining = glAppPwrBudgetTotal;
+    uint16_t sum = 0u;
+    uint16_t extra;
+    uint8_t served = 0u;
+    uint8_t best;
+    uint8_t idx;
+
+    /* Every port gets the guaranteed power */
+    for (idx = 0u; idx < NO_OF_TYPEC_PORTS; idx++)
+    {
+        if (port_p[idx].ptrPdStackContext != NULL)
+        {
+            port_p[idx].targetPower = CY_PDUTILS_GET_MIN(glAppPwrBudgetMin, port_p[idx].limitPower);
+            remaining -= port_p[idx].targetPower;
+        }
+    }
+
+    /*
+     * The rest goes to ports with contracts, highest contract power first, then to attached
+     * ports without a contract and last to the detached ports
+     */
+    do
+    {
+        best = NO_OF_TYPEC_PORTS;
+        for (idx = 0u; idx < NO_OF_TYPEC_PORTS; idx++)
+        {
+            if ((port_p[idx].ptrPdStackContext != NULL) && ((served & (1u << idx)) == 0u) &&
+                    ((best == NO_OF_TYPEC_PORTS) || (port_p[idx].contractPower > port_p[best].contractPower) ||
+                     ((port_p[idx].contractPower == port_p[best].contractPower) &&
+                      (port_p[idx].attached) && (!port_p[best].attached))))
+            {
+                best = idx;
+            }
+        }
+
+        if (best != NO_OF_TYPEC_PORTS)
+        {
+            served |= (uint8_t)(1u << best);
+            extra = CY_PDUTILS_GET_MIN(remaining, port_p[best].limitPower - port_p[best].targetPower);
+            port_p[best].targetPower += extra;
+            remaining -= extra;
+        }
+    } while (best != NO_OF_TYPEC_PORTS);
+
+    /* Small changes are not published while the budget allows the current allocation to be kept */
+    for (idx = 0u; idx < NO_OF_TYPEC_PORTS; idx++)
+    {
+        sum += port_p[idx].targetPower;
+    }
+
+    for (idx = 0u; idx < NO_OF_TYPEC_PORTS; idx++)
+    {
+        if ((port_p[idx].ptrPdStackContext != NULL) && (port_p[idx].targetPower != port_p[idx].allocPower) &&
+                (port_p[idx].allocPower <= port_p[idx].limitPower) &&
+                (port_p[idx].targetPower + CY_APP_PWR_BUDGET_HYSTERESIS > port_p[idx].allocPower) &&
+                (port_p[idx].allocPower + CY_APP_PWR_BUDGET_HYSTERESIS > port_p[idx].targetPower) &&
+                ((sum - port_p[idx].targetPower + port_p[idx].allocPower) <= glAppPwrBudgetTotal))
+        {
+            sum = sum - port_p[idx].targetPower + port_p[idx].allocPower;
+            port_p[idx].targetPower = port_p[idx].allocPower;
+        }
+    }
+}
+
+/* Limits a source PDO to the allocation. Returns false if the PDO is not to be advertised. */
+static bool pwr_budget_scale_pdo(cy_pd_pd_do_t *pdo, uint16_t power, bool first)
+{
+    uint32_t cur;
+    bool keep = true;
+
+    switch (pdo->fixed_src.supplyType)
+    {
+        case CY_PDSTACK_PDO_FIXED_SUPPLY:
+            cur = CY_PDUTILS_GET_MIN(((uint32_t)power * 2000u) / pdo->fixed_src.voltage, pdo->fixed_src.maxCurrent);
+            pdo->fixed_src.maxCurrent = cur;
+            keep = (first || (cur >= CY_APP_PWR_BUDGET_MIN_CURRENT));
+            break;
+
+        case CY_PDSTACK_PDO_VARIABLE_SUPPLY:
+            cur = CY_PDUTILS_GET_MIN(((uint32_t)power * 2000u) / pdo->var_src.maxVoltage, pdo->var_src.maxCurrent);
+            pdo->var_src.maxCurrent = cur;
+            keep = (cur >= CY_APP_PWR_BUDGET_MIN_CURRENT);
+            break;
+
+        case CY_PDSTACK_PDO_BATTERY:
+            pdo->bat_src.maxPower = CY_PDUTILS_GET_MIN((uint32_t)power * 4u, pdo->bat_src.maxPower);
+            break;
+
+        case CY_PDSTACK_PDO_AUGMENTED:
+            if (pdo->pps_src.apdoType == CY_PDSTACK_APDO_PPS)
+            {
+                cur = CY_PDUTILS_GET_MIN(((uint32_t)power * 200u) / pdo->pps_src.maxVolt, pdo->pps_src.maxCur);
+                pdo->pps_src.maxCur = cur;
+                keep = ((cur * 5u) >= CY_APP_PWR_BUDGET_MIN_CURRENT);
+            }
+            else
+            {
+                /* Other APDOs cannot be scaled */
+                keep = false;
+            }
+            break;
+
+        default:
+            keep = false;
+            break;
+    }
+
+    return keep;
+}
+
+/* Advertises the source capabilities for the allocation of the port */
+static void pwr_budget_publish(cy_stc_app_pwr_budget_port_t *port_p)
+{
+    cy_stc_pdstack_context_t *ptrPdStackContext = port_p->ptrPdStackContext;
+    cy_pd_pd_do_t pdo[CY_PD_MAX_NO_OF_PDO];
+    uint8_t count = 0u;
+    uint8_t mask = 0u;
+    uint8_t idx;
+
+    for (idx = 0u; idx < port_p->baseCount; idx++)
+    {
+        pdo[count] = port_p->basePdo[idx];
+
+        /* The full capabilities are restored as they are */
+        if ((port_p->targetPower >= port_p->maxPower) ||
+                (pwr_budget_scale_pdo(&pdo[count], port_p->targetPower, (idx == 0u))))
+        {
+            if ((port_p->baseMask & (1u << idx)) != 0u)
+            {
+                mask |= (uint8_t)(1u << count);
+            }
+            count++;
+        }
+    }
+
+    (void)Cy_PdStack_Dpm_UpdateSrcCap(ptrPdStackContext, count, pdo);
+    (void)Cy_PdStack_Dpm_UpdateSrcCapMask(ptrPdStackContext, mask);
+
+    port_p->allocPower = port_p->targetPower;
+    port_p->capChangePending = ((ptrPdStackContext->dpmConfig.contractExist) &&
+            (ptrPdStackContext->dpmConfig.curPortRole == CY_PD_PRT_ROLE_SOURCE));
+}
+
+cy_en_app_status_t Cy_App_PowerBudget_Init(uint16_t totalPower, uint16_t minPortPower)
+{
+    uint8_t idx;
+
+    if (((uint32_t)minPortPower * NO_OF_TYPEC_PORTS) > totalPower)
+    {
+        return CY_APP_STAT_BAD_PARAM;
+    }
+
+    for (idx = 0u; idx < NO_OF_TYPEC_PORTS; idx++)
+    {
+        glAppPwrBudgetPort[idx].ptrPdStackContext = NULL;
+    }
+
+    glAppPwrBudgetTotal = totalPower;
+    glAppPwrBudgetMin = minPortPower;
+    glAppPwrBudgetRebalance = false;
+
+    return CY_APP_STAT_SUCCESS;
+}
+
+cy_en_app_status_t Cy_App_PowerBudget_AddPort(cy_stc_pdstack_context_t *ptrPdStackContext)
+{
+    cy_stc_app_pwr_budget_port_t *port_p = &glAppPwrBudgetPort[ptrPdStackContext->port];
+    const cy_stc_pdstack_dpm_status_t *dpm_stat = &ptrPdStackContext->dpmStat;
+    uint16_t power;
+    uint8_t idx;
+
+    if ((dpm_stat->srcPdoCount == 0u) || (dpm_stat->srcPdoCount > CY_PD_MAX_NO_OF_PDO))
+    {
+        return CY_APP_STAT_BAD_PARAM;
+    }
+
+    port_p->baseCount = dpm_stat->srcPdoCount;
+    port_p->baseMask = dpm_stat->srcPdoMask;
+    port_p->maxPower = 0u;
+
+    for (idx = 0u; idx < port_p->baseCount; idx++)
+    {
+        port_p->basePdo[idx] = dpm_stat->curSrcPdo[idx];
+        power = pwr_budget_pdo_power(dpm_stat->curSrcPdo[idx]);
+        if (((port_p->baseMask & (1u << idx)) != 0u) && (power > port_p->maxPower))
+        {
+            port_p->maxPower = power;
+        }
+    }
+
+    port_p->limitPower = port_p->maxPower;
+    port_p->allocPower = port_p->maxPower;
+    port_p->targetPower = port_p->maxPower;
+    port_p->contractPower = pwr_budget_contract_power(ptrPdStackContext);
+    port_p->attached = (ptrPdStackContext->dpmConfig.attach);
+    port_p->capChangePending = false;
+    port_p->ptrPdStackContext = ptrPdStackContext;
+
+    /* Bring the advertised capabilities within the budget */
+    pwr_budget_schedule(ptrPdStackContext);
+
+    return CY_APP_STAT_SUCCESS;
+}
+
+void Cy_App_PowerBudget_EventHandler(cy_stc_pdstack_context_t *ptrPdStackContext, cy_en_pdstack_app_evt_t evt)
+{
+    cy_stc_app_pwr_budget_port_t *port_p = &glAppPwrBudgetPort[ptrPdStackContext->port];
+
+    if (port_p->ptrPdStackContext == NULL)
+    {
+        return;
+    }
+
+    switch (evt)
+    {
+        case APP_EVT_TYPEC_ATTACH:
+            port_p->attached = true;
+            pwr_budget_schedule(ptrPdStackContext);
+            break;
+
+        case APP_EVT_DISCONNECT:
+        case APP_EVT_TYPE_C_ERROR_RECOVERY:
+            port_p->attached = false;
+            port_p->contractPower = 0u;
+            port_p->capChangePending = false;
+            pwr_budget_schedule(ptrPdStackContext);
+            break;
+
+        case APP_EVT_HARD_RESET_RCVD:
+        case APP_EVT_HARD_RESET_SENT:
+        case APP_EVT_PR_SWAP_COMPLETE:
+            port_p->contractPower = 0u;
+            pwr_budget_schedule(ptrPdStackContext);
+            break;
+
+        case APP_EVT_PD_CONTRACT_NEGOTIATION_COMPLETE:
+            port_p->contractPower = pwr_budget_contract_power(ptrPdStackContext);
+            port_p->capChangePending = false;
+            pwr_budget_schedule(ptrPdStackContext);
+            break;
+
+        default:
+            /* Nothing to do */
+            break;
+    }
+}
+
+void Cy_App_PowerBudget_Task(cy_stc_pdstack_context_t *ptrPdStackContext)
+{
+    cy_stc_app_pwr_budget_port_t *port_p = &glAppPwrBudgetPort[ptrPdStackContext->port];
+    uint16_t committed;
+    uint8_t idx;
+    uint8_t other;
+
+    /* Send capability changes which the stack could not take earlier */
+    if ((port_p->capChangePending) && (Cy_PdStack_Dpm_SendPdCommand(ptrPdStackContext,
+                    CY_PDSTACK_DPM_CMD_SRC_CAP_CHNG, NULL, false, NULL) == CY_PDSTACK_STAT_SUCCESS))
+    {
+        port_p->capChangePending = false;
+    }
+
+    if (!glAppPwrBudgetRebalance)
+    {
+        return;
+    }
+
+    glAppPwrBudgetRebalance = false;
+    port_p = glAppPwrBudgetPort;
+    pwr_budget_compute();
+
+    /* Publish reductions first to release power */
+    for (idx = 0u; idx < NO_OF_TYPEC_PORTS; idx++)
+    {
+        if ((port_p[idx].ptrPdStackContext != NULL) && (port_p[idx].targetPower < port_p[idx].allocPower))
+        {
+            pwr_budget_publish(&port_p[idx]);
+        }
+    }
+
+    /*
+     * A port is only raised once the power has actually been released: other ports count with
+     * their allocation, or with their contract if it has not yet been renegotiated below the allocation.
+     */
+    for (idx = 0u; idx < NO_OF_TYPEC_PORTS; idx++)
+    {
+        if ((port_p[idx].ptrPdStackContext == NULL) || (port_p[idx].targetPower <= port_p[idx].allocPower))
+        {
+            continue;
+        }
+
+        committed = port_p[idx].targetPower;
+        for (other = 0u; other < NO_OF_TYPEC_PORTS; other++)
+        {
+            if ((other != idx) && (port_p[other].ptrPdStackContext != NULL))
+            {
+                committed += CY_PDUTILS_GET_MAX(port_p[other].allocPower, port_p[other].contractPower);
+            }
+        }
+
+        /* Otherwise, the next contract event of the other ports triggers another attempt */
+        if (committed <= glAppPwrBudgetTotal)
+        {
+            pwr_budget_publish(&port_p[idx]);
+        }
+    }
+}
+
+cy_en_app_status_t Cy_App_PowerBudget_SetPortLimit(cy_stc_pdstack_context_t *ptrPdStackContext, uint8_t percent)
+{
+    cy_stc_app_pwr_budget_port_t *port_p = &glAppPwrBudgetPort[ptrPdStackContext->port];
+
+    if (port_p->ptrPdStackContext == NULL)
+    {
+        return CY_APP_STAT_NOT_SUPPORTED;
+    }
+
+    if ((percent == 0u) || (percent > 100u))
+    {
+        return CY_APP_STAT_BAD_PARAM;
+    }
+
+    port_p->limitPower = (uint16_t)(((uint32_t)port_p->maxPower * percent) / 100u);
+    pwr_budget_schedule(ptrPdStackContext);
+
+    return CY_APP_STAT_SUCCESS;
+}
+
+uint16_t Cy_App_PowerBudget_GetAllocation(cy_stc_pdstack_context_t *ptrPdStackContext)
+{
+    const cy_stc_app_pwr_budget_port_t *port_p = &glAppPwrBudgetPort[ptrPdStackContext->port];
+
+    return (port_p->ptrPdStackContext == NULL) ? 0u : port_p->allocPower;
+}
+
+uint16_t Cy_App_PowerBudget_GetUsedPower(void)
+{
+    uint16_t used = 0u;
+    uint8_t idx;
+
+    for (idx = 0u; idx < NO_OF_TYPEC_PORTS; idx++)
+    {
+        if (glAppPwrBudgetPort[idx].ptrPdStackContext != NULL)
+        {
+            used += glAppPwrBudgetPort[idx].contractPower;
+        }
+    }
+
+    return used;
+}
+
+#endif /* CY_APP_POWER_BUDGET_ENABLE */
+
+/* [] End of file */
@@ -0,0 +1,210 @@
+/***************************************************************************//**
+* \file cy_app_power_budget.h
+* \version 2.0
+*
+* \brief
+* Defines the data structures and function prototypes of the power budget
+* manager shared by the source ports of a multi-port charger.
+*
+********************************************************************************
+* \copyright
+* Copyright 2024, Cypress Semiconductor Corporation (an Infineon company)
+* or an affiliate of Cypress Semiconductor Corporation. All rights reserved.
+* You may use this file only in accordance with the license, terms, conditions,
+* disclaimers, and limitations in the end user license agreement accompanying
+* the software package with which this file was provided.
+*******************************************************************************/
+
+#ifndef _CY_APP_POWER_BUDGET_H_
+#define _CY_APP_POWER_BUDGET_H_
+
+/*******************************************************************************
+ * Header files including
+ ******************************************************************************/
+#include <stdint.h>
+#include <stdbool.h>
+#include "cy_pdstack_common.h"
+#include "cy_app_status.h"
+
+#if (CY_APP_POWER_BUDGET_ENABLE || DOXYGEN)
+
+/**
+* \addtogroup group_pmg_app_common_power_budget
+* \{
+* The power budget manager owns the total adapter power of a multi-port
+* charger and divides it between the source ports. Every port is guaranteed a
+* minimum allocation, so that a newly attached sink is served at once. The rest
+* of the budget goes to ports with active contracts, highest contract power
+* first, then to attached ports without a contract, up to the power of the
+* full source capabilities of each port.
+*
+* Allocations are recomputed on attach, detach and contract events, after a
+* settle delay which batches bursts of events. The source capabilities of a
+* port are republished only if its allocation changes by more than
+* CY_APP_PWR_BUDGET_HYSTERESIS. Reductions are published first; a port is only
+* raised once the power it needs has been released by the other ports.
+*
+* Only the SPR source PDOs are managed. EPR source capabilities are not
+* changed by the budget manager.
+*
+* A port can additionally be limited to a percentage of its full power with
+* Cy_App_PowerBudget_SetPortLimit, as done by the thermal derating controller.
+* The allocation of the port never exceeds the limit, and the power the port
+* cannot take is given to the other ports. The budget manager remains the only
+* module which publishes the source capabilities of its ports.
+*
+* <b>Usage:</b>
+* 1. Call Cy_App_PowerBudget_Init with the adapter power.
+* 2. Call Cy_App_PowerBudget_AddPort for each source port once the PD stack
+* has been initialized. The source capabilities held by the stack at this
+* point are the capabilities of the port at full power.
+* 3. Cy_App_EventHandler passes PD events to the manager, and Cy_App_Task runs
+* Cy_App_PowerBudget_Task.
+*
+* \defgroup group_pmg_app_common_power_budget_macros Macros
+* \defgroup group_pmg_app_common_power_budget_data_structures Data structures
+* \defgroup group_pmg_app_common_power_budget_functions Functions
+*/
+/** \} group_pmg_app_common_power_budget */
+
+/*****************************************************************************
+ * Macros
+ *****************************************************************************/
+/**
+* \addtogroup group_pmg_app_common_power_budget_macros
+* \{
+*/
+
+#ifndef CY_APP_PWR_BUDGET_SETTLE_DELAY
+/** Delay in ms from an attach, detach or contract event to the rebalancing of the budget. */
+#define CY_APP_PWR_BUDGET_SETTLE_DELAY          (500u)
+#endif /* CY_APP_PWR_BUDGET_SETTLE_DELAY */
+
+#ifndef CY_APP_PWR_BUDGET_HYSTERESIS
+/** Allocation changes in watts below this value are not published to the port partner. */
+#define CY_APP_PWR_BUDGET_HYSTERESIS            (3u)
+#endif /* CY_APP_PWR_BUDGET_HYSTERESIS */
+
+#ifndef CY_APP_PWR_BUDGET_MIN_CURRENT
+/** PDOs other than vSafe5V which would offer less than this current (10 mA units) are not advertised. */
+#define CY_APP_PWR_BUDGET_MIN_CURRENT           (50u)
+#endif /* CY_APP_PWR_BUDGET_MIN_CURRENT */
+
+/** \} group_pmg_app_common_power_budget_macros */
+
+/*****************************************************************************
+ * Data Struct Definition
+ *****************************************************************************/
+/**
+* \addtogroup group_pmg_app_common_power_budget_data_structures
+* \{
+*/
+
+/**
+ * @brief Budget state of one source port
+ */
+typedef struct
+{
+    cy_stc_pdstack_context_t *ptrPdStackContext;    /**< PDStack context; NULL if the port is not managed. */
+    cy_pd_pd_do_t basePdo[CY_PD_MAX_NO_OF_PDO];     /**< Source PDOs of the port at full power. */
+    uint8_t baseCount;                  /**< Number of source PDOs at full power. */
+    uint8_t baseMask;                   /**< Mask of enabled source PDOs at full power. */
+    uint16_t maxPower;                  /**< Power of the full source capabilities in watts. */
+    uint16_t limitPower;                /**< Power the port is limited to in watts; maxPower if it is not limited. */
+    uint16_t allocPower;                /**< Allocation published to the port in watts. */
+    uint16_t targetPower;               /**< Allocation computed for the port in watts. */
+    uint16_t contractPower;             /**< Power of the active contract in watts; 0 if there is none. */
+    bool attached;                      /**< A port partner is attached. */
+    bool capChangePending;              /**< Changed source capabilities still have to be sent to the partner. */
+} cy_stc_app_pwr_budget_port_t;
+
+/** \} group_pmg_app_common_power_budget_data_structures */
+
+/*****************************************************************************
+ * Global Function Declaration
+ *****************************************************************************/
+/**
+* \addtogroup group_pmg_app_common_power_budget_functions
+* \{
+*/
+
+/**
+ * @brief Initializes the power budget manager.
+ *
+ * @param totalPower Adapter power shared by all ports in watts
+ * @param minPortPower Power guaranteed to each port in watts
+ *
+ * @return CY_APP_STAT_SUCCESS if the budget manager is initialized;
+ * CY_APP_STAT_BAD_PARAM if the guaranteed power of all ports exceeds the total.
+ */
+cy_en_app_status_t Cy_App_PowerBudget_Init(uint16_t totalPower, uint16_t minPortPower);
+
+/**
+ * @brief Places a source port under the control of the budget manager. The
+ * source capabilities currently held by the stack are taken as the
+ * capabilities of the port at full power.
+ *
+ * @param ptrPdStackContext Pointer to the PDStack context
+ *
+ * @return CY_APP_STAT_SUCCESS if the port is added; CY_APP_STAT_BAD_PARAM if
+ * the port has no source capabilities.
+ */
+cy_en_app_status_t Cy_App_PowerBudget_AddPort(cy_stc_pdstack_context_t *ptrPdStackContext);
+
+/**
+ * @brief Updates the budget state of the port from a PD event. Called from
+ * Cy_App_EventHandler.
+ *
+ * @param ptrPdStackContext Pointer to the PDStack context
+ * @param evt Event that is being notified
+ *
+ * @return None
+ */
+void Cy_App_PowerBudget_EventHandler(cy_stc_pdstack_context_t *ptrPdStackContext, cy_en_pdstack_app_evt_t evt);
+
+/**
+ * @brief Rebalances the budget and publishes changed source capabilities. Called
+ * from Cy_App_Task.
+ *
+ * @param ptrPdStackContext Pointer to the PDStack context of the calling port
+ *
+ * @return None
+ */
+void Cy_App_PowerBudget_Task(cy_stc_pdstack_context_t *ptrPdStackContext);
+
+/**
+ * @brief Limits the allocation of a managed port to a percentage of its full
+ * power. The budget is rebalanced after the settle delay.
+ *
+ * @param ptrPdStackContext Pointer to the PDStack context
+ * @param percent Percentage of the full power; 100 removes the limit
+ *
+ * @return CY_APP_STAT_SUCCESS if the limit is set; CY_APP_STAT_BAD_PARAM if
+ * the percentage is out of range; CY_APP_STAT_NOT_SUPPORTED if the port is not
+ * managed.
+ */
+cy_en_app_status_t Cy_App_PowerBudget_SetPortLimit(cy_stc_pdstack_context_t *ptrPdStackContext, uint8_t percent);
+
+/**
+ * @brief Returns the power currently allocated to the port.
+ *
+ * @param ptrPdStackContext Pointer to the PDStack context
+ *
+ * @return Allocation in watts; 0 if the port is not managed.
+ */
+uint16_t Cy_App_PowerBudget_GetAllocation(cy_stc_pdstack_context_t *ptrPdStackContext);
+
+/**
+ * @brief Returns the power of all active contracts on the managed ports.
+ *
+ * @return Contracted power in watts.
+ */
+uint16_t Cy_App_PowerBudget_GetUsedPower(void);
+
+/** \} group_pmg_app_common_power_budget_functions */
+
+#endif /* (CY_APP_POWER_BUDGET_ENABLE || DOXYGEN) */
+
+#endif /* _CY_APP_POWER_BUDGET_H_ */
+
+/* [] END OF FILE */
@@ -24,6 +24,27 @@
 #include "cy_pdstack_timer_id.h"
 #include "cy_usbpd_vbus_ctrl.h"
 #include "cy_app_fault_handlers.h"
+#if CY_APP_ADC_SCHED_ENABLE
+#include "cy_app_adc_sched.h"
+#endif /* CY_APP_ADC_SCHED_ENABLE */
+
+/*
+ * UVP trips are only confirmed where the comparator does not turn the consumer
+ * FET off in hardware. OVP trips are always handled at once.
+ */
+#if (CY_APP_SNK_FAULT_CONFIRM_ENABLE && VBUS_UVP_ENABLE && (!defined(CY_DEVICE_CCG3PA)))
+#define SNK_UVP_CONFIRM_ENABLE                  (1u)
+#else
+#define SNK_UVP_CONFIRM_ENABLE                  (0u)
+#endif /* (CY_APP_SNK_FAULT_CONFIRM_ENABLE && VBUS_UVP_ENABLE && (!defined(CY_DEVICE_CCG3PA))) */
+
+#if SNK_UVP_CONFIRM_ENABLE
+#include "cy_app_coroutine.h"
+
+#if ((CY_APP_SNK_FAULT_CONFIRM_MIN == 0u) || (CY_APP_SNK_FAULT_CONFIRM_MIN > CY_APP_SNK_FAULT_CONFIRM_SAMPLES))
+#error "CY_APP_SNK_FAULT_CONFIRM_MIN must be between 1 and CY_APP_SNK_FAULT_CONFIRM_SAMPLES."
+#endif
+#endif /* SNK_UVP_CONFIRM_ENABLE */
 
 #if CY_HPI_ENABLED
 #include "cy_hpi.h"
@@ -152,6 +173,87 @@ void sink_fet_on(cy_stc_pdstack_context_t * context)
     soln_sink_fet_on (context);
 }
 
+#if CY_APP_SNK_FAULT_CONFIRM_ENABLE
+/* Trip confirmation statistics of each port */
+static cy_stc_app_snk_fault_confirm_stats_t glAppSnkFaultConfirm[NO_OF_TYPEC_PORTS];
+
+const cy_stc_app_snk_fault_confirm_stats_t* Cy_App_Sink_GetFaultConfirmStats(cy_stc_pdstack_context_t *context)
+{
+    return &glAppSnkFaultConfirm[context->port];
+}
+#endif /* CY_APP_SNK_FAULT_CONFIRM_ENABLE */
+
+#if SNK_UVP_CONFIRM_ENABLE
+/* Number of samples taken and of samples below the UVP limit since the trip */
+static uint8_t glAppSnkUvpSamples[NO_OF_TYPEC_PORTS];
+static uint8_t glAppSnkUvpBeyond[NO_OF_TYPEC_PORTS];
+
+bool app_psnk_vbus_uvp_cbk (void * context, bool comp_out);
+static void psnk_uvp_fault(cy_stc_pdstack_context_t *pdstack_ctx);
+
+/* Check whether the samples taken so far decide the trip */
+static bool psnk_uvp_decided(uint8_t port)
+{
+    return ((glAppSnkUvpBeyond[port] >= CY_APP_SNK_FAULT_CONFIRM_MIN) ||
+            ((glAppSnkUvpSamples[port] - glAppSnkUvpBeyond[port]) >
+             (CY_APP_SNK_FAULT_CONFIRM_SAMPLES - CY_APP_SNK_FAULT_CONFIRM_MIN)));
+}
+
+/*
+ * Samples VBUS once per CY_APP_SNK_FAULT_CONFIRM_INTERVAL ms after a UVP trip.
+ * The trip is handled as a fault if CY_APP_SNK_FAULT_CONFIRM_MIN samples are
+ * below the limit; otherwise the comparator is enabled again.
+ */
+static cy_en_app_coro_status_t psnk_uvp_confirm(cy_stc_pdstack_context_t *context, cy_stc_app_coro_t *coro)
+{
+    uint8_t port = context->port;
+    uint16_t volt = Cy_App_GetStatus(port)->psnk_volt;
+    uint16_t limit = volt - (uint16_t)(((uint32_t)volt *
+                context->ptrUsbPdContext->usbpdConfig->vbusUvpConfig->threshold) / 100u);
+
+    CY_APP_CORO_BEGIN(coro);
+
+    glAppSnkUvpSamples[port] = 0u;
+    glAppSnkUvpBeyond[port] = 0u;
+
+    while (!psnk_uvp_decided(port))
+    {
+#if CY_APP_ADC_SCHED_ENABLE
+        /* The ADC reference may be switched for a scheduled measurement; trust the comparator */
+        if (Cy_App_AdcSched_IsBusy(context))
+        {
+            glAppSnkUvpBeyond[port] = CY_APP_SNK_FAULT_CONFIRM_MIN;
+            break;
+        }
+#endif /* CY_APP_ADC_SCHED_ENABLE */
+
+        glAppSnkUvpSamples[port]++;
+        if (Cy_App_VbusGetValue(context) <= limit)
+        {
+            glAppSnkUvpBeyond[port]++;
+        }
+
+        if (!psnk_uvp_decided(port))
+        {
+            CY_APP_CORO_WAIT_MS(coro, CY_APP_SNK_FAULT_CONFIRM_INTERVAL);
+        }
+    }
+
+    if (glAppSnkUvpBeyond[port] >= CY_APP_SNK_FAULT_CONFIRM_MIN)
+    {
+        glAppSnkFaultConfirm[port].uvpConfirmed++;
+        psnk_uvp_fault(context);
+    }
+    else
+    {
+        glAppSnkFaultConfirm[port].uvpRejected++;
+        Cy_App_Fault_UvpEnable(context, volt, false, app_psnk_vbus_uvp_cbk);
+    }
+
+    CY_APP_CORO_END(coro);
+}
+#endif /* SNK_UVP_CONFIRM_ENABLE */
+
 #if VBUS_OVP_ENABLE
 bool app_psnk_vbus_ovp_cbk(void * cbkContext, bool comp_out)
 {
@@ -188,12 +290,8 @@ static void app_psnk_vbus_uvp_tmr_cbk(cy_timer_id_t id,  void *context)
 }
 #endif /* CY_APP_DEFER_SNK_VBUS_UVP_HANDLING */
 
-bool app_psnk_vbus_uvp_cbk (void * context, bool comp_out)
+static void psnk_uvp_fault(cy_stc_pdstack_context_t *pdstack_ctx)
 {
-    cy_stc_usbpd_context_t *ptrUsbPdContext = (cy_stc_usbpd_context_t *)context;
-    /* Get the PDStack context from the USB PD context */
-    cy_stc_pdstack_context_t * pdstack_ctx = Cy_PdStack_Dpm_GetContext(ptrUsbPdContext->port);
-
     /* UVP fault */
     sink_fet_off(pdstack_ctx);
 
@@ -205,6 +303,21 @@ bool app_psnk_vbus_uvp_cbk (void * context, bool comp_out)
     /* Notify the application layer about the fault */
     Cy_App_EventHandler(pdstack_ctx, APP_EVT_VBUS_UVP_FAULT, NULL);
 #endif /* DEFER_VBUS_UVP_HANDLING */
+}
+
+bool app_psnk_vbus_uvp_cbk (void * context, bool comp_out)
+{
+    cy_stc_usbpd_context_t *ptrUsbPdContext = (cy_stc_usbpd_context_t *)context;
+    /* Get the PDStack context from the USB PD context */
+    cy_stc_pdstack_context_t * pdstack_ctx = Cy_PdStack_Dpm_GetContext(ptrUsbPdContext->port);
+
+#if SNK_UVP_CONFIRM_ENABLE
+    /* Leave the consumer path on and sample VBUS outside of the interrupt */
+    Cy_App_Coro_Start(pdstack_ctx, CY_APP_CORO_SNK_UVP_CONFIRM, psnk_uvp_confirm,
+            CY_APP_SNK_FAULT_CONFIRM_INTERVAL);
+#else
+    psnk_uvp_fault(pdstack_ctx);
+#endif /* SNK_UVP_CONFIRM_ENABLE */
 
     (void)comp_out;
 
@@ -310,6 +423,9 @@ static void app_psnk_tmr_cbk(cy_timer_id_t id,  void * callbackCtx)
     cy_stc_pdstack_context_t * context = callbackCtx;
     uint8_t port = context->port;
     cy_stc_app_status_t* app_stat = Cy_App_GetStatus(port);
+#if CY_APP_VBUS_DISCHARGE_CTRL_ENABLE
+    uint16_t period;
+#endif /* CY_APP_VBUS_DISCHARGE_CTRL_ENABLE */
 
     if (context->port != 0u)
     {
@@ -325,7 +441,12 @@ static void app_psnk_tmr_cbk(cy_timer_id_t id,  void * callbackCtx)
             break;
 
         case CY_APP_PSINK_DIS_MONITOR_TIMER:
+#if CY_APP_VBUS_DISCHARGE_CTRL_ENABLE
+            period = Cy_App_VbusDischargeCtrl_Poll(context, NULL);
+            if (period == 0u)
+#else
             if(Cy_App_VbusIsPresent(context, CY_PD_VSAFE_5V, 0) == false)
+#endif /* CY_APP_VBUS_DISCHARGE_CTRL_ENABLE */
             {
                 Cy_PdUtils_SwTimer_Stop(context->ptrTimerContext,
                         CY_APP_GET_TIMER_ID(context, CY_APP_PSINK_DIS_TIMER));
@@ -335,9 +456,15 @@ static void app_psnk_tmr_cbk(cy_timer_id_t id,  void * callbackCtx)
             else
             {
                 /*Start monitor timer again*/
+#if CY_APP_VBUS_DISCHARGE_CTRL_ENABLE
+                Cy_PdUtils_SwTimer_Start(context->ptrTimerContext, context,
+                        CY_APP_GET_TIMER_ID(context, CY_APP_PSINK_DIS_MONITOR_TIMER),
+                        period, app_psnk_tmr_cbk);
+#else
                 Cy_PdUtils_SwTimer_Start(context->ptrTimerContext, context,
                         CY_APP_GET_TIMER_ID(context, CY_APP_PSINK_DIS_MONITOR_TIMER),
                         CY_APP_PSINK_DIS_MONITOR_TIMER_PERIOD, app_psnk_tmr_cbk);
+#endif /* CY_APP_VBUS_DISCHARGE_CTRL_ENABLE */
             }
             break;
 
@@ -369,10 +496,16 @@ void Cy_App_Sink_Disable (cy_stc_pdstack_context_t * context, cy_pdstack_sink_di
     Cy_PdUtils_SwTimer_StopRange(context->ptrTimerContext,
             CY_APP_GET_TIMER_ID(context, CY_APP_PSINK_DIS_TIMER),
             CY_APP_GET_TIMER_ID(context, CY_APP_PSINK_VBUS_UVP_DEFER_TIMER));
+#if SNK_UVP_CONFIRM_ENABLE
+    Cy_App_Coro_Stop(context, CY_APP_CORO_SNK_UVP_CONFIRM);
+#endif /* SNK_UVP_CONFIRM_ENABLE */
 
     if ((snk_discharge_off_handler != NULL) && (context->dpmConfig.dpmEnabled))
     {
         Cy_USBPD_Vbus_DischargeOn(context->ptrUsbPdContext);
+#if CY_APP_VBUS_DISCHARGE_CTRL_ENABLE
+        Cy_App_VbusDischargeCtrl_Start(context, CY_PD_VSAFE_5V, 0, CY_APP_PSINK_DIS_MONITOR_TIMER_PERIOD);
+#endif /* CY_APP_VBUS_DISCHARGE_CTRL_ENABLE */
 
         app_stat->snk_dis_cbk = snk_discharge_off_handler;
 
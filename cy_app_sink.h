@@ -46,11 +46,36 @@
 * 3. Register the application callback to the PDStack middleware library.
 *    See the \ref section_pmg_app_common_quick_start section.
 *
+* When CY_APP_SNK_FAULT_CONFIRM_ENABLE is set, a UVP comparator trip is only
+* handled as a fault if VBUS samples taken from a coroutine after the trip
+* confirm it. The consumer path stays on while the samples are taken, and a
+* rejected trip re-enables the comparator. OVP trips are always handled at
+* once. Devices on which the UVP comparator turns the consumer FET off in
+* hardware (CCG3PA) do not confirm trips.
+*
+* \defgroup group_pmg_app_common_psnk_data_structures Data structures
 * \defgroup group_pmg_app_common_psnk_functions Functions
 */
 
 /** \} group_pmg_app_common_psnk */
 
+#if (CY_APP_SNK_FAULT_CONFIRM_ENABLE || DOXYGEN)
+/**
+* \addtogroup group_pmg_app_common_psnk_data_structures
+* \{
+*/
+
+/**
+ * @brief Sink UVP trip confirmation statistics of a port
+ */
+typedef struct
+{
+    uint16_t uvpConfirmed;              /**< Number of UVP trips confirmed by the VBUS samples. */
+    uint16_t uvpRejected;               /**< Number of UVP trips rejected by the VBUS samples. */
+} cy_stc_app_snk_fault_confirm_stats_t;
+
+/** \} group_pmg_app_common_psnk_data_structures */
+#endif /* (CY_APP_SNK_FAULT_CONFIRM_ENABLE || DOXYGEN) */
 
 /**
 * \addtogroup group_pmg_app_common_psnk_functions
@@ -121,6 +146,16 @@ void Cy_App_Sink_Disable (cy_stc_pdstack_context_t * context, cy_pdstack_sink_di
  */
 bool Cy_App_Sink_VbusCFetOnCtrl(cy_stc_pdstack_context_t *context, uint8_t *ctrl_p);
 
+#if (CY_APP_SNK_FAULT_CONFIRM_ENABLE || DOXYGEN)
+/**
+ * @brief Returns the UVP trip confirmation statistics of the port.
+ *
+ * @param context Pointer to the PDStack context
+ * @return Pointer to the statistics.
+ */
+const cy_stc_app_snk_fault_confirm_stats_t* Cy_App_Sink_GetFaultConfirmStats(cy_stc_pdstack_context_t *context);
+#endif /* (CY_APP_SNK_FAULT_CONFIRM_ENABLE || DOXYGEN) */
+
 /** \} group_pmg_app_common_psnk_functions */
 #endif /* _CY_APP_SINK_H_ */
 
@@ -0,0 +1,273 @@
+/***************************************************************************//**
+* \file cy_app_sink_energy.c
+* \version 2.0
+*
+* \brief
+* Implements the sink input energy accounting
+*
+********************************************************************************
+* \copyright
+* Copyright 2024, Cypress Semiconductor Corporation (an Infineon company)
+* or an affiliate of Cypress Semiconductor Corporation. All rights reserved.
+* You may use this file only in accordance with the license, terms, conditions,
+* disclaimers, and limitations in the end user license agreement accompanying
+* the software package with which this file was provided.
+*******************************************************************************/
+
+#include <string.h>
+#include "cybsp.h"
+#include "cy_app_config.h"
+#include "cy_app.h"
+#include "cy_app_sink_energy.h"
+#include "cy_app_coroutine.h"
+#if CY_APP_SINK_ENERGY_IBUS_ENABLE
+#include "cy_app_telemetry.h"
+#endif /* CY_APP_SINK_ENERGY_IBUS_ENABLE */
+#if BATTERY_CHARGING_ENABLE
+#include "cy_app_battery_charging.h"
+#endif /* BATTERY_CHARGING_ENABLE */
+
+#include "cy_pdstack_dpm.h"
+#include "cy_pdutils.h"
+#include "cy_usbpd_vbus_ctrl.h"
+
+#if CY_APP_SINK_ENERGY_ENABLE
+
+#if (CY_APP_SINK_ENERGY_IBUS_ENABLE && !(CY_APP_TELEMETRY_ENABLE && CY_APP_TELEMETRY_IBUS_ENABLE))
+#error "CY_APP_SINK_ENERGY_IBUS_ENABLE requires CY_APP_TELEMETRY_ENABLE and CY_APP_TELEMETRY_IBUS_ENABLE."
+#endif
+
+/* Energy in uJ that makes up 1 mWh */
+#define SINK_ENERGY_UJ_PER_MWH          (3600000u)
+
+/* Accounting state of each port */
+static cy_stc_app_sink_energy_t glAppSinkEnergy[NO_OF_TYPEC_PORTS];
+
+/* Type of the source the port currently draws power from */
+static uint8_t sink_energy_src_type(cy_stc_pdstack_context_t *ptrPdStackContext)
+{
+    uint8_t src_type = (uint8_t)CY_APP_SINK_SRC_TYPEC;
+
+    if (ptrPdStackContext->dpmConfig.contractExist)
+    {
+        src_type = (ptrPdStackContext->dpmStat.snkSelPdo.fixed_src.supplyType == CY_PDSTACK_PDO_AUGMENTED) ?
+            (uint8_t)CY_APP_SINK_SRC_PD_PPS : (uint8_t)CY_APP_SINK_SRC_PD_FIXED;
+    }
+#if BATTERY_CHARGING_ENABLE
+    else
+    {
+        switch (Cy_App_Bc_GetStatus(ptrPdStackContext->ptrUsbPdContext)->cur_mode)
+        {
+            case BC_CHARGE_DCP:
+            case BC_CHARGE_CDP:
+                src_type = (uint8_t)CY_APP_SINK_SRC_BC;
+                break;
+
+            case BC_CHARGE_QC2:
+            case BC_CHARGE_QC3:
+                src_type = (uint8_t)CY_APP_SINK_SRC_QC;
+                break;
+
+            case BC_CHARGE_AFC:
+                src_type = (uint8_t)CY_APP_SINK_SRC_AFC;
+                break;
+
+            case BC_CHARGE_APPLE:
+                src_type = (uint8_t)CY_APP_SINK_SRC_APPLE;
+                break;
+
+            default:
+                /* Nothing to do */
+                break;
+        }
+    }
+#endif /* BATTERY_CHARGING_ENABLE */
+
+    return src_type;
+}
+
+#if CY_APP_SINK_ENERGY_IBUS_ENABLE
+/* Energy in mWh counted by the telemetry sampler since the last call */
+static uint32_t sink_energy_measured(cy_stc_pdstack_context_t *ptrPdStackContext)
+{
+    cy_stc_app_sink_energy_t *snk = &glAppSinkEnergy[ptrPdStackContext->port];
+    uint32_t energy = Cy_App_Telemetry_GetStats(ptrPdStackContext)->energy;
+    uint32_t delta;
+
+    /* The telemetry statistics restart on each contract and when they are cleared */
+    delta = (energy >= snk->telEnergy) ? (energy - snk->telEnergy) : energy;
+    snk->telEnergy = energy;
+
+    return delta;
+}
+#endif /* CY_APP_SINK_ENERGY_IBUS_ENABLE */
+
+/* Adds one period of the contract power in mW and the measured energy in mWh to an accumulator */
+static void sink_energy_add(cy_stc_app_sink_energy_acc_t *acc, uint32_t energy, uint32_t contract_power)
+{
+    acc->contractRem += contract_power * CY_APP_SINK_ENERGY_PERIOD;
+    while (acc->contractRem >= SINK_ENERGY_UJ_PER_MWH)
+    {
+        acc->contractRem -= SINK_ENERGY_UJ_PER_MWH;
+        acc->contractEnergy++;
+    }
+
+#if CY_APP_SINK_ENERGY_IBUS_ENABLE
+    acc->energy += energy;
+#else
+    /* Without a measurement the energy drawn is that of the set points */
+    (void)energy;
+    acc->energy = acc->contractEnergy;
+#endif /* CY_APP_SINK_ENERGY_IBUS_ENABLE */
+
+    acc->timeRem += CY_APP_SINK_ENERGY_PERIOD;
+    while (acc->timeRem >= 1000u)
+    {
+        acc->timeRem -= 1000u;
+        acc->time++;
+    }
+}
+
+static void sink_energy_update(cy_stc_pdstack_context_t *ptrPdStackContext)
+{
+    cy_stc_app_sink_energy_t *snk = &glAppSinkEnergy[ptrPdStackContext->port];
+    const cy_stc_app_status_t *app_stat = Cy_App_GetStatus(ptrPdStackContext->port);
+    uint32_t contract_power;
+    uint32_t energy = 0u;
+    uint8_t src_type;
+
+#if CY_APP_SINK_ENERGY_IBUS_ENABLE
+    /* VBUS and IBUS are measured by the telemetry sampler, which defers to the ADC scheduler */
+    energy = sink_energy_measured(ptrPdStackContext);
+#endif /* CY_APP_SINK_ENERGY_IBUS_ENABLE */
+
+    if (ptrPdStackContext->dpmConfig.curPortRole == CY_PD_PRT_ROLE_SINK)
+    {
+        /* A change of the source type starts a new contract */
+        src_type = sink_energy_src_type(ptrPdStackContext);
+        if (src_type != snk->srcType)
+        {
+            memset(&snk->contract, 0, sizeof(cy_stc_app_sink_energy_acc_t));
+            snk->srcType = src_type;
+        }
+
+        /* mV * 10 mA / 100 gives mW */
+        contract_power = ((uint32_t)app_stat->psnk_volt * app_stat->psnk_cur) / 100u;
+
+        sink_energy_add(&snk->contract, energy, contract_power);
+        sink_energy_add(&snk->total[src_type], energy, contract_power);
+    }
+}
+
+/* Accounts the energy once each period while the port is attached */
+static cy_en_app_coro_status_t sink_energy_meter(cy_stc_pdstack_context_t *ptrPdStackContext, cy_stc_app_coro_t *coro)
+{
+    CY_APP_CORO_BEGIN(coro);
+
+    for (;;)
+    {
+        CY_APP_CORO_WAIT_MS(coro, CY_APP_SINK_ENERGY_PERIOD);
+
+        if (!glAppSinkEnergy[ptrPdStackContext->port].active)
+        {
+            CY_APP_CORO_EXIT(coro);
+        }
+
+        sink_energy_update(ptrPdStackContext);
+    }
+
+    CY_APP_CORO_END(coro);
+}
+
+void Cy_App_SinkEnergy_EventHandler(cy_stc_pdstack_context_t *ptrPdStackContext, cy_en_pdstack_app_evt_t evt)
+{
+    cy_stc_app_sink_energy_t *snk = &glAppSinkEnergy[ptrPdStackContext->port];
+
+    switch (evt)
+    {
+        case APP_EVT_TYPEC_ATTACH:
+            memset(&snk->contract, 0, sizeof(cy_stc_app_sink_energy_acc_t));
+            snk->srcType = (uint8_t)CY_APP_SINK_SRC_TYPEC;
+            snk->telEnergy = 0u;
+            snk->active = true;
+            Cy_App_Coro_Start(ptrPdStackContext, CY_APP_CORO_SINK_ENERGY, sink_energy_meter, CY_APP_SINK_ENERGY_PERIOD);
+            break;
+
+        case APP_EVT_DISCONNECT:
+        case APP_EVT_TYPE_C_ERROR_RECOVERY:
+            snk->active = false;
+            Cy_App_Coro_Stop(ptrPdStackContext, CY_APP_CORO_SINK_ENERGY);
+            break;
+
+        case APP_EVT_PD_CONTRACT_NEGOTIATION_COMPLETE:
+#if CY_APP_SINK_ENERGY_IBUS_ENABLE
+            /* Account the energy of the previous contract before the telemetry statistics restart */
+            if ((snk->active) && (ptrPdStackContext->dpmConfig.curPortRole == CY_PD_PRT_ROLE_SINK))
+            {
+                uint32_t energy = sink_energy_measured(ptrPdStackContext);
+
+                snk->contract.energy += energy;
+                snk->total[snk->srcType].energy += energy;
+            }
+            snk->telEnergy = 0u;
+#endif /* CY_APP_SINK_ENERGY_IBUS_ENABLE */
+            memset(&snk->contract, 0, sizeof(cy_stc_app_sink_energy_acc_t));
+            break;
+
+        default:
+            /* Nothing to do */
+            break;
+    }
+}
+
+cy_en_app_status_t Cy_App_SinkEnergy_GetReport(cy_stc_pdstack_context_t *ptrPdStackContext,
+        uint8_t srcType, cy_stc_app_sink_energy_report_t *report)
+{
+    const cy_stc_app_sink_energy_t *snk = &glAppSinkEnergy[ptrPdStackContext->port];
+    const cy_stc_app_sink_energy_acc_t *acc;
+    uint32_t intr_state;
+
+    if (srcType == CY_APP_SINK_ENERGY_CONTRACT)
+    {
+        acc = &snk->contract;
+        srcType = snk->srcType;
+    }
+    else if (srcType < (uint8_t)CY_APP_SINK_SRC_MAX)
+    {
+        acc = &snk->total[srcType];
+    }
+    else
+    {
+        return CY_APP_STAT_BAD_PARAM;
+    }
+
+    intr_state = Cy_SysLib_EnterCriticalSection();
+
+    report->srcType = srcType;
+    report->measured = (CY_APP_SINK_ENERGY_IBUS_ENABLE != 0u);
+    report->reserved = 0u;
+    report->energy = acc->energy;
+    report->contractEnergy = acc->contractEnergy;
+    report->time = acc->time;
+
+    Cy_SysLib_ExitCriticalSection(intr_state);
+
+    return CY_APP_STAT_SUCCESS;
+}
+
+void Cy_App_SinkEnergy_Clear(cy_stc_pdstack_context_t *ptrPdStackContext)
+{
+    cy_stc_app_sink_energy_t *snk = &glAppSinkEnergy[ptrPdStackContext->port];
+    uint32_t intr_state;
+
+    intr_state = Cy_SysLib_EnterCriticalSection();
+
+    memset(&snk->contract, 0, sizeof(cy_stc_app_sink_energy_acc_t));
+    memset(snk->total, 0, sizeof(snk->total));
+
+    Cy_SysLib_ExitCriticalSection(intr_state);
+}
+
+#endif /* CY_APP_SINK_ENERGY_ENABLE */
+
+/* [] End of file */
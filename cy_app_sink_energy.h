@@ -0,0 +1,194 @@
+/***************************************************************************//**
+* \file cy_app_sink_energy.h
+* \version 2.0
+*
+* \brief
+* Defines the data structures and function prototypes of the sink input energy
+* accounting.
+*
+********************************************************************************
+* \copyright
+* Copyright 2024, Cypress Semiconductor Corporation (an Infineon company)
+* or an affiliate of Cypress Semiconductor Corporation. All rights reserved.
+* You may use this file only in accordance with the license, terms, conditions,
+* disclaimers, and limitations in the end user license agreement accompanying
+* the software package with which this file was provided.
+*******************************************************************************/
+
+#ifndef _CY_APP_SINK_ENERGY_H_
+#define _CY_APP_SINK_ENERGY_H_
+
+/*******************************************************************************
+ * Header files including
+ ******************************************************************************/
+#include <stdint.h>
+#include <stdbool.h>
+#include "cy_pdstack_common.h"
+#include "cy_app_status.h"
+
+#if (CY_APP_SINK_ENERGY_ENABLE || DOXYGEN)
+
+/**
+* \addtogroup group_pmg_app_common_sink_energy
+* \{
+* The sink energy accounting integrates the power of the negotiated set
+* points, psnk_volt x psnk_cur, of a sink port every CY_APP_SINK_ENERGY_PERIOD
+* ms while a port partner is attached. If CY_APP_SINK_ENERGY_IBUS_ENABLE is
+* set, the measured energy is taken from the VBUS x IBUS energy counter of the
+* telemetry sampler as well, so that the two can be compared.
+*
+* The energy is accumulated for the active contract, which restarts on each
+* PD contract and each change of the source type, and in a total per source
+* type. The source type is derived from the PD contract, or from the charging
+* scheme detected by the battery charging module if there is no PD contract.
+*
+* The accounting can be read with Cy_App_SinkEnergy_GetReport, or by the EC
+* through the HPI PD response command with ID CY_APP_PD_RESP_ID_SINK_ENERGY.
+* A read command carries one data byte which selects the source type of the
+* total to be read, or CY_APP_SINK_ENERGY_CONTRACT for the active contract. A
+* read without data returns the active contract.
+*
+* \defgroup group_pmg_app_common_sink_energy_macros Macros
+* \defgroup group_pmg_app_common_sink_energy_enums Enumerated types
+* \defgroup group_pmg_app_common_sink_energy_data_structures Data structures
+* \defgroup group_pmg_app_common_sink_energy_functions Functions
+*/
+/** \} group_pmg_app_common_sink_energy */
+
+/*****************************************************************************
+ * Macros
+ *****************************************************************************/
+/**
+* \addtogroup group_pmg_app_common_sink_energy_macros
+* \{
+*/
+
+/** Selects the report of the active contract instead of a source type total. */
+#define CY_APP_SINK_ENERGY_CONTRACT             (0xFFu)
+
+/** \} group_pmg_app_common_sink_energy_macros */
+
+/*****************************************************************************
+ * Enumerated Data Definition
+ *****************************************************************************/
+/**
+* \addtogroup group_pmg_app_common_sink_energy_enums
+* \{
+*/
+
+/**
+ * @typedef cy_en_app_sink_src_type_t
+ * @brief Type of the source a sink port draws power from.
+ */
+typedef enum
+{
+    CY_APP_SINK_SRC_TYPEC = 0u,         /**< Type-C current or BC 1.2 SDP. */
+    CY_APP_SINK_SRC_PD_FIXED,           /**< PD fixed, variable or battery supply. */
+    CY_APP_SINK_SRC_PD_PPS,             /**< PD augmented supply. */
+    CY_APP_SINK_SRC_BC,                 /**< BC 1.2 DCP or CDP. */
+    CY_APP_SINK_SRC_QC,                 /**< QC 2.0 or QC 3.0 charger. */
+    CY_APP_SINK_SRC_AFC,                /**< AFC charger. */
+    CY_APP_SINK_SRC_APPLE,              /**< Apple charger. */
+    CY_APP_SINK_SRC_MAX                 /**< Number of source types. */
+} cy_en_app_sink_src_type_t;
+
+/** \} group_pmg_app_common_sink_energy_enums */
+
+/*****************************************************************************
+ * Data Struct Definition
+ *****************************************************************************/
+/**
+* \addtogroup group_pmg_app_common_sink_energy_data_structures
+* \{
+*/
+
+/**
+ * @brief Energy accounting report. This structure is also the payload of the
+ * HPI sink energy response.
+ */
+typedef struct
+{
+    uint8_t srcType;                    /**< Source type, of type cy_en_app_sink_src_type_t. */
+    bool measured;                      /**< true if energy is measured; false if it is the contract energy. */
+    uint16_t reserved;                  /**< Reserved for alignment. */
+    uint32_t energy;                    /**< Energy drawn in mWh. */
+    uint32_t contractEnergy;            /**< Energy of the negotiated set points in mWh. */
+    uint32_t time;                      /**< Time accounted in s. */
+} cy_stc_app_sink_energy_report_t;
+
+/**
+ * @brief Energy accumulator
+ */
+typedef struct
+{
+    uint32_t energy;                    /**< Energy drawn in mWh. */
+    uint32_t contractEnergy;            /**< Energy of the negotiated set points in mWh. */
+    uint32_t time;                      /**< Time accounted in s. */
+    uint32_t contractRem;               /**< Contract energy in uJ not yet counted in mWh. */
+    uint16_t timeRem;                   /**< Time in ms not yet counted in s. */
+} cy_stc_app_sink_energy_acc_t;
+
+/**
+ * @brief Energy accounting state of one port
+ */
+typedef struct
+{
+    cy_stc_app_sink_energy_acc_t contract;                      /**< Accumulator of the active contract. */
+    cy_stc_app_sink_energy_acc_t total[CY_APP_SINK_SRC_MAX];    /**< Accumulators of each source type. */
+    uint32_t telEnergy;                 /**< Telemetry energy counter in mWh at the last period. */
+    uint8_t srcType;                    /**< Source type of the active contract. */
+    bool active;                        /**< Accounting is enabled on the port. */
+} cy_stc_app_sink_energy_t;
+
+/** \} group_pmg_app_common_sink_energy_data_structures */
+
+/*****************************************************************************
+ * Global Function Declaration
+ *****************************************************************************/
+/**
+* \addtogroup group_pmg_app_common_sink_energy_functions
+* \{
+*/
+
+/**
+ * @brief Starts, restarts and stops the accounting on the port from a PD
+ * event. Called from Cy_App_EventHandler.
+ *
+ * @param ptrPdStackContext Pointer to the PDStack context
+ * @param evt Event that is being notified
+ *
+ * @return None
+ */
+void Cy_App_SinkEnergy_EventHandler(cy_stc_pdstack_context_t *ptrPdStackContext, cy_en_pdstack_app_evt_t evt);
+
+/**
+ * @brief Reads the accounting of the active contract or of a source type.
+ *
+ * @param ptrPdStackContext Pointer to the PDStack context
+ * @param srcType Source type of the total to be read, or
+ * CY_APP_SINK_ENERGY_CONTRACT for the active contract
+ * @param report Report to be filled
+ *
+ * @return CY_APP_STAT_SUCCESS if the report is filled; CY_APP_STAT_BAD_PARAM
+ * if the source type is invalid.
+ */
+cy_en_app_status_t Cy_App_SinkEnergy_GetReport(cy_stc_pdstack_context_t *ptrPdStackContext,
+        uint8_t srcType, cy_stc_app_sink_energy_report_t *report);
+
+/**
+ * @brief Clears the accounting of the active contract and all source types of
+ * the port.
+ *
+ * @param ptrPdStackContext Pointer to the PDStack context
+ *
+ * @return None
+ */
+void Cy_App_SinkEnergy_Clear(cy_stc_pdstack_context_t *ptrPdStackContext);
+
+/** \} group_pmg_app_common_sink_energy_functions */
+
+#endif /* (CY_APP_SINK_ENERGY_ENABLE || DOXYGEN) */
+
+#endif /* _CY_APP_SINK_ENERGY_H_ */
+
+/* [] END OF FILE */
@@ -22,10 +22,14 @@
 #include "cy_app_source.h"
 #include "cy_app_timer_id.h"
 #include "cy_app_fault_handlers.h"
+#include "cy_pdutils.h"
 #include "cy_pdutils_sw_timer.h"
 #include "cy_pdstack_timer_id.h"
 #include "cy_pdstack_dpm.h"
 #include "cy_usbpd_vbus_ctrl.h"
+#if CY_APP_ADC_SCHED_ENABLE
+#include "cy_app_adc_sched.h"
+#endif /* CY_APP_ADC_SCHED_ENABLE */
 
 /* Type-C current levels in 10 mA units */
 #define CUR_LEVEL_3A    300
@@ -45,6 +49,93 @@ static const uint32_t cc_rp_to_cur_map[] = {
     CUR_LEVEL_1_5A,
     CUR_LEVEL_3A
 };
+
+/* Returns the OCP current in 10 mA units of a source PDO. */
+static uint32_t psrc_pdo_ocp_cur(cy_pd_pd_do_t pdo, bool above_15v)
+{
+    uint32_t ocp_cur;
+
+    switch(pdo.src_gen.supplyType)
+    {
+        case CY_PDSTACK_PDO_FIXED_SUPPLY:
+        case CY_PDSTACK_PDO_VARIABLE_SUPPLY:
+            ocp_cur = pdo.src_gen.maxCurPower;
+            break;
+        case CY_PDSTACK_PDO_AUGMENTED:
+            if(pdo.pps_src.apdoType == CY_PDSTACK_APDO_AVS)
+            {
+                /* PDP value is in 1W units and the max volt is in 100 mV units. Convert pdp in 100 mW units
+                 * and divide by voltage gives the current in amps then multiplied by 100 to convert in 10 mA units. */
+                ocp_cur = ((pdo.epr_avs_src.pdp * 10) / pdo.epr_avs_src.maxVolt) * 100;
+            }
+            else if(pdo.spr_avs_src.apdoType == CY_PDSTACK_APDO_SPR_AVS)
+            {
+                /* Set the current limit based on the contract voltage. */
+                ocp_cur = (above_15v) ? pdo.spr_avs_src.maxCur2 : pdo.spr_avs_src.maxCur1;
+            }
+            else
+            {
+                /* Max current in PPS PDO is in 50 mA units, multiplied by 5 to convert in 10 mA units. */
+                ocp_cur = pdo.pps_src.maxCur * 5;
+            }
+            break;
+        default:
+            ocp_cur = pdo.src_gen.maxCurPower;
+            break;
+    }
+
+    return ocp_cur;
+}
+
+#if CY_APP_PROT_THRESHOLD_CACHE_ENABLE
+/* Protection thresholds of the source PDOs advertised on each port. */
+static cy_stc_app_prot_threshold_table_t glAppProtThreshold[NO_OF_TYPEC_PORTS];
+
+/* Derives the thresholds of all source PDOs of the port. */
+static void prot_threshold_build(cy_stc_pdstack_context_t *context)
+{
+    cy_stc_app_prot_threshold_table_t *table = &glAppProtThreshold[context->port];
+    const cy_stc_pdstack_dpm_status_t *dpm_stat = &context->dpmStat;
+    uint8_t count = CY_PDUTILS_GET_MIN(dpm_stat->srcPdoCount, CY_PD_MAX_NO_OF_PDO);
+    uint8_t idx;
+
+    for (idx = 0u; idx < count; idx++)
+    {
+        table->entry[idx].pdo = dpm_stat->curSrcPdo[idx].val;
+        table->entry[idx].ocpCur[0] = (uint16_t)psrc_pdo_ocp_cur(dpm_stat->curSrcPdo[idx], false);
+        table->entry[idx].ocpCur[1] = (uint16_t)psrc_pdo_ocp_cur(dpm_stat->curSrcPdo[idx], true);
+    }
+
+    table->count = count;
+}
+
+/*
+ * Returns the thresholds of the selected source PDO. The table is rebuilt only when the
+ * selected PDO does not match the entry at its object position, which happens once after
+ * each change of the source PDOs. Returns NULL for PDOs which are not in the table, like
+ * EPR PDOs.
+ */
+static const cy_stc_app_prot_threshold_t* prot_threshold_get(cy_stc_pdstack_context_t *context)
+{
+    const cy_stc_app_prot_threshold_table_t *table = &glAppProtThreshold[context->port];
+    const cy_stc_pdstack_dpm_status_t *dpm_stat = &context->dpmStat;
+    uint8_t idx = (uint8_t)(dpm_stat->srcRdo.rdo_gen.objPos - 1u);
+
+    if ((idx < table->count) && (table->entry[idx].pdo == dpm_stat->srcSelPdo.val))
+    {
+        return &table->entry[idx];
+    }
+
+    prot_threshold_build(context);
+
+    if ((idx < table->count) && (table->entry[idx].pdo == dpm_stat->srcSelPdo.val))
+    {
+        return &table->entry[idx];
+    }
+
+    return NULL;
+}
+#endif /* CY_APP_PROT_THRESHOLD_CACHE_ENABLE */
 #endif /* (VBUS_OCP_ENABLE) */
 
 static void psrc_shutdown(cy_stc_pdstack_context_t * context, bool discharge_dis);
@@ -54,6 +145,33 @@ static void psrc_shutdown(cy_stc_pdstack_context_t * context, bool discharge_dis
 bool gl_fet_soft_start_en[NO_OF_TYPEC_PORTS] = {false};
 void ocp_handler_wrapper(cy_timer_id_t id,  void *cbkContext);
 
+/* Soft-start profile of each port */
+static cy_stc_app_soft_start_step_t glAppSoftStartProfile[NO_OF_TYPEC_PORTS][CY_APP_SOFT_START_MAX_STEPS];
+
+/* Number of steps in the profile of each port; 0 to use the fixed soft-start step */
+static uint8_t glAppSoftStartCount[NO_OF_TYPEC_PORTS];
+
+/* The FET turn-on in progress follows the profile of the port */
+static volatile bool glAppSoftStartProfileRun[NO_OF_TYPEC_PORTS];
+
+/* Step being executed */
+static uint8_t glAppSoftStartStep[NO_OF_TYPEC_PORTS];
+
+/* Time in ms spent in the current step */
+static uint16_t glAppSoftStartDwell[NO_OF_TYPEC_PORTS];
+
+/* Time in ms since the FET was turned on */
+static uint16_t glAppSoftStartElapsed[NO_OF_TYPEC_PORTS];
+
+/* Time in ms VBUS took to reach the target voltage; 0 until reached */
+static uint16_t glAppSoftStartRampTime[NO_OF_TYPEC_PORTS];
+
+/* Number of OCP trips during the soft start */
+static uint8_t glAppSoftStartTrips[NO_OF_TYPEC_PORTS];
+
+/* The drive strength has been lowered after an OCP trip */
+static volatile bool glAppSoftStartTripHold[NO_OF_TYPEC_PORTS];
+
 #endif /* VBUS_SOFT_START_ENABLE */
 
 void app_psrc_tmr_cbk(cy_timer_id_t id,  void * callbackCtx);
@@ -77,21 +195,198 @@ void vbus_fet_on_cbk (cy_timer_id_t id,  void * context)
 #endif /* (defined(CY_DEVICE_PMG1S3) && (!CY_PD_SINK_ONLY)) */
 
 #if VBUS_SOFT_START_ENABLE
-static void Vbus_NgdoSoftStartOn(cy_stc_pdstack_context_t *context)
+/* Applies the drive strength and OCP setting of the current profile step */
+static void soft_start_apply_step(cy_stc_pdstack_context_t *context)
 {
+    const cy_stc_app_soft_start_step_t *step = &glAppSoftStartProfile[context->port][glAppSoftStartStep[context->port]];
+
     /* Disable the OCP fault detection module */
     Cy_USBPD_Fault_Vbus_OcpDisable(context->ptrUsbPdContext, true);
 
-    /* Set the OCP threshold to 200 mA for soft start */
-    Cy_USBPD_Fault_Vbus_OcpEnable(context->ptrUsbPdContext, 20, app_psrc_vbus_ocp_cbk);
+    if (!step->ocpMask)
+    {
+        /* Set the OCP threshold used for soft start */
+        Cy_USBPD_Fault_Vbus_OcpEnable(context->ptrUsbPdContext, CY_APP_SOFT_START_OCP_CUR, app_psrc_vbus_ocp_cbk);
+    }
+
+    Cy_USBPD_Vbus_NgdoSetDriveStrength(context->ptrUsbPdContext, step->driveStrength);
+    glAppSoftStartDwell[context->port] = 0u;
+}
+
+/* Restores the full drive strength and the OCP settings of the contract */
+static void soft_start_finish(cy_stc_pdstack_context_t *context)
+{
+    Cy_USBPD_Vbus_NgdoSetDriveStrength(context->ptrUsbPdContext, CY_APP_SOFT_START_FINAL_DRIVE);
+
+    gl_fet_soft_start_en[context->port] = false;
+    glAppSoftStartTripHold[context->port] = false;
+
+    Cy_App_Source_SetCurrent(context, CUR_LEVEL_3A);
+}
+
+static void soft_start_next_step(cy_stc_pdstack_context_t *context)
+{
+    uint8_t port = context->port;
+
+    glAppSoftStartStep[port]++;
+    if (glAppSoftStartStep[port] >= glAppSoftStartCount[port])
+    {
+        soft_start_finish(context);
+    }
+    else
+    {
+        soft_start_apply_step(context);
+    }
+}
+
+/* Executes one poll period of the soft-start profile */
+static void soft_start_profile_poll(cy_stc_pdstack_context_t *context)
+{
+    uint8_t port = context->port;
+    uint32_t target = Cy_App_GetStatus(port)->psrc_volt;
+    uint32_t margin = (target * CY_APP_VBUS_NEW_VALID_MARGIN) / 100u;
+    uint32_t vbus = Cy_App_VbusGetValue(context);
+    const cy_stc_app_soft_start_step_t *step;
+
+    glAppSoftStartElapsed[port] += CY_APP_SOFT_START_POLL_PERIOD;
+
+    /* Record the time VBUS took to get within the valid window of the target */
+    if ((glAppSoftStartRampTime[port] == 0u) && (vbus + margin >= target))
+    {
+        glAppSoftStartRampTime[port] = glAppSoftStartElapsed[port];
+    }
+
+    if (gl_fet_soft_start_en[port])
+    {
+        glAppSoftStartDwell[port] += CY_APP_SOFT_START_POLL_PERIOD;
+
+        if (glAppSoftStartTripHold[port])
+        {
+            /* Once the lowered drive strength has been held, continue with the next step or
+             * leave a persistent overload to the regular OCP handling */
+            if (glAppSoftStartDwell[port] >= CY_APP_SOFT_START_TRIP_DWELL)
+            {
+                glAppSoftStartTripHold[port] = false;
+                if (glAppSoftStartTrips[port] > CY_APP_SOFT_START_MAX_TRIPS)
+                {
+                    soft_start_finish(context);
+                }
+                else
+                {
+                    soft_start_next_step(context);
+                }
+            }
+        }
+        else
+        {
+            step = &glAppSoftStartProfile[port][glAppSoftStartStep[port]];
+
+            /* A step ends early once VBUS has reached its level */
+            if ((glAppSoftStartDwell[port] >= step->dwell) ||
+                    ((step->vbusPercent != 0u) && ((vbus * 100u) >= (target * step->vbusPercent))))
+            {
+                soft_start_next_step(context);
+            }
+        }
+    }
+
+    /* Keep polling until VBUS has reached the target, to record the ramp time */
+    if ((gl_fet_soft_start_en[port]) ||
+            ((glAppSoftStartRampTime[port] == 0u) && (glAppSoftStartElapsed[port] < CY_APP_SOFT_START_RAMP_TIMEOUT)))
+    {
+        Cy_PdUtils_SwTimer_Start(context->ptrTimerContext, context, CY_APP_GET_TIMER_ID(context, CY_APP_FET_SOFT_START_TIMER_ID),
+                CY_APP_SOFT_START_POLL_PERIOD, ocp_handler_wrapper);
+    }
+    else
+    {
+        glAppSoftStartProfileRun[port] = false;
+    }
+}
+
+static void Vbus_NgdoSoftStartOn(cy_stc_pdstack_context_t *context)
+{
+    uint8_t port = context->port;
+
+    if (glAppSoftStartCount[port] == 0u)
+    {
+        glAppSoftStartProfileRun[port] = false;
+
+        /* Disable the OCP fault detection module */
+        Cy_USBPD_Fault_Vbus_OcpDisable(context->ptrUsbPdContext, true);
+
+        /* Set the OCP threshold to 200 mA for soft start */
+        Cy_USBPD_Fault_Vbus_OcpEnable(context->ptrUsbPdContext, 20, app_psrc_vbus_ocp_cbk);
+
+        gl_fet_soft_start_en[context->port] = true;
+
+        /* Sets the drive strength of the NGDO to HIGH (1.05 uA) */
+        Cy_USBPD_Vbus_NgdoSetDriveStrength(context->ptrUsbPdContext, (uint8_t)0x07);
+
+        /* Start the timer which will change drive strength and OCP settings to default after a timeout */
+        Cy_PdUtils_SwTimer_Start(context->ptrTimerContext, context, CY_APP_GET_TIMER_ID(context, CY_APP_FET_SOFT_START_TIMER_ID), 50, ocp_handler_wrapper);
+        return;
+    }
+
+    glAppSoftStartStep[port]       = 0u;
+    glAppSoftStartElapsed[port]    = 0u;
+    glAppSoftStartRampTime[port]   = 0u;
+    glAppSoftStartTrips[port]      = 0u;
+    glAppSoftStartTripHold[port]   = false;
+    glAppSoftStartProfileRun[port] = true;
+
+    gl_fet_soft_start_en[port] = true;
+    soft_start_apply_step(context);
+
+    /* Start the timer which steps through the profile */
+    Cy_PdUtils_SwTimer_Start(context->ptrTimerContext, context, CY_APP_GET_TIMER_ID(context, CY_APP_FET_SOFT_START_TIMER_ID),
+            CY_APP_SOFT_START_POLL_PERIOD, ocp_handler_wrapper);
+}
+
+static void Vbus_NgdoSoftStartOff(cy_stc_pdstack_context_t *context)
+{
+    /* Only a profile is stopped with the FET; the fixed step completes on its timer */
+    if (glAppSoftStartProfileRun[context->port])
+    {
+        Cy_PdUtils_SwTimer_Stop(context->ptrTimerContext, CY_APP_GET_TIMER_ID(context, CY_APP_FET_SOFT_START_TIMER_ID));
+        gl_fet_soft_start_en[context->port] = false;
+        glAppSoftStartTripHold[context->port] = false;
+        glAppSoftStartProfileRun[context->port] = false;
+    }
+}
+
+cy_en_app_status_t Cy_App_Source_SetSoftStartProfile(cy_stc_pdstack_context_t *context,
+        const cy_stc_app_soft_start_step_t *steps, uint8_t count)
+{
+    uint8_t idx;
+
+    if (count > CY_APP_SOFT_START_MAX_STEPS)
+    {
+        return CY_APP_STAT_BAD_PARAM;
+    }
+
+    if ((count != 0u) && (steps == NULL))
+    {
+        return CY_APP_STAT_BAD_PARAM;
+    }
 
-    gl_fet_soft_start_en[context->port] = true;
+    /* The profile cannot change while it is executed */
+    if ((gl_fet_soft_start_en[context->port]) || (glAppSoftStartProfileRun[context->port]))
+    {
+        return CY_APP_STAT_BUSY;
+    }
+
+    for (idx = 0u; idx < count; idx++)
+    {
+        glAppSoftStartProfile[context->port][idx] = steps[idx];
+    }
+    glAppSoftStartCount[context->port] = count;
 
-    /* Sets the drive strength of the NGDO to HIGH (1.05 uA) */
-    Cy_USBPD_Vbus_NgdoSetDriveStrength(context->ptrUsbPdContext, (uint8_t)0x07);
+    return CY_APP_STAT_SUCCESS;
+}
 
-    /* Start the timer which will change drive strength and OCP settings to default after a timeout */
-    Cy_PdUtils_SwTimer_Start(context->ptrTimerContext, context, CY_APP_GET_TIMER_ID(context, CY_APP_FET_SOFT_START_TIMER_ID), 50, ocp_handler_wrapper);
+uint16_t Cy_App_Source_GetSoftStartRampTime(cy_stc_pdstack_context_t *context)
+{
+    return glAppSoftStartRampTime[context->port];
 }
 #endif /* VBUS_SOFT_START_ENABLE */
 
@@ -166,6 +461,10 @@ static void vbus_fet_off(cy_stc_pdstack_context_t *context)
     /* Stop the VBUS_FET_ON_TIMER */
     Cy_PdUtils_SwTimer_Stop(context->ptrTimerContext, CY_APP_GET_TIMER_ID(context, CY_APP_VBUS_FET_ON_TIMER));
 
+#if VBUS_SOFT_START_ENABLE
+    Vbus_NgdoSoftStartOff(context);
+#endif /* VBUS_SOFT_START_ENABLE */
+
     Cy_USBPD_Vbus_NgdoG1Ctrl (context->ptrUsbPdContext, false);
     Cy_USBPD_Vbus_NgdoEqCtrl (context->ptrUsbPdContext, true);
 
@@ -191,11 +490,76 @@ static void call_psrc_ready_cbk(cy_stc_pdstack_context_t * context)
     }
 }
 
+/* The source voltage has settled at the new level: re-arm the protections and signal PS_RDY */
+static void psrc_transition_done(cy_stc_pdstack_context_t * context)
+{
+    cy_stc_app_status_t* app_stat = Cy_App_GetStatus(context->port);
+
+    Cy_PdUtils_SwTimer_Stop(context->ptrTimerContext, CY_APP_GET_TIMER_ID(context, CY_APP_PSOURCE_EN_TIMER));
+    app_stat->psrc_volt_old = app_stat->psrc_volt;
+    Cy_App_VbusDischargeOff(context);
+
+    if(app_stat->psrc_rising == false)
+    {
+#if VBUS_OVP_ENABLE
+        /* VBUS voltage has stabilized at the new lower level. Update the OVP and RCP limits. */
+        Cy_App_Fault_OvpEnable(context, app_stat->psrc_volt,
+                               CCG_SRC_FET, app_psrc_vbus_ovp_cbk);
+#endif /* VBUS_OVP_ENABLE */
+
+#if VBUS_RCP_ENABLE
+        Cy_App_Fault_RcpEnable(context, app_stat->psrc_volt, 
+                               app_psrc_vbus_rcp_cbk);
+#endif /* VBUS_RCP_ENABLE */
+    }
+    else
+    {
+#if VBUS_UVP_ENABLE
+        Cy_App_Fault_UvpEnable(context, 
+                               app_stat->psrc_volt, 
+                               CCG_SRC_FET, app_psrc_vbus_ovp_cbk);
+#endif /* VBUS_UVP_ENABLE */
+    }
+
+    call_psrc_ready_cbk(context);
+}
+
+#if CY_APP_VBUS_RAMP_MONITOR_ENABLE
+/* Number of consecutive VBUS measurements within the valid window of the new voltage */
+static uint8_t glAppPsrcRampCount[NO_OF_TYPEC_PORTS];
+
+/* The hysteresis of the transition is replaced by VBUS measurements */
+static bool glAppPsrcRampCheck[NO_OF_TYPEC_PORTS];
+
+/* Measures VBUS and checks whether it has settled within the valid window of the new voltage */
+static bool psrc_ramp_settled(cy_stc_pdstack_context_t * context)
+{
+    cy_stc_app_status_t* app_stat = Cy_App_GetStatus(context->port);
+    uint32_t margin = ((uint32_t)app_stat->psrc_volt * CY_APP_VBUS_NEW_VALID_MARGIN) / 100u;
+    uint32_t vbus = Cy_App_VbusGetValue(context);
+
+    if ((vbus + margin >= app_stat->psrc_volt) && (vbus <= app_stat->psrc_volt + margin))
+    {
+        glAppPsrcRampCount[context->port]++;
+    }
+    else
+    {
+        glAppPsrcRampCount[context->port] = 0u;
+    }
+
+    return (glAppPsrcRampCount[context->port] >= CY_APP_VBUS_RAMP_STABLE_COUNT);
+}
+#endif /* CY_APP_VBUS_RAMP_MONITOR_ENABLE */
+
 /*Timer callback*/
 void app_psrc_tmr_cbk(cy_timer_id_t id,  void * callbackCtx)
 {
     cy_stc_pdstack_context_t* context = callbackCtx;
     cy_stc_app_status_t* app_stat = Cy_App_GetStatus(context->port);
+#if CY_APP_VBUS_DISCHARGE_CTRL_ENABLE
+    uint16_t period = CY_APP_PSOURCE_EN_MONITOR_TIMER_PERIOD;
+    uint16_t vbus;
+#endif /* CY_APP_VBUS_DISCHARGE_CTRL_ENABLE */
 
     if (context->port != 0u)
     {
@@ -229,11 +593,24 @@ void app_psrc_tmr_cbk(cy_timer_id_t id,  void * callbackCtx)
             break;
 
         case CY_APP_PSOURCE_EN_MONITOR_TIMER:
+#if CY_APP_VBUS_DISCHARGE_CTRL_ENABLE
+            if (app_stat->psrc_rising == false)
+            {
+                /* Follow the discharge slope; a period of 0 means the target has been reached */
+                period = Cy_App_VbusDischargeCtrl_Poll(context, NULL);
+            }
+
+            if (((app_stat->psrc_rising == true) &&
+                        (Cy_App_VbusIsPresent(context, app_stat->psrc_volt, CY_APP_VBUS_TURN_ON_MARGIN) == true)) ||
+                    ((app_stat->psrc_rising == false) && (period == 0u))
+               )
+#else
             if (((app_stat->psrc_rising == true) &&
                         (Cy_App_VbusIsPresent(context, app_stat->psrc_volt, CY_APP_VBUS_TURN_ON_MARGIN) == true)) ||
                     ((app_stat->psrc_rising == false) &&
                      (Cy_App_VbusIsPresent(context, app_stat->psrc_volt, CY_APP_VBUS_DISCHARGE_MARGIN) == false))
                )
+#endif /* CY_APP_VBUS_DISCHARGE_CTRL_ENABLE */
             {
 #if CY_PD_EPR_AVS_ENABLE
                 if(context->dpmExtStat.eprAvsMode == CY_PDSTACK_EPR_AVS_SMALL)
@@ -245,17 +622,30 @@ void app_psrc_tmr_cbk(cy_timer_id_t id,  void * callbackCtx)
                 else
 #endif /* CY_PD_EPR_AVS_ENABLE */
                 {
+#if CY_APP_VBUS_RAMP_MONITOR_ENABLE
+                    /* Confirm the new voltage by measurement instead of waiting for the full hysteresis */
+                    glAppPsrcRampCount[context->port] = 0u;
+                    glAppPsrcRampCheck[context->port] = true;
+                    Cy_PdUtils_SwTimer_Start(context->ptrTimerContext, context, CY_APP_GET_TIMER_ID(context, CY_APP_PSOURCE_EN_HYS_TIMER),
+                            CY_APP_VBUS_RAMP_SAMPLE_PERIOD, app_psrc_tmr_cbk);
+#else
                     /* Start source enable hysteresis timer */
                     Cy_PdUtils_SwTimer_Start(context->ptrTimerContext, context, CY_APP_GET_TIMER_ID(context, CY_APP_PSOURCE_EN_HYS_TIMER),
                             CY_APP_PSOURCE_EN_HYS_TIMER_PERIOD, app_psrc_tmr_cbk);
+#endif /* CY_APP_VBUS_RAMP_MONITOR_ENABLE */
                 }
 
                 break;
             }
 
             /* Start monitor timer again */
+#if CY_APP_VBUS_DISCHARGE_CTRL_ENABLE
+            Cy_PdUtils_SwTimer_Start(context->ptrTimerContext, context, CY_APP_GET_TIMER_ID(context, CY_APP_PSOURCE_EN_MONITOR_TIMER),
+                    period, app_psrc_tmr_cbk);
+#else
             Cy_PdUtils_SwTimer_Start(context->ptrTimerContext, context, CY_APP_GET_TIMER_ID(context, CY_APP_PSOURCE_EN_MONITOR_TIMER),
                     CY_APP_PSOURCE_EN_MONITOR_TIMER_PERIOD, app_psrc_tmr_cbk);
+#endif /* CY_APP_VBUS_DISCHARGE_CTRL_ENABLE */
             break;
 
         case CY_APP_PSOURCE_EN_HYS_TIMER:
@@ -273,33 +663,18 @@ void app_psrc_tmr_cbk(cy_timer_id_t id,  void * callbackCtx)
                         CY_APP_PSOURCE_EN_HYS_TIMER_PERIOD, app_psrc_tmr_cbk);
                 return;
             }
-            Cy_PdUtils_SwTimer_Stop(context->ptrTimerContext, CY_APP_GET_TIMER_ID(context, CY_APP_PSOURCE_EN_TIMER));
-            app_stat->psrc_volt_old = app_stat->psrc_volt;
-            Cy_App_VbusDischargeOff(context);
-
-            if(app_stat->psrc_rising == false)
-            {
-#if VBUS_OVP_ENABLE
-                /* VBUS voltage has stabilized at the new lower level. Update the OVP and RCP limits. */
-                Cy_App_Fault_OvpEnable(context, app_stat->psrc_volt,
-                                       CCG_SRC_FET, app_psrc_vbus_ovp_cbk);
-#endif /* VBUS_OVP_ENABLE */
 
-#if VBUS_RCP_ENABLE
-                Cy_App_Fault_RcpEnable(context, app_stat->psrc_volt, 
-                                       app_psrc_vbus_rcp_cbk);
-#endif /* VBUS_RCP_ENABLE */
-            }
-            else
+#if CY_APP_VBUS_RAMP_MONITOR_ENABLE
+            if ((glAppPsrcRampCheck[context->port]) && (!psrc_ramp_settled(context)))
             {
-#if VBUS_UVP_ENABLE
-                Cy_App_Fault_UvpEnable(context, 
-                                       app_stat->psrc_volt, 
-                                       CCG_SRC_FET, app_psrc_vbus_ovp_cbk);
-#endif /* VBUS_UVP_ENABLE */
+                /* CY_APP_PSOURCE_EN_TIMER remains the upper bound for the transition */
+                Cy_PdUtils_SwTimer_Start(context->ptrTimerContext, context, CY_APP_GET_TIMER_ID(context, CY_APP_PSOURCE_EN_HYS_TIMER),
+                        CY_APP_VBUS_RAMP_SAMPLE_PERIOD, app_psrc_tmr_cbk);
+                return;
             }
-
-            call_psrc_ready_cbk(context);
+            glAppPsrcRampCheck[context->port] = false;
+#endif /* CY_APP_VBUS_RAMP_MONITOR_ENABLE */
+            psrc_transition_done(context);
             break;
 
         case CY_APP_PSOURCE_DIS_TIMER:
@@ -309,6 +684,16 @@ void app_psrc_tmr_cbk(cy_timer_id_t id,  void * callbackCtx)
             break;
 
         case CY_APP_PSOURCE_DIS_MONITOR_TIMER:
+#if CY_APP_VBUS_DISCHARGE_CTRL_ENABLE
+            period = Cy_App_VbusDischargeCtrl_Poll(context, &vbus);
+            if (vbus < (CY_PD_VSAFE_5V + ((CY_PD_VSAFE_5V * CY_APP_VBUS_DISCHARGE_TO_5V_MARGIN) / 100)))
+            {
+                /* If the voltage drops below 5 V turn off the FET and continue discharge. */
+                psrc_shutdown(context, false);
+            }
+
+            if (period == 0u)
+#else
             if (Cy_App_VbusIsPresent(context, CY_PD_VSAFE_5V, CY_APP_VBUS_DISCHARGE_TO_5V_MARGIN) == false)
             {
                 /* If the voltage drops below 5 V turn off the FET and continue discharge. */
@@ -316,6 +701,7 @@ void app_psrc_tmr_cbk(cy_timer_id_t id,  void * callbackCtx)
             }
 
             if (Cy_App_VbusIsPresent(context, CY_PD_VSAFE_0V, CY_APP_VBUS_TURN_ON_MARGIN) == false)
+#endif /* CY_APP_VBUS_DISCHARGE_CTRL_ENABLE */
             {
                 /* Start extra discharge to allow proper discharge below Vsafe0V */
                 Cy_PdUtils_SwTimer_Start(context->ptrTimerContext, context, CY_APP_GET_TIMER_ID(context, CY_APP_PSOURCE_DIS_EXT_DIS_TIMER),
@@ -324,8 +710,13 @@ void app_psrc_tmr_cbk(cy_timer_id_t id,  void * callbackCtx)
             else
             {
                 /* Start monitor timer again */
+#if CY_APP_VBUS_DISCHARGE_CTRL_ENABLE
+                Cy_PdUtils_SwTimer_Start(context->ptrTimerContext, context, CY_APP_GET_TIMER_ID(context, CY_APP_PSOURCE_DIS_MONITOR_TIMER),
+                        period, app_psrc_tmr_cbk);
+#else
                 Cy_PdUtils_SwTimer_Start(context->ptrTimerContext, context, CY_APP_GET_TIMER_ID(context, CY_APP_PSOURCE_DIS_MONITOR_TIMER),
                         CY_APP_PSOURCE_DIS_MONITOR_TIMER_PERIOD, app_psrc_tmr_cbk);
+#endif /* CY_APP_VBUS_DISCHARGE_CTRL_ENABLE */
             }
             break;
 
@@ -376,7 +767,11 @@ void ocp_handler_wrapper(cy_timer_id_t id,  void *cbkContext)
 {
     cy_stc_pdstack_context_t *context = (cy_stc_pdstack_context_t *)cbkContext;
 
-    if (gl_fet_soft_start_en[context->port])
+    if (glAppSoftStartProfileRun[context->port])
+    {
+        soft_start_profile_poll(context);
+    }
+    else if (gl_fet_soft_start_en[context->port])
     {
         Cy_USBPD_Vbus_NgdoSetDriveStrength(context->ptrUsbPdContext, 0x0E);
 
@@ -403,11 +798,22 @@ bool app_psrc_vbus_ocp_cbk(void *cbkContext, bool comp_out)
              /* Disable the OCP fault detection module */
             Cy_USBPD_Fault_Vbus_OcpDisable(context, true);
 
-            Cy_USBPD_Vbus_NgdoSetDriveStrength(context, 0x02); 
-            
-            /* Schedule a timer which will increase the drive strength after a delay. */
-            Cy_PdUtils_SwTimer_Start(ptrPdStackContext->ptrTimerContext, ptrPdStackContext, 
-                            CY_APP_GET_TIMER_ID(ptrPdStackContext, CY_APP_FET_SOFT_START_TIMER_ID), 5, ocp_handler_wrapper);
+            if (glAppSoftStartProfileRun[context->port])
+            {
+                /* Lower the drive strength; the profile timer decides on the next step after a delay. */
+                Cy_USBPD_Vbus_NgdoSetDriveStrength(context, CY_APP_SOFT_START_TRIP_DRIVE);
+                glAppSoftStartTrips[context->port]++;
+                glAppSoftStartDwell[context->port] = 0u;
+                glAppSoftStartTripHold[context->port] = true;
+            }
+            else
+            {
+                Cy_USBPD_Vbus_NgdoSetDriveStrength(context, 0x02); 
+                
+                /* Schedule a timer which will increase the drive strength after a delay. */
+                Cy_PdUtils_SwTimer_Start(ptrPdStackContext->ptrTimerContext, ptrPdStackContext, 
+                                CY_APP_GET_TIMER_ID(ptrPdStackContext, CY_APP_FET_SOFT_START_TIMER_ID), 5, ocp_handler_wrapper);
+            }
         }
         else
 #endif /* VBUS_SOFT_START_ENABLE */
@@ -602,6 +1008,129 @@ void psrc_select_voltage(cy_stc_pdstack_context_t *context)
 #endif /* PMG1_PD_DUALPORT_ENABLE */
 }
 
+#if CY_APP_FRS_RX_FAST_PATH_ENABLE
+/* Source path of each port is prepared for a fast role swap */
+static volatile bool glAppFrsArmed[NO_OF_TYPEC_PORTS];
+
+/* ADC level below which VBUS is within vSafe5V, computed when the port is armed */
+static uint8_t glAppFrsVsafe5vLevel[NO_OF_TYPEC_PORTS];
+
+#if VBUS_OCP_ENABLE
+/* OCP limit in 10 mA units for the current the partner requires after the swap */
+static uint32_t glAppFrsOcpCur[NO_OF_TYPEC_PORTS];
+#endif /* VBUS_OCP_ENABLE */
+
+extern cy_en_usbpd_adc_id_t glAppVbusPollAdcId[NO_OF_TYPEC_PORTS];
+extern cy_en_usbpd_adc_input_t glAppVbusPollAdcInput[NO_OF_TYPEC_PORTS];
+
+/* Check whether the old source has let VBUS fall to vSafe5V */
+static bool frs_vbus_is_safe(cy_stc_pdstack_context_t *context)
+{
+    uint8_t port = context->port;
+
+#if CY_APP_ADC_SCHED_ENABLE
+    /* The ADC is configured for another request; try again on the next poll */
+    if (Cy_App_AdcSched_IsBusy(context))
+    {
+        return false;
+    }
+#endif /* CY_APP_ADC_SCHED_ENABLE */
+
+    /* The comparator output is set while VBUS is above the level */
+    return (!Cy_USBPD_Adc_CompSample(context->ptrUsbPdContext, glAppVbusPollAdcId[port],
+                glAppVbusPollAdcInput[port], glAppFrsVsafe5vLevel[port]));
+}
+
+void Cy_App_Source_FrsArm(cy_stc_pdstack_context_t *context, bool arm)
+{
+    uint8_t port = context->port;
+#if VBUS_OCP_ENABLE
+    uint8_t frs_cur;
+#endif /* VBUS_OCP_ENABLE */
+
+    if ((arm) && (!glAppFrsArmed[port]))
+    {
+        /*
+         * Only compute the comparator level and the OCP limit here. The
+         * regulator is left alone while the port is still a sink.
+         */
+        Cy_USBPD_Adc_Calibrate(context->ptrUsbPdContext, glAppVbusPollAdcId[port]);
+        glAppFrsVsafe5vLevel[port] = Cy_USBPD_Adc_GetVbusLevel(context->ptrUsbPdContext,
+                glAppVbusPollAdcId[port], CY_PD_VSAFE_5V, CY_APP_FRS_VSAFE5V_MARGIN);
+
+#if VBUS_OCP_ENABLE
+        /* FR_Swap field of the sink PDO: 1 = default USB power, 2 = 1.5 A, 3 = 3 A */
+        frs_cur = context->dpmStat.curSnkPdo[0].fixed_snk.frSwap;
+        glAppFrsOcpCur[port] = cc_rp_to_cur_map[(frs_cur > 0u) ? (frs_cur - 1u) : 0u];
+#endif /* VBUS_OCP_ENABLE */
+    }
+
+    glAppFrsArmed[port] = arm;
+}
+
+bool Cy_App_Source_FrsOn(cy_stc_pdstack_context_t *context)
+{
+    cy_stc_app_status_t *app_stat = Cy_App_GetStatus(context->port);
+    uint32_t intr_state;
+
+    intr_state = Cy_SysLib_EnterCriticalSection();
+
+    /* The new source may only drive VBUS once the old one has let it fall to vSafe5V */
+    if ((!glAppFrsArmed[context->port]) || (app_stat->is_vbus_on) || (!frs_vbus_is_safe(context)))
+    {
+        Cy_SysLib_ExitCriticalSection(intr_state);
+        return false;
+    }
+
+    glAppFrsArmed[context->port] = false;
+    app_stat->is_vbus_on = true;
+
+    app_stat->psrc_volt = CY_PD_VSAFE_5V;
+    app_stat->psrc_volt_old = CY_PD_VSAFE_5V;
+    psrc_select_voltage(context);
+
+    /* Protect the provider path before it carries any current */
+#if VBUS_OVP_ENABLE
+    Cy_App_Fault_OvpEnable(context, CY_PD_VSAFE_5V, CCG_SRC_FET, app_psrc_vbus_ovp_cbk);
+#endif /* VBUS_OVP_ENABLE */
+
+#if VBUS_OCP_ENABLE
+    Cy_App_Fault_OcpEnable(context, glAppFrsOcpCur[context->port], app_psrc_vbus_ocp_cbk);
+#endif /* VBUS_OCP_ENABLE */
+
+#if VBUS_SCP_ENABLE
+    Cy_App_Fault_ScpEnable(context, 1000, app_psrc_vbus_scp_cbk);
+#endif /* VBUS_SCP_ENABLE */
+
+    /* Same sequence as vbus_fet_on, without soft start and with the full gate drive at once */
+#if (!(CY_APP_REGULATOR_REQUIRE_STABLE_ON_TIME))
+    Cy_USBPD_Vbus_GdrvCfetOff(context->ptrUsbPdContext, false);
+    Cy_SysLib_DelayUs(10);
+#endif /* (!(CY_APP_REGULATOR_REQUIRE_STABLE_ON_TIME)) */
+
+#if defined(CY_DEVICE_CCG3PA)
+    Cy_USBPD_Vbus_GdrvPfetOn(context->ptrUsbPdContext, CY_APP_VBUS_P_FET_CTRL);
+#else
+    Cy_USBPD_Vbus_GdrvPfetOn(context->ptrUsbPdContext, true);
+#endif /* defined(CY_DEVICE_CCG3PA) */
+
+#if (defined(CY_DEVICE_PMG1S3) && (!CY_PD_SINK_ONLY))
+    Cy_USBPD_Vbus_NgdoG1Ctrl(context->ptrUsbPdContext, true);
+#endif /* (defined(CY_DEVICE_PMG1S3) && (!CY_PD_SINK_ONLY)) */
+
+    Cy_SysLib_ExitCriticalSection(intr_state);
+
+    soln_vbus_fet_on(context);
+
+    return true;
+}
+
+bool Cy_App_Source_FrsIsArmed(cy_stc_pdstack_context_t *context)
+{
+    return glAppFrsArmed[context->port];
+}
+#endif /* CY_APP_FRS_RX_FAST_PATH_ENABLE */
+
 void Cy_App_Source_SetVoltage(cy_stc_pdstack_context_t * context, uint16_t volt_mV)
 {
     uint8_t port = context->port;
@@ -656,44 +1185,25 @@ void Cy_App_Source_SetCurrent (cy_stc_pdstack_context_t *context, uint16_t cur_1
     /* Update the OCP/SCP thresholds when required. */
     const cy_stc_pdstack_dpm_status_t *dpm_stat = &context->dpmStat;
     cy_stc_pd_dpm_config_t *dpm_config = &context->dpmConfig;
+    /* SPR AVS current limit depends on whether the contract voltage is above 15 V. */
+    bool above_15v = (dpm_stat->srcRdo.rdo_spr_avs.outVolt > (CY_PD_VSAFE_15V / 25U));
     uint32_t ocp_cur;
+#if CY_APP_PROT_THRESHOLD_CACHE_ENABLE
+    const cy_stc_app_prot_threshold_t *threshold;
+#endif /* CY_APP_PROT_THRESHOLD_CACHE_ENABLE */
 
     if (dpm_config->contractExist)
     {
-        switch(dpm_stat->srcSelPdo.src_gen.supplyType)
+#if CY_APP_PROT_THRESHOLD_CACHE_ENABLE
+        threshold = prot_threshold_get(context);
+        if (threshold != NULL)
         {
-            case CY_PDSTACK_PDO_FIXED_SUPPLY:
-            case CY_PDSTACK_PDO_VARIABLE_SUPPLY:
-                ocp_cur = dpm_stat->srcSelPdo.src_gen.maxCurPower;
-                break;
-            case CY_PDSTACK_PDO_AUGMENTED:
-                if(dpm_stat->srcSelPdo.pps_src.apdoType == CY_PDSTACK_APDO_AVS)
-                {
-                    /* PDP value is in 1W units and the max volt is in 100 mV units. Convert pdp in 100 mW units
-                     * and divide by voltage gives the current in amps then multiplied by 100 to convert in 10 mA units. */  
-                    ocp_cur = ((dpm_stat->srcSelPdo.epr_avs_src.pdp * 10) / dpm_stat->srcSelPdo.epr_avs_src.maxVolt) * 100;
-                }
-                else if(dpm_stat->srcSelPdo.spr_avs_src.apdoType == CY_PDSTACK_APDO_SPR_AVS)
-                {
-                    /* Set the current limit based on the contract voltage. */
-                    if(dpm_stat->srcRdo.rdo_spr_avs.outVolt <= (CY_PD_VSAFE_15V / 25U))
-                    {
-                        ocp_cur = dpm_stat->srcSelPdo.spr_avs_src.maxCur1;
-                    }
-                    else
-                    {
-                        ocp_cur = dpm_stat->srcSelPdo.spr_avs_src.maxCur2;
-                    }
-                }
-                else
-                {
-                    /* Max current in PPS PDO is in 50 mA units, multiplied by 5 to convert in 10 mA units. */
-                    ocp_cur = dpm_stat->srcSelPdo.pps_src.maxCur * 5;
-                }
-                break;
-            default:
-                ocp_cur = dpm_stat->srcSelPdo.src_gen.maxCurPower;
-                break;
+            ocp_cur = threshold->ocpCur[above_15v ? 1u : 0u];
+        }
+        else
+#endif /* CY_APP_PROT_THRESHOLD_CACHE_ENABLE */
+        {
+            ocp_cur = psrc_pdo_ocp_cur(dpm_stat->srcSelPdo, above_15v);
         }
     }
     else
@@ -768,8 +1278,16 @@ void Cy_App_Source_Enable (cy_stc_pdstack_context_t * context,
             {
                 app_stat->psrc_rising = false;
                 Cy_App_VbusDischargeOn(context);
+#if CY_APP_VBUS_DISCHARGE_CTRL_ENABLE
+                Cy_App_VbusDischargeCtrl_Start(context, app_stat->psrc_volt, CY_APP_VBUS_DISCHARGE_MARGIN,
+                        CY_APP_PSOURCE_EN_MONITOR_TIMER_PERIOD);
+#endif /* CY_APP_VBUS_DISCHARGE_CTRL_ENABLE */
             }
             app_stat->pwr_ready_cbk = pwr_ready_handler;
+#if CY_APP_VBUS_RAMP_MONITOR_ENABLE
+            glAppPsrcRampCount[context->port] = 0u;
+            glAppPsrcRampCheck[context->port] = false;
+#endif /* CY_APP_VBUS_RAMP_MONITOR_ENABLE */
 
             /* Start power source enable and monitor timers */
 #if CY_PD_EPR_ENABLE
@@ -860,6 +1378,10 @@ void Cy_App_Source_Disable(cy_stc_pdstack_context_t * context, cy_pdstack_pwr_re
     {
         /* Turn on discharge to get the voltage to drop faster */
         Cy_App_VbusDischargeOn(context);
+#if CY_APP_VBUS_DISCHARGE_CTRL_ENABLE
+        Cy_App_VbusDischargeCtrl_Start(context, CY_PD_VSAFE_0V, CY_APP_VBUS_TURN_ON_MARGIN,
+                CY_APP_PSOURCE_DIS_MONITOR_TIMER_PERIOD);
+#endif /* CY_APP_VBUS_DISCHARGE_CTRL_ENABLE */
         app_stat->pwr_ready_cbk = pwr_ready_handler;
 #if(CY_PD_EPR_ENABLE)
         bool isActive = true;
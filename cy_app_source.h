@@ -28,6 +28,7 @@
 #include "cy_pdutils_sw_timer.h"
 #include "cy_pdstack_timer_id.h"
 #include "cy_usbpd_vbus_ctrl.h"
+#include "cy_app_status.h"
 
 /**
 * \addtogroup group_pmg_app_common_psrc
@@ -56,11 +57,70 @@
 * 3. Register the application callback to the PDStack middleware library.
 *    See the \ref section_pmg_app_common_quick_start section.
 *
+* When VBUS_SOFT_START_ENABLE is set and a soft-start profile has been set
+* with Cy_App_Source_SetSoftStartProfile, the provider FET is turned on
+* following the profile. Each step of the profile applies an NGDO drive
+* strength for a dwell time, with OCP either masked or set to
+* CY_APP_SOFT_START_OCP_CUR. A step can end early once VBUS reaches a given
+* share of the target voltage. An OCP trip lowers the drive strength to
+* CY_APP_SOFT_START_TRIP_DRIVE for CY_APP_SOFT_START_TRIP_DWELL ms before the
+* next step. The time VBUS took to reach the target is recorded on every
+* turn-on with a profile. Without a profile, the single fixed soft-start step
+* is used.
+*
+* \defgroup group_pmg_app_common_psrc_data_structures Data structures
 * \defgroup group_pmg_app_common_psrc_functions Functions
 */
 
 /** \} group_pmg_app_common_psrc */
 
+#if (VBUS_SOFT_START_ENABLE || DOXYGEN)
+/**
+* \addtogroup group_pmg_app_common_psrc_data_structures
+* \{
+*/
+
+/**
+ * @brief One step of a VBUS soft-start profile
+ */
+typedef struct
+{
+    uint8_t driveStrength;              /**< NGDO drive strength applied in the step. */
+    uint8_t dwell;                      /**< Duration of the step in ms. */
+    bool ocpMask;                       /**< true to mask OCP during the step. */
+    uint8_t vbusPercent;                /**< The step ends early once VBUS reaches this percentage of the target voltage; 0 to always run the full dwell time. */
+} cy_stc_app_soft_start_step_t;
+
+/** \} group_pmg_app_common_psrc_data_structures */
+#endif /* (VBUS_SOFT_START_ENABLE || DOXYGEN) */
+
+#if ((CY_APP_PROT_THRESHOLD_CACHE_ENABLE && VBUS_OCP_ENABLE) || DOXYGEN)
+/**
+* \addtogroup group_pmg_app_common_psrc_data_structures
+* \{
+*/
+
+/**
+ * @brief Protection thresholds of one source PDO
+ */
+typedef struct
+{
+    uint32_t pdo;                       /**< Source PDO the thresholds were derived from. */
+    uint16_t ocpCur[2];                 /**< OCP current in 10 mA units for contract voltages up to and above 15 V. */
+} cy_stc_app_prot_threshold_t;
+
+/**
+ * @brief Protection thresholds of the source PDOs advertised on a port, indexed by object position - 1.
+ */
+typedef struct
+{
+    cy_stc_app_prot_threshold_t entry[CY_PD_MAX_NO_OF_PDO];     /**< Thresholds of each source PDO. */
+    uint8_t count;                      /**< Number of source PDOs the table was built for. */
+} cy_stc_app_prot_threshold_table_t;
+
+/** \} group_pmg_app_common_psrc_data_structures */
+#endif /* ((CY_APP_PROT_THRESHOLD_CACHE_ENABLE && VBUS_OCP_ENABLE) || DOXYGEN) */
+
 /**
 * \addtogroup group_pmg_app_common_psrc_functions
 * \{
@@ -132,6 +192,72 @@ void Cy_App_Source_Enable (cy_stc_pdstack_context_t * context,
  */
 void Cy_App_Source_Disable(cy_stc_pdstack_context_t * context, cy_pdstack_pwr_ready_cbk_t pwr_ready_handler);
 
+#if (CY_APP_FRS_RX_FAST_PATH_ENABLE || DOXYGEN)
+/**
+ * @brief Prepares the source path of the port for a fast role swap, or
+ * releases it. Arming computes the vSafe5V comparator level and the OCP limit
+ * for the swap; the regulator is not touched while the port is a sink.
+ *
+ * @param context Pointer to the PDStack context
+ * @param arm true to arm; false to disarm
+ *
+ * @return None
+ */
+void Cy_App_Source_FrsArm(cy_stc_pdstack_context_t *context, bool arm);
+
+/**
+ * @brief Switches the port from the consumer to the provider FET on a fast
+ * role swap signal. Can be called from interrupt context. The FET is only
+ * turned on once VBUS is at or below vSafe5V; vSafe5V is selected and OVP,
+ * OCP and SCP are enabled before that. The port is disarmed. A later
+ * Cy_App_Source_Enable call from the PD stack finds the FET on and only
+ * starts the supply monitoring.
+ *
+ * @param context Pointer to the PDStack context
+ *
+ * @return true if the provider FET has been turned on; false if the port is
+ * not armed, the provider FET is already on or VBUS is still above vSafe5V.
+ */
+bool Cy_App_Source_FrsOn(cy_stc_pdstack_context_t *context);
+
+/**
+ * @brief Checks whether the source path of the port is armed for a fast role
+ * swap.
+ *
+ * @param context Pointer to the PDStack context
+ *
+ * @return true if the port is armed; false otherwise.
+ */
+bool Cy_App_Source_FrsIsArmed(cy_stc_pdstack_context_t *context);
+#endif /* (CY_APP_FRS_RX_FAST_PATH_ENABLE || DOXYGEN) */
+
+#if (VBUS_SOFT_START_ENABLE || DOXYGEN)
+/**
+ * @brief Sets the soft-start profile of the port. The steps are copied and
+ * used from the next provider FET turn-on.
+ *
+ * @param context Pointer to the PDStack context
+ * @param steps Profile steps
+ * @param count Number of steps; 0 to restore the fixed soft-start step
+ *
+ * @return CY_APP_STAT_SUCCESS if the profile is set; CY_APP_STAT_BAD_PARAM if
+ * the profile is invalid; CY_APP_STAT_BUSY if a soft start is in progress.
+ */
+cy_en_app_status_t Cy_App_Source_SetSoftStartProfile(cy_stc_pdstack_context_t *context,
+        const cy_stc_app_soft_start_step_t *steps, uint8_t count);
+
+/**
+ * @brief Returns the time VBUS took to get within the valid window of the
+ * target voltage after the last provider FET turn-on. The time is only
+ * recorded while a soft-start profile is set.
+ *
+ * @param context Pointer to the PDStack context
+ *
+ * @return Ramp time in ms; 0 if VBUS has not reached the target.
+ */
+uint16_t Cy_App_Source_GetSoftStartRampTime(cy_stc_pdstack_context_t *context);
+#endif /* (VBUS_SOFT_START_ENABLE || DOXYGEN) */
+
 /** \} group_pmg_app_common_psrc_functions */
 
 #endif /* _CY_APP_SOURCE_H_ */
@@ -18,6 +18,13 @@
 #include "cy_app_config.h"
 #include "cy_app_swap.h"
 #include "cy_app.h"
+#if CY_APP_FRS_RX_FAST_PATH_ENABLE
+#include "cy_app_source.h"
+#include "cy_app_coroutine.h"
+#include "cy_app_timer_id.h"
+#include "cy_pdutils.h"
+#include "cy_pdutils_sw_timer.h"
+#endif /* CY_APP_FRS_RX_FAST_PATH_ENABLE */
 
 #if (DFP_ALT_MODE_SUPP || UFP_ALT_MODE_SUPP)
 #include "cy_pdaltmode_mngr.h"
@@ -249,5 +256,173 @@ void Cy_App_Swap_EvalFrSwap (cy_stc_pdstack_context_t* context, cy_pdstack_app_r
 #endif /* (CY_PD_REV3_ENABLE && CY_PD_FRS_TX_ENABLE) */
 #endif /* ((!CY_PD_SOURCE_ONLY) && (!CY_PD_SINK_ONLY)) */
 
+#if CY_APP_FRS_RX_FAST_PATH_ENABLE
+#if (!CY_APP_TIMESTAMP_ENABLE)
+#error "CY_APP_FRS_RX_FAST_PATH_ENABLE requires CY_APP_TIMESTAMP_ENABLE to measure the swap latency."
+#endif
+
+/* Swaps which take this many ms or longer are beyond the range of the time stamp or of the latency. */
+#define FRS_LATENCY_MAX_MS      ((CY_PDUTILS_GET_MIN(CY_APP_TIMESTAMP_MASK, 0xFFFFu) / 1000u) - 1u)
+
+/* Fast role swap statistics of each port */
+static cy_stc_app_frs_stats_t glAppFrsStats[NO_OF_TYPEC_PORTS];
+
+/* Time stamp of the last FRS signal of each port */
+static uint32_t glAppFrsSignalTime[NO_OF_TYPEC_PORTS];
+
+/* PHY callback of the PD stack, which the FRS signal is passed on to */
+static cy_usbpd_phy_cbk_t glAppFrsPhyCbk[NO_OF_TYPEC_PORTS];
+
+static void frs_latency_timer_cb(cy_timer_id_t id, void *callbackCtx)
+{
+    cy_stc_pdstack_context_t *context = (cy_stc_pdstack_context_t *)callbackCtx;
+
+    (void)id;
+
+    glAppFrsStats[context->port].timeoutCount++;
+}
+
+/* The port is a sink at vSafe5V which asks the partner to support a fast role swap */
+static bool frs_is_capable(cy_stc_pdstack_context_t * context)
+{
+    return ((context->dpmConfig.contractExist) &&
+            (context->dpmConfig.curPortRole == CY_PD_PRT_ROLE_SINK) &&
+            (Cy_App_GetStatus(context->port)->psnk_volt == CY_PD_VSAFE_5V) &&
+            (context->dpmStat.curSnkPdo[0].fixed_snk.frSwap != 0u));
+}
+
+/* Poll for VBUS to fall to vSafe5V when it was still above on the FRS signal */
+static uint8_t glAppFrsPollCount[NO_OF_TYPEC_PORTS];
+
+static cy_en_app_coro_status_t frs_vbus_wait(cy_stc_pdstack_context_t *context, cy_stc_app_coro_t *coro)
+{
+    CY_APP_CORO_BEGIN(coro);
+
+    glAppFrsPollCount[context->port] = 0u;
+    while ((Cy_App_Source_FrsIsArmed(context)) &&
+            (glAppFrsPollCount[context->port] < CY_APP_FRS_VSAFE5V_POLL_COUNT))
+    {
+        CY_APP_CORO_WAIT_MS(coro, 1u);
+
+        if (Cy_App_Source_FrsOn(context))
+        {
+            glAppFrsStats[context->port].fastCount++;
+            CY_APP_CORO_EXIT(coro);
+        }
+        glAppFrsPollCount[context->port]++;
+    }
+
+    CY_APP_CORO_END(coro);
+}
+
+void Cy_App_Swap_FrsEventHandler(cy_stc_pdstack_context_t * context, cy_en_pdstack_app_evt_t evt)
+{
+    cy_stc_app_frs_stats_t *stats = &glAppFrsStats[context->port];
+    cy_timer_id_t timer_id = CY_APP_GET_TIMER_ID(context, CY_APP_FRS_LATENCY_TIMER);
+    uint32_t latency;
+
+    switch (evt)
+    {
+        case APP_EVT_PD_CONTRACT_NEGOTIATION_COMPLETE:
+            Cy_App_Source_FrsArm(context, frs_is_capable(context));
+            break;
+
+        case APP_EVT_FR_SWAP_COMPLETE:
+            if (Cy_PdUtils_SwTimer_IsRunning(context->ptrTimerContext, timer_id))
+            {
+                /* The timer tells whether the time stamp may have wrapped since the signal. */
+                latency = CY_APP_FRS_LATENCY_TIMEOUT -
+                    Cy_PdUtils_SwTimer_GetCount(context->ptrTimerContext, timer_id);
+                Cy_PdUtils_SwTimer_Stop(context->ptrTimerContext, timer_id);
+
+                if (latency < FRS_LATENCY_MAX_MS)
+                {
+                    latency = CY_PDUTILS_GET_MIN(CY_APP_TIMESTAMP_DIFF(glAppFrsSignalTime[context->port],
+                                Cy_App_GetTimestamp()), 0xFFFFu);
+                }
+                else
+                {
+                    latency = 0xFFFFu;
+                }
+
+                stats->lastLatency = (uint16_t)latency;
+                stats->maxLatency = CY_PDUTILS_GET_MAX(stats->maxLatency, (uint16_t)latency);
+            }
+            Cy_App_Coro_Stop(context, CY_APP_CORO_FRS_VBUS);
+            Cy_App_Source_FrsArm(context, false);
+            break;
+
+        case APP_EVT_DISCONNECT:
+        case APP_EVT_TYPE_C_ERROR_RECOVERY:
+        case APP_EVT_HARD_RESET_RCVD:
+        case APP_EVT_HARD_RESET_SENT:
+        case APP_EVT_PR_SWAP_COMPLETE:
+            Cy_App_Coro_Stop(context, CY_APP_CORO_FRS_VBUS);
+            Cy_App_Source_FrsArm(context, false);
+            break;
+
+        default:
+            /* Nothing to do */
+            break;
+    }
+}
+
+void Cy_App_Swap_FrsSignalHandler(cy_stc_pdstack_context_t * context)
+{
+    cy_stc_app_frs_stats_t *stats = &glAppFrsStats[context->port];
+    uint32_t signal_time = Cy_App_GetTimestamp();
+
+    /* Switch the power path first; everything else can wait */
+    if (Cy_App_Source_FrsOn(context))
+    {
+        stats->fastCount++;
+    }
+    else if (Cy_App_Source_FrsIsArmed(context))
+    {
+        /* VBUS is still above vSafe5V */
+        Cy_App_Coro_Start(context, CY_APP_CORO_FRS_VBUS, frs_vbus_wait, 0u);
+    }
+    else
+    {
+        /* Nothing to do */
+    }
+
+    stats->signalCount++;
+    glAppFrsSignalTime[context->port] = signal_time;
+    Cy_PdUtils_SwTimer_Start(context->ptrTimerContext, context,
+            CY_APP_GET_TIMER_ID(context, CY_APP_FRS_LATENCY_TIMER),
+            CY_APP_FRS_LATENCY_TIMEOUT, frs_latency_timer_cb);
+}
+
+/* Runs the fast path in the FRS signal interrupt before the PD stack handles the signal */
+static void frs_phy_cbk(void *callbackCtx, uint32_t event)
+{
+    cy_stc_usbpd_context_t *usbpd_ctx = (cy_stc_usbpd_context_t *)callbackCtx;
+
+    if (event == (uint32_t)CY_USBPD_PHY_EVT_FRS_SIG_RCVD)
+    {
+        Cy_App_Swap_FrsSignalHandler((cy_stc_pdstack_context_t *)usbpd_ctx->pdStackContext);
+    }
+
+    glAppFrsPhyCbk[usbpd_ctx->port](callbackCtx, event);
+}
+
+void Cy_App_Swap_FrsInit(cy_stc_pdstack_context_t * context)
+{
+    cy_stc_usbpd_context_t *usbpd_ctx = context->ptrUsbPdContext;
+
+    if ((usbpd_ctx->pdPhyCbk != NULL) && (usbpd_ctx->pdPhyCbk != frs_phy_cbk))
+    {
+        glAppFrsPhyCbk[context->port] = usbpd_ctx->pdPhyCbk;
+        usbpd_ctx->pdPhyCbk = frs_phy_cbk;
+    }
+}
+
+const cy_stc_app_frs_stats_t* Cy_App_Swap_FrsGetStats(cy_stc_pdstack_context_t * context)
+{
+    return &glAppFrsStats[context->port];
+}
+#endif /* CY_APP_FRS_RX_FAST_PATH_ENABLE */
+
 /* [] END OF FILE */
 
@@ -51,11 +51,56 @@
 * 3. Register the application callback to the PdStack middleware library.
 *    Refer to the \ref section_pmg_app_common_quick_start section.
 *
+* When CY_APP_FRS_RX_FAST_PATH_ENABLE is set, the source path of a sink port
+* is armed while it has a 5 V contract and its sink capabilities request fast
+* role swap support from the partner. Cy_App_Swap_FrsInit, called from
+* Cy_App_Init, places Cy_App_Swap_FrsSignalHandler in front of the PHY
+* callback of the PD stack. On the FRS signal interrupt it turns the provider
+* FET on as soon as VBUS is at or below vSafe5V, before the PD stack processes
+* the swap. The time from the signal to the completion of the swap is measured
+* in us with Cy_App_GetTimestamp and can be read with Cy_App_Swap_FrsGetStats.
+* The fast path requires CY_APP_TIMESTAMP_ENABLE.
 *
+* \defgroup group_pmg_app_common_swap_macros Macros
+* \defgroup group_pmg_app_common_swap_data_structures Data structures
 * \defgroup group_pmg_app_common_swap_functions Functions
 */
 /** \} group_pmg_app_common_swap */
 
+#if (CY_APP_FRS_RX_FAST_PATH_ENABLE || DOXYGEN)
+/**
+* \addtogroup group_pmg_app_common_swap_macros
+* \{
+*/
+
+#ifndef CY_APP_FRS_LATENCY_TIMEOUT
+/** Time in ms after the FRS signal after which the swap is counted as not completed. */
+#define CY_APP_FRS_LATENCY_TIMEOUT              (1000u)
+#endif /* CY_APP_FRS_LATENCY_TIMEOUT */
+
+/** \} group_pmg_app_common_swap_macros */
+
+/**
+* \addtogroup group_pmg_app_common_swap_data_structures
+* \{
+*/
+
+/**
+ * @brief Fast role swap statistics of a port
+ */
+typedef struct
+{
+    uint16_t signalCount;               /**< Number of FRS signals received. */
+    uint16_t fastCount;                 /**< Number of signals on which the provider FET was turned on at once. */
+    uint16_t timeoutCount;              /**< Number of signals not followed by a completed swap in time. */
+    uint16_t lastLatency;               /**< Time in us from the signal to the completion of the last swap;
+                                             0xFFFF if it took longer. */
+    uint16_t maxLatency;                /**< Maximum time in us from the signal to the completion of a swap. */
+} cy_stc_app_frs_stats_t;
+
+/** \} group_pmg_app_common_swap_data_structures */
+#endif /* (CY_APP_FRS_RX_FAST_PATH_ENABLE || DOXYGEN) */
+
 
 /**
 * \addtogroup group_pmg_app_common_swap_functions
@@ -108,6 +153,49 @@ void Cy_App_Swap_EvalFrSwap(cy_stc_pdstack_context_t * context, cy_pdstack_app_r
 
 #endif /* (CY_PD_REV3_ENABLE || DOXYGEN) */ 
 
+#if (CY_APP_FRS_RX_FAST_PATH_ENABLE || DOXYGEN)
+/**
+ * @brief Arms and disarms the FRS fast path of the port from a PD event, and
+ * completes the latency measurement. Called from Cy_App_EventHandler.
+ *
+ * @param context Pointer to the PDStack context
+ * @param evt Event that is being notified
+ *
+ * @return None
+ */
+void Cy_App_Swap_FrsEventHandler(cy_stc_pdstack_context_t * context, cy_en_pdstack_app_evt_t evt);
+
+/**
+ * @brief Hooks the FRS fast path into the PHY callback of the PD stack, so
+ * that Cy_App_Swap_FrsSignalHandler runs in the FRS signal interrupt. Has to
+ * be called after the PD stack has been initialized. Called from Cy_App_Init.
+ *
+ * @param context Pointer to the PDStack context
+ *
+ * @return None
+ */
+void Cy_App_Swap_FrsInit(cy_stc_pdstack_context_t * context);
+
+/**
+ * @brief Handles an FRS signal received from the partner. Called from the FRS
+ * signal interrupt, ahead of the PD stack processing.
+ *
+ * @param context Pointer to the PDStack context
+ *
+ * @return None
+ */
+void Cy_App_Swap_FrsSignalHandler(cy_stc_pdstack_context_t * context);
+
+/**
+ * @brief Returns the fast role swap statistics of the port.
+ *
+ * @param context Pointer to the PDStack context
+ *
+ * @return Pointer to the statistics.
+ */
+const cy_stc_app_frs_stats_t* Cy_App_Swap_FrsGetStats(cy_stc_pdstack_context_t * context);
+#endif /* (CY_APP_FRS_RX_FAST_PATH_ENABLE || DOXYGEN) */
+
 /** \} group_pmg_app_common_swap_functions */
 
 #endif /* _CY_APP_SWAP_H_ */
@@ -0,0 +1,243 @@
+/***************************************************************************//**
+* \file cy_app_telemetry.c
+* \version 2.0
+*
+* \brief
+* Implements the per-port VBUS and IBUS telemetry sampler
+*
+********************************************************************************
+* \copyright
+* Copyright 2024, Cypress Semiconductor Corporation (an Infineon company)
+* or an affiliate of Cypress Semiconductor Corporation. All rights reserved.
+* You may use this file only in accordance with the license, terms, conditions,
+* disclaimers, and limitations in the end user license agreement accompanying
+* the software package with which this file was provided.
+*******************************************************************************/
+
+#include <string.h>
+#include "cybsp.h"
+#include "cy_app_config.h"
+#include "cy_app.h"
+#include "cy_app_telemetry.h"
+#include "cy_app_coroutine.h"
+#if CY_APP_ADC_SCHED_ENABLE
+#include "cy_app_adc_sched.h"
+#endif /* CY_APP_ADC_SCHED_ENABLE */
+
+#include "cy_pdstack_dpm.h"
+#include "cy_pdutils.h"
+#include "cy_usbpd_vbus_ctrl.h"
+
+#if CY_APP_TELEMETRY_ENABLE
+
+/* Energy in uJ that makes up 1 mWh */
+#define TELEMETRY_UJ_PER_MWH            (3600000u)
+
+/* Telemetry state of each port */
+static cy_stc_app_telemetry_t glAppTelemetry[NO_OF_TYPEC_PORTS];
+
+/* Starts a new set of statistics; the ring keeps the samples of the previous contract */
+static void telemetry_reset_stats(cy_stc_app_telemetry_t *tel)
+{
+    memset(&tel->stats, 0, sizeof(cy_stc_app_telemetry_stats_t));
+    tel->vbusAcc   = 0u;
+    tel->ibusAcc   = 0u;
+    tel->energyRem = 0u;
+}
+
+static void telemetry_add_sample(cy_stc_app_telemetry_t *tel, uint16_t vbus, uint16_t ibus)
+{
+    cy_stc_app_telemetry_stats_t *stats = &tel->stats;
+    uint32_t energy;
+
+    tel->ring[tel->ringIdx].vbus = vbus;
+    tel->ring[tel->ringIdx].ibus = ibus;
+    tel->ringIdx = (uint8_t)((tel->ringIdx + 1u) % CY_APP_TELEMETRY_RING_SIZE);
+    if (tel->ringCount < CY_APP_TELEMETRY_RING_SIZE)
+    {
+        tel->ringCount++;
+    }
+
+    if (stats->count == 0u)
+    {
+        /* Seed the averages with the first sample of the contract */
+        stats->vbusMin = vbus;
+        stats->vbusMax = vbus;
+        stats->ibusMin = ibus;
+        stats->ibusMax = ibus;
+        tel->vbusAcc   = (uint32_t)vbus << CY_APP_TELEMETRY_EWMA_SHIFT;
+        tel->ibusAcc   = (uint32_t)ibus << CY_APP_TELEMETRY_EWMA_SHIFT;
+    }
+    else
+    {
+        stats->vbusMin = CY_PDUTILS_GET_MIN(stats->vbusMin, vbus);
+        stats->vbusMax = CY_PDUTILS_GET_MAX(stats->vbusMax, vbus);
+        stats->ibusMin = CY_PDUTILS_GET_MIN(stats->ibusMin, ibus);
+        stats->ibusMax = CY_PDUTILS_GET_MAX(stats->ibusMax, ibus);
+        tel->vbusAcc   = tel->vbusAcc - (tel->vbusAcc >> CY_APP_TELEMETRY_EWMA_SHIFT) + vbus;
+        tel->ibusAcc   = tel->ibusAcc - (tel->ibusAcc >> CY_APP_TELEMETRY_EWMA_SHIFT) + ibus;
+    }
+
+    stats->vbusAvg = (uint16_t)(tel->vbusAcc >> CY_APP_TELEMETRY_EWMA_SHIFT);
+    stats->ibusAvg = (uint16_t)(tel->ibusAcc >> CY_APP_TELEMETRY_EWMA_SHIFT);
+
+    if (stats->count < UINT32_MAX)
+    {
+        stats->count++;
+    }
+
+    /* mV * 10 mA / 100 gives mW; mW * ms gives uJ */
+    energy = (((uint32_t)vbus * ibus) / 100u) * CY_APP_TELEMETRY_PERIOD;
+    tel->energyRem += energy;
+    while (tel->energyRem >= TELEMETRY_UJ_PER_MWH)
+    {
+        tel->energyRem -= TELEMETRY_UJ_PER_MWH;
+        stats->energy++;
+    }
+}
+
+static void telemetry_sample(cy_stc_pdstack_context_t *ptrPdStackContext)
+{
+    uint16_t ibus = 0u;
+
+#if CY_APP_ADC_SCHED_ENABLE
+    /* The ADC reference may be switched for a scheduled measurement; skip this sample */
+    if (Cy_App_AdcSched_IsBusy(ptrPdStackContext))
+    {
+        return;
+    }
+#endif /* CY_APP_ADC_SCHED_ENABLE */
+
+#if CY_APP_TELEMETRY_IBUS_ENABLE
+    ibus = Cy_USBPD_Hal_MeasureCur(ptrPdStackContext->ptrUsbPdContext);
+#endif /* CY_APP_TELEMETRY_IBUS_ENABLE */
+
+    telemetry_add_sample(&glAppTelemetry[ptrPdStackContext->port], Cy_App_VbusGetValue(ptrPdStackContext), ibus);
+}
+
+/* Sampler which runs once each period while the port is attached */
+static cy_en_app_coro_status_t telemetry_sampler(cy_stc_pdstack_context_t *ptrPdStackContext, cy_stc_app_coro_t *coro)
+{
+    CY_APP_CORO_BEGIN(coro);
+
+    for (;;)
+    {
+        CY_APP_CORO_WAIT_MS(coro, CY_APP_TELEMETRY_PERIOD);
+
+        if (!glAppTelemetry[ptrPdStackContext->port].active)
+        {
+            CY_APP_CORO_EXIT(coro);
+        }
+
+        telemetry_sample(ptrPdStackContext);
+    }
+
+    CY_APP_CORO_END(coro);
+}
+
+void Cy_App_Telemetry_EventHandler(cy_stc_pdstack_context_t *ptrPdStackContext, cy_en_pdstack_app_evt_t evt)
+{
+    cy_stc_app_telemetry_t *tel = &glAppTelemetry[ptrPdStackContext->port];
+
+    switch (evt)
+    {
+        case APP_EVT_TYPEC_ATTACH:
+            Cy_App_Telemetry_Clear(ptrPdStackContext);
+            tel->active = true;
+            Cy_App_Coro_Start(ptrPdStackContext, CY_APP_CORO_TELEMETRY, telemetry_sampler, CY_APP_TELEMETRY_PERIOD);
+            break;
+
+        case APP_EVT_DISCONNECT:
+        case APP_EVT_TYPE_C_ERROR_RECOVERY:
+            tel->active = false;
+            Cy_App_Coro_Stop(ptrPdStackContext, CY_APP_CORO_TELEMETRY);
+            break;
+
+        case APP_EVT_PD_CONTRACT_NEGOTIATION_COMPLETE:
+            telemetry_reset_stats(tel);
+            break;
+
+        default:
+            /* Nothing to do */
+            break;
+    }
+}
+
+const cy_stc_app_telemetry_stats_t* Cy_App_Telemetry_GetStats(cy_stc_pdstack_context_t *ptrPdStackContext)
+{
+    return &glAppTelemetry[ptrPdStackContext->port].stats;
+}
+
+uint8_t Cy_App_Telemetry_GetSamples(cy_stc_pdstack_context_t *ptrPdStackContext,
+        cy_stc_app_telemetry_sample_t *samples, uint8_t maxCount)
+{
+    const cy_stc_app_telemetry_t *tel = &glAppTelemetry[ptrPdStackContext->port];
+    uint32_t intr_state;
+    uint8_t count;
+    uint8_t idx;
+    uint8_t slot;
+
+    intr_state = Cy_SysLib_EnterCriticalSection();
+
+    count = CY_PDUTILS_GET_MIN(tel->ringCount, maxCount);
+
+    /* Start with the oldest of the latest count samples */
+    slot = (uint8_t)((tel->ringIdx + CY_APP_TELEMETRY_RING_SIZE - count) % CY_APP_TELEMETRY_RING_SIZE);
+    for (idx = 0u; idx < count; idx++)
+    {
+        samples[idx] = tel->ring[slot];
+        slot = (uint8_t)((slot + 1u) % CY_APP_TELEMETRY_RING_SIZE);
+    }
+
+    Cy_SysLib_ExitCriticalSection(intr_state);
+
+    return count;
+}
+
+void Cy_App_Telemetry_Clear(cy_stc_pdstack_context_t *ptrPdStackContext)
+{
+    cy_stc_app_telemetry_t *tel = &glAppTelemetry[ptrPdStackContext->port];
+    uint32_t intr_state;
+
+    intr_state = Cy_SysLib_EnterCriticalSection();
+
+    telemetry_reset_stats(tel);
+    tel->ringIdx   = 0u;
+    tel->ringCount = 0u;
+
+    Cy_SysLib_ExitCriticalSection(intr_state);
+}
+
+void Cy_App_Telemetry_Sleep(void)
+{
+    cy_stc_pdstack_context_t *ptrPdStackContext;
+    uint8_t port;
+
+    for (port = 0u; port < NO_OF_TYPEC_PORTS; port++)
+    {
+        if (glAppTelemetry[port].active)
+        {
+            ptrPdStackContext = Cy_PdStack_Dpm_GetContext(port);
+            Cy_App_Coro_Stop(ptrPdStackContext, CY_APP_CORO_TELEMETRY);
+        }
+    }
+}
+
+void Cy_App_Telemetry_Resume(void)
+{
+    cy_stc_pdstack_context_t *ptrPdStackContext;
+    uint8_t port;
+
+    for (port = 0u; port < NO_OF_TYPEC_PORTS; port++)
+    {
+        if (glAppTelemetry[port].active)
+        {
+            ptrPdStackContext = Cy_PdStack_Dpm_GetContext(port);
+            Cy_App_Coro_Start(ptrPdStackContext, CY_APP_CORO_TELEMETRY, telemetry_sampler, CY_APP_TELEMETRY_PERIOD);
+        }
+    }
+}
+
+#endif /* CY_APP_TELEMETRY_ENABLE */
+
+/* [] End of file */
@@ -0,0 +1,198 @@
+/***************************************************************************//**
+* \file cy_app_telemetry.h
+* \version 2.0
+*
+* \brief
+* Defines the data structures and function prototypes of the per-port VBUS and
+* IBUS telemetry sampler.
+*
+********************************************************************************
+* \copyright
+* Copyright 2024, Cypress Semiconductor Corporation (an Infineon company)
+* or an affiliate of Cypress Semiconductor Corporation. All rights reserved.
+* You may use this file only in accordance with the license, terms, conditions,
+* disclaimers, and limitations in the end user license agreement accompanying
+* the software package with which this file was provided.
+*******************************************************************************/
+
+#ifndef _CY_APP_TELEMETRY_H_
+#define _CY_APP_TELEMETRY_H_
+
+/*******************************************************************************
+ * Header files including
+ ******************************************************************************/
+#include <stdint.h>
+#include <stdbool.h>
+#include "cy_pdstack_common.h"
+
+#if (CY_APP_TELEMETRY_ENABLE || DOXYGEN)
+
+/**
+* \addtogroup group_pmg_app_common_telemetry
+* \{
+* The telemetry sampler measures VBUS, and IBUS if CY_APP_TELEMETRY_IBUS_ENABLE
+* is set, every CY_APP_TELEMETRY_PERIOD ms while a port partner is attached.
+* The latest samples are kept in a ring. Minimum, maximum and exponentially
+* weighted average values and the delivered energy are accumulated from the
+* start of each contract.
+*
+* Sampling stops while the device is in deep sleep and restarts on wakeup. The
+* energy accumulated does not include the time spent in deep sleep.
+*
+* The statistics can be read with Cy_App_Telemetry_GetStats and
+* Cy_App_Telemetry_GetSamples, or by the EC through the HPI PD response
+* command with ID CY_APP_PD_RESP_ID_TELEMETRY.
+*
+* \defgroup group_pmg_app_common_telemetry_macros Macros
+* \defgroup group_pmg_app_common_telemetry_data_structures Data structures
+* \defgroup group_pmg_app_common_telemetry_functions Functions
+*/
+/** \} group_pmg_app_common_telemetry */
+
+/*****************************************************************************
+ * Macros
+ *****************************************************************************/
+/**
+* \addtogroup group_pmg_app_common_telemetry_macros
+* \{
+*/
+
+#ifndef CY_APP_TELEMETRY_PERIOD
+/** Sampling period in ms. */
+#define CY_APP_TELEMETRY_PERIOD                 (100u)
+#endif /* CY_APP_TELEMETRY_PERIOD */
+
+#ifndef CY_APP_TELEMETRY_RING_SIZE
+/** Number of latest samples kept per port. */
+#define CY_APP_TELEMETRY_RING_SIZE              (8u)
+#endif /* CY_APP_TELEMETRY_RING_SIZE */
+
+#ifndef CY_APP_TELEMETRY_EWMA_SHIFT
+/** Weight of a new sample in the average is 1 / (2 ^ CY_APP_TELEMETRY_EWMA_SHIFT). */
+#define CY_APP_TELEMETRY_EWMA_SHIFT             (3u)
+#endif /* CY_APP_TELEMETRY_EWMA_SHIFT */
+
+/** \} group_pmg_app_common_telemetry_macros */
+
+/*****************************************************************************
+ * Data Struct Definition
+ *****************************************************************************/
+/**
+* \addtogroup group_pmg_app_common_telemetry_data_structures
+* \{
+*/
+
+/**
+ * @brief One telemetry sample
+ */
+typedef struct
+{
+    uint16_t vbus;                      /**< VBUS voltage in mV. */
+    uint16_t ibus;                      /**< VBUS current in 10 mA units; 0 if not measured. */
+} cy_stc_app_telemetry_sample_t;
+
+/**
+ * @brief Statistics accumulated from the start of the contract. This structure
+ * is also the payload of the HPI telemetry response.
+ */
+typedef struct
+{
+    uint16_t vbusMin;                   /**< Minimum VBUS voltage in mV. */
+    uint16_t vbusMax;                   /**< Maximum VBUS voltage in mV. */
+    uint16_t vbusAvg;                   /**< Average VBUS voltage in mV. */
+    uint16_t ibusMin;                   /**< Minimum VBUS current in 10 mA units. */
+    uint16_t ibusMax;                   /**< Maximum VBUS current in 10 mA units. */
+    uint16_t ibusAvg;                   /**< Average VBUS current in 10 mA units. */
+    uint32_t energy;                    /**< Energy delivered in mWh. */
+    uint32_t count;                     /**< Number of samples taken. */
+} cy_stc_app_telemetry_stats_t;
+
+/**
+ * @brief Telemetry state of one port
+ */
+typedef struct
+{
+    cy_stc_app_telemetry_stats_t stats;                         /**< Statistics of the contract. */
+    cy_stc_app_telemetry_sample_t ring[CY_APP_TELEMETRY_RING_SIZE]; /**< Latest samples. */
+    uint32_t vbusAcc;                   /**< Scaled VBUS average. */
+    uint32_t ibusAcc;                   /**< Scaled IBUS average. */
+    uint32_t energyRem;                 /**< Energy in uJ not yet counted in mWh. */
+    uint8_t ringIdx;                    /**< Ring slot written next. */
+    uint8_t ringCount;                  /**< Number of valid samples in the ring. */
+    bool active;                        /**< Sampling is enabled on the port. */
+} cy_stc_app_telemetry_t;
+
+/** \} group_pmg_app_common_telemetry_data_structures */
+
+/*****************************************************************************
+ * Global Function Declaration
+ *****************************************************************************/
+/**
+* \addtogroup group_pmg_app_common_telemetry_functions
+* \{
+*/
+
+/**
+ * @brief Starts, restarts and stops sampling on the port from a PD event.
+ * Called from Cy_App_EventHandler.
+ *
+ * @param ptrPdStackContext Pointer to the PDStack context
+ * @param evt Event that is being notified
+ *
+ * @return None
+ */
+void Cy_App_Telemetry_EventHandler(cy_stc_pdstack_context_t *ptrPdStackContext, cy_en_pdstack_app_evt_t evt);
+
+/**
+ * @brief Returns the statistics of the current contract on the port.
+ *
+ * @param ptrPdStackContext Pointer to the PDStack context
+ *
+ * @return Pointer to the statistics.
+ */
+const cy_stc_app_telemetry_stats_t* Cy_App_Telemetry_GetStats(cy_stc_pdstack_context_t *ptrPdStackContext);
+
+/**
+ * @brief Copies the latest samples of the port, oldest first.
+ *
+ * @param ptrPdStackContext Pointer to the PDStack context
+ * @param samples Buffer to copy the samples to
+ * @param maxCount Number of samples the buffer can hold
+ *
+ * @return Number of samples copied.
+ */
+uint8_t Cy_App_Telemetry_GetSamples(cy_stc_pdstack_context_t *ptrPdStackContext,
+        cy_stc_app_telemetry_sample_t *samples, uint8_t maxCount);
+
+/**
+ * @brief Clears the statistics and samples of the port.
+ *
+ * @param ptrPdStackContext Pointer to the PDStack context
+ *
+ * @return None
+ */
+void Cy_App_Telemetry_Clear(cy_stc_pdstack_context_t *ptrPdStackContext);
+
+/**
+ * @brief Stops sampling on all ports before deep sleep entry. Called from
+ * Cy_App_Sleep.
+ *
+ * @return None
+ */
+void Cy_App_Telemetry_Sleep(void);
+
+/**
+ * @brief Restarts sampling on the ports on which it was active before deep
+ * sleep entry. Called from Cy_App_Resume.
+ *
+ * @return None
+ */
+void Cy_App_Telemetry_Resume(void);
+
+/** \} group_pmg_app_common_telemetry_functions */
+
+#endif /* (CY_APP_TELEMETRY_ENABLE || DOXYGEN) */
+
+#endif /* _CY_APP_TELEMETRY_H_ */
+
+/* [] END OF FILE */
@@ -0,0 +1,309 @@
+/***************************************************************************//**
+* \file cy_app_thermal.c
+* \version 2.0
+*
+* \brief
+* Implements the thermal derating controller of the source ports
+*
+********************************************************************************
+* \copyright
+* Copyright 2024, Cypress Semiconductor Corporation (an Infineon company)
+* or an affiliate of Cypress Semiconductor Corporation. All rights reserved.
+* You may use this file only in accordance with the license, terms, conditions,
+* disclaimers, and limitations in the end user license agreement accompanying
+* the software package with which this file was provided.
+*******************************************************************************/
+
+#include "cybsp.h"
+#include "cy_app_config.h"
+#include "cy_app.h"
+#include "cy_app_thermal.h"
+#include "cy_app_source.h"
+#include "cy_app_coroutine.h"
+#if CY_APP_POWER_BUDGET_ENABLE
+#include "cy_app_power_budget.h"
+#endif /* CY_APP_POWER_BUDGET_ENABLE */
+
+#include "cy_pdstack_dpm.h"
+#include "cy_pdutils.h"
+
+#if CY_APP_THERMAL_DERATE_ENABLE
+
+/* Derating state of each port */
+static cy_stc_app_thermal_t glAppThermal[NO_OF_TYPEC_PORTS];
+
+/* Requests a temperature sample from the task once each period */
+static cy_en_app_coro_status_t thermal_pacer(cy_stc_pdstack_context_t *ptrPdStackContext, cy_stc_app_coro_t *coro)
+{
+    CY_APP_CORO_BEGIN(coro);
+
+    for (;;)
+    {
+        CY_APP_CORO_WAIT_MS(coro, CY_APP_THERMAL_SAMPLE_PERIOD);
+        glAppThermal[ptrPdStackContext->port].sample = true;
+    }
+
+    CY_APP_CORO_END(coro);
+}
+
+/* Scales a current in 10 mA or 50 mA units to the percentage */
+static uint32_t thermal_scale(uint32_t cur, uint8_t percent)
+{
+    return ((cur * percent) / 100u);
+}
+
+/* Derates a source PDO. Returns false if the PDO is not to be advertised. */
+static bool thermal_derate_pdo(cy_pd_pd_do_t *pdo, uint8_t percent, bool first)
+{
+    uint32_t cur;
+    bool keep = true;
+
+    switch (pdo->fixed_src.supplyType)
+    {
+        case CY_PDSTACK_PDO_FIXED_SUPPLY:
+            cur = thermal_scale(pdo->fixed_src.maxCurrent, percent);
+            if (first)
+            {
+                cur = CY_PDUTILS_GET_MIN(CY_PDUTILS_GET_MAX(cur, CY_APP_THERMAL_MIN_CURRENT), pdo->fixed_src.maxCurrent);
+            }
+            pdo->fixed_src.maxCurrent = cur;
+            keep = (first || (cur >= CY_APP_THERMAL_MIN_CURRENT));
+            break;
+
+        case CY_PDSTACK_PDO_VARIABLE_SUPPLY:
+            cur = thermal_scale(pdo->var_src.maxCurrent, percent);
+            pdo->var_src.maxCurrent = cur;
+            keep = (cur >= CY_APP_THERMAL_MIN_CURRENT);
+            break;
+
+        case CY_PDSTACK_PDO_BATTERY:
+            pdo->bat_src.maxPower = thermal_scale(pdo->bat_src.maxPower, percent);
+            break;
+
+        case CY_PDSTACK_PDO_AUGMENTED:
+            if (pdo->pps_src.apdoType == CY_PDSTACK_APDO_PPS)
+            {
+                cur = thermal_scale(pdo->pps_src.maxCur, percent);
+                pdo->pps_src.maxCur = cur;
+                keep = ((cur * 5u) >= CY_APP_THERMAL_MIN_CURRENT);
+            }
+            else
+            {
+                /* Other APDOs cannot be derated */
+                keep = false;
+            }
+            break;
+
+        default:
+            keep = false;
+            break;
+    }
+
+    return keep;
+}
+
+/* Advertises the source capabilities of the derating level */
+static void thermal_publish(cy_stc_pdstack_context_t *ptrPdStackContext, uint8_t level)
+{
+    cy_stc_app_thermal_t *therm = &glAppThermal[ptrPdStackContext->port];
+    cy_pd_pd_do_t pdo[CY_PD_MAX_NO_OF_PDO];
+    uint8_t count = 0u;
+    uint8_t mask = 0u;
+    uint8_t idx;
+
+    therm->level = level;
+    therm->holdTime = CY_APP_THERMAL_RENEG_INTERVAL;
+
+#if CY_APP_POWER_BUDGET_ENABLE
+    /* The budget manager publishes the lower of its allocation and the derated power */
+    if (Cy_App_PowerBudget_SetPortLimit(ptrPdStackContext,
+                (level == 0u) ? 100u : therm->ladder[level - 1u].powerPercent) == CY_APP_STAT_SUCCESS)
+    {
+        return;
+    }
+#endif /* CY_APP_POWER_BUDGET_ENABLE */
+
+    for (idx = 0u; idx < therm->baseCount; idx++)
+    {
+        pdo[count] = therm->basePdo[idx];
+
+        /* The full capabilities are restored as they are */
+        if ((level == 0u) ||
+                (thermal_derate_pdo(&pdo[count], therm->ladder[level - 1u].powerPercent, (idx == 0u))))
+        {
+            if ((therm->baseMask & (1u << idx)) != 0u)
+            {
+                mask |= (uint8_t)(1u << count);
+            }
+            count++;
+        }
+    }
+
+    (void)Cy_PdStack_Dpm_UpdateSrcCap(ptrPdStackContext, count, pdo);
+    (void)Cy_PdStack_Dpm_UpdateSrcCapMask(ptrPdStackContext, mask);
+
+    therm->capChangePending = ((ptrPdStackContext->dpmConfig.contractExist) &&
+            (ptrPdStackContext->dpmConfig.curPortRole == CY_PD_PRT_ROLE_SOURCE));
+}
+
+/* Returns the level for the temperature, moving away from the current level only past its limits */
+static uint8_t thermal_get_target(const cy_stc_app_thermal_t *therm, uint8_t temp)
+{
+    uint8_t level = therm->level;
+
+    while ((level < therm->ladderCount) && (temp >= therm->ladder[level].enterTemp))
+    {
+        level++;
+    }
+
+    while ((level > 0u) && (temp <= therm->ladder[level - 1u].exitTemp))
+    {
+        level--;
+    }
+
+    return level;
+}
+
+/* Updates the hot shutdown flag of the port from the turn off and turn on limits */
+static void thermal_update_shutdown(cy_stc_pdstack_context_t *ptrPdStackContext, uint8_t temp)
+{
+    cy_stc_app_status_t *app_stat = Cy_App_GetStatus(ptrPdStackContext->port);
+
+    if (app_stat->turn_off_temp_limit == 0u)
+    {
+        return;
+    }
+
+    if ((temp >= app_stat->turn_off_temp_limit) && (!app_stat->is_hot_shutdown))
+    {
+        app_stat->is_hot_shutdown = true;
+
+        /* Keep the source path off until the port has cooled down */
+        ptrPdStackContext->dpmStat.faultActive = true;
+        if ((ptrPdStackContext->dpmConfig.attach) &&
+                (ptrPdStackContext->dpmConfig.curPortRole == CY_PD_PRT_ROLE_SOURCE))
+        {
+            Cy_App_Source_Disable(ptrPdStackContext, NULL);
+            Cy_PdStack_Dpm_GoToErrorRecovery(ptrPdStackContext);
+        }
+    }
+    else if ((temp <= app_stat->turn_on_temp_limit) && (app_stat->is_hot_shutdown))
+    {
+        app_stat->is_hot_shutdown = false;
+        ptrPdStackContext->dpmStat.faultActive = false;
+
+        /* Let an attached sink see a fresh attach with the source path enabled again */
+        if (ptrPdStackContext->dpmConfig.attach)
+        {
+            Cy_PdStack_Dpm_GoToErrorRecovery(ptrPdStackContext);
+        }
+    }
+    else
+    {
+        /* Keep the flag within the hysteresis band */
+    }
+}
+
+cy_en_app_status_t Cy_App_Thermal_Init(cy_stc_pdstack_context_t *ptrPdStackContext,
+        cy_app_thermal_read_cbk_t readTemp, const cy_stc_app_thermal_level_t *ladder, uint8_t count)
+{
+    cy_stc_app_thermal_t *therm = &glAppThermal[ptrPdStackContext->port];
+    const cy_stc_pdstack_dpm_status_t *dpm_stat = &ptrPdStackContext->dpmStat;
+    uint8_t idx;
+
+    if ((readTemp == NULL) || (ladder == NULL) || (count == 0u) || (count > CY_APP_THERMAL_MAX_LEVELS) ||
+            (dpm_stat->srcPdoCount == 0u) || (dpm_stat->srcPdoCount > CY_PD_MAX_NO_OF_PDO))
+    {
+        return CY_APP_STAT_BAD_PARAM;
+    }
+
+    for (idx = 0u; idx < count; idx++)
+    {
+        if ((ladder[idx].exitTemp >= ladder[idx].enterTemp) || (ladder[idx].powerPercent == 0u) ||
+                (ladder[idx].powerPercent > 100u) ||
+                ((idx != 0u) && ((ladder[idx].enterTemp <= ladder[idx - 1u].enterTemp) ||
+                                 (ladder[idx].powerPercent >= ladder[idx - 1u].powerPercent))))
+        {
+            return CY_APP_STAT_BAD_PARAM;
+        }
+
+        therm->ladder[idx] = ladder[idx];
+    }
+
+    therm->ladderCount = count;
+    therm->baseCount = dpm_stat->srcPdoCount;
+    therm->baseMask = dpm_stat->srcPdoMask;
+    for (idx = 0u; idx < therm->baseCount; idx++)
+    {
+        therm->basePdo[idx] = dpm_stat->curSrcPdo[idx];
+    }
+
+    therm->level = 0u;
+    therm->temp = 0u;
+    therm->holdTime = 0u;
+    therm->sample = true;
+    therm->capChangePending = false;
+    therm->readTemp = readTemp;
+
+    Cy_App_Coro_Start(ptrPdStackContext, CY_APP_CORO_THERMAL, thermal_pacer, CY_APP_THERMAL_SAMPLE_PERIOD);
+
+    return CY_APP_STAT_SUCCESS;
+}
+
+void Cy_App_Thermal_Task(cy_stc_pdstack_context_t *ptrPdStackContext)
+{
+    cy_stc_app_thermal_t *therm = &glAppThermal[ptrPdStackContext->port];
+    uint8_t target;
+    uint8_t temp;
+
+    if (therm->readTemp == NULL)
+    {
+        return;
+    }
+
+    /* Send capability changes which the stack could not take earlier */
+    if (therm->capChangePending)
+    {
+        if ((!ptrPdStackContext->dpmConfig.contractExist) || (Cy_PdStack_Dpm_SendPdCommand(ptrPdStackContext,
+                        CY_PDSTACK_DPM_CMD_SRC_CAP_CHNG, NULL, false, NULL) == CY_PDSTACK_STAT_SUCCESS))
+        {
+            therm->capChangePending = false;
+        }
+    }
+
+    if (!therm->sample)
+    {
+        return;
+    }
+
+    therm->sample = false;
+    therm->holdTime -= CY_PDUTILS_GET_MIN(therm->holdTime, CY_APP_THERMAL_SAMPLE_PERIOD);
+
+    if (!therm->readTemp(ptrPdStackContext, &temp))
+    {
+        return;
+    }
+
+    therm->temp = temp;
+    thermal_update_shutdown(ptrPdStackContext, temp);
+
+    target = thermal_get_target(therm, temp);
+    if ((target != therm->level) && (therm->holdTime == 0u))
+    {
+        thermal_publish(ptrPdStackContext, target);
+    }
+}
+
+uint8_t Cy_App_Thermal_GetLevel(cy_stc_pdstack_context_t *ptrPdStackContext)
+{
+    return glAppThermal[ptrPdStackContext->port].level;
+}
+
+uint8_t Cy_App_Thermal_GetTemperature(cy_stc_pdstack_context_t *ptrPdStackContext)
+{
+    return glAppThermal[ptrPdStackContext->port].temp;
+}
+
+#endif /* CY_APP_THERMAL_DERATE_ENABLE */
+
+/* [] End of file */
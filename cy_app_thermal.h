@@ -0,0 +1,204 @@
+/***************************************************************************//**
+* \file cy_app_thermal.h
+* \version 2.0
+*
+* \brief
+* Defines the data structures and function prototypes of the thermal derating
+* controller of the source ports.
+*
+********************************************************************************
+* \copyright
+* Copyright 2024, Cypress Semiconductor Corporation (an Infineon company)
+* or an affiliate of Cypress Semiconductor Corporation. All rights reserved.
+* You may use this file only in accordance with the license, terms, conditions,
+* disclaimers, and limitations in the end user license agreement accompanying
+* the software package with which this file was provided.
+*******************************************************************************/
+
+#ifndef _CY_APP_THERMAL_H_
+#define _CY_APP_THERMAL_H_
+
+/*******************************************************************************
+ * Header files including
+ ******************************************************************************/
+#include <stdint.h>
+#include <stdbool.h>
+#include "cy_pdstack_common.h"
+#include "cy_app_status.h"
+
+#if (CY_APP_THERMAL_DERATE_ENABLE || DOXYGEN)
+
+/**
+* \addtogroup group_pmg_app_common_thermal
+* \{
+* The thermal derating controller samples the temperature of a source port
+* every CY_APP_THERMAL_SAMPLE_PERIOD ms through a callback provided by the
+* application. As the temperature rises through the levels of a derating
+* ladder, the currents of the advertised source PDOs, including the PPS
+* current limits, are reduced to the power percentage of the level. Each level
+* is left only once the temperature has fallen to its exit temperature.
+*
+* Source capability changes are published at most once every
+* CY_APP_THERMAL_RENEG_INTERVAL ms. The port partner is asked to renegotiate
+* if a contract exists.
+*
+* The is_hot_shutdown flag of the port status is set once the temperature
+* reaches turn_off_temp_limit, and cleared once it falls to
+* turn_on_temp_limit. A turn_off_temp_limit of 0 disables the flag updates.
+* While the flag is set, the source path of the port is kept off: the port
+* is marked as faulty, and an attached sink goes through error recovery both
+* when the flag is set and when it is cleared.
+*
+* If the port is also managed by the power budget manager, the derating level
+* is passed to it as a power limit, and the budget manager publishes the lower
+* of its allocation and the derated power.
+*
+* <b>Usage:</b>
+* 1. Call Cy_App_Thermal_Init for each source port once the PD stack has been
+* initialized. The source capabilities held by the stack at this point are the
+* capabilities of the port at full power.
+* 2. Cy_App_Task runs Cy_App_Thermal_Task.
+*
+* \defgroup group_pmg_app_common_thermal_macros Macros
+* \defgroup group_pmg_app_common_thermal_data_structures Data structures
+* \defgroup group_pmg_app_common_thermal_functions Functions
+*/
+/** \} group_pmg_app_common_thermal */
+
+/*****************************************************************************
+ * Macros
+ *****************************************************************************/
+/**
+* \addtogroup group_pmg_app_common_thermal_macros
+* \{
+*/
+
+#ifndef CY_APP_THERMAL_SAMPLE_PERIOD
+/** Temperature sampling period in ms. */
+#define CY_APP_THERMAL_SAMPLE_PERIOD            (1000u)
+#endif /* CY_APP_THERMAL_SAMPLE_PERIOD */
+
+#ifndef CY_APP_THERMAL_RENEG_INTERVAL
+/** Minimum time in ms between two source capability changes of a port. */
+#define CY_APP_THERMAL_RENEG_INTERVAL           (10000u)
+#endif /* CY_APP_THERMAL_RENEG_INTERVAL */
+
+#ifndef CY_APP_THERMAL_MAX_LEVELS
+/** Maximum number of levels of a derating ladder. */
+#define CY_APP_THERMAL_MAX_LEVELS               (4u)
+#endif /* CY_APP_THERMAL_MAX_LEVELS */
+
+#ifndef CY_APP_THERMAL_MIN_CURRENT
+/** Derated PDOs other than vSafe5V which would offer less than this current
+ * (10 mA units) are not advertised. vSafe5V does not go below this current. */
+#define CY_APP_THERMAL_MIN_CURRENT              (50u)
+#endif /* CY_APP_THERMAL_MIN_CURRENT */
+
+/** \} group_pmg_app_common_thermal_macros */
+
+/*****************************************************************************
+ * Data Struct Definition
+ *****************************************************************************/
+/**
+* \addtogroup group_pmg_app_common_thermal_data_structures
+* \{
+*/
+
+/**
+ * @brief Callback which reads the temperature of a port.
+ *
+ * @param ptrPdStackContext Pointer to the PDStack context
+ * @param temp Temperature in degrees Celsius
+ *
+ * @return true if the temperature has been read; false otherwise.
+ */
+typedef bool (*cy_app_thermal_read_cbk_t)(cy_stc_pdstack_context_t *ptrPdStackContext, uint8_t *temp);
+
+/**
+ * @brief One level of a derating ladder
+ */
+typedef struct
+{
+    uint8_t enterTemp;                  /**< The level is entered at or above this temperature in degrees Celsius. */
+    uint8_t exitTemp;                   /**< The level is left at or below this temperature in degrees Celsius. */
+    uint8_t powerPercent;               /**< Percentage of the full PDO currents advertised in the level. */
+} cy_stc_app_thermal_level_t;
+
+/**
+ * @brief Thermal derating state of one port
+ */
+typedef struct
+{
+    cy_app_thermal_read_cbk_t readTemp;                         /**< Temperature source; NULL if the port is not managed. */
+    cy_stc_app_thermal_level_t ladder[CY_APP_THERMAL_MAX_LEVELS];   /**< Derating ladder, coolest level first. */
+    cy_pd_pd_do_t basePdo[CY_PD_MAX_NO_OF_PDO];                 /**< Source PDOs of the port at full power. */
+    uint8_t ladderCount;                /**< Number of levels of the ladder. */
+    uint8_t baseCount;                  /**< Number of source PDOs at full power. */
+    uint8_t baseMask;                   /**< Mask of enabled source PDOs at full power. */
+    uint8_t level;                      /**< Level published to the port; 0 for full power. */
+    uint8_t temp;                       /**< Last temperature read in degrees Celsius. */
+    uint16_t holdTime;                  /**< Time in ms until the next change may be published. */
+    volatile bool sample;               /**< The sampling period has expired. */
+    bool capChangePending;              /**< Changed source capabilities still have to be sent to the partner. */
+} cy_stc_app_thermal_t;
+
+/** \} group_pmg_app_common_thermal_data_structures */
+
+/*****************************************************************************
+ * Global Function Declaration
+ *****************************************************************************/
+/**
+* \addtogroup group_pmg_app_common_thermal_functions
+* \{
+*/
+
+/**
+ * @brief Starts thermal derating of a source port. The ladder is copied.
+ *
+ * @param ptrPdStackContext Pointer to the PDStack context
+ * @param readTemp Callback which reads the temperature of the port
+ * @param ladder Derating ladder, coolest level first. The enter temperatures
+ * have to rise and the power percentages have to fall from level to level.
+ * @param count Number of levels
+ *
+ * @return CY_APP_STAT_SUCCESS if derating is started; CY_APP_STAT_BAD_PARAM if
+ * the callback, the ladder or the source capabilities are invalid.
+ */
+cy_en_app_status_t Cy_App_Thermal_Init(cy_stc_pdstack_context_t *ptrPdStackContext,
+        cy_app_thermal_read_cbk_t readTemp, const cy_stc_app_thermal_level_t *ladder, uint8_t count);
+
+/**
+ * @brief Samples the temperature and publishes derated source capabilities
+ * when required. Called from Cy_App_Task.
+ *
+ * @param ptrPdStackContext Pointer to the PDStack context
+ *
+ * @return None
+ */
+void Cy_App_Thermal_Task(cy_stc_pdstack_context_t *ptrPdStackContext);
+
+/**
+ * @brief Returns the derating level published to the port.
+ *
+ * @param ptrPdStackContext Pointer to the PDStack context
+ *
+ * @return 0 for full power; otherwise the ladder level starting at 1.
+ */
+uint8_t Cy_App_Thermal_GetLevel(cy_stc_pdstack_context_t *ptrPdStackContext);
+
+/**
+ * @brief Returns the last temperature read for the port.
+ *
+ * @param ptrPdStackContext Pointer to the PDStack context
+ *
+ * @return Temperature in degrees Celsius.
+ */
+uint8_t Cy_App_Thermal_GetTemperature(cy_stc_pdstack_context_t *ptrPdStackContext);
+
+/** \} group_pmg_app_common_thermal_functions */
+
+#endif /* (CY_APP_THERMAL_DERATE_ENABLE || DOXYGEN) */
+
+#endif /* _CY_APP_THERMAL_H_ */
+
+/* [] END OF FILE */
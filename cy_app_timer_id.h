@@ -85,9 +85,6 @@ typedef enum {
     CY_APP_SBU_DELAYED_CONNECT_TIMER,
     /**< Timer is used for delayed SBU connection in Thunderbolt mode. */
 
-    CY_APP_CBL_DISC_TRIGGER_TIMER,
-    /**< Timer is used to trigger cable discovery after a V5V supply change. */
-
     CY_APP_V5V_CHANGE_DEBOUNCE_TIMER,
     /**< Timer is used to debounce V5V voltage changes. */
     
@@ -106,9 +103,6 @@ typedef enum {
     CY_APP_BB_OFF_TIMER,
     /**< Timer is used to display USB billboard interface to save power. */
 
-    CY_APP_INITIATE_SWAP_TIMER,
-    /**< Timer is used to initiate SWAP operations in DRP applications with a power/data role preference. */
-
     CY_APP_VDM_NOT_SUPPORT_RESP_TIMER_ID,
     /**< VDM not supported response timer. */
 
@@ -130,9 +124,6 @@ typedef enum {
     CY_APP_CDP_DP_DM_POLL_TIMER,
     /**< Timer is used to initiate DP/DM voltage polling while connected as a CDP. */
 
-    CY_APP_EPR_MODE_TIMER,
-    /**< Timer is used by EPR state machine. */
-
     CY_APP_EPR_EXT_CMD_TIMER,
     /**< Timer is used to send enter/exit EPR mode events to EPR state machine. */
 
@@ -227,18 +218,42 @@ typedef enum {
     CY_APP_MOISTURE_DETECT_TIMER_ID,
     /**< Timer used to start moisture detection after typec attach wait */
 
-    CY_APP_PD_GET_REVISION_COMMAND_RETRY_TIMER,
-    /**< Timer is used to retry get revision command */
-
     CY_APP_GOSHEN_AUTH_RESP_WAIT_TIMER,
     /**< Goshen Ridge authentication response wait timer ID */
 
     CY_APP_FXVL_UPD_TIMER,
     /**< Foxville update timer ID */
 
-    CY_APP_FXVL_SMBUS_TIMER
+    CY_APP_FXVL_SMBUS_TIMER,
     /**< Foxville SM BUS timer ID */
 
+    CY_APP_COROUTINE_TIMER,
+    /**< Timer shared by all application coroutines of a port */
+
+    CY_APP_PARTNER_FLUSH_TIMER,
+    /**< Timer used to batch writes of the partner cache to flash */
+
+    CY_APP_PWR_BUDGET_TIMER,
+    /**< Timer used to batch events before the power budget is rebalanced */
+
+    CY_APP_ADC_CAL_AGE_TIMER,
+    /**< Timer used to limit the age of the cached VBUS ADC calibration */
+
+    CY_APP_ADC_SCHED_TIMER,
+    /**< Timer used by the ADC scheduler to wait for the settle time of a request */
+
+    CY_APP_FRS_LATENCY_TIMER,
+    /**< Timer used to measure the time from an FRS signal to the completion of the swap */
+
+    CY_APP_FAULT_RECORD_FLUSH_TIMER,
+    /**< Timer used to batch the flash writes of fault records */
+
+    CY_APP_FAULT_RECORD_TIME_TIMER,
+    /**< Timer which provides the default time base of the fault records */
+
+    CY_APP_BC_QC_PULSE_SETTLE_TIMER
+    /**< Timer used to detect the end of a QC 3.0 pulse train */
+
 } cy_en_timer_id_t;
 
 /** \} group_pmg_app_common_app_enums */
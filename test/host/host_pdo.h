@@ -0,0 +1,87 @@
+/*
+ * PD data object builders for the host tests. Voltages are given in mV,
+ * currents in mA and power in mW.
+ */
+
+#ifndef HOST_PDO_H
+#define HOST_PDO_H
+
+#include "host_sdk.h"
+
+static inline cy_pd_pd_do_t host_fixed_src(uint32_t mv, uint32_t ma)
+{
+    cy_pd_pd_do_t pdo = {0};
+
+    pdo.fixed_src.supplyType = CY_PDSTACK_PDO_FIXED_SUPPLY;
+    pdo.fixed_src.voltage = mv / 50u;
+    pdo.fixed_src.maxCurrent = ma / 10u;
+    return pdo;
+}
+
+static inline cy_pd_pd_do_t host_var_src(uint32_t min_mv, uint32_t max_mv, uint32_t ma)
+{
+    cy_pd_pd_do_t pdo = {0};
+
+    pdo.var_src.supplyType = CY_PDSTACK_PDO_VARIABLE_SUPPLY;
+    pdo.var_src.minVoltage = min_mv / 50u;
+    pdo.var_src.maxVoltage = max_mv / 50u;
+    pdo.var_src.maxCurrent = ma / 10u;
+    return pdo;
+}
+
+static inline cy_pd_pd_do_t host_bat_src(uint32_t min_mv, uint32_t max_mv, uint32_t mw)
+{
+    cy_pd_pd_do_t pdo = {0};
+
+    pdo.bat_src.supplyType = CY_PDSTACK_PDO_BATTERY;
+    pdo.bat_src.minVoltage = min_mv / 50u;
+    pdo.bat_src.maxVoltage = max_mv / 50u;
+    pdo.bat_src.maxPower = mw / 250u;
+    return pdo;
+}
+
+static inline cy_pd_pd_do_t host_pps_src(uint32_t min_mv, uint32_t max_mv, uint32_t ma)
+{
+    cy_pd_pd_do_t pdo = {0};
+
+    pdo.pps_src.supplyType = CY_PDSTACK_PDO_AUGMENTED;
+    pdo.pps_src.apdoType = CY_PDSTACK_APDO_PPS;
+    pdo.pps_src.minVolt = min_mv / 100u;
+    pdo.pps_src.maxVolt = max_mv / 100u;
+    pdo.pps_src.maxCur = ma / 50u;
+    return pdo;
+}
+
+static inline cy_pd_pd_do_t host_fixed_snk(uint32_t mv, uint32_t ma)
+{
+    cy_pd_pd_do_t pdo = {0};
+
+    pdo.fixed_snk.supplyType = CY_PDSTACK_PDO_FIXED_SUPPLY;
+    pdo.fixed_snk.voltage = mv / 50u;
+    pdo.fixed_snk.opCurrent = ma / 10u;
+    return pdo;
+}
+
+static inline cy_pd_pd_do_t host_var_snk(uint32_t min_mv, uint32_t max_mv, uint32_t ma)
+{
+    cy_pd_pd_do_t pdo = {0};
+
+    pdo.var_snk.supplyType = CY_PDSTACK_PDO_VARIABLE_SUPPLY;
+    pdo.var_snk.minVoltage = min_mv / 50u;
+    pdo.var_snk.maxVoltage = max_mv / 50u;
+    pdo.var_snk.opCurrent = ma / 10u;
+    return pdo;
+}
+
+static inline cy_pd_pd_do_t host_bat_snk(uint32_t min_mv, uint32_t max_mv, uint32_t mw)
+{
+    cy_pd_pd_do_t pdo = {0};
+
+    pdo.bat_snk.supplyType = CY_PDSTACK_PDO_BATTERY;
+    pdo.bat_snk.minVoltage = min_mv / 50u;
+    pdo.bat_snk.maxVoltage = max_mv / 50u;
+    pdo.bat_snk.opPower = mw / 250u;
+    return pdo;
+}
+
+#endif /* HOST_PDO_H */
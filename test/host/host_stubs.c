@@ -0,0 +1,379 @@
+/*
+ * Host implementations of the SDK functions declared in stubs/host_sdk.h.
+ * Software timers count down in ms steps of host_timer_advance(); PD stack
+ * commands only record that they have been issued, and the fault comparators
+ * and power FETs record their state for the test to act on. Flash rows are read by
+ * address, so host_flash_map() maps memory where the device has its flash.
+ */
+
+#define _DEFAULT_SOURCE
+#include <string.h>
+#include <stdint.h>
+#include <sys/mman.h>
+#include "host_test.h"
+
+unsigned int host_fail_count = 0u;
+
+host_src_cap_t host_src_cap[NO_OF_TYPEC_PORTS];
+uint32_t host_pd_cmd_count[NO_OF_TYPEC_PORTS];
+uint32_t host_typec_cmd_count[NO_OF_TYPEC_PORTS];
+uint32_t host_pe_stop_count[NO_OF_TYPEC_PORTS];
+cy_en_pdstack_status_t host_pd_cmd_status = CY_PDSTACK_STAT_SUCCESS;
+cy_en_pdstack_dpm_pd_cmd_t host_pd_cmd_last[NO_OF_TYPEC_PORTS];
+cy_en_pdstack_dpm_pd_cmd_t host_typec_cmd_last[NO_OF_TYPEC_PORTS];
+cy_pdstack_dpm_typec_cmd_cbk_t host_typec_cmd_cbk[NO_OF_TYPEC_PORTS];
+uint32_t host_dpm_start_count[NO_OF_TYPEC_PORTS];
+cy_stc_pdstack_context_t *host_dpm_context[NO_OF_TYPEC_PORTS];
+host_fault_comp_t host_fault_comp[NO_OF_TYPEC_PORTS][HOST_FAULT_COUNT];
+bool host_pfet_on[NO_OF_TYPEC_PORTS];
+bool host_cfet_on[NO_OF_TYPEC_PORTS];
+bool host_discharge_on[NO_OF_TYPEC_PORTS];
+uint32_t host_flash_writes;
+
+typedef struct
+{
+    cy_cb_timer_t cb;
+    void *ctx;
+    uint16_t count;
+    uint16_t period;
+    bool running;
+} host_timer_t;
+
+static host_timer_t host_timer[HOST_TIMER_COUNT];
+
+int host_test_result(const char *name)
+{
+    if (host_fail_count != 0u)
+    {
+        printf("%s: %u check(s) failed\n", name, host_fail_count);
+        return 1;
+    }
+
+    printf("%s: passed\n", name);
+    return 0;
+}
+
+uint32_t Cy_SysLib_EnterCriticalSection(void)
+{
+    return 0u;
+}
+
+void Cy_SysLib_ExitCriticalSection(uint32_t savedIntrStatus)
+{
+    (void)savedIntrStatus;
+}
+
+void Cy_SysLib_DelayUs(uint16_t microseconds)
+{
+    (void)microseconds;
+}
+
+bool host_flash_map(uint16_t first_row)
+{
+    uintptr_t addr = (uintptr_t)first_row << CY_APP_SYS_FLASH_ROW_SHIFT_NUM;
+    size_t size = ((uintptr_t)CY_APP_SYS_FLASH_ROW_COUNT << CY_APP_SYS_FLASH_ROW_SHIFT_NUM) - addr;
+    void *map;
+
+    /* The mapping has to start on a page boundary; the rows are erased to 0 */
+    map = mmap((void *)addr, size, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+    if (map != (void *)addr)
+    {
+        if (map != MAP_FAILED)
+        {
+            munmap(map, size);
+        }
+        return false;
+    }
+
+    return true;
+}
+
+cy_en_flashdrv_status_t Cy_Flash_WriteRow(uint32_t rowAddr, const uint32_t *data)
+{
+    host_flash_writes++;
+    memcpy((void *)(uintptr_t)rowAddr, data, CY_APP_SYS_FLASH_ROW_SIZE);
+    return CY_FLASH_DRV_SUCCESS;
+}
+
+uint32_t Cy_PdUtils_DivRoundUp(uint32_t x, uint32_t y)
+{
+    return (x + y - 1u) / y;
+}
+
+bool Cy_PdUtils_SwTimer_Start(cy_stc_pdutils_sw_timer_t *context, void *callbackContext,
+        cy_timer_id_t id, uint16_t period, cy_cb_timer_t cb)
+{
+    (void)context;
+
+    if ((id >= HOST_TIMER_COUNT) || (period == 0u))
+    {
+        return false;
+    }
+
+    host_timer[id].cb = cb;
+    host_timer[id].ctx = callbackContext;
+    host_timer[id].count = period;
+    host_timer[id].period = period;
+    host_timer[id].running = true;
+    return true;
+}
+
+void Cy_PdUtils_SwTimer_Stop(cy_stc_pdutils_sw_timer_t *context, cy_timer_id_t id)
+{
+    (void)context;
+
+    if (id < HOST_TIMER_COUNT)
+    {
+        host_timer[id].running = false;
+    }
+}
+
+void Cy_PdUtils_SwTimer_StopRange(cy_stc_pdutils_sw_timer_t *context, cy_timer_id_t start, cy_timer_id_t end)
+{
+    cy_timer_id_t id;
+
+    for (id = start; (id <= end) && (id < HOST_TIMER_COUNT); id++)
+    {
+        Cy_PdUtils_SwTimer_Stop(context, id);
+    }
+}
+
+bool Cy_PdUtils_SwTimer_IsRunning(cy_stc_pdutils_sw_timer_t *context, cy_timer_id_t id)
+{
+    (void)context;
+
+    return ((id < HOST_TIMER_COUNT) && (host_timer[id].running));
+}
+
+uint16_t Cy_PdUtils_SwTimer_GetCount(cy_stc_pdutils_sw_timer_t *context, cy_timer_id_t id)
+{
+    (void)context;
+
+    return (Cy_PdUtils_SwTimer_IsRunning(context, id)) ? host_timer[id].count : 0u;
+}
+
+void host_timer_advance(uint32_t ms)
+{
+    cy_timer_id_t id;
+
+    while (ms-- != 0u)
+    {
+        for (id = 0u; id < HOST_TIMER_COUNT; id++)
+        {
+            if ((host_timer[id].running) && (--host_timer[id].count == 0u))
+            {
+                /* The callback may restart the timer */
+                host_timer[id].running = false;
+                host_timer[id].cb(id, host_timer[id].ctx);
+            }
+        }
+    }
+}
+
+uint16_t host_timer_period(cy_timer_id_t id)
+{
+    return (id < HOST_TIMER_COUNT) ? host_timer[id].period : 0u;
+}
+
+void host_timer_reset(void)
+{
+    memset(host_timer, 0, sizeof(host_timer));
+}
+
+cy_en_pdstack_status_t Cy_PdStack_Dpm_SendPdCommand(cy_stc_pdstack_context_t *ptrPdStackContext,
+        cy_en_pdstack_dpm_pd_cmd_t command, void *cmdParams, bool noResp, cy_pdstack_dpm_pd_cmd_cbk_t cbk)
+{
+    (void)cmdParams;
+    (void)noResp;
+    (void)cbk;
+
+    host_pd_cmd_count[ptrPdStackContext->port]++;
+    host_pd_cmd_last[ptrPdStackContext->port] = command;
+    return host_pd_cmd_status;
+}
+
+cy_en_pdstack_status_t Cy_PdStack_Dpm_SendTypecCommand(cy_stc_pdstack_context_t *ptrPdStackContext,
+        cy_en_pdstack_dpm_pd_cmd_t command, cy_pdstack_dpm_typec_cmd_cbk_t cbk)
+{
+    host_typec_cmd_count[ptrPdStackContext->port]++;
+    host_typec_cmd_last[ptrPdStackContext->port] = command;
+    host_typec_cmd_cbk[ptrPdStackContext->port] = cbk;
+    return CY_PDSTACK_STAT_SUCCESS;
+}
+
+cy_en_pdstack_status_t Cy_PdStack_Dpm_UpdateSrcCap(cy_stc_pdstack_context_t *ptrPdStackContext,
+        uint8_t count, const cy_pd_pd_do_t *pdo)
+{
+    host_src_cap_t *cap = &host_src_cap[ptrPdStackContext->port];
+
+    memcpy(cap->pdo, pdo, count * sizeof(cy_pd_pd_do_t));
+    cap->count = count;
+    cap->updates++;
+    return CY_PDSTACK_STAT_SUCCESS;
+}
+
+cy_en_pdstack_status_t Cy_PdStack_Dpm_UpdateSrcCapMask(cy_stc_pdstack_context_t *ptrPdStackContext, uint8_t mask)
+{
+    host_src_cap[ptrPdStackContext->port].mask = mask;
+    return CY_PDSTACK_STAT_SUCCESS;
+}
+
+cy_en_pdstack_status_t Cy_PdStack_Dpm_IsRdoValid(cy_stc_pdstack_context_t *ptrPdStackContext, cy_pd_pd_do_t rdo)
+{
+    (void)ptrPdStackContext;
+    (void)rdo;
+
+    return CY_PDSTACK_STAT_SUCCESS;
+}
+
+cy_en_pdstack_status_t Cy_PdStack_Dpm_Start(cy_stc_pdstack_context_t *ptrPdStackContext)
+{
+    host_dpm_start_count[ptrPdStackContext->port]++;
+    return CY_PDSTACK_STAT_SUCCESS;
+}
+
+cy_en_pdstack_status_t Cy_PdStack_Dpm_PeStop(cy_stc_pdstack_context_t *ptrPdStackContext)
+{
+    host_pe_stop_count[ptrPdStackContext->port]++;
+    return CY_PDSTACK_STAT_SUCCESS;
+}
+
+cy_stc_pdstack_context_t* Cy_PdStack_Dpm_GetContext(uint8_t portIdx)
+{
+    return host_dpm_context[portIdx];
+}
+
+void Cy_USBPD_TypeC_RdEnable(cy_stc_usbpd_context_t *context)
+{
+    (void)context;
+}
+
+void Cy_USBPD_TypeC_DisableRd(cy_stc_usbpd_context_t *context, uint8_t channel)
+{
+    (void)context;
+    (void)channel;
+}
+
+static void fault_comp_enable(cy_stc_usbpd_context_t *context, host_fault_t fault, uint32_t level,
+        cy_cb_vbus_fault_t cb)
+{
+    host_fault_comp_t *comp = &host_fault_comp[context->port][fault];
+
+    comp->cb = cb;
+    comp->level = level;
+    comp->enables++;
+    comp->enabled = true;
+}
+
+static void fault_comp_disable(cy_stc_usbpd_context_t *context, host_fault_t fault)
+{
+    host_fault_comp[context->port][fault].enabled = false;
+}
+
+void Cy_USBPD_Fault_Vbus_OvpEnable(cy_stc_usbpd_context_t *context, uint16_t volt, cy_cb_vbus_fault_t cb, bool pctrl)
+{
+    (void)pctrl;
+
+    fault_comp_enable(context, HOST_FAULT_VBUS_OVP, volt, cb);
+}
+
+void Cy_USBPD_Fault_Vbus_OvpDisable(cy_stc_usbpd_context_t *context, bool pctrl)
+{
+    (void)pctrl;
+
+    fault_comp_disable(context, HOST_FAULT_VBUS_OVP);
+}
+
+void Cy_USBPD_Fault_Vbus_UvpEnable(cy_stc_usbpd_context_t *context, uint16_t volt, cy_cb_vbus_fault_t cb, bool pctrl)
+{
+    (void)pctrl;
+
+    fault_comp_enable(context, HOST_FAULT_VBUS_UVP, volt, cb);
+}
+
+void Cy_USBPD_Fault_Vbus_UvpDisable(cy_stc_usbpd_context_t *context, bool pctrl)
+{
+    (void)pctrl;
+
+    fault_comp_disable(context, HOST_FAULT_VBUS_UVP);
+}
+
+void Cy_USBPD_Fault_Vbus_OcpEnable(cy_stc_usbpd_context_t *context, uint32_t current, cy_cb_vbus_fault_t cb)
+{
+    fault_comp_enable(context, HOST_FAULT_VBUS_OCP, current, cb);
+}
+
+void Cy_USBPD_Fault_Vbus_OcpDisable(cy_stc_usbpd_context_t *context, bool pctrl)
+{
+    (void)pctrl;
+
+    fault_comp_disable(context, HOST_FAULT_VBUS_OCP);
+}
+
+void Cy_USBPD_Fault_Vbus_ScpEnable(cy_stc_usbpd_context_t *context, uint32_t current, cy_cb_vbus_fault_t cb)
+{
+    fault_comp_enable(context, HOST_FAULT_VBUS_SCP, current, cb);
+}
+
+void Cy_USBPD_Fault_Vbus_ScpDisable(cy_stc_usbpd_context_t *context)
+{
+    fault_comp_disable(context, HOST_FAULT_VBUS_SCP);
+}
+
+void Cy_USBPD_Fault_Vbus_RcpEnable(cy_stc_usbpd_context_t *context, uint16_t volt, cy_cb_vbus_fault_t cb)
+{
+    fault_comp_enable(context, HOST_FAULT_VBUS_RCP, volt, cb);
+}
+
+void Cy_USBPD_Fault_Vbus_RcpDisable(cy_stc_usbpd_context_t *context)
+{
+    fault_comp_disable(context, HOST_FAULT_VBUS_RCP);
+}
+
+void Cy_USBPD_Fault_Vconn_OcpEnable(cy_stc_usbpd_context_t *context, cy_cb_vbus_fault_t cb)
+{
+    fault_comp_enable(context, HOST_FAULT_VCONN_OCP, 0u, cb);
+}
+
+void Cy_USBPD_Fault_Vconn_OcpDisable(cy_stc_usbpd_context_t *context)
+{
+    fault_comp_disable(context, HOST_FAULT_VCONN_OCP);
+}
+
+void Cy_USBPD_Vbus_GdrvPfetOn(cy_stc_usbpd_context_t *context, bool pfet)
+{
+    (void)pfet;
+
+    host_pfet_on[context->port] = true;
+}
+
+void Cy_USBPD_Vbus_GdrvPfetOff(cy_stc_usbpd_context_t *context, bool pfet)
+{
+    (void)pfet;
+
+    host_pfet_on[context->port] = false;
+}
+
+void Cy_USBPD_Vbus_GdrvCfetOn(cy_stc_usbpd_context_t *context, bool pfet)
+{
+    (void)pfet;
+
+    host_cfet_on[context->port] = true;
+}
+
+void Cy_USBPD_Vbus_GdrvCfetOff(cy_stc_usbpd_context_t *context, bool pfet)
+{
+    (void)pfet;
+
+    host_cfet_on[context->port] = false;
+}
+
+void Cy_USBPD_Vbus_DischargeOn(cy_stc_usbpd_context_t *context)
+{
+    host_discharge_on[context->port] = true;
+}
+
+void Cy_USBPD_Vbus_DischargeOff(cy_stc_usbpd_context_t *context)
+{
+    host_discharge_on[context->port] = false;
+}
@@ -0,0 +1,115 @@
+/*
+ * Host test helpers: the software timer model, the recorded PD stack
+ * commands and the check macros shared by the host tests.
+ */
+
+#ifndef HOST_TEST_H
+#define HOST_TEST_H
+
+#include <stdio.h>
+#include "host_sdk.h"
+
+/* Number of failed checks of the test program */
+extern unsigned int host_fail_count;
+
+#define HOST_CHECK(cond)                                                        \
+    do {                                                                        \
+        if (!(cond)) {                                                          \
+            printf("%s:%d: check failed: %s\n", __FILE__, __LINE__, #cond);     \
+            host_fail_count++;                                                  \
+        }                                                                       \
+    } while (0)
+
+#define HOST_CHECK_EQ(actual, expected)                                         \
+    do {                                                                        \
+        unsigned long host_a_ = (unsigned long)(actual);                        \
+        unsigned long host_e_ = (unsigned long)(expected);                      \
+        if (host_a_ != host_e_) {                                               \
+            printf("%s:%d: %s is %lu, expected %lu\n", __FILE__, __LINE__,      \
+                    #actual, host_a_, host_e_);                                 \
+            host_fail_count++;                                                  \
+        }                                                                       \
+    } while (0)
+
+/* Returns the exit status of the test program */
+int host_test_result(const char *name);
+
+/* Advances the software timers by the given time, running expired callbacks */
+void host_timer_advance(uint32_t ms);
+
+/* Period of the last start of the timer; 0 if it was never started */
+uint16_t host_timer_period(cy_timer_id_t id);
+
+/* Stops all timers and forgets their periods */
+void host_timer_reset(void);
+
+/* Last capabilities published with Cy_PdStack_Dpm_UpdateSrcCap on each port */
+typedef struct
+{
+    cy_pd_pd_do_t pdo[CY_PD_MAX_NO_OF_PDO];
+    uint8_t count;
+    uint8_t mask;
+    uint32_t updates;
+} host_src_cap_t;
+
+extern host_src_cap_t host_src_cap[NO_OF_TYPEC_PORTS];
+
+/* Number of PD and Type-C commands issued on each port */
+extern uint32_t host_pd_cmd_count[NO_OF_TYPEC_PORTS];
+extern uint32_t host_typec_cmd_count[NO_OF_TYPEC_PORTS];
+
+/* Number of Cy_PdStack_Dpm_PeStop calls on each port */
+extern uint32_t host_pe_stop_count[NO_OF_TYPEC_PORTS];
+
+/* Status returned by Cy_PdStack_Dpm_SendPdCommand */
+extern cy_en_pdstack_status_t host_pd_cmd_status;
+
+/* Last PD and Type-C command issued on each port, and the callback of the Type-C command */
+extern cy_en_pdstack_dpm_pd_cmd_t host_pd_cmd_last[NO_OF_TYPEC_PORTS];
+extern cy_en_pdstack_dpm_pd_cmd_t host_typec_cmd_last[NO_OF_TYPEC_PORTS];
+extern cy_pdstack_dpm_typec_cmd_cbk_t host_typec_cmd_cbk[NO_OF_TYPEC_PORTS];
+
+/* Number of Cy_PdStack_Dpm_Start calls on each port */
+extern uint32_t host_dpm_start_count[NO_OF_TYPEC_PORTS];
+
+/* Contexts returned by Cy_PdStack_Dpm_GetContext; set by the test */
+extern cy_stc_pdstack_context_t *host_dpm_context[NO_OF_TYPEC_PORTS];
+
+/* USBPD fault comparators */
+typedef enum
+{
+    HOST_FAULT_VBUS_OVP = 0,
+    HOST_FAULT_VBUS_UVP,
+    HOST_FAULT_VBUS_OCP,
+    HOST_FAULT_VBUS_SCP,
+    HOST_FAULT_VBUS_RCP,
+    HOST_FAULT_VCONN_OCP,
+    HOST_FAULT_COUNT
+} host_fault_t;
+
+/* Setting of a fault comparator from the last Cy_USBPD_Fault_* call */
+typedef struct
+{
+    cy_cb_vbus_fault_t cb;
+    uint32_t level;             /* Voltage in mV or current in 10 mA units */
+    uint32_t enables;           /* Number of enable calls */
+    bool enabled;
+} host_fault_comp_t;
+
+extern host_fault_comp_t host_fault_comp[NO_OF_TYPEC_PORTS][HOST_FAULT_COUNT];
+
+/* Gate driver and VBUS discharge state of each port */
+extern bool host_pfet_on[NO_OF_TYPEC_PORTS];
+extern bool host_cfet_on[NO_OF_TYPEC_PORTS];
+extern bool host_discharge_on[NO_OF_TYPEC_PORTS];
+
+/*
+ * Maps the flash rows from first_row to the end of flash at their device
+ * addresses, which must be page aligned. Returns false if the range is taken.
+ */
+bool host_flash_map(uint16_t first_row);
+
+/* Number of Cy_Flash_WriteRow calls */
+extern uint32_t host_flash_writes;
+
+#endif /* HOST_TEST_H */
@@ -0,0 +1,5 @@
+/* Host build replacement; see host_sdk.h */
+#ifndef HOST_CY_PDALTMODE_DEFINES_H
+#define HOST_CY_PDALTMODE_DEFINES_H
+#include "host_sdk.h"
+#endif
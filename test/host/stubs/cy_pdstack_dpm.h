@@ -0,0 +1,5 @@
+/* Host build replacement; see host_sdk.h */
+#ifndef HOST_CY_PDSTACK_DPM_H
+#define HOST_CY_PDSTACK_DPM_H
+#include "host_sdk.h"
+#endif
@@ -0,0 +1,5 @@
+/* Host build replacement; see host_sdk.h */
+#ifndef HOST_CY_PDUTILS_SW_TIMER_H
+#define HOST_CY_PDUTILS_SW_TIMER_H
+#include "host_sdk.h"
+#endif
@@ -0,0 +1,5 @@
+/* Host build replacement; see host_sdk.h */
+#ifndef HOST_CY_USBPD_VBUS_CTRL_H
+#define HOST_CY_USBPD_VBUS_CTRL_H
+#include "host_sdk.h"
+#endif
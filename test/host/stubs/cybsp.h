@@ -0,0 +1,5 @@
+/* Host build replacement; see host_sdk.h */
+#ifndef HOST_CYBSP_H
+#define HOST_CYBSP_H
+#include "host_sdk.h"
+#endif
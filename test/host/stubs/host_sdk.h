@@ -0,0 +1,671 @@
+/*
+ * Minimal host build replacements for the PDL, PDStack, USBPD and PDUtils
+ * declarations used by the application modules under test. Only the types,
+ * fields and functions referenced by those modules are provided; the layout
+ * of the PD data objects follows the USB PD specification.
+ */
+
+#ifndef HOST_SDK_H
+#define HOST_SDK_H
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <stddef.h>
+
+/*******************************************************************************
+ * Build configuration
+ ******************************************************************************/
+#ifndef NO_OF_TYPEC_PORTS
+#define NO_OF_TYPEC_PORTS                       (2u)
+#endif
+#ifndef CY_PD_REV3_ENABLE
+#define CY_PD_REV3_ENABLE                       (1u)
+#endif
+#ifndef CY_PD_EPR_ENABLE
+#define CY_PD_EPR_ENABLE                        (0u)
+#endif
+#ifndef CY_PD_EPR_AVS_ENABLE
+#define CY_PD_EPR_AVS_ENABLE                    (0u)
+#endif
+#ifndef CY_PD_SOURCE_ONLY
+#define CY_PD_SOURCE_ONLY                       (0u)
+#endif
+#ifndef CY_PD_SINK_ONLY
+#define CY_PD_SINK_ONLY                         (0u)
+#endif
+
+/*******************************************************************************
+ * PDL
+ ******************************************************************************/
+typedef struct { uint32_t reserved; } CySCB_Type;
+typedef struct { uint32_t reserved; } cy_stc_scb_uart_config_t;
+typedef struct { uint32_t reserved; } cy_stc_scb_i2c_context_t;
+
+uint32_t Cy_SysLib_EnterCriticalSection(void);
+void Cy_SysLib_ExitCriticalSection(uint32_t savedIntrStatus);
+void Cy_SysLib_DelayUs(uint16_t microseconds);
+
+typedef enum
+{
+    CY_FLASH_DRV_SUCCESS = 0,
+    CY_FLASH_DRV_INV_PROT
+} cy_en_flashdrv_status_t;
+
+cy_en_flashdrv_status_t Cy_Flash_WriteRow(uint32_t rowAddr, const uint32_t *data);
+
+/*******************************************************************************
+ * Flash layout
+ ******************************************************************************/
+#define CY_APP_SYS_FLASH_ROW_SIZE               (128u)
+#define CY_APP_SYS_FLASH_ROW_SHIFT_NUM          (7u)
+#define CY_APP_SYS_FLASH_ROW_COUNT              (0x400u)
+#define CY_APP_SYS_APP_PRIORITY_ROW_NUM         (CY_APP_SYS_FLASH_ROW_COUNT - 4u)
+
+/*******************************************************************************
+ * PDUtils
+ ******************************************************************************/
+#define CY_PDUTILS_GET_MIN(a, b)                (((a) > (b)) ? (b) : (a))
+#define CY_PDUTILS_GET_MAX(a, b)                (((a) > (b)) ? (a) : (b))
+#define CY_PDUTILS_DIV_ROUND_UP(x, y)           (((x) + ((y) - 1u)) / (y))
+
+#define CY_PDUTILS_TIMER_APP_PORT0_START_ID     (0x200u)
+#define CY_PDUTILS_TIMER_APP_PORT1_START_ID     (0x300u)
+
+/* Application timer IDs of both ports and the PD stack timers fit in this range */
+#define HOST_TIMER_COUNT                        (0x400u)
+
+typedef uint16_t cy_timer_id_t;
+typedef void (*cy_cb_timer_t)(cy_timer_id_t id, void *callbackContext);
+typedef struct { uint32_t reserved; } cy_stc_pdutils_sw_timer_t;
+
+uint32_t Cy_PdUtils_DivRoundUp(uint32_t x, uint32_t y);
+bool Cy_PdUtils_SwTimer_Start(cy_stc_pdutils_sw_timer_t *context, void *callbackContext,
+        cy_timer_id_t id, uint16_t period, cy_cb_timer_t cb);
+void Cy_PdUtils_SwTimer_Stop(cy_stc_pdutils_sw_timer_t *context, cy_timer_id_t id);
+void Cy_PdUtils_SwTimer_StopRange(cy_stc_pdutils_sw_timer_t *context, cy_timer_id_t start, cy_timer_id_t end);
+bool Cy_PdUtils_SwTimer_IsRunning(cy_stc_pdutils_sw_timer_t *context, cy_timer_id_t id);
+uint16_t Cy_PdUtils_SwTimer_GetCount(cy_stc_pdutils_sw_timer_t *context, cy_timer_id_t id);
+
+/*******************************************************************************
+ * USBPD
+ ******************************************************************************/
+typedef enum
+{
+    CY_USBPD_ADC_ID_0 = 0,
+    CY_USBPD_ADC_ID_1
+} cy_en_usbpd_adc_id_t;
+
+typedef enum
+{
+    CY_USBPD_ADC_INPUT_AMUX_A = 0,
+    CY_USBPD_ADC_INPUT_AMUX_B
+} cy_en_usbpd_adc_input_t;
+
+typedef enum
+{
+    CY_USBPD_SUPPLY_V5V = 0,
+    CY_USBPD_SUPPLY_VSYS
+} cy_en_usbpd_supply_t;
+
+typedef bool (*cy_cb_vbus_fault_t)(void *context, bool compOut);
+
+typedef enum
+{
+    CY_USBPD_VBUS_OVP_MODE_ADC = 0,
+    CY_USBPD_VBUS_OVP_MODE_UVOV,
+    CY_USBPD_VBUS_OVP_MODE_UVOV_AUTOCTRL
+} cy_en_usbpd_vbus_ovp_mode_t;
+
+typedef struct
+{
+    uint8_t enable;
+    uint8_t mode;
+    uint8_t threshold;
+    uint8_t debounce;
+    uint8_t retryCount;
+} cy_stc_fault_vbus_ovp_cfg_t;
+
+typedef struct
+{
+    uint8_t enable;
+    uint8_t mode;
+    uint8_t threshold;
+    uint8_t debounce;
+    uint8_t retryCount;
+} cy_stc_fault_vbus_uvp_cfg_t;
+
+typedef struct
+{
+    uint8_t enable;
+    uint8_t debounce;
+    uint8_t retryCount;
+} cy_stc_fault_vbus_ocp_cfg_t;
+
+typedef struct
+{
+    uint8_t enable;
+    uint8_t debounce;
+    uint8_t retryCount;
+} cy_stc_fault_vbus_scp_cfg_t;
+
+typedef struct
+{
+    uint8_t enable;
+    uint8_t retryCount;
+} cy_stc_fault_vbus_rcp_cfg_t;
+
+typedef struct
+{
+    uint8_t enable;
+    uint8_t debounce;
+    uint8_t retryCount;
+} cy_stc_fault_vconn_ocp_cfg_t;
+
+typedef struct
+{
+    cy_stc_fault_vbus_ovp_cfg_t *vbusOvpConfig;
+    cy_stc_fault_vbus_ocp_cfg_t *vbusOcpConfig;
+    cy_stc_fault_vbus_rcp_cfg_t *vbusRcpConfig;
+    cy_stc_fault_vbus_uvp_cfg_t *vbusUvpConfig;
+    cy_stc_fault_vbus_scp_cfg_t *vbusScpConfig;
+    cy_stc_fault_vconn_ocp_cfg_t *vconnOcpConfig;
+} cy_stc_usbpd_config_t;
+
+typedef enum
+{
+    CY_USBPD_PHY_EVT_TX_MSG_COLLISION = 0,
+    CY_USBPD_PHY_EVT_TX_MSG_PHY_IDLE,
+    CY_USBPD_PHY_EVT_TX_MSG_FAILED,
+    CY_USBPD_PHY_EVT_TX_MSG_SUCCESS,
+    CY_USBPD_PHY_EVT_TX_RST_COLLISION,
+    CY_USBPD_PHY_EVT_TX_RST_SUCCESS,
+    CY_USBPD_PHY_EVT_RX_MSG,
+    CY_USBPD_PHY_EVT_RX_MSG_CMPLT,
+    CY_USBPD_PHY_EVT_RX_RST,
+    CY_USBPD_PHY_EVT_FRS_SIG_RCVD,
+    CY_USBPD_PHY_EVT_FRS_SIG_SENT
+} cy_en_usbpd_phy_events_t;
+
+typedef void (*cy_usbpd_phy_cbk_t)(void *callbackCtx, uint32_t event);
+
+typedef struct
+{
+    uint8_t port;
+    cy_stc_usbpd_config_t *usbpdConfig;
+    cy_usbpd_phy_cbk_t pdPhyCbk;
+    void *pdStackContext;
+} cy_stc_usbpd_context_t;
+
+/*******************************************************************************
+ * PDStack
+ ******************************************************************************/
+#define TYPEC_PORT_0_IDX                        (0u)
+#define TYPEC_PORT_1_IDX                        (1u)
+#define CY_PD_MAX_NO_OF_PDO                     (7u)
+#define CY_PD_MAX_NO_OF_EPR_PDO                 (6u)
+#define CY_PD_VSAFE_0V                          (0u)
+#define CY_PD_VSAFE_5V                          (5000u)
+#define CY_PD_VSAFE_15V                         (15000u)
+#define CY_PD_ISAFE_DEF                         (50u)
+#define CY_PD_VOLT_PER_UNIT                     (50u)
+#define CY_PD_SNK_MIN_MAX_MASK                  (0x3FFu)
+#define CY_PD_GIVE_BACK_MASK                    (0x8000u)
+#define CY_PD_EXTERNALLY_POWERED_BIT_POS        (7u)
+
+#define CY_PDSTACK_PDO_FIXED_SUPPLY             (0u)
+#define CY_PDSTACK_PDO_BATTERY                  (1u)
+#define CY_PDSTACK_PDO_VARIABLE_SUPPLY          (2u)
+#define CY_PDSTACK_PDO_AUGMENTED                (3u)
+
+#define CY_PDSTACK_APDO_PPS                     (0u)
+#define CY_PDSTACK_APDO_AVS                     (1u)
+#define CY_PDSTACK_APDO_SPR_AVS                 (2u)
+
+#define CY_PDSTACK_HIGHEST_POWER                (1u)
+#define CY_PDSTACK_HIGHEST_VOLTAGE              (2u)
+#define CY_PDSTACK_HIGHEST_CURRENT              (3u)
+
+#define CY_PDSTACK_GET_PD_TIMER_ID(context, id) ((cy_timer_id_t)(id) + (cy_timer_id_t)((context)->port * 0x40u))
+#define CY_PDSTACK_PD_VCONN_RECOVERY_TIMER      (0x10u)
+#define CY_PDSTACK_PD_OCP_DEBOUNCE_TIMER        (0x11u)
+#define CY_PDSTACK_PD_VCONN_OCP_DEBOUNCE_TIMER  (0x12u)
+
+typedef enum
+{
+    CY_PD_REV1 = 0,
+    CY_PD_REV2,
+    CY_PD_REV3
+} cy_en_pd_pd_rev_t;
+
+typedef enum
+{
+    CY_PD_PRT_ROLE_SINK = 0,
+    CY_PD_PRT_ROLE_SOURCE,
+    CY_PD_PRT_DUAL
+} cy_en_pd_port_role_t;
+
+typedef enum
+{
+    CY_PD_PRT_TYPE_UFP = 0,
+    CY_PD_PRT_TYPE_DRP,
+    CY_PD_PRT_TYPE_DFP
+} cy_en_pd_port_type_t;
+
+typedef enum
+{
+    CY_PD_CC_CHANNEL_1 = 0,
+    CY_PD_CC_CHANNEL_2
+} cy_en_pd_cc_channel_t;
+
+typedef enum
+{
+    CY_PDSTACK_STAT_SUCCESS = 0,
+    CY_PDSTACK_STAT_BUSY,
+    CY_PDSTACK_STAT_FAILURE
+} cy_en_pdstack_status_t;
+
+typedef enum
+{
+    CY_PDSTACK_REQ_SEND_HARD_RESET = 1,
+    CY_PDSTACK_REQ_ACCEPT,
+    CY_PDSTACK_REQ_REJECT,
+    CY_PDSTACK_REQ_WAIT,
+    CY_PDSTACK_REQ_NOT_SUPPORTED
+} cy_en_pdstack_app_req_status_t;
+
+typedef enum
+{
+    CY_PDSTACK_DPM_CMD_SRC_CAP_CHNG = 0,
+    CY_PDSTACK_DPM_CMD_SEND_HARD_RESET,
+    CY_PDSTACK_DPM_CMD_TYPEC_ERR_RECOVERY,
+    CY_PDSTACK_DPM_CMD_PORT_DISABLE
+} cy_en_pdstack_dpm_pd_cmd_t;
+
+typedef enum
+{
+    APP_RESP_ACCEPT = 0,
+    APP_RESP_REJECT,
+    APP_RESP_WAIT,
+    APP_RESP_NOT_SUPPORTED
+} cy_en_pdstack_app_resp_t;
+
+typedef enum
+{
+    CY_PDSTACK_DPM_RESP_FAIL = 0,
+    CY_PDSTACK_DPM_RESP_SUCCESS
+} cy_en_pdstack_dpm_typec_cmd_resp_t;
+
+typedef enum
+{
+    CY_PDSTACK_EPR_MODE_ENTER = 0,
+    CY_PDSTACK_EPR_MODE_EXIT
+} cy_en_pdstack_eprmdo_action_t;
+
+typedef enum
+{
+    APP_EVT_TYPEC_ATTACH = 0,
+    APP_EVT_CONNECT,
+    APP_EVT_DISCONNECT,
+    APP_EVT_HARD_RESET_RCVD,
+    APP_EVT_HARD_RESET_SENT,
+    APP_EVT_HARD_RESET_COMPLETE,
+    APP_EVT_PD_CONTRACT_NEGOTIATION_COMPLETE,
+    APP_EVT_PR_SWAP_COMPLETE,
+    APP_EVT_FR_SWAP_COMPLETE,
+    APP_EVT_TYPE_C_ERROR_RECOVERY,
+    APP_EVT_VBUS_PORT_DISABLE,
+    APP_EVT_VBUS_OCP_FAULT,
+    APP_EVT_VBUS_OVP_FAULT,
+    APP_EVT_VBUS_UVP_FAULT,
+    APP_EVT_VBUS_SCP_FAULT,
+    APP_EVT_VBUS_RCP_FAULT,
+    APP_EVT_VCONN_OCP_FAULT,
+    APP_EVT_STANDBY_CURRENT
+} cy_en_pdstack_app_evt_t;
+
+typedef union
+{
+    uint32_t val;
+
+    struct
+    {
+        uint32_t maxCurPower    : 10;
+        uint32_t minVoltage     : 10;
+        uint32_t maxVoltage     : 10;
+        uint32_t supplyType     : 2;
+    } src_gen;
+
+    struct
+    {
+        uint32_t maxCurrent     : 10;
+        uint32_t voltage        : 10;
+        uint32_t pkPeakCurrent  : 2;
+        uint32_t reserved       : 1;
+        uint32_t eprModeCapable : 1;
+        uint32_t unchunkSup     : 1;
+        uint32_t drSwap         : 1;
+        uint32_t usbCommCap     : 1;
+        uint32_t extPowered     : 1;
+        uint32_t usbSuspendSup  : 1;
+        uint32_t dualRolePower  : 1;
+        uint32_t supplyType     : 2;
+    } fixed_src;
+
+    struct
+    {
+        uint32_t maxCurrent     : 10;
+        uint32_t minVoltage     : 10;
+        uint32_t maxVoltage     : 10;
+        uint32_t supplyType     : 2;
+    } var_src;
+
+    struct
+    {
+        uint32_t maxPower       : 10;
+        uint32_t minVoltage     : 10;
+        uint32_t maxVoltage     : 10;
+        uint32_t supplyType     : 2;
+    } bat_src;
+
+    struct
+    {
+        uint32_t maxCur         : 7;
+        uint32_t reserved1      : 1;
+        uint32_t minVolt        : 8;
+        uint32_t reserved2      : 1;
+        uint32_t maxVolt        : 8;
+        uint32_t reserved3      : 2;
+        uint32_t pwrLimited     : 1;
+        uint32_t apdoType       : 2;
+        uint32_t supplyType     : 2;
+    } pps_src;
+
+    struct
+    {
+        uint32_t pdp            : 8;
+        uint32_t minVolt        : 9;
+        uint32_t reserved1      : 1;
+        uint32_t maxVolt        : 9;
+        uint32_t pkPower        : 1;
+        uint32_t apdoType       : 2;
+        uint32_t supplyType     : 2;
+    } epr_avs_src;
+
+    struct
+    {
+        uint32_t maxCur2        : 10;
+        uint32_t maxCur1        : 10;
+        uint32_t reserved1      : 6;
+        uint32_t pkCurrent      : 2;
+        uint32_t apdoType       : 2;
+        uint32_t supplyType     : 2;
+    } spr_avs_src;
+
+    struct
+    {
+        uint32_t opCurrent      : 10;
+        uint32_t voltage        : 10;
+        uint32_t reserved       : 3;
+        uint32_t frSwap         : 2;
+        uint32_t drSwap         : 1;
+        uint32_t usbCommCap     : 1;
+        uint32_t extPowered     : 1;
+        uint32_t highCap        : 1;
+        uint32_t dualRolePower  : 1;
+        uint32_t supplyType     : 2;
+    } fixed_snk;
+
+    struct
+    {
+        uint32_t opCurrent      : 10;
+        uint32_t minVoltage     : 10;
+        uint32_t maxVoltage     : 10;
+        uint32_t supplyType     : 2;
+    } var_snk;
+
+    struct
+    {
+        uint32_t opPower        : 10;
+        uint32_t minVoltage     : 10;
+        uint32_t maxVoltage     : 10;
+        uint32_t supplyType     : 2;
+    } bat_snk;
+
+    struct
+    {
+        uint32_t opCur          : 7;
+        uint32_t reserved1      : 1;
+        uint32_t minVolt        : 8;
+        uint32_t reserved2      : 1;
+        uint32_t maxVolt        : 8;
+        uint32_t reserved3      : 3;
+        uint32_t apdoType       : 2;
+        uint32_t supplyType     : 2;
+    } pps_snk;
+
+    struct
+    {
+        uint32_t pdp            : 8;
+        uint32_t minVolt        : 9;
+        uint32_t reserved1      : 1;
+        uint32_t maxVolt        : 9;
+        uint32_t reserved2      : 1;
+        uint32_t apdoType       : 2;
+        uint32_t supplyType     : 2;
+    } epr_avs_snk;
+
+    struct
+    {
+        uint32_t minMaxPowerCur : 10;
+        uint32_t opPowerCur     : 10;
+        uint32_t reserved1      : 2;
+        uint32_t eprModeCapable : 1;
+        uint32_t unchunkSup     : 1;
+        uint32_t noUsbSuspend   : 1;
+        uint32_t usbCommCap     : 1;
+        uint32_t capMismatch    : 1;
+        uint32_t giveBackFlag   : 1;
+        uint32_t objPos         : 4;
+    } rdo_gen;
+
+    struct
+    {
+        uint32_t opCur          : 7;
+        uint32_t reserved1      : 2;
+        uint32_t outVolt        : 12;
+        uint32_t reserved2      : 1;
+        uint32_t eprModeCapable : 1;
+        uint32_t unchunkSup     : 1;
+        uint32_t noUsbSuspend   : 1;
+        uint32_t usbCommCap     : 1;
+        uint32_t capMismatch    : 1;
+        uint32_t reserved3      : 1;
+        uint32_t objPos         : 4;
+    } rdo_pps;
+
+    struct
+    {
+        uint32_t opCur          : 7;
+        uint32_t reserved1      : 2;
+        uint32_t outVolt        : 12;
+        uint32_t reserved2      : 1;
+        uint32_t eprModeCapable : 1;
+        uint32_t unchunkSup     : 1;
+        uint32_t noUsbSuspend   : 1;
+        uint32_t usbCommCap     : 1;
+        uint32_t capMismatch    : 1;
+        uint32_t reserved3      : 1;
+        uint32_t objPos         : 4;
+    } rdo_epr_avs;
+
+    struct
+    {
+        uint32_t opCur          : 7;
+        uint32_t reserved1      : 2;
+        uint32_t outVolt        : 12;
+        uint32_t reserved2      : 1;
+        uint32_t eprModeCapable : 1;
+        uint32_t unchunkSup     : 1;
+        uint32_t noUsbSuspend   : 1;
+        uint32_t usbCommCap     : 1;
+        uint32_t capMismatch    : 1;
+        uint32_t reserved3      : 1;
+        uint32_t objPos         : 4;
+    } rdo_spr_avs;
+
+    struct
+    {
+        uint32_t reserved1      : 16;
+        uint32_t hotSwapBat     : 4;
+        uint32_t fixedBat       : 4;
+        uint32_t reserved2      : 1;
+        uint32_t batStatusChange: 1;
+        uint32_t ocp            : 1;
+        uint32_t otp            : 1;
+        uint32_t opCondChange   : 1;
+        uint32_t srcInputChange : 1;
+        uint32_t ovp            : 1;
+        uint32_t extAlert       : 1;
+    } ado_alert;
+} cy_pd_pd_do_t;
+
+typedef union
+{
+    uint32_t val;
+    struct
+    {
+        uint32_t msgType        : 5;
+        uint32_t specRev        : 2;
+        uint32_t dataRole       : 1;
+        uint32_t pwrRole        : 1;
+        uint32_t msgId          : 3;
+        uint32_t len            : 3;
+        uint32_t extd           : 1;
+        uint32_t dataSize       : 9;
+        uint32_t reserved       : 7;
+    } hdr;
+} cy_pd_pd_hdr_t;
+
+typedef struct
+{
+    cy_pd_pd_hdr_t hdr;
+    uint8_t len;
+    cy_pd_pd_do_t dat[CY_PD_MAX_NO_OF_PDO + CY_PD_MAX_NO_OF_EPR_PDO];
+} cy_stc_pdstack_pd_packet_t;
+
+typedef struct
+{
+    bool attach;
+    bool contractExist;
+    uint8_t curPortRole;
+    uint8_t curPortType;
+    uint8_t specRevSopLive;
+    uint8_t polarity;
+    uint8_t revPol;
+    uint8_t attachedDev;
+    bool vconnLogical;
+    bool dpmEnabled;
+} cy_stc_pd_dpm_config_t;
+
+typedef struct
+{
+    cy_pd_pd_do_t curSnkPdo[CY_PD_MAX_NO_OF_PDO + CY_PD_MAX_NO_OF_EPR_PDO];
+    uint16_t curSnkMaxMin[CY_PD_MAX_NO_OF_PDO + CY_PD_MAX_NO_OF_EPR_PDO];
+    uint8_t curSnkPdocount;
+    cy_pd_pd_do_t curSrcPdo[CY_PD_MAX_NO_OF_PDO];
+    uint8_t srcPdoCount;
+    uint8_t srcPdoMask;
+    uint8_t snkPdoMask;
+    uint8_t srcPdoFlags[2];
+    uint8_t snkPdoFlags[2];
+    uint8_t portRole;
+    bool deadBat;
+    cy_pd_pd_do_t srcSelPdo;
+    cy_pd_pd_do_t srcRdo;
+    bool snkUsbSuspEn;
+    bool snkUsbCommEn;
+    bool faultActive;
+    uint8_t swapResponse;
+    uint8_t srcCurLevel;
+    cy_pd_pd_do_t alert;
+} cy_stc_pdstack_dpm_status_t;
+
+typedef struct
+{
+    struct
+    {
+        bool snkEnable;
+    } epr;
+    bool eprActive;
+    uint8_t curEprSnkPdoCount;
+} cy_stc_pdstack_dpm_ext_status_t;
+
+typedef struct
+{
+    uint8_t hardResetCount;
+} cy_stc_pdstack_pe_status_t;
+
+typedef struct cy_stc_pdstack_context
+{
+    uint8_t port;
+    cy_stc_pdstack_pe_status_t peStat;
+    cy_stc_pd_dpm_config_t dpmConfig;
+    cy_stc_pdstack_dpm_status_t dpmStat;
+    cy_stc_pdstack_dpm_ext_status_t dpmExtStat;
+    cy_stc_pdutils_sw_timer_t *ptrTimerContext;
+    cy_stc_usbpd_context_t *ptrUsbPdContext;
+    void *ptrAltModeContext;
+} cy_stc_pdstack_context_t;
+
+typedef struct
+{
+    cy_pd_pd_do_t respDo;
+    cy_en_pdstack_app_req_status_t reqStatus;
+} app_resp_t;
+
+typedef struct
+{
+    uint8_t faultStatus;
+} cy_stc_pdstack_app_status_t;
+
+typedef void (*cy_pdstack_app_resp_cbk_t)(cy_stc_pdstack_context_t *ptrPdStackContext, app_resp_t *appResp);
+typedef void (*cy_pdstack_pwr_ready_cbk_t)(cy_stc_pdstack_context_t *ptrPdStackContext);
+typedef void (*cy_pdstack_sink_discharge_off_cbk_t)(cy_stc_pdstack_context_t *ptrPdStackContext);
+typedef void (*cy_pdstack_dpm_typec_cmd_cbk_t)(cy_stc_pdstack_context_t *ptrPdStackContext,
+        cy_en_pdstack_dpm_typec_cmd_resp_t resp);
+typedef void (*cy_pdstack_dpm_pd_cmd_cbk_t)(cy_stc_pdstack_context_t *ptrPdStackContext, uint32_t resp,
+        const void *pktPtr);
+
+cy_en_pdstack_status_t Cy_PdStack_Dpm_SendPdCommand(cy_stc_pdstack_context_t *ptrPdStackContext,
+        cy_en_pdstack_dpm_pd_cmd_t command, void *cmdParams, bool noResp, cy_pdstack_dpm_pd_cmd_cbk_t cbk);
+cy_en_pdstack_status_t Cy_PdStack_Dpm_SendTypecCommand(cy_stc_pdstack_context_t *ptrPdStackContext,
+        cy_en_pdstack_dpm_pd_cmd_t command, cy_pdstack_dpm_typec_cmd_cbk_t cbk);
+cy_en_pdstack_status_t Cy_PdStack_Dpm_UpdateSrcCap(cy_stc_pdstack_context_t *ptrPdStackContext,
+        uint8_t count, const cy_pd_pd_do_t *pdo);
+cy_en_pdstack_status_t Cy_PdStack_Dpm_UpdateSrcCapMask(cy_stc_pdstack_context_t *ptrPdStackContext, uint8_t mask);
+cy_en_pdstack_status_t Cy_PdStack_Dpm_Start(cy_stc_pdstack_context_t *ptrPdStackContext);
+cy_en_pdstack_status_t Cy_PdStack_Dpm_PeStop(cy_stc_pdstack_context_t *ptrPdStackContext);
+cy_stc_pdstack_context_t* Cy_PdStack_Dpm_GetContext(uint8_t portIdx);
+void Cy_USBPD_TypeC_RdEnable(cy_stc_usbpd_context_t *context);
+void Cy_USBPD_TypeC_DisableRd(cy_stc_usbpd_context_t *context, uint8_t channel);
+void Cy_USBPD_Fault_Vbus_OvpEnable(cy_stc_usbpd_context_t *context, uint16_t volt, cy_cb_vbus_fault_t cb, bool pctrl);
+void Cy_USBPD_Fault_Vbus_OvpDisable(cy_stc_usbpd_context_t *context, bool pctrl);
+void Cy_USBPD_Fault_Vbus_UvpEnable(cy_stc_usbpd_context_t *context, uint16_t volt, cy_cb_vbus_fault_t cb, bool pctrl);
+void Cy_USBPD_Fault_Vbus_UvpDisable(cy_stc_usbpd_context_t *context, bool pctrl);
+void Cy_USBPD_Fault_Vbus_OcpEnable(cy_stc_usbpd_context_t *context, uint32_t current, cy_cb_vbus_fault_t cb);
+void Cy_USBPD_Fault_Vbus_OcpDisable(cy_stc_usbpd_context_t *context, bool pctrl);
+void Cy_USBPD_Fault_Vbus_ScpEnable(cy_stc_usbpd_context_t *context, uint32_t current, cy_cb_vbus_fault_t cb);
+void Cy_USBPD_Fault_Vbus_ScpDisable(cy_stc_usbpd_context_t *context);
+void Cy_USBPD_Fault_Vbus_RcpEnable(cy_stc_usbpd_context_t *context, uint16_t volt, cy_cb_vbus_fault_t cb);
+void Cy_USBPD_Fault_Vbus_RcpDisable(cy_stc_usbpd_context_t *context);
+void Cy_USBPD_Fault_Vconn_OcpEnable(cy_stc_usbpd_context_t *context, cy_cb_vbus_fault_t cb);
+void Cy_USBPD_Fault_Vconn_OcpDisable(cy_stc_usbpd_context_t *context);
+void Cy_USBPD_Vbus_GdrvPfetOn(cy_stc_usbpd_context_t *context, bool pfet);
+void Cy_USBPD_Vbus_GdrvPfetOff(cy_stc_usbpd_context_t *context, bool pfet);
+void Cy_USBPD_Vbus_GdrvCfetOn(cy_stc_usbpd_context_t *context, bool pfet);
+void Cy_USBPD_Vbus_GdrvCfetOff(cy_stc_usbpd_context_t *context, bool pfet);
+void Cy_USBPD_Vbus_DischargeOn(cy_stc_usbpd_context_t *context);
+void Cy_USBPD_Vbus_DischargeOff(cy_stc_usbpd_context_t *context);
+cy_en_pdstack_status_t Cy_PdStack_Dpm_IsRdoValid(cy_stc_pdstack_context_t *ptrPdStackContext, cy_pd_pd_do_t rdo);
+
+#endif /* HOST_SDK_H */
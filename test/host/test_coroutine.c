@@ -0,0 +1,106 @@
+/*
+ * Host test of the coroutine scheduler: wake-up of sequences which share the
+ * port timer, and release of a slot which a completing sequence has handed to
+ * another function.
+ */
+
+#include <string.h>
+#include "host_test.h"
+#include "cy_app_coroutine.h"
+
+static cy_stc_pdstack_context_t ctx;
+
+static uint32_t first_runs;
+static uint32_t second_runs;
+static uint32_t ticks;
+
+static cy_en_app_coro_status_t second(cy_stc_pdstack_context_t *context, cy_stc_app_coro_t *coro)
+{
+    CY_APP_CORO_BEGIN(coro);
+
+    second_runs++;
+    CY_APP_CORO_WAIT_MS(coro, 10u);
+    second_runs++;
+
+    CY_APP_CORO_END(coro);
+}
+
+/* Completes after handing its slot to the second sequence */
+static cy_en_app_coro_status_t first(cy_stc_pdstack_context_t *context, cy_stc_app_coro_t *coro)
+{
+    CY_APP_CORO_BEGIN(coro);
+
+    first_runs++;
+    CY_APP_CORO_WAIT_MS(coro, 5u);
+    Cy_App_Coro_Start(context, CY_APP_CORO_GET_REVISION, second, 20u);
+
+    CY_APP_CORO_END(coro);
+}
+
+static cy_en_app_coro_status_t ticker(cy_stc_pdstack_context_t *context, cy_stc_app_coro_t *coro)
+{
+    CY_APP_CORO_BEGIN(coro);
+
+    for (;;)
+    {
+        CY_APP_CORO_WAIT_MS(coro, 3u);
+        ticks++;
+    }
+
+    CY_APP_CORO_END(coro);
+}
+
+/* Sequences with different periods are resumed at their own times */
+static void test_shared_timer(void)
+{
+    Cy_App_Coro_Start(&ctx, CY_APP_CORO_TELEMETRY, ticker, 0u);
+    HOST_CHECK_EQ(ticks, 0u);
+
+    host_timer_advance(10u);
+    HOST_CHECK_EQ(ticks, 3u);
+
+    Cy_App_Coro_Start(&ctx, CY_APP_CORO_GET_REVISION, second, 4u);
+    host_timer_advance(4u);
+    HOST_CHECK_EQ(second_runs, 1u);
+    HOST_CHECK_EQ(ticks, 4u);
+
+    host_timer_advance(10u);
+    HOST_CHECK_EQ(second_runs, 2u);
+    HOST_CHECK_EQ(ticks, 8u);
+    HOST_CHECK(!Cy_App_Coro_IsActive(&ctx, CY_APP_CORO_GET_REVISION));
+
+    Cy_App_Coro_Stop(&ctx, CY_APP_CORO_TELEMETRY);
+    host_timer_advance(10u);
+    HOST_CHECK_EQ(ticks, 8u);
+    HOST_CHECK(!Cy_App_Coro_IsActive(&ctx, CY_APP_CORO_TELEMETRY));
+}
+
+/* A slot restarted from within its coroutine is kept when the coroutine completes */
+static void test_restart_from_coroutine(void)
+{
+    second_runs = 0u;
+
+    Cy_App_Coro_Start(&ctx, CY_APP_CORO_GET_REVISION, first, 0u);
+    HOST_CHECK_EQ(first_runs, 1u);
+
+    host_timer_advance(5u);
+    HOST_CHECK(Cy_App_Coro_IsActive(&ctx, CY_APP_CORO_GET_REVISION));
+    HOST_CHECK_EQ(second_runs, 0u);
+
+    host_timer_advance(20u);
+    HOST_CHECK_EQ(second_runs, 1u);
+    host_timer_advance(10u);
+    HOST_CHECK_EQ(second_runs, 2u);
+    HOST_CHECK_EQ(first_runs, 1u);
+    HOST_CHECK(!Cy_App_Coro_IsActive(&ctx, CY_APP_CORO_GET_REVISION));
+}
+
+int main(void)
+{
+    memset(&ctx, 0, sizeof(ctx));
+
+    test_shared_timer();
+    test_restart_from_coroutine();
+
+    return host_test_result("test_coroutine");
+}
@@ -0,0 +1,285 @@
+/*
+ * Host test of the fault recovery backoff: the delay sequence of a fault source,
+ * the cap and jitter, the backoff level across detach and its decay during a
+ * stable contract, and retry limits of registered policies across InitVars.
+ */
+
+#include <string.h>
+#include "host_test.h"
+#include "cy_app.h"
+#include "cy_app_coroutine.h"
+#include "cy_app_fault_handlers.h"
+
+cy_stc_pdstack_app_status_t glAppPdStatus[NO_OF_TYPEC_PORTS];
+
+static cy_stc_pdstack_context_t ctx[NO_OF_TYPEC_PORTS];
+static cy_stc_usbpd_context_t usbpd[NO_OF_TYPEC_PORTS];
+static cy_stc_usbpd_config_t usbpd_cfg;
+
+/* OCP retry count of the configuration table */
+static cy_stc_fault_vbus_ocp_cfg_t ocp_cfg = { 1u, 10u, 5u };
+
+cy_stc_pdstack_app_status_t* Cy_App_GetPdAppStatus(uint8_t port)
+{
+    return &glAppPdStatus[port];
+}
+
+bool Cy_App_VbusIsPresent(cy_stc_pdstack_context_t *ptrPdStackContext, uint16_t volt, int8_t per)
+{
+    (void)ptrPdStackContext;
+    (void)volt;
+    (void)per;
+
+    return false;
+}
+
+static void init_port(uint8_t port)
+{
+    memset(&ctx[port], 0, sizeof(ctx[port]));
+    usbpd[port].port = port;
+    usbpd[port].usbpdConfig = &usbpd_cfg;
+    ctx[port].port = port;
+    ctx[port].ptrUsbPdContext = &usbpd[port];
+    ctx[port].dpmConfig.attach = true;
+    ctx[port].dpmConfig.contractExist = true;
+    ctx[port].dpmConfig.curPortRole = CY_PD_PRT_ROLE_SOURCE;
+}
+
+static bool backoff_running(uint8_t port)
+{
+    return Cy_App_Coro_IsActive(&ctx[port], CY_APP_CORO_FAULT_BACKOFF);
+}
+
+/*
+ * Reports the fault and lets the backoff expire. Returns the backoff delay, or 0 if
+ * the recovery was not delayed.
+ */
+static uint16_t report(uint8_t port, uint8_t fault_id)
+{
+    uint32_t recoveries = host_pd_cmd_count[port];
+    uint16_t delay = 0u;
+
+    if (fault_id == CY_APP_FAULT_TYPE_VBUS_OCP)
+    {
+        (void)Cy_App_Fault_EventHandler(&ctx[port], APP_EVT_VBUS_OCP_FAULT, NULL);
+    }
+    else
+    {
+        HOST_CHECK_EQ(Cy_App_Fault_Report(&ctx[port], fault_id), CY_APP_STAT_SUCCESS);
+    }
+
+    if (backoff_running(port))
+    {
+        delay = Cy_App_Fault_GetRecoveryStats(&ctx[port])->lastDelay;
+
+        /* The power stage stays off for the whole delay */
+        host_timer_advance(delay - 1u);
+        HOST_CHECK_EQ(host_pd_cmd_count[port], recoveries);
+        host_timer_advance(1u);
+    }
+
+    return delay;
+}
+
+static void stable_contract(uint8_t port, uint32_t periods)
+{
+    (void)Cy_App_Fault_EventHandler(&ctx[port], APP_EVT_PD_CONTRACT_NEGOTIATION_COMPLETE, NULL);
+    host_timer_advance(periods * CY_APP_FAULT_DECAY_PERIOD);
+}
+
+static void test_backoff_sequence(void)
+{
+    const cy_stc_app_fault_policy_t policy = { 100u, 10000u, 10u, 0u };
+    const cy_stc_app_fault_recovery_stats_t *stats = Cy_App_Fault_GetRecoveryStats(&ctx[0]);
+    uint32_t recoveries;
+    uint8_t id;
+
+    init_port(0u);
+    (void)Cy_App_Fault_InitVars(&ctx[0]);
+    HOST_CHECK_EQ(Cy_App_Fault_RegisterSource(&ctx[0], 0u, &id), CY_APP_STAT_SUCCESS);
+    HOST_CHECK_EQ(id, CY_APP_FAULT_TYPE_COUNT);
+    HOST_CHECK_EQ(Cy_App_Fault_SetPolicy(&ctx[0], id, &policy), CY_APP_STAT_SUCCESS);
+
+    /* The delay doubles with each occurrence and each one ends in a recovery */
+    recoveries = host_pd_cmd_count[0];
+    HOST_CHECK_EQ(report(0u, id), 100u);
+    HOST_CHECK_EQ(report(0u, id), 200u);
+    HOST_CHECK_EQ(report(0u, id), 400u);
+    HOST_CHECK_EQ(report(0u, id), 800u);
+    HOST_CHECK_EQ(host_pd_cmd_count[0], recoveries + 4u);
+    HOST_CHECK_EQ(stats->attempts, 4u);
+    HOST_CHECK_EQ(stats->lastDelay, 800u);
+    HOST_CHECK_EQ(stats->totalDelay, 1500u);
+    HOST_CHECK(Cy_App_Fault_GetStatus(&ctx[0]) & CY_APP_FAULT_STATUS_ACTIVE(id));
+
+    /* A detach clears the count but not the backoff */
+    (void)Cy_App_Fault_EventHandler(&ctx[0], APP_EVT_DISCONNECT, NULL);
+    HOST_CHECK_EQ(Cy_App_Fault_GetStatus(&ctx[0]), 0u);
+    HOST_CHECK_EQ(report(0u, id), 1600u);
+
+    /* Each stable contract period forgets one occurrence */
+    stable_contract(0u, 1u);
+    HOST_CHECK_EQ(Cy_App_Fault_GetStatus(&ctx[0]), 0u);
+    stable_contract(0u, 1u);
+    HOST_CHECK_EQ(report(0u, id), 800u);
+
+    /* A fault ends the stable contract period */
+    (void)Cy_App_Fault_EventHandler(&ctx[0], APP_EVT_PD_CONTRACT_NEGOTIATION_COMPLETE, NULL);
+    host_timer_advance(CY_APP_FAULT_DECAY_PERIOD - 1u);
+    HOST_CHECK_EQ(report(0u, id), 1600u);
+    host_timer_advance(CY_APP_FAULT_DECAY_PERIOD);
+    HOST_CHECK_EQ(report(0u, id), 3200u);
+
+    /* Capped at the maximum delay */
+    HOST_CHECK_EQ(report(0u, id), 6400u);
+    HOST_CHECK_EQ(report(0u, id), 10000u);
+    HOST_CHECK_EQ(report(0u, id), 10000u);
+
+    /* Fully decayed back to the base delay */
+    (void)Cy_App_Fault_EventHandler(&ctx[0], APP_EVT_DISCONNECT, NULL);
+    stable_contract(0u, 20u);
+    HOST_CHECK_EQ(report(0u, id), 100u);
+
+    /* No recovery once the fault source is disconnected */
+    (void)Cy_App_Fault_Report(&ctx[0], id);
+    HOST_CHECK(backoff_running(0u));
+    recoveries = host_pd_cmd_count[0];
+    (void)Cy_App_Fault_EventHandler(&ctx[0], APP_EVT_DISCONNECT, NULL);
+    host_timer_advance(1000u);
+    HOST_CHECK(!backoff_running(0u));
+    HOST_CHECK_EQ(host_pd_cmd_count[0], recoveries);
+}
+
+static void test_retry_limit(void)
+{
+    const cy_stc_app_fault_policy_t policy = { 100u, 1000u, 2u, 0u };
+    uint32_t pe_stops;
+    uint8_t id = CY_APP_FAULT_TYPE_COUNT;
+
+    /* Continues with the source registered by test_backoff_sequence */
+    HOST_CHECK_EQ(Cy_App_Fault_SetPolicy(&ctx[0], id, &policy), CY_APP_STAT_SUCCESS);
+    (void)Cy_App_Fault_EventHandler(&ctx[0], APP_EVT_DISCONNECT, NULL);
+    stable_contract(0u, 20u);
+
+    pe_stops = host_pe_stop_count[0];
+    HOST_CHECK_EQ(report(0u, id), 100u);
+    HOST_CHECK_EQ(report(0u, id), 200u);
+    HOST_CHECK(!Cy_App_Fault_IsCountExceeded(&ctx[0]));
+
+    /* The third occurrence disables the port without a backoff */
+    HOST_CHECK_EQ(report(0u, id), 0u);
+    HOST_CHECK(Cy_App_Fault_IsCountExceeded(&ctx[0]));
+    HOST_CHECK(Cy_App_Fault_GetStatus(&ctx[0]) & CY_APP_FAULT_STATUS_EXCEEDED(id));
+    HOST_CHECK_EQ(host_pe_stop_count[0], pe_stops + 1u);
+
+    /* Invalid policies */
+    HOST_CHECK_EQ(Cy_App_Fault_SetPolicy(&ctx[0], id, NULL), CY_APP_STAT_BAD_PARAM);
+    {
+        const cy_stc_app_fault_policy_t inverted = { 1000u, 100u, 2u, 0u };
+        const cy_stc_app_fault_policy_t jitter = { 100u, 1000u, 2u, 101u };
+
+        HOST_CHECK_EQ(Cy_App_Fault_SetPolicy(&ctx[0], id, &inverted), CY_APP_STAT_BAD_PARAM);
+        HOST_CHECK_EQ(Cy_App_Fault_SetPolicy(&ctx[0], id, &jitter), CY_APP_STAT_BAD_PARAM);
+        HOST_CHECK_EQ(Cy_App_Fault_SetPolicy(&ctx[0], id + 1u, &policy), CY_APP_STAT_BAD_PARAM);
+    }
+}
+
+static void test_jitter(void)
+{
+    const cy_stc_app_fault_policy_t policy = { 100u, 1000u, 50u, 20u };
+    uint16_t delay;
+    uint8_t round;
+
+    init_port(1u);
+    (void)Cy_App_Fault_InitVars(&ctx[1]);
+    HOST_CHECK_EQ(Cy_App_Fault_SetPolicy(&ctx[1], CY_APP_FAULT_TYPE_VBUS_OCP, &policy), CY_APP_STAT_SUCCESS);
+
+    /* Within 20 % of the nominal delay, which still doubles */
+    for (round = 0u; round < 8u; round++)
+    {
+        delay = report(1u, CY_APP_FAULT_TYPE_VBUS_OCP);
+        HOST_CHECK((delay >= 80u) && (delay <= 120u));
+        delay = report(1u, CY_APP_FAULT_TYPE_VBUS_OCP);
+        HOST_CHECK((delay >= 160u) && (delay <= 240u));
+
+        (void)Cy_App_Fault_EventHandler(&ctx[1], APP_EVT_DISCONNECT, NULL);
+        stable_contract(1u, 3u);
+    }
+}
+
+/* Retry limit of a built-in fault source, checked by reporting faults until it is exceeded */
+static uint8_t ocp_retry_limit(uint8_t port)
+{
+    uint8_t count = 0u;
+
+    (void)Cy_App_Fault_EventHandler(&ctx[port], APP_EVT_DISCONNECT, NULL);
+    while ((!Cy_App_Fault_IsCountExceeded(&ctx[port])) && (count < 20u))
+    {
+        (void)report(port, CY_APP_FAULT_TYPE_VBUS_OCP);
+        count++;
+    }
+    (void)Cy_App_Fault_EventHandler(&ctx[port], APP_EVT_DISCONNECT, NULL);
+    stable_contract(port, 30u);
+
+    return (uint8_t)(count - 1u);
+}
+
+/* A registered policy applies whether it is set before or after InitVars */
+static void test_init_order(void)
+{
+    const cy_stc_app_fault_policy_t policy = { 0u, 0u, 1u, 0u };
+    const cy_stc_app_fault_policy_t backoff = { 50u, 50u, 3u, 0u };
+    uint32_t recoveries;
+    uint8_t id;
+
+    /* Configuration table only */
+    init_port(0u);
+    init_port(1u);
+    (void)Cy_App_Fault_InitVars(&ctx[0]);
+    HOST_CHECK_EQ(ocp_retry_limit(0u), 5u);
+
+    /* Policy after InitVars */
+    HOST_CHECK_EQ(Cy_App_Fault_SetPolicy(&ctx[0], CY_APP_FAULT_TYPE_VBUS_OCP, &policy), CY_APP_STAT_SUCCESS);
+    HOST_CHECK_EQ(ocp_retry_limit(0u), 1u);
+
+    /* Policy before InitVars */
+    HOST_CHECK_EQ(Cy_App_Fault_SetPolicy(&ctx[1], CY_APP_FAULT_TYPE_VBUS_OCP, &policy), CY_APP_STAT_SUCCESS);
+    (void)Cy_App_Fault_InitVars(&ctx[1]);
+    HOST_CHECK_EQ(ocp_retry_limit(1u), 1u);
+
+    /* Repeated initialization keeps it */
+    (void)Cy_App_Fault_InitVars(&ctx[0]);
+    (void)Cy_App_Fault_InitVars(&ctx[1]);
+    HOST_CHECK_EQ(ocp_retry_limit(0u), 1u);
+    HOST_CHECK_EQ(ocp_retry_limit(1u), 1u);
+
+    /* Solution sources and their policies are dropped by InitVars and registered again */
+    HOST_CHECK_EQ(Cy_App_Fault_RegisterSource(&ctx[1], 3u, &id), CY_APP_STAT_SUCCESS);
+    HOST_CHECK_EQ(Cy_App_Fault_SetPolicy(&ctx[1], id, &backoff), CY_APP_STAT_SUCCESS);
+    HOST_CHECK_EQ(report(1u, id), 50u);
+
+    (void)Cy_App_Fault_InitVars(&ctx[1]);
+    HOST_CHECK_EQ(Cy_App_Fault_Report(&ctx[1], id), CY_APP_STAT_BAD_PARAM);
+    HOST_CHECK_EQ(Cy_App_Fault_SetPolicy(&ctx[1], id, &backoff), CY_APP_STAT_BAD_PARAM);
+    HOST_CHECK_EQ(Cy_App_Fault_GetStatus(&ctx[1]) & CY_APP_FAULT_STATUS_ACTIVE(id), 0u);
+
+    HOST_CHECK_EQ(Cy_App_Fault_RegisterSource(&ctx[1], 3u, &id), CY_APP_STAT_SUCCESS);
+    HOST_CHECK_EQ(id, CY_APP_FAULT_TYPE_COUNT);
+
+    /* Without the policy, the recovery is immediate */
+    recoveries = host_pd_cmd_count[1];
+    HOST_CHECK_EQ(report(1u, id), 0u);
+    HOST_CHECK_EQ(host_pd_cmd_count[1], recoveries + 1u);
+}
+
+int main(void)
+{
+    usbpd_cfg.vbusOcpConfig = &ocp_cfg;
+
+    test_backoff_sequence();
+    test_retry_limit();
+    test_jitter();
+    test_init_order();
+
+    return host_test_result("test_fault_backoff");
+}
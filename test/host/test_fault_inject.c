@@ -0,0 +1,781 @@
+/*
+ * Host fault injection test of the fault, source and sink handlers. A script
+ * of faults, each with the comparator that trips, its start time and its
+ * duration, is applied to the USBPD fault comparators while a DPM model runs
+ * the hard reset, Type-C error recovery, port disable and VConn recovery the
+ * handlers ask for. Reports the reaction and recovery latency, the fault and
+ * recovery counts and the final state of the port for each fault type.
+ */
+
+#include <string.h>
+#include "host_test.h"
+#include "host_pdo.h"
+#include "cy_app.h"
+#include "cy_app_fault_handlers.h"
+#include "cy_app_source.h"
+#include "cy_app_sink.h"
+
+/* Time VBUS stays off during a hard reset (tSrcRecover) */
+#define T_SRC_RECOVER                   (660u)
+
+/* Time the port stays detached during a Type-C error recovery (tErrorRecovery) */
+#define T_ERROR_RECOVERY                (25u)
+
+/* Fault condition that lasts for the rest of the script */
+#define PERSISTENT                      (0xFFFFFFFFu)
+
+/* No time recorded */
+#define NO_TIME                         (0xFFFFFFFFu)
+
+/* State of the DPM model */
+typedef enum
+{
+    DPM_DETACHED = 0,       /* Port not attached or not started */
+    DPM_POWER_OFF,          /* Waiting for the power stage to turn VBUS off */
+    DPM_OFF,                /* VBUS off for tSrcRecover or tErrorRecovery */
+    DPM_TURN_ON,            /* VBUS being turned on to vSafe5V */
+    DPM_NEGOTIATE,          /* Transition to the contract voltage */
+    DPM_READY,              /* Explicit contract */
+    DPM_PE_STOPPED,         /* Policy engine stopped after the fault limit */
+    DPM_DISABLED            /* Port disabled until it is started again */
+} dpm_state_t;
+
+static const char *const dpm_state_name[] = {
+    "detached", "power off", "off", "turn on", "negotiate", "ready", "PE stopped", "disabled"
+};
+
+typedef struct
+{
+    dpm_state_t state;
+    uint32_t timer;             /* ms left in DPM_OFF */
+    bool pwr_ready;             /* Power stage transition complete */
+    bool hard_reset;            /* The power cycle is a hard reset */
+    uint32_t pd_cmds;           /* Commands of the host stubs already handled */
+    uint32_t typec_cmds;
+    uint32_t pe_stops;
+    uint32_t starts;
+    uint32_t recoveries;        /* Hard resets and Type-C error recoveries */
+} dpm_t;
+
+/* One fault of the script */
+typedef struct
+{
+    host_fault_t fault;         /* Comparator that trips */
+    uint32_t time;              /* Start of the fault condition in ms */
+    uint32_t duration;          /* Length of the fault condition in ms */
+} inject_t;
+
+/* Outcome of a script */
+typedef struct
+{
+    uint32_t reaction;          /* ms from the first trip to the first fault event */
+    uint32_t recovery;          /* ms from the first trip to the restore after the last fault; NO_TIME if none */
+    uint32_t trips;             /* Comparator trips */
+    uint32_t faults;            /* Fault events raised by the handlers */
+    uint32_t recoveries;        /* Hard resets and Type-C error recoveries */
+    uint32_t status;            /* Cy_App_Fault_GetStatus at the end */
+    dpm_state_t state;          /* Final state of the DPM model */
+} result_t;
+
+cy_stc_pdstack_app_status_t glAppPdStatus[NO_OF_TYPEC_PORTS];
+
+static cy_stc_pdstack_context_t ctx[NO_OF_TYPEC_PORTS];
+static cy_stc_usbpd_context_t usbpd[NO_OF_TYPEC_PORTS];
+static cy_stc_app_status_t app_status[NO_OF_TYPEC_PORTS];
+static cy_stc_usbpd_config_t usbpd_cfg;
+
+/* Two recoveries for each fault type; the third occurrence exceeds the limit */
+static cy_stc_fault_vbus_ovp_cfg_t ovp_cfg = { 1u, CY_USBPD_VBUS_OVP_MODE_UVOV, 20u, 10u, 2u };
+static cy_stc_fault_vbus_uvp_cfg_t uvp_cfg = { 1u, CY_USBPD_VBUS_OVP_MODE_UVOV, 20u, 10u, 2u };
+static cy_stc_fault_vbus_ocp_cfg_t ocp_cfg = { 1u, 10u, 2u };
+static cy_stc_fault_vbus_scp_cfg_t scp_cfg = { 1u, 10u, 2u };
+static cy_stc_fault_vbus_rcp_cfg_t rcp_cfg = { 1u, 2u };
+static cy_stc_fault_vconn_ocp_cfg_t vconn_ocp_cfg = { 1u, 10u, 2u };
+
+static dpm_t dpm[NO_OF_TYPEC_PORTS];
+
+/* VBUS driven by the partner while the port is a sink */
+static uint16_t partner_vbus[NO_OF_TYPEC_PORTS];
+
+/* VConn switch of the port */
+static bool vconn_on[NO_OF_TYPEC_PORTS];
+
+/* ms since the start of the script */
+static uint32_t now;
+
+/* Trips, fault events and restores of the script being run */
+static uint32_t trip_count;
+static uint32_t fault_count;
+static uint32_t first_trip;
+static uint32_t first_fault;
+static uint32_t last_restore;
+
+/* Enable count of the comparator at the last trip of each script entry */
+static uint32_t inject_armed[8];
+
+cy_stc_app_status_t* Cy_App_GetStatus(uint8_t port)
+{
+    return &app_status[port];
+}
+
+cy_stc_pdstack_app_status_t* Cy_App_GetPdAppStatus(uint8_t port)
+{
+    return &glAppPdStatus[port];
+}
+
+static uint16_t vbus_level(uint8_t port)
+{
+    if (ctx[port].dpmConfig.curPortRole == CY_PD_PRT_ROLE_SOURCE)
+    {
+        return (host_pfet_on[port]) ? app_status[port].psrc_volt : CY_PD_VSAFE_0V;
+    }
+
+    return partner_vbus[port];
+}
+
+bool Cy_App_VbusIsPresent(cy_stc_pdstack_context_t *ptrPdStackContext, uint16_t volt, int8_t per)
+{
+    int32_t level = ((int32_t)volt * (100 + per)) / 100;
+
+    /* vSafe0V ends at 0.8 V */
+    if (level < 800)
+    {
+        level = 800;
+    }
+
+    return ((int32_t)vbus_level(ptrPdStackContext->port) > level);
+}
+
+uint16_t Cy_App_VbusGetValue(cy_stc_pdstack_context_t *ptrPdStackContext)
+{
+    return vbus_level(ptrPdStackContext->port);
+}
+
+void Cy_App_VbusDischargeOn(cy_stc_pdstack_context_t* context)
+{
+    Cy_USBPD_Vbus_DischargeOn(context->ptrUsbPdContext);
+}
+
+void Cy_App_VbusDischargeOff(cy_stc_pdstack_context_t* context)
+{
+    Cy_USBPD_Vbus_DischargeOff(context->ptrUsbPdContext);
+}
+
+/* Passes the events of the handlers and of the DPM model to the fault handler, as the solution does */
+void Cy_App_EventHandler(cy_stc_pdstack_context_t *ptrPdStackContext,
+        cy_en_pdstack_app_evt_t evt, const void* dat)
+{
+    switch (evt)
+    {
+        case APP_EVT_VBUS_OCP_FAULT:
+        case APP_EVT_VBUS_OVP_FAULT:
+        case APP_EVT_VBUS_UVP_FAULT:
+        case APP_EVT_VBUS_SCP_FAULT:
+        case APP_EVT_VBUS_RCP_FAULT:
+        case APP_EVT_VCONN_OCP_FAULT:
+            if (fault_count++ == 0u)
+            {
+                first_fault = now;
+            }
+            last_restore = NO_TIME;
+            break;
+
+        default:
+            break;
+    }
+
+    (void)Cy_App_Fault_EventHandler(ptrPdStackContext, evt, dat);
+}
+
+/* VConn path of the solution: OCP debounce, then the switch is turned off and the fault reported */
+static void vconn_ocp_tmr_cbk(cy_timer_id_t id, void *context)
+{
+    cy_stc_pdstack_context_t *ptrPdStackContext = (cy_stc_pdstack_context_t *)context;
+
+    Cy_App_VconnDisable(ptrPdStackContext, ptrPdStackContext->dpmConfig.revPol);
+    Cy_App_EventHandler(ptrPdStackContext, APP_EVT_VCONN_OCP_FAULT, NULL);
+
+    (void)id;
+}
+
+static bool vconn_ocp_cbk(void *context, bool comp_out)
+{
+    cy_stc_usbpd_context_t *ptrUsbPdContext = (cy_stc_usbpd_context_t *)context;
+    cy_stc_pdstack_context_t *ptrPdStackContext = Cy_PdStack_Dpm_GetContext(ptrUsbPdContext->port);
+    cy_timer_id_t id = CY_PDSTACK_GET_PD_TIMER_ID(ptrPdStackContext, CY_PDSTACK_PD_VCONN_OCP_DEBOUNCE_TIMER);
+    bool retval = false;
+
+    if (comp_out)
+    {
+        Cy_PdUtils_SwTimer_Start(ptrPdStackContext->ptrTimerContext, ptrPdStackContext, id,
+                ptrUsbPdContext->usbpdConfig->vconnOcpConfig->debounce, vconn_ocp_tmr_cbk);
+    }
+    else
+    {
+        retval = Cy_PdUtils_SwTimer_IsRunning(ptrPdStackContext->ptrTimerContext, id);
+        Cy_PdUtils_SwTimer_Stop(ptrPdStackContext->ptrTimerContext, id);
+    }
+
+    return retval;
+}
+
+bool Cy_App_VconnEnable(cy_stc_pdstack_context_t *ptrPdStackContext, uint8_t channel)
+{
+    if ((glAppPdStatus[ptrPdStackContext->port].faultStatus & CY_APP_PORT_VCONN_FAULT_ACTIVE) != 0u)
+    {
+        return false;
+    }
+
+    Cy_App_Fault_Vconn_OcpEnable(ptrPdStackContext, vconn_ocp_cbk);
+    vconn_on[ptrPdStackContext->port] = true;
+
+    (void)channel;
+    return true;
+}
+
+void Cy_App_VconnDisable(cy_stc_pdstack_context_t *ptrPdStackContext, uint8_t channel)
+{
+    vconn_on[ptrPdStackContext->port] = false;
+    Cy_App_Fault_Vconn_OcpDisable(ptrPdStackContext);
+
+    (void)channel;
+}
+
+static void dpm_pwr_ready(cy_stc_pdstack_context_t *ptrPdStackContext)
+{
+    dpm[ptrPdStackContext->port].pwr_ready = true;
+}
+
+/* Turns the power stage of the port on at the voltage */
+static void dpm_power_on(uint8_t port, uint16_t volt)
+{
+    if (ctx[port].dpmConfig.curPortRole == CY_PD_PRT_ROLE_SOURCE)
+    {
+        Cy_App_Source_SetVoltage(&ctx[port], volt);
+        Cy_App_Source_Enable(&ctx[port], dpm_pwr_ready);
+    }
+    else
+    {
+        partner_vbus[port] = volt;
+        Cy_App_Sink_SetVoltage(&ctx[port], volt);
+        Cy_App_Sink_SetCurrent(&ctx[port], 300u);
+        Cy_App_Sink_Enable(&ctx[port]);
+        dpm[port].pwr_ready = true;
+    }
+}
+
+/* Turns the power stage of the port off; the partner removes VBUS when the port is a sink */
+static void dpm_power_off(uint8_t port)
+{
+    if (ctx[port].dpmConfig.curPortRole == CY_PD_PRT_ROLE_SOURCE)
+    {
+        Cy_App_Source_Disable(&ctx[port], dpm_pwr_ready);
+    }
+    else
+    {
+        Cy_App_Sink_Disable(&ctx[port], NULL);
+        partner_vbus[port] = CY_PD_VSAFE_0V;
+        dpm[port].pwr_ready = true;
+    }
+}
+
+/* Attach of the partner: vSafe5V, then a 9 V 3 A contract with the second PDO */
+static void dpm_attach(uint8_t port)
+{
+    ctx[port].dpmConfig.attach = true;
+    ctx[port].dpmConfig.contractExist = false;
+    ctx[port].dpmConfig.vconnLogical = (ctx[port].dpmConfig.curPortRole == CY_PD_PRT_ROLE_SOURCE);
+    ctx[port].dpmStat.srcCurLevel = 2u;
+    dpm[port].hard_reset = false;
+    dpm[port].state = DPM_TURN_ON;
+    dpm_power_on(port, CY_PD_VSAFE_5V);
+}
+
+/* Hard reset or Type-C error recovery: VBUS off and on again, then a new contract */
+static void dpm_power_cycle(uint8_t port, bool hard_reset)
+{
+    dpm[port].recoveries++;
+    dpm[port].hard_reset = hard_reset;
+    dpm[port].state = DPM_POWER_OFF;
+    ctx[port].dpmConfig.contractExist = false;
+
+    Cy_App_EventHandler(&ctx[port], (hard_reset) ? APP_EVT_HARD_RESET_SENT : APP_EVT_TYPE_C_ERROR_RECOVERY, NULL);
+    dpm_power_off(port);
+}
+
+static void dpm_power_ready(uint8_t port)
+{
+    switch (dpm[port].state)
+    {
+        case DPM_POWER_OFF:
+            dpm[port].state = DPM_OFF;
+            dpm[port].timer = (dpm[port].hard_reset) ? T_SRC_RECOVER : T_ERROR_RECOVERY;
+            break;
+
+        case DPM_TURN_ON:
+            Cy_App_EventHandler(&ctx[port], (dpm[port].hard_reset) ? APP_EVT_HARD_RESET_COMPLETE : APP_EVT_CONNECT, NULL);
+            ctx[port].dpmConfig.contractExist = true;
+            ctx[port].dpmStat.srcSelPdo = ctx[port].dpmStat.curSrcPdo[1];
+            ctx[port].dpmStat.srcRdo.val = 0u;
+            ctx[port].dpmStat.srcRdo.rdo_gen.objPos = 2u;
+            dpm[port].state = DPM_NEGOTIATE;
+            dpm_power_on(port, 9000u);
+            break;
+
+        case DPM_NEGOTIATE:
+            Cy_App_EventHandler(&ctx[port], APP_EVT_PD_CONTRACT_NEGOTIATION_COMPLETE, NULL);
+            dpm[port].state = DPM_READY;
+            if (first_trip != NO_TIME)
+            {
+                last_restore = now;
+            }
+            break;
+
+        default:
+            break;
+    }
+}
+
+/* Runs the commands the handlers have issued and the power sequence of the port for 1 ms */
+static void dpm_step(uint8_t port)
+{
+    dpm_t *model = &dpm[port];
+
+    if (host_pe_stop_count[port] != model->pe_stops)
+    {
+        model->pe_stops = host_pe_stop_count[port];
+        model->state = DPM_PE_STOPPED;
+        ctx[port].dpmConfig.contractExist = false;
+    }
+
+    if (host_pd_cmd_count[port] != model->pd_cmds)
+    {
+        model->pd_cmds = host_pd_cmd_count[port];
+        if ((host_pd_cmd_status == CY_PDSTACK_STAT_SUCCESS) &&
+                (host_pd_cmd_last[port] == CY_PDSTACK_DPM_CMD_SEND_HARD_RESET))
+        {
+            dpm_power_cycle(port, true);
+        }
+    }
+
+    if (host_typec_cmd_count[port] != model->typec_cmds)
+    {
+        model->typec_cmds = host_typec_cmd_count[port];
+        if (host_typec_cmd_last[port] == CY_PDSTACK_DPM_CMD_TYPEC_ERR_RECOVERY)
+        {
+            dpm_power_cycle(port, false);
+        }
+        else if (host_typec_cmd_last[port] == CY_PDSTACK_DPM_CMD_PORT_DISABLE)
+        {
+            /* Rd is removed, so the partner sees a detach and removes VBUS */
+            dpm_power_off(port);
+            model->pwr_ready = false;
+            model->state = DPM_DISABLED;
+            ctx[port].dpmConfig.attach = false;
+            ctx[port].dpmConfig.contractExist = false;
+            Cy_App_EventHandler(&ctx[port], APP_EVT_VBUS_PORT_DISABLE, NULL);
+            if (host_typec_cmd_cbk[port] != NULL)
+            {
+                host_typec_cmd_cbk[port](&ctx[port], CY_PDSTACK_DPM_RESP_SUCCESS);
+            }
+        }
+    }
+
+    if (host_dpm_start_count[port] != model->starts)
+    {
+        model->starts = host_dpm_start_count[port];
+        dpm_attach(port);
+    }
+
+    if ((model->state == DPM_OFF) && (--model->timer == 0u))
+    {
+        model->state = DPM_TURN_ON;
+        if (!model->hard_reset)
+        {
+            ctx[port].dpmConfig.attach = true;
+        }
+        dpm_power_on(port, CY_PD_VSAFE_5V);
+    }
+
+    if (model->pwr_ready)
+    {
+        model->pwr_ready = false;
+        dpm_power_ready(port);
+    }
+
+    /* VConn is turned on again once the fault handler has cleared the VConn fault */
+    if ((model->state == DPM_READY) && (ctx[port].dpmConfig.vconnLogical) && (!vconn_on[port]) &&
+            ((glAppPdStatus[port].faultStatus & CY_APP_PORT_VCONN_FAULT_ACTIVE) == 0u))
+    {
+        (void)Cy_App_VconnEnable(&ctx[port], ctx[port].dpmConfig.revPol);
+        if (first_trip != NO_TIME)
+        {
+            last_restore = now;
+        }
+    }
+}
+
+/*
+ * Trips the comparators of the script entries whose condition is present. A
+ * comparator trips once for each time it is enabled; OVP, UVP, SCP and RCP
+ * disable themselves on the trip, the OCP comparators also report the end of
+ * the condition.
+ */
+static void inject(uint8_t port, const inject_t *script, uint8_t count)
+{
+    host_fault_comp_t *comp;
+    bool present;
+    uint8_t idx;
+
+    for (idx = 0u; idx < count; idx++)
+    {
+        comp = &host_fault_comp[port][script[idx].fault];
+        present = (now >= script[idx].time) &&
+            ((script[idx].duration == PERSISTENT) || (now < script[idx].time + script[idx].duration));
+
+        if ((present) && (comp->enabled) && (inject_armed[idx] != comp->enables))
+        {
+            inject_armed[idx] = comp->enables;
+            if (trip_count++ == 0u)
+            {
+                first_trip = now;
+            }
+
+            if ((script[idx].fault == HOST_FAULT_VBUS_OCP) || (script[idx].fault == HOST_FAULT_VCONN_OCP))
+            {
+                (void)comp->cb(&usbpd[port], true);
+            }
+            else
+            {
+                comp->enabled = false;
+                (void)comp->cb(&usbpd[port], script[idx].fault != HOST_FAULT_VBUS_UVP);
+            }
+        }
+        else if ((!present) && (now == script[idx].time + script[idx].duration) && (comp->enabled) &&
+                ((script[idx].fault == HOST_FAULT_VBUS_OCP) || (script[idx].fault == HOST_FAULT_VCONN_OCP)))
+        {
+            (void)comp->cb(&usbpd[port], false);
+        }
+    }
+}
+
+static void init_port(uint8_t port, uint8_t role)
+{
+    memset(&ctx[port], 0, sizeof(ctx[port]));
+    memset(&usbpd[port], 0, sizeof(usbpd[port]));
+    memset(&app_status[port], 0, sizeof(app_status[port]));
+    memset(&glAppPdStatus[port], 0, sizeof(glAppPdStatus[port]));
+    memset(&dpm[port], 0, sizeof(dpm[port]));
+    memset(host_fault_comp[port], 0, sizeof(host_fault_comp[port]));
+
+    usbpd[port].port = port;
+    usbpd[port].usbpdConfig = &usbpd_cfg;
+    ctx[port].port = port;
+    ctx[port].ptrUsbPdContext = &usbpd[port];
+    ctx[port].dpmConfig.curPortRole = role;
+    ctx[port].dpmConfig.dpmEnabled = true;
+    ctx[port].dpmStat.curSrcPdo[0] = host_fixed_src(5000u, 3000u);
+    ctx[port].dpmStat.curSrcPdo[1] = host_fixed_src(9000u, 3000u);
+    ctx[port].dpmStat.srcPdoCount = 2u;
+    host_dpm_context[port] = &ctx[port];
+
+    dpm[port].pd_cmds = host_pd_cmd_count[port];
+    dpm[port].typec_cmds = host_typec_cmd_count[port];
+    dpm[port].pe_stops = host_pe_stop_count[port];
+    dpm[port].starts = host_dpm_start_count[port];
+    partner_vbus[port] = CY_PD_VSAFE_0V;
+    vconn_on[port] = false;
+    host_pfet_on[port] = false;
+    host_cfet_on[port] = false;
+
+    host_timer_reset();
+    Cy_App_Fault_ClearCounts(port);
+    (void)Cy_App_Fault_InitVars(&ctx[port]);
+
+    dpm_attach(port);
+}
+
+/* Attaches a partner to the port, runs the script for the given time and reports the outcome */
+static result_t run(const char *name, uint8_t port, uint8_t role, const inject_t *script, uint8_t count,
+        uint32_t length)
+{
+    result_t result;
+
+    init_port(port, role);
+
+    /* The contract is in place before the script starts */
+    for (now = 0u; (now < 100u) && (dpm[port].state != DPM_READY); now++)
+    {
+        host_timer_advance(1u);
+        dpm_step(port);
+    }
+    HOST_CHECK_EQ(dpm[port].state, DPM_READY);
+
+    memset(inject_armed, 0, sizeof(inject_armed));
+    trip_count = 0u;
+    fault_count = 0u;
+    first_trip = NO_TIME;
+    first_fault = NO_TIME;
+    last_restore = NO_TIME;
+    dpm[port].recoveries = 0u;
+
+    /* Comparators trip at the start of each ms, timers expire at its end */
+    for (now = 0u; now < length; )
+    {
+        inject(port, script, count);
+        now++;
+        host_timer_advance(1u);
+        Cy_App_Fault_Task(&ctx[port]);
+        dpm_step(port);
+    }
+
+    result.reaction = ((first_trip != NO_TIME) && (first_fault != NO_TIME)) ? (first_fault - first_trip) : 0u;
+    result.recovery = ((first_trip != NO_TIME) && (last_restore != NO_TIME)) ? (last_restore - first_trip) : NO_TIME;
+    result.trips = trip_count;
+    result.faults = fault_count;
+    result.recoveries = dpm[port].recoveries;
+    result.status = Cy_App_Fault_GetStatus(&ctx[port]);
+    result.state = dpm[port].state;
+
+    if (result.recovery == NO_TIME)
+    {
+        printf("  %-16s reaction %2u ms, not restored, trips %u, faults %u, recoveries %u, %s\n", name,
+                (unsigned)result.reaction, (unsigned)result.trips, (unsigned)result.faults,
+                (unsigned)result.recoveries, dpm_state_name[result.state]);
+    }
+    else
+    {
+        printf("  %-16s reaction %2u ms, restored after %4u ms, trips %u, faults %u, recoveries %u, %s\n", name,
+                (unsigned)result.reaction, (unsigned)result.recovery, (unsigned)result.trips,
+                (unsigned)result.faults, (unsigned)result.recoveries, dpm_state_name[result.state]);
+    }
+
+    return result;
+}
+
+/* The source path is back at the contract voltage with all protections armed */
+static void check_source_restored(uint8_t port)
+{
+    HOST_CHECK(host_pfet_on[port]);
+    HOST_CHECK_EQ(app_status[port].psrc_volt, 9000u);
+    HOST_CHECK(!ctx[port].dpmStat.faultActive);
+    HOST_CHECK(host_fault_comp[port][HOST_FAULT_VBUS_OVP].enabled);
+    HOST_CHECK_EQ(host_fault_comp[port][HOST_FAULT_VBUS_OVP].level, 9000u);
+    HOST_CHECK(host_fault_comp[port][HOST_FAULT_VBUS_UVP].enabled);
+    HOST_CHECK(host_fault_comp[port][HOST_FAULT_VBUS_OCP].enabled);
+    HOST_CHECK(host_fault_comp[port][HOST_FAULT_VBUS_SCP].enabled);
+    HOST_CHECK(host_fault_comp[port][HOST_FAULT_VBUS_RCP].enabled);
+}
+
+/* A single trip of each source comparator ends in one hard reset and the contract is restored */
+static void test_source_single(void)
+{
+    static const struct
+    {
+        const char *name;
+        inject_t fault;
+        uint32_t reaction;
+        bool alert_ovp;
+    } cases[] = {
+        { "src OVP",        { HOST_FAULT_VBUS_OVP, 100u, 1u },  0u, true  },
+        { "src UVP",        { HOST_FAULT_VBUS_UVP, 100u, 1u },  0u, false },
+        { "src OCP",        { HOST_FAULT_VBUS_OCP, 100u, 50u }, 10u, false },
+        { "src SCP",        { HOST_FAULT_VBUS_SCP, 100u, 1u },  0u, false },
+        { "src RCP",        { HOST_FAULT_VBUS_RCP, 100u, 1u },  0u, true  }
+    };
+    result_t result;
+    uint8_t idx;
+
+    for (idx = 0u; idx < (sizeof(cases) / sizeof(cases[0])); idx++)
+    {
+        result = run(cases[idx].name, 0u, CY_PD_PRT_ROLE_SOURCE, &cases[idx].fault, 1u, 2000u);
+
+        HOST_CHECK_EQ(result.trips, 1u);
+        HOST_CHECK_EQ(result.faults, 1u);
+        HOST_CHECK_EQ(result.reaction, cases[idx].reaction);
+        HOST_CHECK_EQ(result.recoveries, 1u);
+        HOST_CHECK_EQ(result.state, DPM_READY);
+        HOST_CHECK((result.recovery >= T_SRC_RECOVER) && (result.recovery < T_SRC_RECOVER + 100u));
+
+        /* The occurrence is remembered until a detach */
+        HOST_CHECK_EQ(result.status, CY_APP_FAULT_STATUS_ACTIVE(
+                    (cases[idx].fault.fault == HOST_FAULT_VBUS_OVP) ? CY_APP_FAULT_TYPE_VBUS_OVP :
+                    (cases[idx].fault.fault == HOST_FAULT_VBUS_UVP) ? CY_APP_FAULT_TYPE_VBUS_UVP :
+                    (cases[idx].fault.fault == HOST_FAULT_VBUS_OCP) ? CY_APP_FAULT_TYPE_VBUS_OCP :
+                    (cases[idx].fault.fault == HOST_FAULT_VBUS_SCP) ? CY_APP_FAULT_TYPE_VBUS_SCP :
+                    CY_APP_FAULT_TYPE_VBUS_RCP));
+        HOST_CHECK(!Cy_App_Fault_IsCountExceeded(&ctx[0]));
+
+        /* Alert to be sent to the sink after the recovery */
+        HOST_CHECK_EQ(ctx[0].dpmStat.alert.ado_alert.ovp, cases[idx].alert_ovp);
+        HOST_CHECK_EQ(ctx[0].dpmStat.alert.ado_alert.ocp, !cases[idx].alert_ovp);
+
+        check_source_restored(0u);
+    }
+}
+
+/* An OCP trip shorter than the debounce is not a fault */
+static void test_source_ocp_glitch(void)
+{
+    static const inject_t script[] = {
+        { HOST_FAULT_VBUS_OCP, 100u, 5u },
+        { HOST_FAULT_VBUS_OCP, 300u, 9u }
+    };
+    result_t result = run("src OCP glitch", 0u, CY_PD_PRT_ROLE_SOURCE, script, 2u, 1000u);
+
+    HOST_CHECK_EQ(result.trips, 2u);
+    HOST_CHECK_EQ(result.faults, 0u);
+    HOST_CHECK_EQ(result.recoveries, 0u);
+    HOST_CHECK_EQ(result.status, 0u);
+    HOST_CHECK_EQ(result.state, DPM_READY);
+
+    /* Threshold of the 3 A PDO */
+    HOST_CHECK_EQ(host_fault_comp[0][HOST_FAULT_VBUS_OCP].level, 300u);
+    check_source_restored(0u);
+}
+
+/* A persistent fault is retried up to the limit, then the policy engine is stopped until a detach */
+static void test_source_persistent(void)
+{
+    static const inject_t script[] = {
+        { HOST_FAULT_VBUS_OVP, 100u, PERSISTENT }
+    };
+    result_t result = run("src OVP held", 0u, CY_PD_PRT_ROLE_SOURCE, script, 1u, 4000u);
+
+    HOST_CHECK_EQ(result.trips, 3u);
+    HOST_CHECK_EQ(result.faults, 3u);
+    HOST_CHECK_EQ(result.recoveries, 2u);
+    HOST_CHECK_EQ(result.recovery, NO_TIME);
+    HOST_CHECK_EQ(result.state, DPM_PE_STOPPED);
+    HOST_CHECK(Cy_App_Fault_IsCountExceeded(&ctx[0]));
+    HOST_CHECK_EQ(result.status, CY_APP_FAULT_STATUS_ACTIVE(CY_APP_FAULT_TYPE_VBUS_OVP) |
+            CY_APP_FAULT_STATUS_EXCEEDED(CY_APP_FAULT_TYPE_VBUS_OVP));
+    HOST_CHECK_EQ(host_typec_cmd_count[0], dpm[0].typec_cmds);
+
+    /* Power stage off and all comparators disabled */
+    HOST_CHECK(!host_pfet_on[0]);
+    HOST_CHECK(ctx[0].dpmStat.faultActive);
+    HOST_CHECK(!host_fault_comp[0][HOST_FAULT_VBUS_OVP].enabled);
+    HOST_CHECK(!host_fault_comp[0][HOST_FAULT_VBUS_OCP].enabled);
+
+    /* A detach clears the counts */
+    Cy_App_EventHandler(&ctx[0], APP_EVT_DISCONNECT, NULL);
+    HOST_CHECK_EQ(Cy_App_Fault_GetStatus(&ctx[0]), 0u);
+    HOST_CHECK(!ctx[0].dpmStat.faultActive);
+}
+
+/* Without a PD contract to reset, the handlers fall back to a Type-C error recovery */
+static void test_source_error_recovery(void)
+{
+    static const inject_t script[] = {
+        { HOST_FAULT_VBUS_SCP, 100u, 1u }
+    };
+    result_t result;
+
+    host_pd_cmd_status = CY_PDSTACK_STAT_FAILURE;
+    result = run("src SCP Type-C", 0u, CY_PD_PRT_ROLE_SOURCE, script, 1u, 1000u);
+    host_pd_cmd_status = CY_PDSTACK_STAT_SUCCESS;
+
+    HOST_CHECK_EQ(result.faults, 1u);
+    HOST_CHECK_EQ(result.recoveries, 1u);
+    HOST_CHECK_EQ(host_typec_cmd_last[0], CY_PDSTACK_DPM_CMD_TYPEC_ERR_RECOVERY);
+    HOST_CHECK_EQ(result.state, DPM_READY);
+    HOST_CHECK(result.recovery < T_SRC_RECOVER);
+    check_source_restored(0u);
+}
+
+/* VConn OCP turns VConn off and restores it without touching the VBUS contract */
+static void test_vconn(void)
+{
+    static const inject_t single[] = {
+        { HOST_FAULT_VCONN_OCP, 100u, 50u }
+    };
+    static const inject_t held[] = {
+        { HOST_FAULT_VCONN_OCP, 100u, PERSISTENT }
+    };
+    result_t result;
+
+    result = run("VConn OCP", 0u, CY_PD_PRT_ROLE_SOURCE, single, 1u, 1000u);
+    HOST_CHECK_EQ(result.faults, 1u);
+    HOST_CHECK_EQ(result.reaction, 10u);
+    HOST_CHECK_EQ(result.recoveries, 0u);
+    HOST_CHECK_EQ(result.recovery, 10u + CY_APP_VCONN_RECOVERY_PERIOD);
+    HOST_CHECK_EQ(result.state, DPM_READY);
+    HOST_CHECK(vconn_on[0]);
+    HOST_CHECK(host_fault_comp[0][HOST_FAULT_VCONN_OCP].enabled);
+    check_source_restored(0u);
+
+    /* After the retries VConn stays off; VBUS is still provided */
+    result = run("VConn OCP held", 0u, CY_PD_PRT_ROLE_SOURCE, held, 1u, 3000u);
+    HOST_CHECK_EQ(result.faults, 3u);
+    HOST_CHECK_EQ(result.recoveries, 0u);
+    HOST_CHECK_EQ(result.recovery, NO_TIME);
+    HOST_CHECK_EQ(result.state, DPM_READY);
+    HOST_CHECK(!vconn_on[0]);
+    HOST_CHECK((glAppPdStatus[0].faultStatus & CY_APP_PORT_VCONN_FAULT_ACTIVE) != 0u);
+    HOST_CHECK(result.status & CY_APP_FAULT_STATUS_EXCEEDED(CY_APP_FAULT_TYPE_VCONN_OCP));
+    check_source_restored(0u);
+}
+
+/* Sink faults on the second port: hard reset recovery, and a port disable once the limit is exceeded */
+static void test_sink(void)
+{
+    static const inject_t ovp[] = {
+        { HOST_FAULT_VBUS_OVP, 100u, 1u }
+    };
+    static const inject_t uvp[] = {
+        { HOST_FAULT_VBUS_UVP, 100u, 1u }
+    };
+    static const inject_t uvp_held[] = {
+        { HOST_FAULT_VBUS_UVP, 100u, 1600u }
+    };
+    result_t result;
+    uint32_t starts = host_dpm_start_count[1];
+
+    result = run("snk OVP", 1u, CY_PD_PRT_ROLE_SINK, ovp, 1u, 2000u);
+    HOST_CHECK_EQ(result.faults, 1u);
+    HOST_CHECK_EQ(result.recoveries, 1u);
+    HOST_CHECK_EQ(result.state, DPM_READY);
+    HOST_CHECK_EQ(result.status, CY_APP_FAULT_STATUS_ACTIVE(CY_APP_FAULT_TYPE_VBUS_OVP));
+    HOST_CHECK(ctx[1].dpmStat.alert.ado_alert.ovp);
+    HOST_CHECK(host_cfet_on[1]);
+    HOST_CHECK_EQ(host_fault_comp[1][HOST_FAULT_VBUS_OVP].level, 9000u);
+
+    result = run("snk UVP", 1u, CY_PD_PRT_ROLE_SINK, uvp, 1u, 2000u);
+    HOST_CHECK_EQ(result.faults, 1u);
+    HOST_CHECK_EQ(result.recoveries, 1u);
+    HOST_CHECK_EQ(result.state, DPM_READY);
+    HOST_CHECK(host_cfet_on[1]);
+    HOST_CHECK(host_fault_comp[1][HOST_FAULT_VBUS_UVP].enabled);
+
+    /* Third trip: the port is disabled, started again once VBUS is gone, and the counts are cleared */
+    result = run("snk UVP held", 1u, CY_PD_PRT_ROLE_SINK, uvp_held, 1u, 4000u);
+    HOST_CHECK_EQ(result.faults, 3u);
+    HOST_CHECK_EQ(result.recoveries, 2u);
+    HOST_CHECK_EQ(host_typec_cmd_last[1], CY_PDSTACK_DPM_CMD_PORT_DISABLE);
+    HOST_CHECK_EQ(host_dpm_start_count[1], starts + 1u);
+    HOST_CHECK_EQ(result.state, DPM_READY);
+    HOST_CHECK_EQ(result.status, 0u);
+    HOST_CHECK_EQ(glAppPdStatus[1].faultStatus, 0u);
+    HOST_CHECK(!ctx[1].dpmStat.faultActive);
+    HOST_CHECK(host_cfet_on[1]);
+}
+
+int main(void)
+{
+    usbpd_cfg.vbusOvpConfig = &ovp_cfg;
+    usbpd_cfg.vbusUvpConfig = &uvp_cfg;
+    usbpd_cfg.vbusOcpConfig = &ocp_cfg;
+    usbpd_cfg.vbusScpConfig = &scp_cfg;
+    usbpd_cfg.vbusRcpConfig = &rcp_cfg;
+    usbpd_cfg.vconnOcpConfig = &vconn_ocp_cfg;
+
+    test_source_single();
+    test_source_ocp_glitch();
+    test_source_persistent();
+    test_source_error_recovery();
+    test_vconn();
+    test_sink();
+
+    return host_test_result("test_fault_inject");
+}
@@ -0,0 +1,337 @@
+/*
+ * Host test of the fast role swap fast path: arming of the source path on FRS
+ * capable sink contracts, the provider FET switch on the FRS signal passed to
+ * the PHY callback, the poll for vSafe5V and the latency statistics.
+ */
+
+#include <string.h>
+#include "host_test.h"
+#include "host_pdo.h"
+#include "cy_app.h"
+#include "cy_app_swap.h"
+#include "cy_app_source.h"
+#include "cy_app_coroutine.h"
+
+static cy_stc_pdstack_context_t ctx;
+static cy_stc_usbpd_context_t usbpd_ctx;
+static cy_stc_app_status_t app_status[NO_OF_TYPEC_PORTS];
+static app_resp_t resp_buf[NO_OF_TYPEC_PORTS];
+
+/* Referenced by the swap request handlers */
+volatile uint8_t glAppPrefDataRole[NO_OF_TYPEC_PORTS];
+volatile uint8_t glAppPrefPowerRole[NO_OF_TYPEC_PORTS];
+
+/* Source path model: arm state, VBUS level and the provider FET */
+static bool frs_armed;
+static bool vbus_safe;
+static bool fet_on;
+static uint32_t frs_on_calls;
+
+/* PHY callback of the PD stack model and the events it has received */
+static uint32_t stack_phy_evts;
+static uint32_t stack_last_evt;
+static bool stack_fet_on;
+
+/* Time stamp counter in us */
+static uint32_t now_us;
+
+static void stack_phy_cbk(void *callbackCtx, uint32_t event)
+{
+    HOST_CHECK(callbackCtx == &usbpd_ctx);
+    stack_phy_evts++;
+    stack_last_evt = event;
+    stack_fet_on = fet_on;
+}
+
+uint32_t Cy_App_GetTimestamp(void)
+{
+    return (now_us & CY_APP_TIMESTAMP_MASK);
+}
+
+/* Advances the software timers and the time stamp */
+static void advance(uint32_t ms)
+{
+    now_us += ms * 1000u;
+    host_timer_advance(ms);
+}
+
+/* FRS signal interrupt */
+static void frs_signal(void)
+{
+    uint32_t evts = stack_phy_evts;
+
+    usbpd_ctx.pdPhyCbk(&usbpd_ctx, CY_USBPD_PHY_EVT_FRS_SIG_RCVD);
+    HOST_CHECK_EQ(stack_phy_evts, evts + 1u);
+    HOST_CHECK_EQ(stack_last_evt, CY_USBPD_PHY_EVT_FRS_SIG_RCVD);
+}
+
+cy_stc_app_status_t* Cy_App_GetStatus(uint8_t port)
+{
+    return &app_status[port];
+}
+
+app_resp_t* Cy_App_GetRespBuffer(uint8_t port)
+{
+    return &resp_buf[port];
+}
+
+void Cy_App_Source_FrsArm(cy_stc_pdstack_context_t *context, bool arm)
+{
+    (void)context;
+    frs_armed = arm;
+}
+
+bool Cy_App_Source_FrsOn(cy_stc_pdstack_context_t *context)
+{
+    (void)context;
+    frs_on_calls++;
+
+    if ((!frs_armed) || (fet_on) || (!vbus_safe))
+    {
+        return false;
+    }
+
+    frs_armed = false;
+    fet_on = true;
+    return true;
+}
+
+bool Cy_App_Source_FrsIsArmed(cy_stc_pdstack_context_t *context)
+{
+    (void)context;
+    return frs_armed;
+}
+
+/* Sink contract at vSafe5V which asks for FRS support at 3 A */
+static void sink_contract(void)
+{
+    ctx.dpmConfig.contractExist = true;
+    ctx.dpmConfig.curPortRole = CY_PD_PRT_ROLE_SINK;
+    ctx.dpmStat.curSnkPdo[0] = host_fixed_snk(5000, 3000);
+    ctx.dpmStat.curSnkPdo[0].fixed_snk.frSwap = 3u;
+    app_status[0].psnk_volt = CY_PD_VSAFE_5V;
+
+    fet_on = false;
+    vbus_safe = false;
+    Cy_App_Swap_FrsEventHandler(&ctx, APP_EVT_PD_CONTRACT_NEGOTIATION_COMPLETE);
+}
+
+/* The fast path is placed in front of the PHY callback of the stack only once */
+static void test_init(void)
+{
+    Cy_App_Swap_FrsInit(&ctx);
+    HOST_CHECK(usbpd_ctx.pdPhyCbk != stack_phy_cbk);
+    Cy_App_Swap_FrsInit(&ctx);
+
+    /* Other PHY events are passed on without the fast path */
+    sink_contract();
+    usbpd_ctx.pdPhyCbk(&usbpd_ctx, CY_USBPD_PHY_EVT_RX_MSG);
+    HOST_CHECK_EQ(stack_phy_evts, 1u);
+    HOST_CHECK_EQ(stack_last_evt, CY_USBPD_PHY_EVT_RX_MSG);
+    HOST_CHECK_EQ(Cy_App_Swap_FrsGetStats(&ctx)->signalCount, 0u);
+    HOST_CHECK(frs_armed);
+}
+
+/* The source path is only armed on a sink contract at vSafe5V with FRS support */
+static void test_arming(void)
+{
+    sink_contract();
+    HOST_CHECK(frs_armed);
+
+    ctx.dpmStat.curSnkPdo[0].fixed_snk.frSwap = 0u;
+    Cy_App_Swap_FrsEventHandler(&ctx, APP_EVT_PD_CONTRACT_NEGOTIATION_COMPLETE);
+    HOST_CHECK(!frs_armed);
+
+    sink_contract();
+    app_status[0].psnk_volt = 9000u;
+    Cy_App_Swap_FrsEventHandler(&ctx, APP_EVT_PD_CONTRACT_NEGOTIATION_COMPLETE);
+    HOST_CHECK(!frs_armed);
+
+    sink_contract();
+    ctx.dpmConfig.curPortRole = CY_PD_PRT_ROLE_SOURCE;
+    Cy_App_Swap_FrsEventHandler(&ctx, APP_EVT_PD_CONTRACT_NEGOTIATION_COMPLETE);
+    HOST_CHECK(!frs_armed);
+
+    sink_contract();
+    ctx.dpmConfig.contractExist = false;
+    Cy_App_Swap_FrsEventHandler(&ctx, APP_EVT_PD_CONTRACT_NEGOTIATION_COMPLETE);
+    HOST_CHECK(!frs_armed);
+
+    /* Disarmed on the events which end the contract */
+    sink_contract();
+    Cy_App_Swap_FrsEventHandler(&ctx, APP_EVT_HARD_RESET_RCVD);
+    HOST_CHECK(!frs_armed);
+    sink_contract();
+    Cy_App_Swap_FrsEventHandler(&ctx, APP_EVT_PR_SWAP_COMPLETE);
+    HOST_CHECK(!frs_armed);
+    sink_contract();
+    Cy_App_Swap_FrsEventHandler(&ctx, APP_EVT_DISCONNECT);
+    HOST_CHECK(!frs_armed);
+}
+
+/* VBUS already at vSafe5V: the provider FET is turned on before the stack sees the signal */
+static void test_signal_fast(void)
+{
+    const cy_stc_app_frs_stats_t *stats = Cy_App_Swap_FrsGetStats(&ctx);
+
+    sink_contract();
+    vbus_safe = true;
+    frs_signal();
+
+    HOST_CHECK(fet_on);
+    HOST_CHECK(stack_fet_on);
+    HOST_CHECK(!frs_armed);
+    HOST_CHECK(!Cy_App_Coro_IsActive(&ctx, CY_APP_CORO_FRS_VBUS));
+    HOST_CHECK_EQ(stats->signalCount, 1u);
+    HOST_CHECK_EQ(stats->fastCount, 1u);
+
+    /* The stack completes the swap 7.25 ms after the signal */
+    advance(7u);
+    now_us += 250u;
+    Cy_App_Swap_FrsEventHandler(&ctx, APP_EVT_FR_SWAP_COMPLETE);
+    HOST_CHECK_EQ(stats->lastLatency, 7250u);
+    HOST_CHECK_EQ(stats->maxLatency, 7250u);
+    HOST_CHECK_EQ(stats->timeoutCount, 0u);
+
+    /* Without a running latency timer, the completion does not update the latency */
+    Cy_App_Swap_FrsEventHandler(&ctx, APP_EVT_FR_SWAP_COMPLETE);
+    HOST_CHECK_EQ(stats->lastLatency, 7250u);
+}
+
+/* VBUS above vSafe5V on the signal: the FET is turned on by the poll once it has fallen */
+static void test_signal_poll(void)
+{
+    const cy_stc_app_frs_stats_t *stats = Cy_App_Swap_FrsGetStats(&ctx);
+
+    sink_contract();
+    frs_on_calls = 0u;
+    frs_signal();
+
+    HOST_CHECK(!fet_on);
+    HOST_CHECK(!stack_fet_on);
+    HOST_CHECK(frs_armed);
+    HOST_CHECK(Cy_App_Coro_IsActive(&ctx, CY_APP_CORO_FRS_VBUS));
+    HOST_CHECK_EQ(stats->signalCount, 2u);
+    HOST_CHECK_EQ(stats->fastCount, 1u);
+
+    advance(3u);
+    HOST_CHECK(!fet_on);
+    HOST_CHECK_EQ(frs_on_calls, 4u);
+
+    vbus_safe = true;
+    advance(1u);
+    HOST_CHECK(fet_on);
+    HOST_CHECK_EQ(frs_on_calls, 5u);
+    HOST_CHECK_EQ(stats->fastCount, 2u);
+    HOST_CHECK(!Cy_App_Coro_IsActive(&ctx, CY_APP_CORO_FRS_VBUS));
+
+    advance(10u);
+    HOST_CHECK_EQ(frs_on_calls, 5u);
+
+    /* The latency includes the poll */
+    advance(6u);
+    Cy_App_Swap_FrsEventHandler(&ctx, APP_EVT_FR_SWAP_COMPLETE);
+    HOST_CHECK_EQ(stats->lastLatency, 20000u);
+    HOST_CHECK_EQ(stats->maxLatency, 20000u);
+}
+
+/* VBUS does not fall: the poll gives up and the swap is counted as timed out */
+static void test_signal_timeout(void)
+{
+    const cy_stc_app_frs_stats_t *stats = Cy_App_Swap_FrsGetStats(&ctx);
+
+    sink_contract();
+    frs_on_calls = 0u;
+    frs_signal();
+
+    advance(CY_APP_FRS_VSAFE5V_POLL_COUNT + 5u);
+    HOST_CHECK(!Cy_App_Coro_IsActive(&ctx, CY_APP_CORO_FRS_VBUS));
+    HOST_CHECK_EQ(frs_on_calls, 1u + CY_APP_FRS_VSAFE5V_POLL_COUNT);
+    HOST_CHECK(!fet_on);
+    HOST_CHECK_EQ(stats->fastCount, 2u);
+
+    advance(CY_APP_FRS_LATENCY_TIMEOUT);
+    HOST_CHECK_EQ(stats->timeoutCount, 1u);
+    HOST_CHECK_EQ(stats->signalCount, 3u);
+    HOST_CHECK_EQ(stats->maxLatency, 20000u);
+}
+
+/* A detach while polling stops the poll and disarms the source path */
+static void test_detach_while_polling(void)
+{
+    sink_contract();
+    frs_on_calls = 0u;
+    frs_signal();
+    HOST_CHECK(Cy_App_Coro_IsActive(&ctx, CY_APP_CORO_FRS_VBUS));
+
+    advance(2u);
+    Cy_App_Swap_FrsEventHandler(&ctx, APP_EVT_DISCONNECT);
+    HOST_CHECK(!Cy_App_Coro_IsActive(&ctx, CY_APP_CORO_FRS_VBUS));
+    HOST_CHECK(!frs_armed);
+
+    vbus_safe = true;
+    advance(CY_APP_FRS_VSAFE5V_POLL_COUNT);
+    HOST_CHECK_EQ(frs_on_calls, 3u);
+    HOST_CHECK(!fet_on);
+    advance(CY_APP_FRS_LATENCY_TIMEOUT);
+}
+
+/* A signal on a port which is not armed does not start the poll */
+static void test_signal_unarmed(void)
+{
+    const cy_stc_app_frs_stats_t *stats = Cy_App_Swap_FrsGetStats(&ctx);
+    uint16_t signals = stats->signalCount;
+
+    sink_contract();
+    Cy_App_Swap_FrsEventHandler(&ctx, APP_EVT_HARD_RESET_SENT);
+    frs_signal();
+
+    HOST_CHECK(!fet_on);
+    HOST_CHECK(!Cy_App_Coro_IsActive(&ctx, CY_APP_CORO_FRS_VBUS));
+    HOST_CHECK_EQ(stats->signalCount, signals + 1u);
+}
+
+/* A swap beyond the range of the time stamp saturates the latency */
+static void test_latency_range(void)
+{
+    const cy_stc_app_frs_stats_t *stats = Cy_App_Swap_FrsGetStats(&ctx);
+
+    sink_contract();
+    vbus_safe = true;
+    frs_signal();
+
+    /* 70 ms is a whole time stamp period plus 4.464 ms */
+    advance(70u);
+    Cy_App_Swap_FrsEventHandler(&ctx, APP_EVT_FR_SWAP_COMPLETE);
+    HOST_CHECK_EQ(stats->lastLatency, 0xFFFFu);
+    HOST_CHECK_EQ(stats->maxLatency, 0xFFFFu);
+
+    /* The latency is exact across a wrap of the time stamp */
+    now_us = CY_APP_TIMESTAMP_MASK - 100u;
+    sink_contract();
+    vbus_safe = true;
+    frs_signal();
+    advance(3u);
+    Cy_App_Swap_FrsEventHandler(&ctx, APP_EVT_FR_SWAP_COMPLETE);
+    HOST_CHECK_EQ(stats->lastLatency, 3000u);
+}
+
+int main(void)
+{
+    memset(&ctx, 0, sizeof(ctx));
+    ctx.dpmConfig.specRevSopLive = CY_PD_REV3;
+    ctx.ptrUsbPdContext = &usbpd_ctx;
+    usbpd_ctx.pdStackContext = &ctx;
+    usbpd_ctx.pdPhyCbk = stack_phy_cbk;
+
+    test_init();
+    test_arming();
+    test_signal_fast();
+    test_signal_poll();
+    test_signal_timeout();
+    test_detach_while_polling();
+    test_signal_unarmed();
+    test_latency_range();
+
+    return host_test_result("test_frs");
+}
@@ -0,0 +1,141 @@
+/*
+ * Host test of the partner cache: allocation of an entry for a new partner,
+ * recognition of the partner after it has been detached, and identification
+ * of a reconnecting partner whose capabilities are answered from the
+ * evaluation cache.
+ */
+
+#include <string.h>
+#include "host_test.h"
+#include "host_pdo.h"
+#include "cy_app_pdo.h"
+#include "cy_app_partner.h"
+
+/* First flash row mapped for the test; the partner rows are at its end */
+#define FLASH_FIRST_ROW                 (0x3E0u)
+
+static app_resp_t resp_buf[NO_OF_TYPEC_PORTS];
+static uint32_t resp_count;
+
+app_resp_t* Cy_App_GetRespBuffer(uint8_t port)
+{
+    return &resp_buf[port];
+}
+
+static void resp_handler(cy_stc_pdstack_context_t *ctx, app_resp_t *resp)
+{
+    (void)ctx;
+    (void)resp;
+    resp_count++;
+}
+
+static cy_stc_pdstack_context_t ctx;
+
+static void eval(const cy_pd_pd_do_t *pdo, uint8_t count)
+{
+    cy_stc_pdstack_pd_packet_t cap;
+
+    memset(&cap, 0, sizeof(cap));
+    memcpy(cap.dat, pdo, count * sizeof(cy_pd_pd_do_t));
+    cap.len = count;
+
+    resp_count = 0u;
+    Cy_App_Pdo_EvalSrcCap(&ctx, &cap, resp_handler);
+    HOST_CHECK_EQ(resp_count, 1u);
+}
+
+/* A new partner gets an entry and is recognised with its contract after a detach */
+static void test_reattach(void)
+{
+    const cy_stc_app_partner_entry_t *entry;
+    cy_stc_app_partner_entry_t contract;
+
+    Cy_App_Partner_Identify(&ctx, 0x1234u);
+    entry = Cy_App_Partner_GetEntry(&ctx);
+    HOST_CHECK(entry != NULL);
+    if (entry == NULL)
+    {
+        return;
+    }
+    HOST_CHECK_EQ(entry->partnerId, 0x1234u);
+    HOST_CHECK_EQ(entry->flags, 0u);
+
+    memset(&contract, 0, sizeof(contract));
+    contract.pdoNo = 2u;
+    contract.contractVolt = 9000u / 50u;
+    Cy_App_Partner_SaveContract(&ctx, &contract);
+
+    Cy_App_Partner_Detach(&ctx);
+    HOST_CHECK(Cy_App_Partner_GetEntry(&ctx) == NULL);
+
+    /* Another partner takes a different entry */
+    Cy_App_Partner_Identify(&ctx, 0x5678u);
+    entry = Cy_App_Partner_GetEntry(&ctx);
+    HOST_CHECK((entry != NULL) && (entry->partnerId == 0x5678u));
+    Cy_App_Partner_Detach(&ctx);
+
+    Cy_App_Partner_Identify(&ctx, 0x1234u);
+    entry = Cy_App_Partner_GetEntry(&ctx);
+    HOST_CHECK(entry != NULL);
+    if (entry != NULL)
+    {
+        HOST_CHECK_EQ(entry->partnerId, 0x1234u);
+        HOST_CHECK_EQ(entry->pdoNo, 2u);
+        HOST_CHECK_EQ(entry->contractVolt, 9000u / 50u);
+        HOST_CHECK((entry->flags & CY_APP_PARTNER_FLAG_CONTRACT) != 0u);
+    }
+
+    /* The contract is written to flash once the flush delay has expired */
+    host_timer_advance(CY_APP_PARTNER_FLUSH_DELAY);
+    Cy_App_Partner_Task(&ctx);
+    HOST_CHECK_EQ(host_flash_writes, 1u);
+
+    Cy_App_Partner_Detach(&ctx);
+}
+
+/* A reconnecting partner is identified when the evaluation cache answers its capabilities */
+static void test_eval_cache_reconnect(void)
+{
+    const cy_pd_pd_do_t snk[] = { host_fixed_snk(5000, 3000), host_fixed_snk(9000, 3000) };
+    const cy_pd_pd_do_t src[] = { host_fixed_src(5000, 3000), host_fixed_src(9000, 3000) };
+    const cy_stc_app_partner_entry_t *entry;
+
+    ctx.dpmStat.curSnkPdo[0] = snk[0];
+    ctx.dpmStat.curSnkPdo[1] = snk[1];
+    ctx.dpmStat.curSnkMaxMin[0] = 300u;
+    ctx.dpmStat.curSnkMaxMin[1] = 300u;
+    ctx.dpmStat.curSnkPdocount = 2u;
+
+    eval(src, 2u);
+    HOST_CHECK(Cy_App_Partner_GetEntry(&ctx) != NULL);
+    HOST_CHECK((Cy_App_Partner_GetFlags(&ctx) & CY_APP_PARTNER_FLAG_CONTRACT) != 0u);
+
+    Cy_App_Partner_UpdateFlags(&ctx, CY_APP_PARTNER_FLAG_EXPIRING, true);
+    Cy_App_Partner_Detach(&ctx);
+    HOST_CHECK(Cy_App_Partner_GetEntry(&ctx) == NULL);
+
+    /* Same capabilities and sink settings: answered from the evaluation cache */
+    eval(src, 2u);
+    entry = Cy_App_Partner_GetEntry(&ctx);
+    HOST_CHECK(entry != NULL);
+    HOST_CHECK((Cy_App_Partner_GetFlags(&ctx) & CY_APP_PARTNER_FLAG_EXPIRING) != 0u);
+    HOST_CHECK((entry != NULL) && (entry->retry == 1u));
+}
+
+int main(void)
+{
+    memset(&ctx, 0, sizeof(ctx));
+
+    if (!host_flash_map(FLASH_FIRST_ROW))
+    {
+        printf("test_partner: flash rows could not be mapped\n");
+        return 1;
+    }
+
+    Cy_App_Partner_Init();
+
+    test_reattach();
+    test_eval_cache_reconnect();
+
+    return host_test_result("test_partner");
+}
@@ -0,0 +1,281 @@
+/*
+ * Host test of the source capability evaluation: the contract computed from
+ * the sink constraint table, the capability mismatch fallback, the evaluation
+ * cache against a fresh evaluation of the same capabilities, and the bypass of
+ * the cache for application policies.
+ */
+
+#include <string.h>
+#include "host_test.h"
+#include "host_pdo.h"
+#include "cy_app_pdo.h"
+
+extern uint32_t glAppContractVoltage[NO_OF_TYPEC_PORTS];
+extern uint32_t glAppContractPower[NO_OF_TYPEC_PORTS];
+extern uint32_t glAppOperCurPower[NO_OF_TYPEC_PORTS];
+extern uint32_t glAppMaxMinPower[NO_OF_TYPEC_PORTS];
+
+static app_resp_t resp_buf[NO_OF_TYPEC_PORTS];
+static app_resp_t last_resp;
+static uint32_t resp_count;
+
+app_resp_t* Cy_App_GetRespBuffer(uint8_t port)
+{
+    return &resp_buf[port];
+}
+
+static void resp_handler(cy_stc_pdstack_context_t *ctx, app_resp_t *resp)
+{
+    (void)ctx;
+    last_resp = *resp;
+    resp_count++;
+}
+
+static cy_stc_pdstack_context_t ctx;
+
+static void set_sink(const cy_pd_pd_do_t *pdo, const uint16_t *max_min, uint8_t count)
+{
+    uint8_t idx;
+
+    for (idx = 0u; idx < count; idx++)
+    {
+        ctx.dpmStat.curSnkPdo[idx] = pdo[idx];
+        ctx.dpmStat.curSnkMaxMin[idx] = max_min[idx];
+    }
+    ctx.dpmStat.curSnkPdocount = count;
+}
+
+static cy_pd_pd_do_t eval(const cy_pd_pd_do_t *pdo, uint8_t count)
+{
+    cy_stc_pdstack_pd_packet_t cap;
+
+    memset(&cap, 0, sizeof(cap));
+    memcpy(cap.dat, pdo, count * sizeof(cy_pd_pd_do_t));
+    cap.len = count;
+
+    resp_count = 0u;
+    Cy_App_Pdo_EvalSrcCap(&ctx, &cap, resp_handler);
+    HOST_CHECK_EQ(resp_count, 1u);
+    return last_resp.respDo;
+}
+
+/* Fixed sink PDOs select the highest power fixed source PDO within their limits */
+static void test_fixed_contract(void)
+{
+    const cy_pd_pd_do_t snk[] = { host_fixed_snk(5000, 3000), host_fixed_snk(9000, 3000), host_fixed_snk(15000, 2000) };
+    const uint16_t max_min[] = { 300, 300, 200 };
+    const cy_pd_pd_do_t src[] = { host_fixed_src(5000, 3000), host_fixed_src(9000, 3000),
+        host_fixed_src(15000, 3000), host_fixed_src(20000, 2250) };
+    cy_pd_pd_do_t rdo;
+
+    set_sink(snk, max_min, 3u);
+    rdo = eval(src, 4u);
+
+    /* 15 V at 2 A is 30 W, 9 V at 3 A only 27 W */
+    HOST_CHECK_EQ(rdo.rdo_gen.objPos, 3u);
+    HOST_CHECK_EQ(rdo.rdo_gen.opPowerCur, 200u);
+    HOST_CHECK_EQ(rdo.rdo_gen.minMaxPowerCur, 200u);
+    HOST_CHECK_EQ(rdo.rdo_gen.capMismatch, 0u);
+    HOST_CHECK_EQ(glAppContractVoltage[0], 15000u / 50u);
+    HOST_CHECK_EQ(glAppContractPower[0], 30000u / 250u);
+}
+
+/* Battery sink PDOs convert the power to a current at the lowest voltage of the source PDO */
+static void test_battery_contract(void)
+{
+    const cy_pd_pd_do_t snk[] = { host_fixed_snk(5000, 500), host_bat_snk(5000, 21000, 45000) };
+    const uint16_t max_min[] = { 50, 180 };
+    const cy_pd_pd_do_t src[] = { host_fixed_src(5000, 3000), host_fixed_src(20000, 3000) };
+    cy_pd_pd_do_t rdo;
+
+    set_sink(snk, max_min, 2u);
+    rdo = eval(src, 2u);
+
+    /* 20 V minus 5 % is 19 V; 45 W at 19 V rounds up to 2.37 A */
+    HOST_CHECK_EQ(rdo.rdo_gen.objPos, 2u);
+    HOST_CHECK_EQ(glAppContractVoltage[0], 19000u / 50u);
+    HOST_CHECK_EQ(glAppOperCurPower[0], 237u);
+    HOST_CHECK_EQ(rdo.rdo_gen.opPowerCur, 237u);
+
+    /* The same source at 2 A cannot supply 2.37 A; only the 5 V PDO is left */
+    {
+        const cy_pd_pd_do_t weak[] = { host_fixed_src(5000, 3000), host_fixed_src(20000, 2000) };
+
+        rdo = eval(weak, 2u);
+        HOST_CHECK_EQ(rdo.rdo_gen.objPos, 1u);
+        HOST_CHECK_EQ(rdo.rdo_gen.opPowerCur, 50u);
+    }
+}
+
+/* Without an acceptable PDO, vSafe5V is requested with capability mismatch */
+static void test_cap_mismatch(void)
+{
+    const cy_pd_pd_do_t snk[] = { host_fixed_snk(5000, 3000), host_fixed_snk(9000, 3000) };
+    const uint16_t max_min[] = { 300, 300 };
+    const cy_pd_pd_do_t src[] = { host_fixed_src(5000, 1500), host_fixed_src(9000, 2000) };
+    cy_pd_pd_do_t rdo;
+
+    set_sink(snk, max_min, 2u);
+    rdo = eval(src, 2u);
+
+    HOST_CHECK_EQ(rdo.rdo_gen.objPos, 1u);
+    HOST_CHECK_EQ(rdo.rdo_gen.capMismatch, 1u);
+    HOST_CHECK_EQ(rdo.rdo_gen.giveBackFlag, 0u);
+
+    /* The operating current is limited to what the source offers at 5 V */
+    HOST_CHECK_EQ(rdo.rdo_gen.opPowerCur, 150u);
+    HOST_CHECK_EQ(rdo.rdo_gen.minMaxPowerCur, 300u);
+}
+
+/* Simple deterministic generator for the synthetic capabilities */
+static uint32_t rand_state = 12345u;
+
+static uint32_t next_rand(uint32_t range)
+{
+    rand_state = (rand_state * 1103515245u) + 12345u;
+    return ((rand_state >> 8u) % range);
+}
+
+static cy_pd_pd_do_t random_src_pdo(void)
+{
+    uint32_t min_mv = 3300u + (next_rand(20u) * 500u);
+    uint32_t ma = 500u + (next_rand(10u) * 250u);
+
+    switch (next_rand(4u))
+    {
+        case 0:
+            return host_var_src(min_mv, min_mv + 5000u, ma);
+        case 1:
+            return host_bat_src(min_mv, min_mv + 5000u, ma * 10u);
+        default:
+            return host_fixed_src(5000u + (next_rand(16u) * 1000u), ma);
+    }
+}
+
+/*
+ * Results answered from the cache and from a fresh evaluation are the same,
+ * also after the sink capabilities change.
+ */
+static void test_cache_matches_evaluation(void)
+{
+    const cy_pd_pd_do_t snk[] = { host_fixed_snk(5000, 900), host_fixed_snk(9000, 1500),
+        host_var_snk(5000, 21000, 1000), host_bat_snk(5000, 21000, 15000) };
+    const uint16_t max_min[] = { 90, 150, 100, 60 };
+    cy_pd_pd_do_t set[8][CY_PD_MAX_NO_OF_PDO];
+    uint32_t expected[8];
+    cy_pd_pd_do_t rdo;
+    uint8_t count[8];
+    uint8_t idx, pdo_idx, pass;
+
+    for (idx = 0u; idx < 8u; idx++)
+    {
+        /* The first PDO is always vSafe5V */
+        count[idx] = (uint8_t)(2u + next_rand(CY_PD_MAX_NO_OF_PDO - 1u));
+        set[idx][0] = host_fixed_src(5000, 3000);
+        for (pdo_idx = 1u; pdo_idx < count[idx]; pdo_idx++)
+        {
+            set[idx][pdo_idx] = random_src_pdo();
+        }
+    }
+
+    for (pass = 0u; pass < 2u; pass++)
+    {
+        set_sink(snk, max_min, (pass == 0u) ? 4u : 3u);
+
+        /* Fresh evaluation of each set */
+        for (idx = 0u; idx < 8u; idx++)
+        {
+            Cy_App_Pdo_ClearEvalCache(&ctx);
+            expected[idx] = eval(set[idx], count[idx]).val;
+        }
+
+        /* Each set twice in a row; the second one is answered from the cache */
+        for (idx = 0u; idx < 8u; idx++)
+        {
+            Cy_App_Pdo_ClearEvalCache(&ctx);
+            rdo = eval(set[idx], count[idx]);
+            HOST_CHECK_EQ(rdo.val, expected[idx]);
+            rdo = eval(set[idx], count[idx]);
+            HOST_CHECK_EQ(rdo.val, expected[idx]);
+        }
+
+        /* Alternating sets within the cache size */
+        for (idx = 0u; idx < 16u; idx++)
+        {
+            rdo = eval(set[idx & 1u], count[idx & 1u]);
+            HOST_CHECK_EQ(rdo.val, expected[idx & 1u]);
+        }
+    }
+}
+
+/* A cached result is not reused once the sink PDOs have changed */
+static void test_cache_invalidated_by_sink_change(void)
+{
+    const cy_pd_pd_do_t snk[] = { host_fixed_snk(5000, 3000), host_fixed_snk(9000, 3000) };
+    const uint16_t max_min[] = { 300, 300 };
+    const cy_pd_pd_do_t src[] = { host_fixed_src(5000, 3000), host_fixed_src(9000, 3000) };
+    cy_pd_pd_do_t rdo;
+
+    set_sink(snk, max_min, 2u);
+    rdo = eval(src, 2u);
+    HOST_CHECK_EQ(rdo.rdo_gen.objPos, 2u);
+
+    /* Same PDO count, different operating current */
+    ctx.dpmStat.curSnkPdo[1] = host_fixed_snk(9000, 2000);
+    ctx.dpmStat.curSnkMaxMin[1] = 200u;
+    rdo = eval(src, 2u);
+    HOST_CHECK_EQ(rdo.rdo_gen.objPos, 2u);
+    HOST_CHECK_EQ(rdo.rdo_gen.opPowerCur, 200u);
+
+    /* The 9 V PDO is dropped from the sink capabilities */
+    ctx.dpmStat.curSnkPdocount = 1u;
+    rdo = eval(src, 2u);
+    HOST_CHECK_EQ(rdo.rdo_gen.objPos, 1u);
+}
+
+/* Prefers the lowest voltage while the external flag is clear and the highest one while it is set */
+static bool prefer_high;
+
+static bool score_by_flag(cy_stc_pdstack_context_t *context, const cy_pd_pd_do_t *pdoSrc,
+        const cy_stc_app_pdo_contract_t *contract, uint32_t *score)
+{
+    (void)context;
+    (void)pdoSrc;
+
+    *score = (prefer_high) ? contract->contractVolt : (0x10000u - contract->contractVolt);
+    return true;
+}
+
+/* Results of an application policy are not cached as it may depend on state outside the key */
+static void test_custom_policy_not_cached(void)
+{
+    static const cy_stc_app_pdo_policy_t by_flag = { score_by_flag, NULL };
+    const cy_pd_pd_do_t snk[] = { host_fixed_snk(5000, 3000), host_fixed_snk(9000, 3000) };
+    const uint16_t max_min[] = { 300, 300 };
+    const cy_pd_pd_do_t src[] = { host_fixed_src(5000, 3000), host_fixed_src(9000, 3000) };
+
+    set_sink(snk, max_min, 2u);
+    HOST_CHECK_EQ(Cy_App_Pdo_RegisterPolicy(&ctx, &by_flag), CY_APP_STAT_SUCCESS);
+
+    prefer_high = false;
+    HOST_CHECK_EQ(eval(src, 2u).rdo_gen.objPos, 1u);
+    prefer_high = true;
+    HOST_CHECK_EQ(eval(src, 2u).rdo_gen.objPos, 2u);
+
+    HOST_CHECK_EQ(Cy_App_Pdo_SetPolicy(&ctx, CY_APP_PDO_POLICY_MAX_POWER), CY_APP_STAT_SUCCESS);
+}
+
+int main(void)
+{
+    memset(&ctx, 0, sizeof(ctx));
+    ctx.dpmConfig.specRevSopLive = CY_PD_REV3;
+
+    test_fixed_contract();
+    test_battery_contract();
+    test_cap_mismatch();
+    test_cache_matches_evaluation();
+    test_cache_invalidated_by_sink_change();
+    test_custom_policy_not_cached();
+
+    return host_test_result("test_pdo_eval");
+}
@@ -0,0 +1,215 @@
+/*
+ * Host test of the source PDO selection policies: the PDO each built-in policy
+ * requests from a synthetic set of source capabilities, registration of an
+ * application policy, and the evaluation time of each policy.
+ */
+
+#include <string.h>
+#include <stdio.h>
+#include <time.h>
+#include "host_test.h"
+#include "host_pdo.h"
+#include "cy_app_pdo.h"
+
+#define BENCH_LOOPS     (20000u)
+
+static app_resp_t resp_buf[NO_OF_TYPEC_PORTS];
+static app_resp_t last_resp;
+
+app_resp_t* Cy_App_GetRespBuffer(uint8_t port)
+{
+    return &resp_buf[port];
+}
+
+static void resp_handler(cy_stc_pdstack_context_t *ctx, app_resp_t *resp)
+{
+    (void)ctx;
+    last_resp = *resp;
+}
+
+static cy_stc_pdstack_context_t ctx;
+static cy_stc_pdstack_pd_packet_t src_cap;
+
+/* Sink which accepts 1 A at each fixed voltage and 30 W from a battery supply */
+static void set_sink(void)
+{
+    const cy_pd_pd_do_t snk[] = { host_fixed_snk(5000, 1000), host_fixed_snk(9000, 1000),
+        host_fixed_snk(15000, 1000), host_fixed_snk(20000, 1000), host_bat_snk(5000, 21000, 30000) };
+    const uint16_t max_min[] = { 100, 100, 100, 100, 120 };
+    uint8_t idx;
+
+    for (idx = 0u; idx < 5u; idx++)
+    {
+        ctx.dpmStat.curSnkPdo[idx] = snk[idx];
+        ctx.dpmStat.curSnkMaxMin[idx] = max_min[idx];
+    }
+    ctx.dpmStat.curSnkPdocount = 5u;
+}
+
+/*
+ * Contracts: 5 V 5 W, 9 V 9 W, 15 V 15 W, 20 V 20 W and the 9-20 V battery supply at 30 W.
+ * Advertised power of the fixed PDOs: 15 W, 27 W, 30 W and 25 W.
+ */
+static void set_source(void)
+{
+    memset(&src_cap, 0, sizeof(src_cap));
+    src_cap.dat[0] = host_fixed_src(5000, 3000);
+    src_cap.dat[1] = host_fixed_src(9000, 3000);
+    src_cap.dat[2] = host_fixed_src(15000, 2000);
+    src_cap.dat[3] = host_fixed_src(20000, 1250);
+    src_cap.dat[4] = host_bat_src(9000, 20000, 60000);
+    src_cap.len = 5u;
+}
+
+static uint32_t eval_pos(void)
+{
+    Cy_App_Pdo_EvalSrcCap(&ctx, &src_cap, resp_handler);
+    return last_resp.respDo.rdo_gen.objPos;
+}
+
+static void test_builtin_policies(void)
+{
+    /* CY_APP_PD_PDO_SEL_ALGO defaults to the maximum contract power */
+    HOST_CHECK_EQ(Cy_App_Pdo_GetPolicy(&ctx), CY_APP_PDO_POLICY_MAX_POWER);
+    HOST_CHECK_EQ(eval_pos(), 5u);
+
+    /* The fixed-only policies do not consider the battery supply */
+    HOST_CHECK_EQ(Cy_App_Pdo_SetPolicy(&ctx, CY_APP_PDO_POLICY_MAX_FIXED_POWER), CY_APP_STAT_SUCCESS);
+    HOST_CHECK_EQ(eval_pos(), 3u);
+
+    HOST_CHECK_EQ(Cy_App_Pdo_SetPolicy(&ctx, CY_APP_PDO_POLICY_MAX_VOLTAGE), CY_APP_STAT_SUCCESS);
+    HOST_CHECK_EQ(eval_pos(), 4u);
+
+    /* 5 V and 9 V both offer 3 A; the later PDO wins the tie */
+    HOST_CHECK_EQ(Cy_App_Pdo_SetPolicy(&ctx, CY_APP_PDO_POLICY_MAX_CURRENT), CY_APP_STAT_SUCCESS);
+    HOST_CHECK_EQ(eval_pos(), 2u);
+
+    /* Without a target voltage the lowest contract voltage has the least loss */
+    HOST_CHECK_EQ(Cy_App_Pdo_SetPolicy(&ctx, CY_APP_PDO_POLICY_LOWEST_LOSS), CY_APP_STAT_SUCCESS);
+    HOST_CHECK_EQ(eval_pos(), 1u);
+    Cy_App_Pdo_SetTargetVoltage(&ctx, 8000u / 50u);
+    HOST_CHECK_EQ(eval_pos(), 2u);
+
+    /*
+     * Above all offered voltages, the highest one is closest. The battery supply and
+     * the 20 V fixed PDO both have a 20 V contract; the contract power breaks the tie.
+     */
+    Cy_App_Pdo_SetTargetVoltage(&ctx, 21000u / 50u);
+    HOST_CHECK_EQ(eval_pos(), 5u);
+    Cy_App_Pdo_SetTargetVoltage(&ctx, 18000u / 50u);
+    HOST_CHECK_EQ(eval_pos(), 5u);
+
+    /* Only fixed PDOs above the target voltage */
+    Cy_App_Pdo_SetTargetVoltage(&ctx, 12000u / 50u);
+    HOST_CHECK_EQ(eval_pos(), 3u);
+
+    /* Maximum power below the fast charge level, lowest loss above it */
+    Cy_App_Pdo_SetTargetVoltage(&ctx, 8000u / 50u);
+    HOST_CHECK_EQ(Cy_App_Pdo_SetPolicy(&ctx, CY_APP_PDO_POLICY_BATTERY), CY_APP_STAT_SUCCESS);
+    Cy_App_Pdo_SetBatteryLevel(&ctx, 10u);
+    HOST_CHECK_EQ(eval_pos(), 5u);
+    Cy_App_Pdo_SetBatteryLevel(&ctx, CY_APP_PDO_BATT_FAST_CHARGE_LEVEL);
+    HOST_CHECK_EQ(eval_pos(), 2u);
+    Cy_App_Pdo_SetBatteryLevel(&ctx, 10u);
+    HOST_CHECK_EQ(eval_pos(), 5u);
+
+    Cy_App_Pdo_SetTargetVoltage(&ctx, 0u);
+    HOST_CHECK_EQ(Cy_App_Pdo_GetPolicy(&ctx), CY_APP_PDO_POLICY_BATTERY);
+}
+
+static uint32_t custom_calls;
+
+/* Prefers the contract closest to 12 V; the battery supply is not used */
+static bool score_near_12v(cy_stc_pdstack_context_t *context, const cy_pd_pd_do_t *pdoSrc,
+        const cy_stc_app_pdo_contract_t *contract, uint32_t *score)
+{
+    uint32_t target = 12000u / 50u;
+
+    (void)context;
+    custom_calls++;
+
+    *score = 0x10000u - ((contract->contractVolt > target) ? (contract->contractVolt - target) :
+            (target - contract->contractVolt));
+    return (pdoSrc->fixed_src.supplyType != CY_PDSTACK_PDO_BATTERY);
+}
+
+static bool score_none(cy_stc_pdstack_context_t *context, const cy_pd_pd_do_t *pdoSrc,
+        const cy_stc_app_pdo_contract_t *contract, uint32_t *score)
+{
+    (void)context;
+    (void)pdoSrc;
+    (void)contract;
+
+    *score = 0u;
+    return false;
+}
+
+static void test_custom_policy(void)
+{
+    static const cy_stc_app_pdo_policy_t near_12v = { score_near_12v, NULL };
+    static const cy_stc_app_pdo_policy_t none = { score_none, NULL };
+    static const cy_stc_app_pdo_policy_t invalid = { NULL, score_near_12v };
+
+    HOST_CHECK_EQ(Cy_App_Pdo_RegisterPolicy(&ctx, NULL), CY_APP_STAT_BAD_PARAM);
+    HOST_CHECK_EQ(Cy_App_Pdo_RegisterPolicy(&ctx, &invalid), CY_APP_STAT_BAD_PARAM);
+    HOST_CHECK_EQ(Cy_App_Pdo_SetPolicy(&ctx, CY_APP_PDO_POLICY_CUSTOM), CY_APP_STAT_BAD_PARAM);
+
+    /* 9 V and 15 V are both 3 V away from 12 V; the later PDO wins the tie */
+    HOST_CHECK_EQ(Cy_App_Pdo_RegisterPolicy(&ctx, &near_12v), CY_APP_STAT_SUCCESS);
+    HOST_CHECK_EQ(Cy_App_Pdo_GetPolicy(&ctx), CY_APP_PDO_POLICY_CUSTOM);
+    custom_calls = 0u;
+    HOST_CHECK_EQ(eval_pos(), 3u);
+
+    /* Called once for each acceptable source and sink PDO pair */
+    HOST_CHECK_EQ(custom_calls, 5u);
+
+    /* A policy which rejects all candidates results in a capability mismatch */
+    HOST_CHECK_EQ(Cy_App_Pdo_RegisterPolicy(&ctx, &none), CY_APP_STAT_SUCCESS);
+    HOST_CHECK_EQ(eval_pos(), 1u);
+    HOST_CHECK_EQ(last_resp.respDo.rdo_gen.capMismatch, 1u);
+
+    /* Selecting a built-in policy replaces the application policy */
+    HOST_CHECK_EQ(Cy_App_Pdo_SetPolicy(&ctx, CY_APP_PDO_POLICY_MAX_POWER), CY_APP_STAT_SUCCESS);
+    HOST_CHECK_EQ(eval_pos(), 5u);
+}
+
+/* Evaluation time of each built-in policy with seven source PDOs; not checked */
+static void bench_policies(void)
+{
+    static const char *const name[] = { "max_power", "max_fixed_power", "max_voltage",
+        "max_current", "lowest_loss", "battery" };
+    clock_t start;
+    uint32_t loop;
+    uint8_t policy;
+
+    src_cap.dat[5] = host_fixed_src(12000, 3000);
+    src_cap.dat[6] = host_pps_src(3300, 21000, 3000);
+    src_cap.len = CY_PD_MAX_NO_OF_PDO;
+
+    for (policy = 0u; policy < (uint8_t)CY_APP_PDO_POLICY_CUSTOM; policy++)
+    {
+        (void)Cy_App_Pdo_SetPolicy(&ctx, (cy_en_app_pdo_policy_t)policy);
+        start = clock();
+        for (loop = 0u; loop < BENCH_LOOPS; loop++)
+        {
+            Cy_App_Pdo_ClearEvalCache(&ctx);
+            Cy_App_Pdo_EvalSrcCap(&ctx, &src_cap, resp_handler);
+        }
+        printf("  %-16s %6.0f ns/eval\n", name[policy],
+                ((double)(clock() - start) * 1e9) / ((double)CLOCKS_PER_SEC * BENCH_LOOPS));
+    }
+}
+
+int main(void)
+{
+    memset(&ctx, 0, sizeof(ctx));
+    ctx.dpmConfig.specRevSopLive = CY_PD_REV3;
+    set_sink();
+    set_source();
+
+    test_builtin_policies();
+    test_custom_policy();
+    bench_policies();
+
+    return host_test_result("test_pdo_policy");
+}
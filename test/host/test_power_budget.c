@@ -0,0 +1,313 @@
+/*
+ * Host test of the power budget manager: the split of the adapter power between
+ * two ports, the published source capabilities, the preference of attached
+ * ports, and a replay of attach, contract and detach events against the used
+ * power and the total budget, which reports the budget utilisation.
+ */
+
+#include <string.h>
+#include "host_test.h"
+#include "host_pdo.h"
+#include "cy_app_power_budget.h"
+
+#define TOTAL_POWER     (100u)
+#define MIN_POWER       (15u)
+#define REPLAY_STEPS    (400u)
+
+static cy_stc_pdstack_context_t ctx[NO_OF_TYPEC_PORTS];
+
+/* Last capabilities advertised on each port */
+static cy_pd_pd_do_t adv_pdo[NO_OF_TYPEC_PORTS][CY_PD_MAX_NO_OF_PDO];
+static uint8_t adv_count[NO_OF_TYPEC_PORTS];
+static uint32_t adv_updates[NO_OF_TYPEC_PORTS];
+
+/* 5 V, 9 V and 15 V at 3 A and 20 V at 3.25 A: 65 W */
+static void init_port(uint8_t port)
+{
+    memset(&ctx[port], 0, sizeof(ctx[port]));
+    ctx[port].port = port;
+    ctx[port].dpmConfig.curPortRole = CY_PD_PRT_ROLE_SOURCE;
+    ctx[port].dpmStat.curSrcPdo[0] = host_fixed_src(5000, 3000);
+    ctx[port].dpmStat.curSrcPdo[1] = host_fixed_src(9000, 3000);
+    ctx[port].dpmStat.curSrcPdo[2] = host_fixed_src(15000, 3000);
+    ctx[port].dpmStat.curSrcPdo[3] = host_fixed_src(20000, 3250);
+    ctx[port].dpmStat.srcPdoCount = 4u;
+    ctx[port].dpmStat.srcPdoMask = 0x0Fu;
+
+    memcpy(adv_pdo[port], ctx[port].dpmStat.curSrcPdo, sizeof(adv_pdo[port]));
+    adv_count[port] = 4u;
+}
+
+/* Runs the settle delay and the task of each port, and records published capabilities */
+static void settle(void)
+{
+    uint8_t port;
+
+    host_timer_advance(CY_APP_PWR_BUDGET_SETTLE_DELAY);
+    for (port = 0u; port < NO_OF_TYPEC_PORTS; port++)
+    {
+        Cy_App_PowerBudget_Task(&ctx[port]);
+    }
+
+    for (port = 0u; port < NO_OF_TYPEC_PORTS; port++)
+    {
+        if (host_src_cap[port].updates != adv_updates[port])
+        {
+            adv_updates[port] = host_src_cap[port].updates;
+            memcpy(adv_pdo[port], host_src_cap[port].pdo, sizeof(adv_pdo[port]));
+            adv_count[port] = host_src_cap[port].count;
+        }
+    }
+}
+
+/* Contract for the fixed PDO at the given position with the given current in 10 mA units */
+static void contract(uint8_t port, uint8_t pos, uint16_t cur)
+{
+    cy_pd_pd_do_t rdo;
+
+    rdo.val = 0u;
+    rdo.rdo_gen.objPos = pos;
+    rdo.rdo_gen.opPowerCur = cur;
+    rdo.rdo_gen.minMaxPowerCur = cur;
+
+    ctx[port].dpmConfig.attach = true;
+    ctx[port].dpmConfig.contractExist = true;
+    ctx[port].dpmStat.srcSelPdo = adv_pdo[port][pos - 1u];
+    ctx[port].dpmStat.srcRdo = rdo;
+    Cy_App_PowerBudget_EventHandler(&ctx[port], APP_EVT_PD_CONTRACT_NEGOTIATION_COMPLETE);
+}
+
+static void detach(uint8_t port)
+{
+    ctx[port].dpmConfig.attach = false;
+    ctx[port].dpmConfig.contractExist = false;
+    Cy_App_PowerBudget_EventHandler(&ctx[port], APP_EVT_DISCONNECT);
+}
+
+static void test_init(void)
+{
+    /* The guaranteed power of both ports exceeds the total */
+    HOST_CHECK_EQ(Cy_App_PowerBudget_Init(20u, 15u), CY_APP_STAT_BAD_PARAM);
+    HOST_CHECK_EQ(Cy_App_PowerBudget_Init(TOTAL_POWER, MIN_POWER), CY_APP_STAT_SUCCESS);
+
+    init_port(0u);
+    init_port(1u);
+    HOST_CHECK_EQ(Cy_App_PowerBudget_GetAllocation(&ctx[0]), 0u);
+    HOST_CHECK_EQ(Cy_App_PowerBudget_SetPortLimit(&ctx[0], 50u), CY_APP_STAT_NOT_SUPPORTED);
+
+    ctx[1].dpmStat.srcPdoCount = 0u;
+    HOST_CHECK_EQ(Cy_App_PowerBudget_AddPort(&ctx[1]), CY_APP_STAT_BAD_PARAM);
+    ctx[1].dpmStat.srcPdoCount = 4u;
+
+    HOST_CHECK_EQ(Cy_App_PowerBudget_AddPort(&ctx[0]), CY_APP_STAT_SUCCESS);
+    HOST_CHECK_EQ(Cy_App_PowerBudget_AddPort(&ctx[1]), CY_APP_STAT_SUCCESS);
+    HOST_CHECK_EQ(Cy_App_PowerBudget_SetPortLimit(&ctx[0], 0u), CY_APP_STAT_BAD_PARAM);
+    HOST_CHECK_EQ(Cy_App_PowerBudget_SetPortLimit(&ctx[0], 101u), CY_APP_STAT_BAD_PARAM);
+}
+
+static void test_split(void)
+{
+    /* Without contracts, the first port keeps its full power and the second one gets the rest */
+    settle();
+    HOST_CHECK_EQ(Cy_App_PowerBudget_GetAllocation(&ctx[0]), 65u);
+    HOST_CHECK_EQ(Cy_App_PowerBudget_GetAllocation(&ctx[1]), 35u);
+    HOST_CHECK_EQ(host_src_cap[0].updates, 0u);
+    HOST_CHECK_EQ(host_src_cap[1].updates, 1u);
+
+    /* 35 W: full current up to 9 V, 2.33 A at 15 V and 1.75 A at 20 V */
+    HOST_CHECK_EQ(host_src_cap[1].count, 4u);
+    HOST_CHECK_EQ(host_src_cap[1].mask, 0x0Fu);
+    HOST_CHECK_EQ(host_src_cap[1].pdo[1].fixed_src.maxCurrent, 300u);
+    HOST_CHECK_EQ(host_src_cap[1].pdo[2].fixed_src.maxCurrent, 233u);
+    HOST_CHECK_EQ(host_src_cap[1].pdo[3].fixed_src.maxCurrent, 175u);
+
+    /* A 30 W contract on the second port moves the remaining power to it */
+    contract(1u, 3u, 200u);
+    HOST_CHECK_EQ(Cy_App_PowerBudget_GetUsedPower(), 30u);
+    host_pd_cmd_count[0] = 0u;
+    host_pd_cmd_count[1] = 0u;
+    settle();
+    HOST_CHECK_EQ(Cy_App_PowerBudget_GetAllocation(&ctx[0]), 35u);
+    HOST_CHECK_EQ(Cy_App_PowerBudget_GetAllocation(&ctx[1]), 65u);
+    HOST_CHECK_EQ(host_src_cap[0].updates, 1u);
+    HOST_CHECK_EQ(host_src_cap[1].updates, 2u);
+    HOST_CHECK_EQ(host_src_cap[1].pdo[3].fixed_src.maxCurrent, 325u);
+
+    /* Only the partner of the port with a contract is told about the new capabilities, once */
+    HOST_CHECK_EQ(host_pd_cmd_count[0], 0u);
+    HOST_CHECK_EQ(host_pd_cmd_count[1], 1u);
+    Cy_App_PowerBudget_Task(&ctx[1]);
+    HOST_CHECK_EQ(host_pd_cmd_count[1], 1u);
+
+    /* A limit of 50 % of 65 W releases power to the first port */
+    HOST_CHECK_EQ(Cy_App_PowerBudget_SetPortLimit(&ctx[1], 50u), CY_APP_STAT_SUCCESS);
+    settle();
+    HOST_CHECK_EQ(Cy_App_PowerBudget_GetAllocation(&ctx[1]), 32u);
+    HOST_CHECK_EQ(Cy_App_PowerBudget_GetAllocation(&ctx[0]), 65u);
+
+    /* Small changes are not published */
+    HOST_CHECK_EQ(Cy_App_PowerBudget_SetPortLimit(&ctx[1], 52u), CY_APP_STAT_SUCCESS);
+    settle();
+    HOST_CHECK_EQ(Cy_App_PowerBudget_GetAllocation(&ctx[1]), 32u);
+
+    HOST_CHECK_EQ(Cy_App_PowerBudget_SetPortLimit(&ctx[1], 100u), CY_APP_STAT_SUCCESS);
+    detach(1u);
+    HOST_CHECK_EQ(Cy_App_PowerBudget_GetUsedPower(), 0u);
+    settle();
+}
+
+/* An attached port without a contract is served before a detached one */
+static void test_attached_first(void)
+{
+    settle();
+    HOST_CHECK_EQ(Cy_App_PowerBudget_GetAllocation(&ctx[0]), 65u);
+    HOST_CHECK_EQ(Cy_App_PowerBudget_GetAllocation(&ctx[1]), 35u);
+
+    ctx[1].dpmConfig.attach = true;
+    Cy_App_PowerBudget_EventHandler(&ctx[1], APP_EVT_TYPEC_ATTACH);
+    settle();
+    HOST_CHECK_EQ(Cy_App_PowerBudget_GetAllocation(&ctx[0]), 35u);
+    HOST_CHECK_EQ(Cy_App_PowerBudget_GetAllocation(&ctx[1]), 65u);
+
+    detach(1u);
+    settle();
+}
+
+/* Simple deterministic generator for the replay */
+static uint32_t rand_state = 2024u;
+
+static uint32_t next_rand(uint32_t range)
+{
+    rand_state = (rand_state * 1103515245u) + 12345u;
+    return ((rand_state >> 8u) % range);
+}
+
+/* Contract power in watts as budgeted by the manager: fixed PDO voltage times the current */
+static uint16_t ref_power(uint8_t port)
+{
+    uint32_t mw;
+
+    if (!ctx[port].dpmConfig.contractExist)
+    {
+        return 0u;
+    }
+
+    mw = ((uint32_t)ctx[port].dpmStat.srcSelPdo.fixed_src.voltage * 50u *
+            ctx[port].dpmStat.srcRdo.rdo_gen.opPowerCur * 10u) / 1000u;
+    return (uint16_t)((mw + 999u) / 1000u);
+}
+
+/* The partner re-requests the same voltage within the new capabilities, or vSafe5V */
+static void renegotiate(uint8_t port)
+{
+    uint16_t volt = ctx[port].dpmStat.srcSelPdo.fixed_src.voltage;
+    uint16_t cur = ctx[port].dpmStat.srcRdo.rdo_gen.opPowerCur;
+    uint8_t pos = 1u;
+    uint8_t idx;
+
+    for (idx = 0u; idx < adv_count[port]; idx++)
+    {
+        if (adv_pdo[port][idx].fixed_src.voltage == volt)
+        {
+            pos = (uint8_t)(idx + 1u);
+        }
+    }
+
+    contract(port, pos, CY_PDUTILS_GET_MIN(cur, adv_pdo[port][pos - 1u].fixed_src.maxCurrent));
+}
+
+/*
+ * Random attach, contract and detach events. The used power matches the contracts,
+ * the allocations stay within the total and, once the partners have renegotiated,
+ * each contract is within the allocation of its port. The allocated and used power
+ * against the total are reported at the end.
+ */
+static void test_replay(void)
+{
+    uint32_t cmd_count[NO_OF_TYPEC_PORTS];
+    uint32_t renegotiated = 0u;
+    uint32_t alloc_total = 0u;
+    uint32_t used_total = 0u;
+    uint16_t alloc_min = TOTAL_POWER;
+    uint16_t used_peak = 0u;
+    uint16_t alloc_sum;
+    uint16_t used;
+    uint32_t step;
+    uint8_t port;
+    uint8_t pos;
+
+    for (step = 0u; step < REPLAY_STEPS; step++)
+    {
+        port = (uint8_t)next_rand(NO_OF_TYPEC_PORTS);
+
+        if (next_rand(4u) == 0u)
+        {
+            detach(port);
+        }
+        else
+        {
+            pos = (uint8_t)(1u + next_rand(adv_count[port]));
+            contract(port, pos, (uint16_t)(50u + next_rand(adv_pdo[port][pos - 1u].fixed_src.maxCurrent - 49u)));
+        }
+
+        used = 0u;
+        for (port = 0u; port < NO_OF_TYPEC_PORTS; port++)
+        {
+            used += ref_power(port);
+            cmd_count[port] = host_pd_cmd_count[port];
+        }
+        HOST_CHECK_EQ(Cy_App_PowerBudget_GetUsedPower(), used);
+
+        /* Rebalance, then let the partners of changed ports renegotiate and settle again */
+        settle();
+        for (port = 0u; port < NO_OF_TYPEC_PORTS; port++)
+        {
+            Cy_App_PowerBudget_Task(&ctx[port]);
+            if (host_pd_cmd_count[port] != cmd_count[port])
+            {
+                renegotiate(port);
+                renegotiated++;
+            }
+        }
+        settle();
+
+        alloc_sum = 0u;
+        used = 0u;
+        for (port = 0u; port < NO_OF_TYPEC_PORTS; port++)
+        {
+            alloc_sum += Cy_App_PowerBudget_GetAllocation(&ctx[port]);
+            used += ref_power(port);
+            HOST_CHECK(Cy_App_PowerBudget_GetAllocation(&ctx[port]) >= MIN_POWER);
+            HOST_CHECK(ref_power(port) <= Cy_App_PowerBudget_GetAllocation(&ctx[port]));
+        }
+
+        HOST_CHECK(alloc_sum <= TOTAL_POWER);
+        HOST_CHECK_EQ(Cy_App_PowerBudget_GetUsedPower(), used);
+        HOST_CHECK(used <= TOTAL_POWER);
+
+        alloc_total += alloc_sum;
+        used_total += used;
+        alloc_min = CY_PDUTILS_GET_MIN(alloc_min, alloc_sum);
+        used_peak = CY_PDUTILS_GET_MAX(used_peak, used);
+    }
+
+    printf("  allocated        avg %5.1f W, min %3u W of %u W (%.0f %%)\n",
+            (double)alloc_total / REPLAY_STEPS, alloc_min, TOTAL_POWER,
+            ((double)alloc_total * 100.0) / ((double)REPLAY_STEPS * TOTAL_POWER));
+    printf("  used             avg %5.1f W, max %3u W of %u W (%.0f %%)\n",
+            (double)used_total / REPLAY_STEPS, used_peak, TOTAL_POWER,
+            ((double)used_total * 100.0) / ((double)REPLAY_STEPS * TOTAL_POWER));
+
+    /* The replay has to reduce allocations below active contracts */
+    HOST_CHECK(renegotiated != 0u);
+}
+
+int main(void)
+{
+    test_init();
+    test_split();
+    test_attached_first();
+    test_replay();
+
+    return host_test_result("test_power_budget");
+}